@@ -0,0 +1,118 @@
+/**
+ * bench_buffer_manager.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Buffer manager benchmarks
+ *
+ * Measures latency and heap allocations per buffer miss. The storage read path,
+ * which allocates an intermediate buffer and a new page on every read, is
+ * compared with the buffer manager miss path which reads the page block into
+ * memory it owns and loads the page in place into the page object of the
+ * replaced page.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+#include <persist/core/buffer/buffer_manager.hpp>
+#include <persist/core/page/record_page/page.hpp>
+#include <persist/core/storage/creator.hpp>
+
+#include "persist/bench/allocation.hpp"
+
+using namespace persist;
+
+class BufferManagerBenchmarkFixture : public benchmark::Fixture {
+protected:
+  const size_t page_count = 64;
+  const size_t slot_count = 4;
+  const std::string connection_string = "file://data/bench_buffer_manager";
+  const std::string log_connection_string = "memory://";
+  std::unique_ptr<Storage<RecordPage>> storage;
+  std::unique_ptr<Storage<LogPage>> log_storage;
+  std::unique_ptr<LogManager> log_manager;
+
+public:
+  void SetUp(const benchmark::State &) override {
+    log_storage = persist::CreateStorage<LogPage>(log_connection_string);
+    log_manager = std::make_unique<LogManager>(*log_storage, 2);
+    log_manager->Start();
+
+    storage = persist::CreateStorage<RecordPage>(connection_string);
+    storage->Open();
+    Transaction txn(*log_manager, 0);
+    for (size_t i = 0; i < page_count; ++i) {
+      PageId page_id = storage->Allocate();
+      auto page = persist::CreatePage<RecordPage>(page_id, DEFAULT_PAGE_SIZE);
+      for (size_t j = 0; j < slot_count; ++j) {
+        RecordPageSlot page_slot;
+        page_slot.data = ByteBuffer(64, 'A');
+        page->InsertPageSlot(page_slot, txn);
+      }
+      storage->Write(*page);
+    }
+  }
+
+  void TearDown(const benchmark::State &) override {
+    storage->Remove();
+    log_manager->Stop();
+  }
+};
+
+BENCHMARK_F(BufferManagerBenchmarkFixture, BM_StorageRead)
+(benchmark::State &state) {
+  PageId page_id = 0;
+  size_t allocations = bench::AllocationCount();
+  for (auto _ : state) {
+    auto page = storage->Read(page_id % page_count + 1);
+    benchmark::DoNotOptimize(page);
+    ++page_id;
+  }
+  state.counters["allocs_per_miss"] =
+      benchmark::Counter(bench::AllocationCount() - allocations,
+                         benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_F(BufferManagerBenchmarkFixture, BM_BufferManagerMiss)
+(benchmark::State &state) {
+  BufferManager<RecordPage> buffer_manager(*storage, MINIMUM_BUFFER_SIZE);
+  buffer_manager.Start();
+
+  // Pages are accessed in a cycle larger than the buffer so every access
+  // results in a miss.
+  PageId page_id = 0;
+  size_t allocations = bench::AllocationCount();
+  for (auto _ : state) {
+    auto page = buffer_manager.Get(page_id % page_count + 1);
+    benchmark::DoNotOptimize(page.operator->());
+    ++page_id;
+  }
+  state.counters["allocs_per_miss"] =
+      benchmark::Counter(bench::AllocationCount() - allocations,
+                         benchmark::Counter::kAvgIterations);
+
+  buffer_manager.Stop();
+}
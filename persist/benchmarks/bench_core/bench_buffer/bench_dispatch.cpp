@@ -0,0 +1,102 @@
+/**
+ * bench_dispatch.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Buffer manager dispatch benchmarks
+ *
+ * Measures the latency of the resident page cycle of getting a page loaded in
+ * buffer, accessing it and releasing the page handle. The cycle through the
+ * virtual buffer manager, replacer and storage interfaces is compared with the
+ * cycle through a buffer manager of concrete replacer and storage types.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <persist/core/buffer/buffer_manager.hpp>
+#include <persist/core/page/record_page/page.hpp>
+#include <persist/core/storage/memory_storage.hpp>
+
+using namespace persist;
+
+/**
+ * @brief Number of pages cycled through, all resident in buffer
+ */
+static const size_t page_count = 16;
+
+/**
+ * @brief Buffer manager using concrete replacer and storage types
+ */
+typedef BufferManager<RecordPage, LRUReplacer, MemoryStorage<RecordPage>>
+    StaticBufferManager;
+
+/**
+ * @brief Allocate pages and load them in buffer.
+ */
+template <class BufferManagerType>
+static void LoadPages(BufferManagerType &buffer_manager) {
+  buffer_manager.Start();
+  for (size_t i = 0; i < page_count; ++i) {
+    buffer_manager.GetNew();
+  }
+}
+
+/**
+ * @brief Resident page cycle through the virtual interfaces.
+ */
+static void BM_ResidentGetVirtual(benchmark::State &state) {
+  MemoryStorage<RecordPage> storage;
+  BufferManager<RecordPage> buffer_manager(storage, page_count);
+  LoadPages(buffer_manager);
+
+  BufferManagerBase<RecordPage> &base = buffer_manager;
+  PageId page_id = 0;
+  for (auto _ : state) {
+    auto page = base.Get(page_id % page_count + 1);
+    benchmark::DoNotOptimize(page->GetId());
+    ++page_id;
+  }
+
+  buffer_manager.Stop();
+}
+
+/**
+ * @brief Resident page cycle through the concrete types.
+ */
+static void BM_ResidentGetStatic(benchmark::State &state) {
+  MemoryStorage<RecordPage> storage;
+  StaticBufferManager buffer_manager(storage, page_count);
+  LoadPages(buffer_manager);
+
+  PageId page_id = 0;
+  for (auto _ : state) {
+    auto page = buffer_manager.Fetch(page_id % page_count + 1);
+    benchmark::DoNotOptimize(page->GetId());
+    ++page_id;
+  }
+
+  buffer_manager.Stop();
+}
+
+BENCHMARK(BM_ResidentGetVirtual);
+BENCHMARK(BM_ResidentGetStatic);
@@ -0,0 +1,144 @@
+/**
+ * bench_pax_page.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief PAX page benchmarks
+ *
+ * Measures the throughput in records per second of summing a single column of
+ * wide fixed schema records stored in pages. Records stored row wise in record
+ * page slots are compared with records stored column wise in PAX pages, where
+ * the column is summed straight from its minipage.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <persist/core/page/pax_page/page.hpp>
+#include <persist/core/page/record_page/page.hpp>
+#include <persist/core/storage/creator.hpp>
+
+using namespace persist;
+
+/**
+ * @brief Records of eight 8 byte columns
+ */
+typedef PaxPage<8, 8, 8, 8, 8, 8, 8, 8> WidePaxPage;
+
+class PaxPageBenchmarkFixture : public benchmark::Fixture {
+protected:
+  const size_t page_count = 64;
+  const std::string log_connection_string = "memory://";
+  std::unique_ptr<Storage<LogPage>> log_storage;
+  std::unique_ptr<LogManager> log_manager;
+  std::vector<std::unique_ptr<RecordPage>> record_pages;
+  std::vector<std::unique_ptr<WidePaxPage>> pax_pages;
+  size_t record_count, records_per_page;
+
+public:
+  void SetUp(const benchmark::State &) override {
+    log_storage = persist::CreateStorage<LogPage>(log_connection_string);
+    log_manager = std::make_unique<LogManager>(*log_storage, 2);
+    log_manager->Start();
+
+    Transaction txn(*log_manager, 0);
+    ByteBuffer record(WidePaxPage::GetRecordSize());
+    uint64_t value = 0;
+    record_count = 0;
+    for (size_t i = 0; i < page_count; ++i) {
+      auto record_page = std::make_unique<RecordPage>(i + 1);
+      auto pax_page = std::make_unique<WidePaxPage>(i + 1);
+      RecordPageSlot page_slot;
+      page_slot.data = record;
+      // Fill both pages with the same records
+      while (record_page->GetFreeSpaceSize(Operation::INSERT) >=
+                 page_slot.GetStorageSize() &&
+             pax_page->GetRecordCount() < pax_page->GetCapacity()) {
+        std::memcpy(record.data(), &++value, sizeof(value));
+        page_slot.data = record;
+        record_page->InsertPageSlot(page_slot, txn);
+        pax_page->InsertRecord(record.data(), txn);
+        ++record_count;
+      }
+      records_per_page = pax_page->GetRecordCount();
+      record_pages.push_back(std::move(record_page));
+      pax_pages.push_back(std::move(pax_page));
+    }
+  }
+
+  void TearDown(const benchmark::State &) override {
+    record_pages.clear();
+    pax_pages.clear();
+    log_manager->Stop();
+  }
+};
+
+/**
+ * @brief Sum the first column of records stored in record pages by reading
+ * each record slot.
+ */
+BENCHMARK_F(PaxPageBenchmarkFixture, RecordPageColumnSum)
+(benchmark::State &state) {
+  Transaction txn(*log_manager, 0);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (auto &page : record_pages) {
+      for (PageSlotId slot_id = 1; slot_id <= records_per_page; ++slot_id) {
+        uint64_t value;
+        const ByteBuffer &data = page->GetPageSlot(slot_id, txn).data;
+        std::memcpy(&value, data.data(), sizeof(value));
+        sum += value;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["records/s"] = benchmark::Counter(
+      static_cast<double>(record_count) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Sum the first column of records stored in PAX pages by reading the
+ * column minipage as an array.
+ */
+BENCHMARK_F(PaxPageBenchmarkFixture, PaxPageColumnSum)
+(benchmark::State &state) {
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (auto &page : pax_pages) {
+      const uint64_t *values =
+          reinterpret_cast<const uint64_t *>(page->GetColumn(0));
+      for (size_t i = 0; i < page->GetSlotCount(); ++i) {
+        sum += values[i];
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["records/s"] = benchmark::Counter(
+      static_cast<double>(record_count) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
@@ -0,0 +1,119 @@
+/**
+ * bench_commit.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Transaction commit benchmarks
+ *
+ * Measures commit latency of transactions backed by file storage for each log
+ * sync policy. Besides the mean latency, the distribution of commit latencies
+ * is reported as percentiles and as a histogram giving the fraction of commits
+ * in each latency bucket.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <persist/core/storage/creator.hpp>
+#include <persist/core/transaction/transaction_manager.hpp>
+
+using namespace persist;
+
+class CommitBenchmarkFixture : public benchmark::Fixture {
+protected:
+  const std::string connection_string = "file://data/bench_commit";
+  const std::string log_connection_string = "file://data/bench_commit_log";
+  std::unique_ptr<Storage<RecordPage>> storage;
+  std::unique_ptr<Storage<LogPage>> log_storage;
+  std::unique_ptr<BufferManager<RecordPage>> buffer_manager;
+  std::unique_ptr<LogManager> log_manager;
+  std::unique_ptr<TransactionManager> txn_manager;
+
+public:
+  void SetUp(const benchmark::State &state) override {
+    storage = persist::CreateStorage<RecordPage>(connection_string);
+    log_storage = persist::CreateStorage<LogPage>(log_connection_string);
+    buffer_manager = std::make_unique<BufferManager<RecordPage>>(*storage);
+    buffer_manager->Start();
+    log_manager = std::make_unique<LogManager>(*log_storage);
+    txn_manager =
+        std::make_unique<TransactionManager>(*buffer_manager, *log_manager);
+    txn_manager->SetSyncPolicy(static_cast<SyncPolicy>(state.range(0)));
+    txn_manager->Start();
+  }
+
+  void TearDown(const benchmark::State &) override {
+    txn_manager->Stop();
+    buffer_manager->Stop();
+    storage->Remove();
+    log_storage->Remove();
+  }
+};
+
+/**
+ * @brief Commit empty transactions and record the latency of each commit.
+ */
+BENCHMARK_DEFINE_F(CommitBenchmarkFixture, BM_Commit)
+(benchmark::State &state) {
+  typedef std::chrono::duration<double, std::micro> Microseconds;
+  std::vector<double> latencies;
+  for (auto _ : state) {
+    Transaction txn = txn_manager->Begin();
+    auto start = std::chrono::steady_clock::now();
+    txn_manager->Commit(txn);
+    auto end = std::chrono::steady_clock::now();
+    latencies.push_back(Microseconds(end - start).count());
+  }
+
+  // Latency percentiles in microseconds
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+  };
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["max_us"] = latencies.back();
+
+  // Fraction of commits in each latency bucket
+  const double bounds[] = {10, 100, 1000, 10000};
+  auto lower = latencies.begin();
+  for (double bound : bounds) {
+    auto upper = std::lower_bound(lower, latencies.end(), bound);
+    state.counters["lt_" + std::to_string(static_cast<int>(bound)) + "us"] =
+        static_cast<double>(upper - lower) / latencies.size();
+    lower = upper;
+  }
+  state.counters["ge_10000us"] =
+      static_cast<double>(latencies.end() - lower) / latencies.size();
+}
+
+// Arguments are sync policies ALWAYS, INTERVAL and NEVER
+BENCHMARK_REGISTER_F(CommitBenchmarkFixture, BM_Commit)
+    ->Arg(static_cast<int>(SyncPolicy::ALWAYS))
+    ->Arg(static_cast<int>(SyncPolicy::INTERVAL))
+    ->Arg(static_cast<int>(SyncPolicy::NEVER));
@@ -0,0 +1,119 @@
+/**
+ * bench_compression.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Log compression benchmarks
+ *
+ * Measures the commit throughput in transactions per second and the log bytes
+ * written per commit of transactions each inserting a JSON document into a
+ * record page. The log is a sequential log synced on every commit. The first
+ * argument selects log compression, `0` for disabled and `1` for enabled, and
+ * the second argument is the number of addresses in each document.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+#include <persist/core/storage/creator.hpp>
+#include <persist/core/transaction/transaction_manager.hpp>
+#include <persist/core/wal/sequential_log.hpp>
+
+using namespace persist;
+
+class CompressionBenchmarkFixture : public benchmark::Fixture {
+protected:
+  const std::string connection_string = "file://data/bench_compression";
+  const std::string log_path = "data/bench_compression_log";
+  std::unique_ptr<Storage<RecordPage>> storage;
+  std::unique_ptr<SequentialLog> log;
+  std::unique_ptr<BufferManager<RecordPage>> buffer_manager;
+  std::unique_ptr<LogManager> log_manager;
+  std::unique_ptr<TransactionManager> txn_manager;
+
+public:
+  void SetUp(const benchmark::State &state) override {
+    storage = persist::CreateStorage<RecordPage>(connection_string);
+    log = std::make_unique<SequentialLog>(log_path);
+    buffer_manager = std::make_unique<BufferManager<RecordPage>>(*storage);
+    buffer_manager->Start();
+    log_manager = std::make_unique<LogManager>(*log);
+    log_manager->SetCompression(state.range(0));
+    txn_manager =
+        std::make_unique<TransactionManager>(*buffer_manager, *log_manager);
+    txn_manager->SetSyncPolicy(SyncPolicy::ALWAYS);
+    txn_manager->Start();
+  }
+
+  void TearDown(const benchmark::State &) override {
+    txn_manager->Stop();
+    buffer_manager->Stop();
+    storage->Remove();
+    log->Remove();
+  }
+};
+
+/**
+ * @brief Commit transactions each inserting a JSON document.
+ */
+BENCHMARK_DEFINE_F(CompressionBenchmarkFixture, BM_CommitInsert)
+(benchmark::State &state) {
+  RecordPageSlot page_slot;
+  auto page = buffer_manager->GetNew();
+  uint64_t start_lsn = log->GetEndLsn();
+  uint64_t id = 0;
+  for (auto _ : state) {
+    ++id;
+    std::string document = "{\"id\": " + std::to_string(id) +
+                           ", \"name\": \"user_" + std::to_string(id) +
+                           "\", \"active\": true, \"addresses\": [";
+    for (int64_t i = 0; i < state.range(1); ++i) {
+      document += std::string(i > 0 ? ", " : "") +
+                  "{\"street\": \"" + std::to_string(id + i) +
+                  " Main Street\", \"city\": \"Springfield\", "
+                  "\"country\": \"United States\"}";
+    }
+    document += "]}";
+    page_slot.data = ByteBuffer(document.begin(), document.end());
+    if (page->GetFreeSpaceSize(Operation::INSERT) <
+        page_slot.GetStorageSize()) {
+      page = buffer_manager->GetNew();
+    }
+    Transaction txn = txn_manager->Begin();
+    page->InsertPageSlot(page_slot, txn);
+    txn_manager->Commit(txn);
+  }
+  state.counters["commits/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  state.counters["log_bytes/commit"] =
+      static_cast<double>(log->GetEndLsn() - start_lsn) / state.iterations();
+}
+
+// Arguments are log compression and number of addresses per document
+BENCHMARK_REGISTER_F(CompressionBenchmarkFixture, BM_CommitInsert)
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({0, 8})
+    ->Args({1, 8});
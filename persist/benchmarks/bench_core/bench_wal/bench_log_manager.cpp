@@ -0,0 +1,74 @@
+/**
+ * bench_log_manager.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Log manager benchmarks
+ *
+ * Measures the throughput in log records per second of adding update log
+ * records from a growing number of concurrent threads.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+#include <persist/core/storage/creator.hpp>
+#include <persist/core/wal/log_manager.hpp>
+
+using namespace persist;
+
+static std::unique_ptr<Storage<LogPage>> storage;
+static std::unique_ptr<LogManager> log_manager;
+
+/**
+ * @brief Add update log records carrying two small page slots.
+ */
+static void BM_Add(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    storage = persist::CreateStorage<LogPage>("memory://");
+    log_manager = std::make_unique<LogManager>(*storage);
+    log_manager->Start();
+  }
+
+  RecordPageSlot page_slot_a, page_slot_b;
+  page_slot_a.data = ByteBuffer(64, 'A');
+  page_slot_b.data = ByteBuffer(64, 'B');
+  RecordPageSlot::Location location(1, 1);
+  for (auto _ : state) {
+    LogRecord log_record(state.thread_index(), LogRecord::Location(),
+                         LogRecord::Type::UPDATE, location, page_slot_a,
+                         page_slot_b);
+    benchmark::DoNotOptimize(log_manager->Add(log_record));
+  }
+  state.counters["records/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+
+  if (state.thread_index() == 0) {
+    log_manager->Stop();
+    log_manager.reset();
+    storage.reset();
+  }
+}
+BENCHMARK(BM_Add)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,64 @@
+/**
+ * bench_log_record.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Log record benchmarks
+ *
+ * Measures the throughput in log records per second and the storage size in
+ * bytes of update log records for a 4 KiB page slot of which the number of
+ * bytes given by the argument is changed.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <persist/core/wal/log_record.hpp>
+
+using namespace persist;
+
+/**
+ * @brief Create and dump update log records.
+ */
+static void BM_LogUpdate(benchmark::State &state) {
+  RecordPageSlot page_slot_a, page_slot_b;
+  page_slot_a.data = ByteBuffer(4096, 'A');
+  page_slot_b = page_slot_a;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    page_slot_b.data[i * 7 % 4096] = 'B';
+  }
+  RecordPageSlot::Location location(1, 1);
+  size_t size = 0;
+  ByteBuffer output;
+  for (auto _ : state) {
+    LogRecord log_record(1, LogRecord::Location(), LogRecord::Type::UPDATE,
+                         location, page_slot_a, page_slot_b);
+    size = log_record.GetStorageSize();
+    output.resize(size);
+    log_record.Dump(output);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.counters["records/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  state.counters["log_bytes"] = size;
+}
+BENCHMARK(BM_LogUpdate)->Arg(1)->Arg(16)->Arg(256);
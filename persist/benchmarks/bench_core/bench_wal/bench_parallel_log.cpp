@@ -0,0 +1,74 @@
+/**
+ * bench_parallel_log.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Parallel log benchmarks
+ *
+ * Measures the throughput in commits per second of threads each adding a log
+ * record and flushing it as a commit does, with the log synced on every
+ * flush. The argument is the number of parallel log streams, where a single
+ * stream is the same as a single log.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include <persist/core/wal/parallel_log_manager.hpp>
+
+using namespace persist;
+
+static std::unique_ptr<ParallelLogManager> log_manager;
+
+/**
+ * @brief Add and flush commit log records.
+ */
+static void BM_Commit(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    log_manager = std::make_unique<ParallelLogManager>(
+        "data/bench_parallel_log", state.range(0));
+    log_manager->Start();
+  }
+
+  for (auto _ : state) {
+    LogManager &stream = log_manager->GetStream();
+    LogRecord log_record(state.thread_index(), LogRecord::Location(),
+                         LogRecord::Type::COMMIT);
+    stream.Flush(stream.Add(log_record).seq_number);
+  }
+  state.counters["commits/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+
+  if (state.thread_index() == 0) {
+    log_manager->Stop();
+    log_manager->Remove();
+    log_manager.reset();
+  }
+}
+BENCHMARK(BM_Commit)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
@@ -0,0 +1,146 @@
+/**
+ * bench_sequential_log.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Sequential log benchmarks
+ *
+ * Compares the log page format stored in file storage with the sequential log
+ * format. Measures the throughput in log records per second of appending
+ * update log records through the log manager, and of the recovery scan reading
+ * back all log records after a restart. The first argument selects the format,
+ * `0` for log pages and `1` for the sequential log.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <persist/core/storage/creator.hpp>
+#include <persist/core/wal/log_manager.hpp>
+#include <persist/core/wal/sequential_log.hpp>
+
+using namespace persist;
+
+/**
+ * @brief Log storage of either format backing a log manager.
+ */
+struct BenchmarkLog {
+  std::unique_ptr<Storage<LogPage>> storage;
+  std::unique_ptr<SequentialLog> log;
+
+  BenchmarkLog(bool sequential) {
+    if (sequential) {
+      log = std::make_unique<SequentialLog>("bench_sequential_log");
+    } else {
+      storage = persist::CreateStorage<LogPage>("file://bench_page_log");
+    }
+  }
+
+  ~BenchmarkLog() {
+    if (log) {
+      log->Remove();
+    } else {
+      storage->Remove();
+    }
+  }
+
+  std::unique_ptr<LogManager> GetLogManager() {
+    std::unique_ptr<LogManager> log_manager =
+        log ? std::make_unique<LogManager>(*log)
+            : std::make_unique<LogManager>(*storage);
+    log_manager->SetSyncPolicy(SyncPolicy::NEVER);
+    log_manager->Start();
+    return log_manager;
+  }
+};
+
+/**
+ * @brief Get an update log record carrying two small page slots.
+ */
+static LogRecord GetLogRecord() {
+  RecordPageSlot page_slot_a, page_slot_b;
+  page_slot_a.data = ByteBuffer(64, 'A');
+  page_slot_b.data = ByteBuffer(64, 'B');
+  RecordPageSlot::Location location(1, 1);
+  return LogRecord(1, LogRecord::Location(), LogRecord::Type::UPDATE, location,
+                   page_slot_a, page_slot_b);
+}
+
+/**
+ * @brief Append update log records.
+ */
+static void BM_Append(benchmark::State &state) {
+  BenchmarkLog log(state.range(0));
+  std::unique_ptr<LogManager> log_manager = log.GetLogManager();
+  LogRecord log_record = GetLogRecord();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(log_manager->Add(log_record));
+  }
+  log_manager->Flush();
+  state.counters["records/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  log_manager->Stop();
+}
+BENCHMARK(BM_Append)->Arg(0)->Arg(1);
+
+/**
+ * @brief Restart the log manager and read back all log records.
+ */
+static void BM_RecoveryScan(benchmark::State &state) {
+  const size_t record_count = state.range(1);
+  BenchmarkLog log(state.range(0));
+  std::vector<LogRecord::Location> locations;
+  {
+    std::unique_ptr<LogManager> log_manager = log.GetLogManager();
+    LogRecord log_record = GetLogRecord();
+    for (size_t i = 0; i < record_count; ++i) {
+      locations.push_back(log_manager->Add(log_record));
+    }
+    log_manager->Stop();
+  }
+
+  for (auto _ : state) {
+    std::unique_ptr<LogManager> log_manager = log.GetLogManager();
+    if (log.log) {
+      // Scan the sequential log from the start
+      log.log->Scan(0, [](SequentialLog::Lsn, Span record) {
+        LogRecord log_record;
+        log_record.Load(record);
+        benchmark::DoNotOptimize(log_record);
+      });
+    } else {
+      // Read log records from log pages in order
+      for (auto &location : locations) {
+        benchmark::DoNotOptimize(log_manager->Get(location));
+      }
+    }
+    log_manager->Stop();
+  }
+  state.counters["records/s"] = benchmark::Counter(
+      static_cast<double>(record_count) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RecoveryScan)->Args({0, 10000})->Args({1, 10000});
@@ -0,0 +1,75 @@
+/**
+ * bench_checksum.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Checksum benchmarks
+ *
+ * Measures the throughput in GB/s of each checksum algorithm over buffers of
+ * page size and larger.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <persist/utility/checksum.hpp>
+
+using namespace persist;
+
+/**
+ * @brief Run checksum of given type over a buffer of size given by the
+ * benchmark argument.
+ */
+template <class H> static void BM_Checksum(benchmark::State &state) {
+  ByteBuffer input(state.range(0));
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<Byte>(i);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(checksum<H>(input));
+  }
+  state.counters["GB/s"] = benchmark::Counter(
+      static_cast<double>(input.size()) * state.iterations() / 1e9,
+      benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief CRC-32C using the portable table driven implementation.
+ */
+struct Crc32cPortableHash {
+  uint32_t operator()(Span input) {
+    return Crc32cHash::Portable(0xFFFFFFFF, input) ^ 0xFFFFFFFF;
+  }
+};
+
+BENCHMARK_TEMPLATE(BM_Checksum, Alder32Hash)
+    ->Arg(DEFAULT_PAGE_SIZE)
+    ->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Checksum, Crc32cHash)
+    ->Arg(DEFAULT_PAGE_SIZE)
+    ->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Checksum, Crc32cPortableHash)
+    ->Arg(DEFAULT_PAGE_SIZE)
+    ->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Checksum, XXHash64)
+    ->Arg(DEFAULT_PAGE_SIZE)
+    ->Arg(65536);
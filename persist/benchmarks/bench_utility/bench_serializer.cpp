@@ -0,0 +1,123 @@
+/**
+ * bench_serializer.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Serializer benchmarks
+ *
+ * Measures the throughput in GB/s of dumping and loading byte buffers of page
+ * size and larger. The bulk copy used for containers of trivially copyable
+ * elements is compared with copying one element at a time.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <persist/utility/serializer.hpp>
+
+using namespace persist;
+
+/**
+ * @brief Byte buffer serialized one element at a time.
+ */
+struct ElementwiseBuffer {
+  ByteBuffer data;
+};
+
+namespace persist {
+inline void _copy(Span &input, ElementwiseBuffer &buffer) {
+  size_t size;
+  _copy(input, size);
+  for (size_t i = 0; i < size; ++i) {
+    Byte element;
+    _copy(input, element);
+    buffer.data.insert(buffer.data.end(), element);
+  }
+}
+
+inline void _copy(const ElementwiseBuffer &buffer, Span &output) {
+  _copy(buffer.data.size(), output);
+  for (auto &element : buffer.data) {
+    _copy(element, output);
+  }
+}
+} // namespace persist
+
+/**
+ * @brief Get buffer of given type holding given number of bytes.
+ */
+template <class T> static T MakeBuffer(size_t size);
+
+template <> ByteBuffer MakeBuffer<ByteBuffer>(size_t size) {
+  ByteBuffer buffer(size);
+  for (size_t i = 0; i < size; ++i) {
+    buffer[i] = static_cast<Byte>(i);
+  }
+  return buffer;
+}
+
+template <> ElementwiseBuffer MakeBuffer<ElementwiseBuffer>(size_t size) {
+  return ElementwiseBuffer{MakeBuffer<ByteBuffer>(size)};
+}
+
+/**
+ * @brief Dump a buffer of size given by the benchmark argument.
+ */
+template <class T> static void BM_Dump(benchmark::State &state) {
+  T input = MakeBuffer<T>(state.range(0));
+  ByteBuffer output(sizeof(size_t) + state.range(0));
+  for (auto _ : state) {
+    Span span(output);
+    dump(span, input);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.counters["GB/s"] = benchmark::Counter(
+      static_cast<double>(state.range(0)) * state.iterations() / 1e9,
+      benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Load a buffer of size given by the benchmark argument.
+ */
+template <class T> static void BM_Load(benchmark::State &state) {
+  ByteBuffer input(sizeof(size_t) + state.range(0));
+  Span span(input);
+  dump(span, MakeBuffer<T>(state.range(0)));
+  for (auto _ : state) {
+    T output;
+    span = Span(input);
+    load(span, output);
+    benchmark::DoNotOptimize(output);
+  }
+  state.counters["GB/s"] = benchmark::Counter(
+      static_cast<double>(state.range(0)) * state.iterations() / 1e9,
+      benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_TEMPLATE(BM_Dump, ByteBuffer)->Arg(DEFAULT_PAGE_SIZE)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Dump, ElementwiseBuffer)
+    ->Arg(DEFAULT_PAGE_SIZE)
+    ->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Load, ByteBuffer)->Arg(DEFAULT_PAGE_SIZE)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Load, ElementwiseBuffer)
+    ->Arg(DEFAULT_PAGE_SIZE)
+    ->Arg(65536);
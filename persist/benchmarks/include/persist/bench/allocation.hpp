@@ -0,0 +1,48 @@
+/**
+ * bench/allocation.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PERSIST_BENCH_ALLOCATION_HPP
+#define PERSIST_BENCH_ALLOCATION_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace persist {
+namespace bench {
+
+/**
+ * @brief Get the number of heap allocations made by the process. The count is
+ * incremented by the replaced global `operator new`.
+ *
+ * @returns Reference to the allocation counter
+ */
+inline std::atomic<size_t> &AllocationCount() {
+  static std::atomic<size_t> count(0);
+  return count;
+}
+
+} // namespace bench
+} // namespace persist
+
+#endif /* PERSIST_BENCH_ALLOCATION_HPP */
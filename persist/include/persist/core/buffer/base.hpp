@@ -25,6 +25,8 @@
 #ifndef PERSIST_CORE_BUFFER_BASE_HPP
 #define PERSIST_CORE_BUFFER_BASE_HPP
 
+#include <functional>
+
 #include <persist/core/buffer/page_handle.hpp>
 #include <persist/core/page/base.hpp>
 
@@ -85,6 +87,34 @@ public:
    */
   virtual PageHandle<PageType> GetNew() = 0;
 
+  /**
+   * Deallocate page with given ID. The page is dropped from the buffer
+   * without being written and its space in backend storage is freed for
+   * re-use by a later new page.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifer
+   * @throws BufferManagerError if the page is pinned
+   */
+  virtual void Deallocate(PageId page_id) = 0;
+
+  /**
+   * Deallocate page with given ID if it satisfies the given predicate. The
+   * check and the deallocation are performed atomically. A page pinned by a
+   * page handle is skipped, and so is a page already deallocated.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifer
+   * @param predicate callable invoked with the unpinned page, returning
+   * `true` if the page is to be deallocated
+   * @returns `true` if page is deallocated else `false`
+   */
+  virtual bool
+  DeallocateIf(PageId page_id,
+               const std::function<bool(PageType &)> &predicate) = 0;
+
   /**
    * Dump a single page to backend storage if modified and unpinned.
    *
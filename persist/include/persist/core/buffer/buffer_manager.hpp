@@ -25,10 +25,15 @@
 #ifndef PERSIST_CORE_BUFFER_MANAGER_HPP
 #define PERSIST_CORE_BUFFER_MANAGER_HPP
 
+#include <algorithm>
+#include <vector>
+
 #include <persist/core/buffer/base.hpp>
 #include <persist/core/buffer/replacer/lru_replacer.hpp>
 #include <persist/core/exceptions/buffer.hpp>
+#include <persist/core/exceptions/storage.hpp>
 #include <persist/core/page/creator.hpp>
+#include <persist/core/page/serializer.hpp>
 #include <persist/core/storage/base.hpp>
 
 #include <persist/utility/mutex.hpp>
@@ -42,13 +47,25 @@ namespace persist {
  * backend storage. The reading of pages while wrting of modifed pages are
  * perfromed in compliance with the page repleacement policy.
  *
+ * Calls to the replacer and the backend storage are made on their concrete
+ * types given as template parameters. With a `final` replacer and storage type
+ * the calls are statically dispatched and can be inlined, while the base
+ * storage type keeps storages pluggable at runtime through their virtual
+ * interface. Pages fetched with `Fetch` are pinned and unpinned directly
+ * through the concrete replacer.
+ *
  * @tparam PageType The type of page managed.
  * @tparam ReplacerType The type of page replacer. Default set to LRUReplacer.
+ * @tparam StorageType The type of backend storage. Default set to the
+ * storage base class.
  */
-template <class PageType, class ReplacerType = LRUReplacer>
+template <class PageType, class ReplacerType = LRUReplacer,
+          class StorageType = Storage<PageType>>
 class BufferManager : public BufferManagerBase<PageType> {
   static_assert(std::is_base_of<Replacer, ReplacerType>::value,
                 "ReplacerType must be derived from persist::Replacer class.");
+  static_assert(std::is_base_of<Storage<PageType>, StorageType>::value,
+                "StorageType must be derived from persist::Storage class.");
 
   PERSIST_PRIVATE
   /**
@@ -69,46 +86,119 @@ class BufferManager : public BufferManagerBase<PageType> {
   struct Frame {
     std::unique_ptr<PageType> page;
     bool modified;
+    bool unwritten; //<- New page not yet written to storage
 
     /**
      * @brief Construct a new Frame object
      *
      */
-    Frame() : page(nullptr), modified(false) {}
+    Frame() : page(nullptr), modified(false), unwritten(false) {}
   };
 
   ReplacerType replacer;                       //<- Page replacer
-  Storage<PageType> &storage GUARDED_BY(lock); //<- Reference to backend storage
+  StorageType &storage GUARDED_BY(lock); //<- Reference to backend storage
   size_t max_size GUARDED_BY(lock);            //<- Maximum size of buffer
   typedef typename std::unordered_map<PageId, Frame> Buffer;
   Buffer buffer GUARDED_BY(lock); //<- Buffer of page frames
   bool started GUARDED_BY(lock);  //<- Flag indicating buffer manager started
+  ByteBuffer block GUARDED_BY(lock); //<- Re-usable page block for storage IO
+
+  /**
+   * @brief Get the backend storage as the storage base class, which keeps the
+   * verification state of stored pages.
+   */
+  Storage<PageType> &GetBaseStorage() { return storage; }
 
   /**
-   * Add page to buffer.
+   * @brief Check if the page with given ID is de-allocated or is a new page
+   * not yet written to backend storage, and thus has no stored block to
+   * verify.
    *
-   * @param page pointer reference to page
+   * @param page_id page identifer
+   * @returns `true` if the page has no stored block else `false`
    */
-  void Put(std::unique_ptr<PageType> &page) {
+  bool IsUnwritten(PageId page_id) {
     LockGuard guard(lock);
 
-    // If buffer is full then remove the victum page
-    if (max_size != 0 && buffer.size() == max_size) {
+    if (storage.IsFree(page_id)) {
+      return true;
+    }
+    auto it = buffer.find(page_id);
+    return it != buffer.end() && it->second.unwritten;
+  }
+
+  /**
+   * Remove page with given ID from buffer and hand the page object over to
+   * the backend storage. Used with storages keeping page objects, in which
+   * case the page is not serialized.
+   *
+   * @param page_id Page identifier
+   */
+  void Release(PageId page_id) {
+    LockGuard guard(lock);
+
+    auto it = buffer.find(page_id);
+    if (it != buffer.end()) {
+      std::unique_ptr<PageType> page = std::move(it->second.page);
+      buffer.erase(it);
+      // Replacer can stop tracking the page
+      replacer.Forget(page_id);
+      // Buffer manager no longer observes the page once handed over
+      page->UnregisterObserver(this);
+      storage.Adopt(std::move(page));
+    }
+  }
+
+  /**
+   * Remove the victum page from buffer if the buffer is full. The victum page
+   * is written to storage if modified. If the storage keeps page objects then
+   * the victum page object is handed over to the storage instead.
+   *
+   * @returns Pointer to the page object of the removed victum page to be
+   * re-used, or `nullptr` if no page was removed.
+   */
+  std::unique_ptr<PageType> Evict() {
+    LockGuard guard(lock);
+
+    std::unique_ptr<PageType> page;
+    if (max_size != 0 && buffer.size() >= max_size) {
       // Get victum page ID from replacer
       PageId victum_page_id = replacer.GetVictumId();
+      if (storage.IsObjectStore()) {
+        Release(victum_page_id);
+        return page;
+      }
       // Write victum page to storage if modified
       Flush(victum_page_id);
-      // Remove page from buffer
-      buffer.erase(victum_page_id);
-      // Replacer can stop tracking the victum page
-      replacer.Forget(victum_page_id);
+      // Remove page from buffer while holding on to the page object
+      auto it = buffer.find(victum_page_id);
+      if (it != buffer.end()) {
+        page = std::move(it->second.page);
+        buffer.erase(it);
+        // Replacer can stop tracking the victum page
+        replacer.Forget(victum_page_id);
+      }
     }
+    return page;
+  }
+
+  /**
+   * Add page to buffer. The page must already have the buffer manager
+   * registered as its observer.
+   *
+   * @param page pointer reference to page
+   */
+  void Put(std::unique_ptr<PageType> &page) {
+    LockGuard guard(lock);
+
+    // If buffer is full then remove the victum page
+    Evict();
 
     PageId page_id = page->GetId();
     // Upsert page to buffer
     buffer[page_id].page = std::move(page);
-    // Register buffer manager as observer to inserted page
-    buffer[page_id].page->RegisterObserver(this);
+    buffer[page_id].modified = false;
+    buffer[page_id].unwritten = false;
     // Replacer starts tracking page for victum page discovery
     replacer.Track(page_id);
   }
@@ -122,9 +212,9 @@ public:
    * @param replacer_type Type of page replacer to be used by buffer manager.
    *
    */
-  BufferManager(Storage<PageType> &storage,
-                size_t max_size = DEFAULT_BUFFER_SIZE)
-      : storage(storage), max_size(max_size), started(false) {
+  BufferManager(StorageType &storage, size_t max_size = DEFAULT_BUFFER_SIZE)
+      : storage(storage), max_size(max_size), started(false),
+        block(storage.GetPageSize()) {
     // Check buffer size value
     if (max_size != 0 && max_size < MINIMUM_BUFFER_SIZE) {
       throw BufferManagerError("Invalid value for max buffer size. The max "
@@ -144,6 +234,8 @@ public:
     if (!started) {
       // Start backend storage
       storage.Open();
+      // Size page block to the page size used by the opened storage
+      block.resize(storage.GetPageSize());
       // Set state to started
       started = true;
     }
@@ -153,7 +245,8 @@ public:
    * @brief Stop buffer manager.
    *
    * All the modified pages loaded onto the buffer are flushed to backend
-   * storage before stopping the manager.
+   * storage before stopping the manager. If the storage keeps page objects
+   * then all unpinned pages are handed over to the storage instead.
    *
    * @thread_safe
    *
@@ -162,8 +255,21 @@ public:
     LockGuard guard(lock);
 
     if (started) {
-      // Flush all loaded pages
-      FlushAll();
+      if (storage.IsObjectStore()) {
+        // Hand over all unpinned pages
+        std::vector<PageId> page_ids;
+        for (const auto &element : buffer) {
+          if (!replacer.IsPinned(element.first)) {
+            page_ids.push_back(element.first);
+          }
+        }
+        for (PageId page_id : page_ids) {
+          Release(page_id);
+        }
+      } else {
+        // Flush all loaded pages
+        FlushAll();
+      }
       // Close backend storage
       storage.Close();
       // Set state to stopped
@@ -176,25 +282,73 @@ public:
    * is not already found in the buffer. In case the page is not found in the
    * backend storage a PageNotFoundError exception is raised.
    *
+   * On a miss the page block is read directly into memory owned by the buffer
+   * manager and loaded in place into the page object of the victum page, if
+   * any, avoiding allocation of an intermediate buffer and a new page. If the
+   * storage keeps page objects then the page object is taken over from the
+   * storage without serialization.
+   *
    * @thread_safe
    *
    * @param page_id Page identifier.
    * @returns Page handle object
    */
-  PageHandle<PageType> Get(PageId page_id) override {
+  PageHandle<PageType> Get(PageId page_id) override { return Fetch(page_id); }
+
+  /**
+   * Get page with given ID as done by `Get`, returning a page handle which
+   * pins and unpins the page directly through the concrete replacer type.
+   *
+   * @thread_safe
+   *
+   * @param page_id Page identifier.
+   * @returns Page handle object of the replacer type
+   */
+  PageHandle<PageType, ReplacerType> Fetch(PageId page_id) {
     LockGuard guard(lock);
 
+    // Return loaded page without further lookups
+    auto it = buffer.find(page_id);
+    if (it != buffer.end()) {
+      return PageHandle<PageType, ReplacerType>(it->second.page.get(),
+                                                &replacer);
+    }
+
+    // Take over the page object on a miss if storage keeps page objects
+    if (storage.IsObjectStore()) {
+      // Make room in buffer before taking over the page object
+      Evict();
+      std::unique_ptr<PageType> page = storage.Release(page_id);
+      // Register buffer manager as observer to the page
+      page->RegisterObserver(this);
+      // Insert page in buffer in accordance with LRU strategy
+      Put(page);
+    }
+
     // Check if page not present in buffer
     if (buffer.find(page_id) == buffer.end()) {
-      // Load page from storage
-      std::unique_ptr<PageType> page = storage.Read(page_id);
+      // Re-use page object of the victum page if buffer is full
+      std::unique_ptr<PageType> page = Evict();
+      // Read page block from storage
+      storage.ReadBlock(page_id, block);
+      if (page == nullptr) {
+        // Create an empty page to load into
+        page = persist::CreatePage<PageType>(0, block.size());
+        // Register buffer manager as observer to the page
+        page->RegisterObserver(this);
+      }
+      // Load page in place from the read block verifying its checksum as per
+      // the storage verification policy
+      persist::LoadPage(block, *page, storage.GetChecksumType(),
+                        GetBaseStorage().IsVerifyRequired(page_id));
+      GetBaseStorage().MarkVerified(page_id);
       // Insert page in buffer in accordance with LRU strategy
       Put(page);
     }
 
     // Create and return page handle object
     PageType *page_ptr = buffer.at(page_id).page.get();
-    return PageHandle<PageType>(page_ptr, &replacer);
+    return PageHandle<PageType, ReplacerType>(page_ptr, &replacer);
   }
 
   /**
@@ -213,13 +367,77 @@ public:
     // Create an empty page
     std::unique_ptr<PageType> page =
         persist::CreatePage<PageType>(page_id, storage.GetPageSize());
+    // Register buffer manager as observer to the page
+    page->RegisterObserver(this);
     // Load the new page in buffer
     Put(page);
+    // A new page is marked modified so that it is written on eviction, as the
+    // page ID may be re-used after deallocation and its stale block must never
+    // be loaded back
+    buffer.at(page_id).modified = true;
+    buffer.at(page_id).unwritten = true;
 
     // Return loaded page
     return Get(page_id);
   }
 
+  /**
+   * Deallocate page with given ID. The page is dropped from the buffer
+   * without being written and its space in backend storage is freed for
+   * re-use by a later new page.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifer
+   * @throws BufferManagerError if the page is pinned
+   */
+  void Deallocate(PageId page_id) override {
+    LockGuard guard(lock);
+
+    auto it = buffer.find(page_id);
+    if (it != buffer.end()) {
+      if (replacer.IsPinned(page_id)) {
+        throw BufferManagerError("Pinned page can not be deallocated.");
+      }
+      // Drop the page without writing it
+      it->second.page->UnregisterObserver(this);
+      buffer.erase(it);
+      replacer.Forget(page_id);
+    }
+    storage.Deallocate(page_id);
+  }
+
+  /**
+   * Deallocate page with given ID if it satisfies the given predicate. The
+   * predicate is invoked while holding the buffer manager lock on the page
+   * which is not pinned, so no page handle can modify the page until it is
+   * deallocated. A page pinned by a page handle is skipped, and so is a page
+   * already deallocated.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifer
+   * @param predicate callable invoked with the unpinned page, returning
+   * `true` if the page is to be deallocated
+   * @returns `true` if page is deallocated else `false`
+   */
+  bool DeallocateIf(PageId page_id,
+                    const std::function<bool(PageType &)> &predicate) override {
+    LockGuard guard(lock);
+
+    if (storage.IsFree(page_id)) {
+      return false;
+    }
+    // Load the page into buffer while holding the lock
+    Fetch(page_id);
+    if (replacer.IsPinned(page_id) ||
+        !predicate(*buffer.at(page_id).page)) {
+      return false;
+    }
+    Deallocate(page_id);
+    return true;
+  }
+
   /**
    * Dump a single page to backend storage. The page will be stored only
    * if it is marked as modified and is unpinned.
@@ -238,10 +456,15 @@ public:
     // Save page if found, modified, and not pinned
     if (it != buffer.end() && it->second.modified &&
         !replacer.IsPinned(page_id)) {
-      // Persist page on backend storage
-      storage.Write(*(it->second.page));
+      // Persist page on backend storage using the re-usable page block. The
+      // block is cleared so that no stale data is written to storage.
+      std::fill(block.begin(), block.end(), 0);
+      persist::DumpPage(*(it->second.page), block, storage.GetChecksumType());
+      storage.WriteBlock(page_id, block);
+      GetBaseStorage().MarkVerified(page_id);
       // Since the page has been saved it is now considered as un-modified
       it->second.modified = false;
+      it->second.unwritten = false;
       // Page successfully flushed
       return true;
     }
@@ -263,6 +486,56 @@ public:
     }
   }
 
+  /**
+   * @brief Verify the checksum of the stored block of page with given ID. The
+   * block is read from backend storage even if the page is loaded in buffer.
+   * De-allocated pages, pages not found in storage and new pages not yet
+   * written to storage are skipped. The block is read into a separate buffer
+   * without holding the buffer manager lock, so that page loads are not
+   * blocked by the scrubbing.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifer
+   * @returns `false` if the stored page is corrupt else `true`
+   */
+  bool Scrub(PageId page_id) {
+    StorageType *scrub_storage;
+    {
+      LockGuard guard(lock);
+
+      if (IsUnwritten(page_id)) {
+        return true;
+      }
+      scrub_storage = &storage;
+    }
+    // Storages guard their blocks so they can be read without the lock
+    ByteBuffer scrub_block(scrub_storage->GetPageSize());
+    try {
+      scrub_storage->ReadBlock(page_id, scrub_block);
+    } catch (PageNotFoundError &err) {
+      return true;
+    }
+    if (persist::VerifyPage(scrub_block, scrub_storage->GetChecksumType())) {
+      return true;
+    }
+    // The page may have been de-allocated while reading its block
+    return IsUnwritten(page_id);
+  }
+
+  /**
+   * @brief Get number of pages in backend storage.
+   *
+   * @thread_safe
+   *
+   * @returns Number of pages in storage
+   */
+  size_t GetPageCount() {
+    LockGuard guard(lock);
+
+    return storage.GetPageCount();
+  }
+
   /**
    * @brief The method handles modified pages by marking the corresponding frame
    * as modified.
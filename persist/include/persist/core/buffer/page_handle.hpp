@@ -43,11 +43,22 @@ namespace persist {
  * unpinning and access control operations on construction and destruction.
  * The page can be accessed using the standard -> operator.
  *
+ * The page is pinned and unpinned through the replacer type of the handle. A
+ * handle of a concrete replacer type calls the replacer directly, while a
+ * handle of the base replacer type dispatches through the virtual interface.
+ * A handle can be moved into a handle of a base replacer type.
+ *
  * @tparam PageType type of page handled by the class
+ * @tparam ReplacerType type of replacer used to pin the page
  */
-template <class PageType> class PageHandle {
+template <class PageType, class ReplacerType = Replacer> class PageHandle {
   static_assert(std::is_base_of<Page, PageType>::value,
                 "PageType must be derived from Page class.");
+  static_assert(std::is_base_of<Replacer, ReplacerType>::value,
+                "ReplacerType must be derived from persist::Replacer class.");
+
+  // Handles of other replacer types can be moved from
+  template <class, class> friend class PageHandle;
 
   PERSIST_PRIVATE
 
@@ -61,7 +72,7 @@ template <class PageType> class PageHandle {
    * @brief Pointer to page replacer
    *
    */
-  Replacer *replacer;
+  ReplacerType *replacer;
 
   /**
    * @brief Flag to indicate handle has ownership
@@ -104,7 +115,7 @@ public:
    * @brief Construct a new Page Handle object
    *
    */
-  PageHandle(PageType *page, Replacer *replacer)
+  PageHandle(PageType *page, ReplacerType *replacer)
       : page(page), replacer(replacer), is_owner(true) {
     // Acquire access ownership of page
     Acquire();
@@ -119,6 +130,16 @@ public:
     other.Unset();
   }
 
+  /**
+   * @brief Move constructor from page handle of a derived replacer type
+   */
+  template <class OtherReplacerType>
+  PageHandle(PageHandle<PageType, OtherReplacerType> &&other)
+      : page(other.page), replacer(other.replacer), is_owner(other.is_owner) {
+    // Unset ownership of the moved object
+    other.Unset();
+  }
+
   /**
    * @brief Move assignment operator. This will relese access ownership of the
    * currently owned page.
@@ -0,0 +1,130 @@
+/**
+ * pinned_view.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PERSIST_CORE_BUFFER_PINNED_VIEW_HPP
+#define PERSIST_CORE_BUFFER_PINNED_VIEW_HPP
+
+#include <utility>
+
+#include <persist/core/buffer/page_handle.hpp>
+#include <persist/core/common.hpp>
+
+namespace persist {
+
+/**
+ * @brief Pinned View Class
+ *
+ * A pinned view is a read-only byte view into a page held together with the
+ * page handle keeping the page pinned in the buffer. The view is created from
+ * the handled page and is never handed out, so it can not outlive the pin.
+ * Pinned views can be moved but not copied, and the viewed bytes can only be
+ * accessed through a named pinned view, never through a temporary one whose
+ * pin is about to be released.
+ *
+ * NOTE: The pin only keeps the page from being evicted. It does not keep the
+ * page from being modified. Updating or removing the viewed data, or
+ * compacting the page, moves or overwrites the viewed bytes, so the view then
+ * points at other data. A view must not be held across modifications of its
+ * page; copy the bytes with `ToBuffer` to keep them.
+ *
+ * @tparam PageType type of page viewed into
+ */
+template <class PageType> class PinnedView {
+  PERSIST_PRIVATE
+  /**
+   * @brief Handle of the viewed page
+   */
+  PageHandle<PageType> page;
+
+  /**
+   * @brief View into the page
+   */
+  ByteView view;
+
+public:
+  /**
+   * @brief Construct a new Pinned View object
+   *
+   * @param page handle of the page to view into
+   * @param get_view callable returning the view given a constant reference to
+   * the handled page
+   */
+  template <class F>
+  PinnedView(PageHandle<PageType> page, F get_view)
+      : page(std::move(page)), view(get_view(*this->page.operator->())) {}
+
+  /**
+   * @brief Move constructor for pinned view
+   */
+  PinnedView(PinnedView &&other)
+      : page(std::move(other.page)), view(other.view) {
+    // Unset view of the moved object
+    other.view = ByteView();
+  }
+
+  /**
+   * @brief Move assignment operator. This will release the pin of the
+   * currently viewed page.
+   */
+  PinnedView &operator=(PinnedView &&other) {
+    // Check for moving same object
+    if (this != &other) {
+      page = std::move(other.page);
+      view = other.view;
+
+      // Unset view of the moved object
+      other.view = ByteView();
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Get the viewed bytes. The bytes are only accessible through a named
+   * pinned view, as they are valid only as long as the view holds the pin.
+   */
+  const Byte *data() const & { return view.start; }
+  const Byte *data() const && = delete;
+
+  /**
+   * @brief Get the number of viewed bytes.
+   */
+  size_t size() const { return view.size; }
+
+  /**
+   * @brief Iterators over the viewed bytes.
+   */
+  const Byte *begin() const & { return view.begin(); }
+  const Byte *end() const & { return view.end(); }
+  const Byte *begin() const && = delete;
+  const Byte *end() const && = delete;
+
+  /**
+   * @brief Copy the viewed bytes into an owned byte buffer.
+   */
+  ByteBuffer ToBuffer() const { return view.ToBuffer(); }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_BUFFER_PINNED_VIEW_HPP */
@@ -38,7 +38,7 @@ namespace persist {
  *
  * This replacer detects victum page ID using the LRU replacement algorithm.
  */
-class LRUReplacer : public Replacer {
+class LRUReplacer final : public Replacer {
   PERSIST_PRIVATE
   // TODO: Need granular locking
   typedef typename persist::Mutex<std::recursive_mutex> Mutex;
@@ -128,9 +128,10 @@ public:
     LockGuard guard(lock);
 
     // Increase reference count for page ID
-    position.at(page_id)->pin_count += 1;
+    Position frame = position.at(page_id);
+    frame->pin_count += 1;
     // Move the frame for given page ID to front in accordance with LRU strategy
-    cache.splice(cache.begin(), cache, position.at(page_id));
+    cache.splice(cache.begin(), cache, frame);
   }
 
   bool IsPinned(PageId page_id) override {
@@ -0,0 +1,223 @@
+/**
+ * scrubber.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef PERSIST_CORE_BUFFER_SCRUBBER_HPP
+#define PERSIST_CORE_BUFFER_SCRUBBER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <persist/core/buffer/buffer_manager.hpp>
+
+#include <persist/utility/mutex.hpp>
+
+// Default number of pages verified per second by the scrubber
+#define DEFAULT_SCRUB_RATE 100
+
+namespace persist {
+
+/**
+ * @brief The scrubber verifies the checksum of pages stored in the backend
+ * storage of a buffer manager in the background. Pages are visited in order of
+ * their ID, wrapping around at the end of the storage, at a limited rate so
+ * that foreground IO is not starved. Corrupt pages are recorded for the user
+ * to inspect. Running the scrubber allows page loads to skip checksum
+ * verification while corruption is still caught.
+ *
+ * @tparam PageType The type of page managed.
+ * @tparam ReplacerType The type of page replacer used by the buffer manager.
+ * @tparam StorageType The type of backend storage used by the buffer manager.
+ */
+template <class PageType, class ReplacerType = LRUReplacer,
+          class StorageType = Storage<PageType>>
+class Scrubber {
+  PERSIST_PRIVATE
+  /**
+   * @brief Lock for thread safety
+   *
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  Mutex lock; //<- lock for achieving thread safety via mutual exclusion
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+
+  typedef BufferManager<PageType, ReplacerType, StorageType> BufferManagerType;
+  BufferManagerType &buffer_manager;         //<- Buffer manager
+  size_t rate GUARDED_BY(lock);              //<- Pages verified per second
+  PageId cursor GUARDED_BY(lock);            //<- ID of next page to verify
+  size_t scrubbed GUARDED_BY(lock);          //<- Number of pages verified
+  std::set<PageId> corrupt GUARDED_BY(lock); //<- Corrupt pages found
+  std::thread scrubber;                      //<- Background scrubber thread
+  std::condition_variable_any scrubber_cv;   //<- Used to wake up the scrubber
+  bool scrubber_stop GUARDED_BY(lock);       //<- Flag to stop the scrubber
+
+  /**
+   * @brief Verify next pages in order of their ID. The caller must hold the
+   * lock.
+   *
+   * @param count Number of pages to verify
+   */
+  void Scrub(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      size_t page_count = buffer_manager.GetPageCount();
+      if (page_count == 0) {
+        return;
+      }
+      if (cursor > page_count) {
+        cursor = 1;
+      }
+      if (buffer_manager.Scrub(cursor)) {
+        corrupt.erase(cursor);
+      } else {
+        corrupt.insert(cursor);
+      }
+      ++cursor;
+      ++scrubbed;
+    }
+  }
+
+  /**
+   * @brief Run the scrubber until stopped.
+   */
+  void RunScrubber() {
+    LockGuard guard(lock);
+    while (!scrubber_stop) {
+      scrubber_cv.wait_for(lock, std::chrono::microseconds(1000000 / rate));
+      if (!scrubber_stop) {
+        Scrub(1);
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Construct a new Scrubber object
+   *
+   * @param buffer_manager Reference to buffer manager of the storage to scrub
+   * @param rate Number of pages verified per second
+   */
+  Scrubber(BufferManagerType &buffer_manager, size_t rate = DEFAULT_SCRUB_RATE)
+      : buffer_manager(buffer_manager), rate(std::max<size_t>(rate, 1)),
+        cursor(1), scrubbed(0), scrubber_stop(false) {}
+
+  /**
+   * @brief Destroy the Scrubber object. The scrubber is stopped.
+   */
+  ~Scrubber() { Stop(); }
+
+  /**
+   * @brief Start background scrubber. No operation is performed if already
+   * started.
+   *
+   * @thread_safe
+   */
+  void Start() {
+    LockGuard guard(lock);
+
+    if (!scrubber.joinable()) {
+      scrubber_stop = false;
+      scrubber = std::thread(&Scrubber::RunScrubber, this);
+    }
+  }
+
+  /**
+   * @brief Stop background scrubber.
+   *
+   * @thread_safe
+   */
+  void Stop() {
+    {
+      LockGuard guard(lock);
+      scrubber_stop = true;
+    }
+    scrubber_cv.notify_all();
+    if (scrubber.joinable()) {
+      scrubber.join();
+    }
+  }
+
+  /**
+   * @brief Verify next pages in order of their ID. The scrubbing wraps around
+   * at the end of the storage.
+   *
+   * @thread_safe
+   *
+   * @param count Number of pages to verify
+   */
+  void ScrubNext(size_t count) {
+    LockGuard guard(lock);
+    Scrub(count);
+  }
+
+  /**
+   * @brief Get the number of pages verified per second.
+   *
+   * @thread_safe
+   */
+  size_t GetRate() {
+    LockGuard guard(lock);
+    return rate;
+  }
+
+  /**
+   * @brief Set the number of pages verified per second.
+   *
+   * @thread_safe
+   *
+   * @param rate Number of pages verified per second
+   */
+  void SetRate(size_t rate) {
+    LockGuard guard(lock);
+    this->rate = std::max<size_t>(rate, 1);
+  }
+
+  /**
+   * @brief Get the number of pages verified so far.
+   *
+   * @thread_safe
+   */
+  size_t GetScrubbedCount() {
+    LockGuard guard(lock);
+    return scrubbed;
+  }
+
+  /**
+   * @brief Get the IDs of corrupt pages found. A page is removed from the set
+   * if it is found intact on a later visit.
+   *
+   * @thread_safe
+   */
+  std::set<PageId> GetCorruptPages() {
+    LockGuard guard(lock);
+    return corrupt;
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_BUFFER_SCRUBBER_HPP */
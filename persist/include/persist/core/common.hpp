@@ -25,6 +25,7 @@
 #ifndef PERSIST_CORE_COMMON_HPP
 #define PERSIST_CORE_COMMON_HPP
 
+#include <algorithm>
 #include <vector>
 
 #include <persist/core/defs.hpp>
@@ -107,6 +108,61 @@ typedef struct Span {
   }
 } Span;
 
+/**
+ * @brief A byte view contains the starting memory location and size of a
+ * read-only byte buffer it does not own. The view is valid only as long as the
+ * viewed memory, for example a pinned page image.
+ *
+ */
+struct ByteView {
+  /**
+   * @brief Starting address of the viewed bytes.
+   *
+   */
+  const Byte *start;
+
+  /**
+   * @brief Number of viewed bytes.
+   *
+   */
+  size_t size;
+
+  /**
+   * @brief Construct a new ByteView object.
+   *
+   * @param start Starting memory address of viewed bytes.
+   * @param size Number of viewed bytes.
+   * @param buffer Reference to ByteBuffer object to view.
+   */
+  ByteView() : start(nullptr), size(0) {}
+  ByteView(const Byte *start, size_t size) : start(start), size(size) {}
+  ByteView(const ByteBuffer &buffer)
+      : start(buffer.data()), size(buffer.size()) {}
+
+  /**
+   * @brief Iterators over the viewed bytes.
+   */
+  const Byte *begin() const { return start; }
+  const Byte *end() const { return start + size; }
+
+  /**
+   * @brief Copy the viewed bytes into an owned byte buffer.
+   */
+  ByteBuffer ToBuffer() const { return ByteBuffer(begin(), end()); }
+
+  /**
+   * @brief Equality comparision operator comparing the viewed bytes.
+   */
+  bool operator==(const ByteView &other) const {
+    return size == other.size && std::equal(begin(), end(), other.begin());
+  }
+
+  /**
+   * @brief Non-equality comparision operator.
+   */
+  bool operator!=(const ByteView &other) const { return !(*this == other); }
+};
+
 /**
  * @brief ByteBuffer literal `_bb`
  */
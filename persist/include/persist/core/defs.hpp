@@ -64,12 +64,34 @@
 // Default buffer size. This is the maximum number of pages the buffer can
 // load in-memory.
 #define DEFAULT_BUFFER_SIZE 1024
+// Default segment size in bytes used by segmented storage. Set to 1 GiB.
+#define DEFAULT_SEGMENT_SIZE 1073741824
+// Default segment size in bytes used by log-structured storage. Set to 64 MiB.
+#define DEFAULT_LOG_SEGMENT_SIZE 67108864
+// Default number of page loads per checksum verification when sampling.
+#define DEFAULT_VERIFY_SAMPLE_INTERVAL 16
+// Default size in bytes beyond which objects are stored in overflow pages.
+#define DEFAULT_LARGE_OBJECT_THRESHOLD 256
 
 // Default log page size in bytes
 #define DEFAULT_LOG_PAGE_SIZE 1024
 // Default log buffer size. This is the default maximum number of log pages the
 // log buffer can load in-memory.
 #define DEFAULT_LOG_BUFFER_SIZE 8
+// Default capacity in bytes of the in-memory log buffer. Set to 1 MiB.
+#define DEFAULT_LOG_BUFFER_CAPACITY 1048576
+// Default interval in milliseconds between log syncs with interval sync policy
+#define DEFAULT_LOG_SYNC_INTERVAL 10
+// Default segment size in bytes of the sequential log. Set to 16 MiB.
+#define DEFAULT_LOG_FILE_SEGMENT_SIZE 16777216
+// Default size in bytes of the tail buffer of the sequential log. Set to 1 MiB.
+#define DEFAULT_LOG_TAIL_SIZE 1048576
+// Default size in bytes beyond which log records are compressed when log
+// compression is enabled.
+#define DEFAULT_LOG_COMPRESSION_THRESHOLD 128
+// Version of the log format stored in log pages and sequential log headers.
+// Logs of another format version are refused when loaded.
+#define LOG_FORMAT_VERSION 1
 // Default FSL buffer size. This is the default maximum number of FSL pages the
 // FSLManager can load in-memory.
 #define DEFAULT_FSL_BUFFER_SIZE 8
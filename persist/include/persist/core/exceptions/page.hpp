@@ -105,6 +105,24 @@ public:
   const char *what() const throw() { return msg.c_str(); }
 };
 
+/**
+ * Page Full Error
+ *
+ * This error is thrown when a page does not have enough free space to store
+ * a page slot.
+ */
+class PageFullError : public PersistException {
+private:
+  std::string msg;
+
+public:
+  PageFullError(PageId page_id)
+      : msg(std::string("Not enough free space in page with ID '") +
+            std::to_string(page_id) + std::string("'.")) {}
+
+  const char *what() const throw() { return msg.c_str(); }
+};
+
 } // namespace persist
 
 #endif /* PERSIST_CORE_EXCEPTIONS_PAGE_HPP */
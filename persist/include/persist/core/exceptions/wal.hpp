@@ -53,6 +53,40 @@ public:
   const char *what() const throw() { return msg.c_str(); }
 };
 
+/**
+ * Log Buffer Error
+ *
+ * This error is thrown if a log record can not be stored in the log buffer.
+ */
+class LogBufferError : public PersistException {
+private:
+  std::string msg;
+
+public:
+  LogBufferError() : msg("Log buffer error.") {}
+  LogBufferError(const char *msg) : msg(msg) {}
+  LogBufferError(std::string &msg) : msg(msg) {}
+
+  const char *what() const throw() { return msg.c_str(); }
+};
+
+/**
+ * Log Record Undo Error
+ *
+ * This error is thrown if the operation of a log record can not be undone.
+ */
+class LogRecordUndoError : public PersistException {
+private:
+  std::string msg;
+
+public:
+  LogRecordUndoError() : msg("Log record undo error.") {}
+  LogRecordUndoError(const char *msg) : msg(msg) {}
+  LogRecordUndoError(std::string &msg) : msg(msg) {}
+
+  const char *what() const throw() { return msg.c_str(); }
+};
+
 } // namespace persist
 
 #endif /* PERSIST_CORE_EXCEPTIONS_WAL_HPP */
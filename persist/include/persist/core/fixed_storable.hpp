@@ -0,0 +1,191 @@
+/**
+ * fixed_storable.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Fixed Storable
+ *
+ * The header file exposes a declarative mechanism for storable objects made
+ * of a fixed list of fields. The fields are listed once and the storage size,
+ * load and dump methods are generated from the list. The storage size is a
+ * compile time constant.
+ */
+
+#ifndef PERSIST_CORE_FIXED_STORABLE_HPP
+#define PERSIST_CORE_FIXED_STORABLE_HPP
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <persist/core/common.hpp>
+
+#include <persist/utility/serializer.hpp>
+
+namespace persist {
+
+/**
+ * @brief Field stored as a different type than its declared type. This is
+ * used to store enumerations as fixed width integers.
+ *
+ * @tparam S stored type of the field
+ * @tparam T declared type of the field
+ */
+template <class S, class T> struct StoredAs { T &value; };
+
+/**
+ * @brief Get a field to be stored as given type.
+ *
+ * @tparam S stored type of the field
+ * @param value reference to the field
+ */
+template <class S, class T> inline StoredAs<S, T> stored_as(T &value) {
+  return {value};
+}
+
+// Internal method to copy content from memory location specified by span object
+// to a field stored as a different type.
+template <class S, class T>
+inline void _copy(Span &input, StoredAs<S, T> &data) {
+  S value;
+  _copy(input, value);
+  data.value = static_cast<T>(value);
+}
+
+// Internal method to copy content from a field stored as a different type to
+// memory location specified by span object
+template <class S, class T>
+inline void _copy(const StoredAs<S, T> &data, Span &output) {
+  _copy(static_cast<S>(data.value), output);
+}
+
+/**
+ * @brief Storage size of a field type as a compile time constant.
+ */
+template <class T> struct StorageSize {
+  static constexpr size_t value = sizeof(T);
+};
+
+template <class S, class T> struct StorageSize<StoredAs<S, T>> {
+  static constexpr size_t value = sizeof(S);
+};
+
+template <> struct StorageSize<std::tuple<>> {
+  static constexpr size_t value = 0;
+};
+
+template <class T, class... Args> struct StorageSize<std::tuple<T, Args...>> {
+  static constexpr size_t value = StorageSize<std::decay_t<T>>::value +
+                                  StorageSize<std::tuple<Args...>>::value;
+};
+
+/**
+ * @brief Fixed Storable Base Class
+ *
+ * Base class of storable objects made of a fixed list of fields. The derived
+ * class lists its fields in order of storage with a `GetFields` method
+ * returning a tuple of references to the fields, for example
+ * `std::tie(page_id, page_size)`. Fields stored as a different type are given
+ * with `stored_as` in a tuple made with `std::make_tuple` and `std::ref`.
+ * Fields are stored using the serializer.
+ *
+ * @tparam T type of the derived class
+ * @tparam ErrorType type of error thrown if the buffer is too small
+ */
+template <class T, class ErrorType> class FixedStorable : public Storable {
+  PERSIST_PRIVATE
+  /**
+   * @brief Get the index sequence of the fields in the tuple.
+   */
+  template <class Fields> static auto GetIndices(const Fields &) {
+    return std::make_index_sequence<std::tuple_size<Fields>::value>();
+  }
+
+  /**
+   * @brief Load each field in the tuple from byte string.
+   */
+  template <class Fields, size_t... I>
+  static void LoadFields(Span input, Fields fields,
+                         std::index_sequence<I...>) {
+    using expand = int[];
+    (void)expand{0, (_copy(input, std::get<I>(fields)), 0)...};
+  }
+
+  /**
+   * @brief Dump each field in the tuple as byte string.
+   */
+  template <class Fields, size_t... I>
+  static void DumpFields(Span output, Fields fields,
+                         std::index_sequence<I...>) {
+    using expand = int[];
+    (void)expand{0, (_copy(std::get<I>(fields), output), 0)...};
+  }
+
+public:
+  /**
+   * @brief Get the storage size of the fields.
+   *
+   * @returns storage size in bytes known at compile time
+   */
+  static constexpr size_t GetFixedStorageSize() {
+    return StorageSize<decltype(std::declval<T &>().GetFields())>::value;
+  }
+
+  /**
+   * @brief Get the storage size of the storable object.
+   *
+   * @returns storage size in bytes.
+   */
+  size_t GetStorageSize() const override { return GetFixedStorageSize(); }
+
+  /**
+   * Load fields from byte string.
+   *
+   * @param input input buffer span to load
+   */
+  void Load(Span input) override {
+    if (input.size < GetFixedStorageSize()) {
+      throw ErrorType();
+    }
+    auto fields = static_cast<T &>(*this).GetFields();
+    LoadFields(input, fields, GetIndices(fields));
+  }
+
+  /**
+   * Dump fields as byte string.
+   *
+   * @param output output buffer span to dump
+   */
+  void Dump(Span output) override {
+    if (output.size < GetFixedStorageSize()) {
+      throw ErrorType();
+    }
+    auto fields = static_cast<T &>(*this).GetFields();
+    DumpFields(output, fields, GetIndices(fields));
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_FIXED_STORABLE_HPP */
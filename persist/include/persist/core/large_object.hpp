@@ -0,0 +1,384 @@
+/**
+ * large_object.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Large Object Storage
+ *
+ * The header file exposes streaming access to objects too large to be held in
+ * a single page slot. Such objects are split into chunks and each chunk is
+ * stored in a page slot of its own overflow page. The chunks are linked as a
+ * doubly-linked list of page slots using the next and previous locations in
+ * the slot headers.
+ */
+
+#ifndef PERSIST_CORE_LARGE_OBJECT_HPP
+#define PERSIST_CORE_LARGE_OBJECT_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include <persist/core/buffer/base.hpp>
+#include <persist/core/page/record_page/page.hpp>
+#include <persist/core/transaction/transaction.hpp>
+
+namespace persist {
+
+/**
+ * @brief Large Object Manager
+ *
+ * The large object manager stores objects larger than a threshold in chains
+ * of overflow pages. Objects are written and read in chunks using a streaming
+ * writer and reader so that they are never held in memory in full. Updates
+ * to a range of an object rewrite only the chunks overlapping the range, and
+ * thus log records of an update carry only the changed chunks.
+ */
+class LargeObjectManager {
+  PERSIST_PRIVATE
+  /**
+   * @brief Get maximum storage size of the page slot header and data size
+   * stored with a chunk of at most the given size. The header is sized for
+   * links to the largest page and slot IDs.
+   *
+   * @param size maximum chunk size in bytes
+   * @returns storage overhead of the chunk in bytes
+   */
+  static size_t GetChunkOverhead(size_t size) {
+    RecordPageSlot::Location max_location(
+        std::numeric_limits<PageId>::max(),
+        std::numeric_limits<PageSlotId>::max());
+    RecordPageSlot::Header header;
+    header.next_location = max_location;
+    header.prev_location = max_location;
+    return header.GetStorageSize() + persist::varint_size(size);
+  }
+
+  /**
+   * @brief Reference to record page buffer manager.
+   */
+  BufferManagerBase<RecordPage> &buffer_manager;
+
+  /**
+   * @brief Size in bytes beyond which objects are stored as large objects.
+   */
+  size_t threshold;
+
+public:
+  /**
+   * @brief Large Object Writer
+   *
+   * The writer appends data to a new large object. Data is buffered until a
+   * chunk is full, at which point the chunk is stored in its overflow page and
+   * the next overflow page is allocated. The writer must be closed to store
+   * the last chunk and get the location of the object. A writer destroyed
+   * without being closed drops its last chunk and frees its empty overflow
+   * page on commit; chunks already stored are left to be undone by aborting
+   * the transaction.
+   */
+  class Writer {
+    PERSIST_PRIVATE
+    /**
+     * @brief Reference to record page buffer manager.
+     */
+    BufferManagerBase<RecordPage> &buffer_manager;
+
+    /**
+     * @brief Reference to active transaction.
+     */
+    Transaction &txn;
+
+    /**
+     * @brief Overflow page of the chunk being written.
+     */
+    PageHandle<RecordPage> page;
+
+    /**
+     * @brief Chunk being written along with the maximum chunk size.
+     */
+    RecordPageSlot chunk;
+    size_t chunk_size;
+
+    /**
+     * @brief Location of the first chunk.
+     */
+    RecordPageSlot::Location location;
+
+    /**
+     * @brief Flag indicating the writer is closed.
+     */
+    bool closed;
+
+    /**
+     * @brief Store the chunk in the current overflow page and continue with
+     * a new chunk linked back to it.
+     */
+    void Store() {
+      PageSlotId slot_id = page->InsertPageSlot(chunk, txn).first;
+      RecordPageSlot::Location prev_location(page->GetId(), slot_id);
+      if (location.IsNull()) {
+        location = prev_location;
+      }
+      chunk = RecordPageSlot();
+      chunk.SetPrevLocation(prev_location);
+      chunk.data.reserve(chunk_size);
+    }
+
+  public:
+    /**
+     * @brief Construct a new Writer object
+     *
+     * @param buffer_manager reference to record page buffer manager
+     * @param txn reference to active transaction
+     */
+    Writer(BufferManagerBase<RecordPage> &buffer_manager, Transaction &txn)
+        : buffer_manager(buffer_manager), txn(txn),
+          page(buffer_manager.GetNew()), closed(false) {
+      size_t free_size = page->GetFreeSpaceSize(Operation::INSERT);
+      chunk_size = free_size - GetChunkOverhead(free_size);
+      chunk.data.reserve(chunk_size);
+    }
+
+    /**
+     * @brief Move constructor. The moved writer is left closed.
+     */
+    Writer(Writer &&other)
+        : buffer_manager(other.buffer_manager), txn(other.txn),
+          page(std::move(other.page)), chunk(std::move(other.chunk)),
+          chunk_size(other.chunk_size), location(other.location),
+          closed(other.closed) {
+      other.closed = true;
+    }
+
+    /**
+     * @brief Destroy the Writer object. The last chunk of a writer not closed
+     * is dropped and its overflow page, which holds no chunk, is freed.
+     */
+    ~Writer() {
+      if (!closed) {
+        try {
+          txn.FreePage(page->GetId());
+        } catch (...) {
+          // Destructor must not throw; the page is left empty at worst
+        }
+      }
+    }
+
+    /**
+     * @brief Append data to the large object.
+     *
+     * @param input input buffer span to append
+     */
+    void Write(Span input) {
+      while (input.size > 0) {
+        if (chunk.data.size() == chunk_size) {
+          // Link the full chunk to the slot its successor takes in a new
+          // overflow page
+          PageHandle<RecordPage> next_page = buffer_manager.GetNew();
+          RecordPageSlot::Location next_location(next_page->GetId(),
+                                                 next_page->GetNextSlotId());
+          chunk.SetNextLocation(next_location);
+          Store();
+          page = std::move(next_page);
+        }
+        size_t size = std::min(input.size, chunk_size - chunk.data.size());
+        chunk.data.insert(chunk.data.end(), input.start, input.start + size);
+        input += size;
+      }
+    }
+
+    /**
+     * @brief Store the last chunk and close the writer.
+     *
+     * @returns location of the first chunk of the large object
+     */
+    RecordPageSlot::Location Close() {
+      if (!closed) {
+        Store();
+        closed = true;
+      }
+      return location;
+    }
+  };
+
+  /**
+   * @brief Large Object Reader
+   *
+   * The reader reads a large object from the start chunk by chunk.
+   */
+  class Reader {
+    PERSIST_PRIVATE
+    /**
+     * @brief Reference to record page buffer manager.
+     */
+    BufferManagerBase<RecordPage> &buffer_manager;
+
+    /**
+     * @brief Reference to active transaction.
+     */
+    Transaction &txn;
+
+    /**
+     * @brief Location of the chunk being read and the offset of the next byte
+     * to read in the chunk.
+     */
+    RecordPageSlot::Location location;
+    size_t offset;
+
+  public:
+    /**
+     * @brief Construct a new Reader object
+     *
+     * @param buffer_manager reference to record page buffer manager
+     * @param location location of the first chunk of the large object
+     * @param txn reference to active transaction
+     */
+    Reader(BufferManagerBase<RecordPage> &buffer_manager,
+           RecordPageSlot::Location location, Transaction &txn)
+        : buffer_manager(buffer_manager), txn(txn), location(location),
+          offset(0) {}
+
+    /**
+     * @brief Read the next bytes of the large object.
+     *
+     * @param output output buffer span to read into
+     * @returns number of bytes read, which is `0` at the end of the object
+     */
+    size_t Read(Span output) {
+      size_t read = 0;
+      while (output.size > 0 && !location.IsNull()) {
+        // Copy chunk data straight from the page image
+        RecordPageSlot::Header header;
+        auto chunk = RecordPage::GetPageSlotView(
+            buffer_manager.Get(location.page_id), location.slot_id, header,
+            txn);
+        size_t size = std::min(output.size, chunk.size() - offset);
+        std::memcpy(output.start, chunk.data() + offset, size);
+        output += size;
+        offset += size;
+        read += size;
+        // Move to the next chunk
+        if (offset == chunk.size()) {
+          location = header.next_location;
+          offset = 0;
+        }
+      }
+      return read;
+    }
+  };
+
+  /**
+   * @brief Construct a new Large Object Manager object
+   *
+   * @param buffer_manager reference to record page buffer manager
+   * @param threshold size in bytes beyond which objects are stored as large
+   * objects
+   */
+  LargeObjectManager(BufferManagerBase<RecordPage> &buffer_manager,
+                     size_t threshold = DEFAULT_LARGE_OBJECT_THRESHOLD)
+      : buffer_manager(buffer_manager), threshold(threshold) {}
+
+  /**
+   * @brief Check if an object of given size is to be stored as a large
+   * object.
+   *
+   * @param size object size in bytes
+   * @returns `true` if the object is large else `false`
+   */
+  bool IsLarge(size_t size) const { return size > threshold; }
+
+  /**
+   * @brief Get a writer for a new large object.
+   *
+   * @param txn reference to active transaction
+   * @returns large object writer
+   */
+  Writer GetWriter(Transaction &txn) { return Writer(buffer_manager, txn); }
+
+  /**
+   * @brief Get a reader for the large object at given location.
+   *
+   * @param location location of the first chunk of the large object
+   * @param txn reference to active transaction
+   * @returns large object reader
+   */
+  Reader GetReader(RecordPageSlot::Location location, Transaction &txn) {
+    return Reader(buffer_manager, location, txn);
+  }
+
+  /**
+   * @brief Overwrite a range of the large object at given location. Only the
+   * chunks overlapping the range are updated, so only these are logged. The
+   * range must lie within the object.
+   *
+   * @param location location of the first chunk of the large object
+   * @param offset offset in bytes of the range in the object
+   * @param input input buffer span of data to write
+   * @param txn reference to active transaction
+   */
+  void Update(RecordPageSlot::Location location, size_t offset, Span input,
+              Transaction &txn) {
+    while (input.size > 0 && !location.IsNull()) {
+      auto page = buffer_manager.Get(location.page_id);
+      const RecordPageSlot &chunk = page->GetPageSlot(location.slot_id, txn);
+      RecordPageSlot::Location next_location = chunk.GetNextLocation();
+      if (offset < chunk.data.size()) {
+        // Rewrite the overlapping part of the chunk
+        RecordPageSlot updated = chunk;
+        size_t size = std::min(input.size, chunk.data.size() - offset);
+        std::memcpy(updated.data.data() + offset, input.start, size);
+        page->UpdatePageSlot(location.slot_id, updated, txn);
+        input += size;
+        offset = 0;
+      } else {
+        offset -= chunk.data.size();
+      }
+      location = next_location;
+    }
+  }
+
+  /**
+   * @brief Remove the large object at given location. Overflow pages left
+   * empty are deallocated once the transaction commits.
+   *
+   * @param location location of the first chunk of the large object
+   * @param txn reference to active transaction
+   */
+  void Remove(RecordPageSlot::Location location, Transaction &txn) {
+    while (!location.IsNull()) {
+      auto page = buffer_manager.Get(location.page_id);
+      RecordPageSlot::Location next_location =
+          page->GetPageSlot(location.slot_id, txn).GetNextLocation();
+      page->RemovePageSlot(location.slot_id, txn);
+      // Removed slots are released on commit, so whether the page is left
+      // empty is only known then.
+      txn.FreePage(page->GetId());
+      location = next_location;
+    }
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_LARGE_OBJECT_HPP */
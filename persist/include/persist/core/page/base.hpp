@@ -91,6 +91,15 @@ public:
     observers.insert(observers.end(), observer);
   }
 
+  /**
+   * @brief Unregister page modification observer
+   *
+   * @param observer pointer to page modication observer
+   */
+  void UnregisterObserver(PageObserver *observer) {
+    observers.remove(observer);
+  }
+
   /**
    * Get page identifier.
    *
@@ -0,0 +1,551 @@
+/**
+ * fixed_record_page/page.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PERSIST_CORE_PAGE_FIXEDRECORDPAGE_PAGE_HPP
+#define PERSIST_CORE_PAGE_FIXEDRECORDPAGE_PAGE_HPP
+
+#include <cstring>
+
+#include <persist/core/exceptions/page.hpp>
+#include <persist/core/page/base.hpp>
+#include <persist/core/page/record_page/slot.hpp>
+#include <persist/core/transaction/transaction.hpp>
+
+namespace persist {
+
+/**
+ * @brief Fixed Record Page
+ *
+ * The page stores records of a fixed size given at compile time. Records are
+ * stored in an array of slots following the page header and a slot is
+ * addressed by its index in the array, so no slot directory or record size is
+ * stored. The page header comprises of the page identifier, the next and
+ * previous page identifiers in case the page is linked, and an occupancy
+ * bitmap with one bit per slot. Free slots are found by scanning the bitmap a
+ * word at a time.
+ *
+ * Like the record page, the page is kept in memory as its byte image so that
+ * loading and dumping the page are plain copies.
+ *
+ * Every slot in a page has a SlotId starting from 1. The (PageId, SlotId)
+ * tuple is used as the location of records in log records so that
+ * operations on the page are logged as part of transactions the way they are
+ * for record pages. The logged page slots carry the record bytes as data, and
+ * the log records are marked with the fixed record page kind so that the
+ * transaction manager undoes them on this page type.
+ *
+ * @tparam RecordSize size of stored records in bytes
+ */
+template <size_t RecordSize> class FixedRecordPage : public Page {
+  static_assert(RecordSize > 0, "RecordSize must be greater than zero.");
+
+  PERSIST_PRIVATE
+  /**
+   * @brief Type of bitmap words
+   */
+  typedef uint64_t Word;
+
+  /**
+   * @brief Number of slots tracked by a bitmap word
+   */
+  static const size_t word_bits = 8 * sizeof(Word);
+
+  /**
+   * @brief Offsets of header fields in the page image
+   */
+  static const size_t next_page_id_offset = sizeof(PageId);
+  static const size_t prev_page_id_offset = 2 * sizeof(PageId);
+  static const size_t bitmap_offset = 3 * sizeof(PageId);
+
+  /**
+   * @brief Byte image of the page
+   */
+  ByteBuffer image;
+
+  /**
+   * @brief Header fields mirrored from the page image
+   */
+  PageId page_id;
+  PageId next_page_id;
+  PageId prev_page_id;
+
+  /**
+   * @brief Number of slots in the page along with the number of bitmap words
+   * and the offset of the first slot.
+   */
+  size_t capacity;
+  size_t word_count;
+  size_t records_offset;
+
+  /**
+   * @brief Number of occupied slots
+   */
+  size_t count;
+
+  /**
+   * @brief Read value stored at given offset in the page image.
+   */
+  template <class T> T Read(size_t offset) const {
+    T value;
+    std::memcpy(&value, image.data() + offset, sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief Write value at given offset in the page image.
+   */
+  template <class T> void Write(size_t offset, const T &value) {
+    std::memcpy(image.data() + offset, &value, sizeof(T));
+  }
+
+  /**
+   * @brief Get bitmap word tracking the slot at given index.
+   */
+  Word GetWord(size_t index) const {
+    return Read<Word>(bitmap_offset + (index / word_bits) * sizeof(Word));
+  }
+
+  /**
+   * @brief Mark the slot at given index as occupied or free.
+   */
+  void SetOccupied(size_t index, bool occupied) {
+    Word word = GetWord(index);
+    Word mask = Word(1) << (index % word_bits);
+    word = occupied ? word | mask : word & ~mask;
+    Write(bitmap_offset + (index / word_bits) * sizeof(Word), word);
+  }
+
+  /**
+   * @brief Check if the slot at given index is occupied.
+   */
+  bool IsOccupiedAt(size_t index) const {
+    return (GetWord(index) >> (index % word_bits)) & 1;
+  }
+
+  /**
+   * @brief Count occupied slots by population count of bitmap words.
+   */
+  size_t CountOccupied() const {
+    size_t _count = 0;
+    for (size_t i = 0; i < word_count; ++i) {
+      Word word = Read<Word>(bitmap_offset + i * sizeof(Word));
+      _count += __builtin_popcountll(word);
+    }
+    return _count;
+  }
+
+  /**
+   * @brief Find index of the first free slot. The bitmap is scanned a word at
+   * a time and the free slot within a word is found by counting trailing set
+   * bits.
+   *
+   * @returns index of the free slot or the capacity if the page is full
+   */
+  size_t FindFree() const {
+    for (size_t i = 0; i < word_count; ++i) {
+      Word word = ~Read<Word>(bitmap_offset + i * sizeof(Word));
+      if (word != 0) {
+        size_t index = i * word_bits + __builtin_ctzll(word);
+        return index < capacity ? index : capacity;
+      }
+    }
+    return capacity;
+  }
+
+  /**
+   * @brief Get pointer to the record stored in the slot at given index.
+   */
+  Byte *GetSlot(size_t index) {
+    return image.data() + records_offset + index * RecordSize;
+  }
+  const Byte *GetSlot(size_t index) const {
+    return image.data() + records_offset + index * RecordSize;
+  }
+
+  /**
+   * @brief Get index of the occupied slot with given identifier.
+   *
+   * @throws PageSlotNotFoundError
+   */
+  size_t Find(PageSlotId slot_id) const {
+    if (slot_id == 0 || slot_id > capacity || !IsOccupiedAt(slot_id - 1)) {
+      throw PageSlotNotFoundError(page_id, slot_id);
+    }
+    return slot_id - 1;
+  }
+
+  /**
+   * @brief Wrap record bytes in a page slot for logging.
+   */
+  static RecordPageSlot ToPageSlot(const Byte *record) {
+    RecordPageSlot page_slot;
+    page_slot.data.assign(record, record + RecordSize);
+    return page_slot;
+  }
+
+  /**
+   * @brief Get record bytes carried by a logged page slot.
+   *
+   * @throws LogRecordParseError if the page slot does not carry a record
+   */
+  static const Byte *FromPageSlot(const RecordPageSlot &page_slot) {
+    if (page_slot.data.size() != RecordSize) {
+      throw LogRecordParseError("Logged record size does not match the page.");
+    }
+    return page_slot.data.data();
+  }
+
+public:
+  /**
+   * @brief Kind of page marked in log records of operations on the page.
+   */
+  static const LogRecord::PageKind page_kind =
+      LogRecord::PageKind::FIXED_RECORD;
+
+  /**
+   * @brief Construct a new FixedRecordPage object. The page holds as many
+   * slots as fit along with their occupancy bitmap.
+   *
+   * @param page_id page identifer
+   * @param page_size page storage size
+   */
+  FixedRecordPage(PageId page_id = 0, size_t page_size = DEFAULT_PAGE_SIZE)
+      : image(page_size, 0), page_id(page_id), next_page_id(0),
+        prev_page_id(0), count(0) {
+    size_t size = page_size > bitmap_offset ? page_size - bitmap_offset : 0;
+    capacity = (8 * size) / (8 * RecordSize + 1);
+    word_count = (capacity + word_bits - 1) / word_bits;
+    while (capacity > 0 && word_count * sizeof(Word) + capacity * RecordSize >
+                               size) {
+      --capacity;
+      word_count = (capacity + word_bits - 1) / word_bits;
+    }
+    records_offset = bitmap_offset + word_count * sizeof(Word);
+    Write(0, page_id);
+  }
+
+  /**
+   * @brief Get size of stored records.
+   *
+   * @returns record size in bytes
+   */
+  static constexpr size_t GetRecordSize() { return RecordSize; }
+
+  /**
+   * Get page ID.
+   *
+   * @returns page identifier
+   */
+  const PageId &GetId() const override { return page_id; }
+
+  /**
+   * Get free space in bytes available in the page. This is the space of free
+   * slots in the page.
+   *
+   * @param operation The type of page operation for which free space is
+   * requested.
+   * @returns free space available in page
+   */
+  size_t GetFreeSpaceSize(Operation) const override {
+    return (capacity - count) * RecordSize;
+  }
+
+  /**
+   * @brief Get number of slots in the page.
+   *
+   * @returns slot capacity
+   */
+  size_t GetCapacity() const { return capacity; }
+
+  /**
+   * @brief Get number of records stored in the page.
+   *
+   * @returns record count
+   */
+  size_t GetRecordCount() const { return count; }
+
+  /**
+   * Get next page ID. A value of `0` means there is no next page.
+   *
+   * @returns next page identifier
+   */
+  const PageId &GetNextPageId() const { return next_page_id; }
+
+  /**
+   * Set next page ID. A value of `0` means there is no next page.
+   *
+   * @param page_id next page ID value to set
+   */
+  void SetNextPageId(PageId page_id) {
+    next_page_id = page_id;
+    Write(next_page_id_offset, page_id);
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * Get previous page ID. A value of `0` means there is no previous page.
+   *
+   * @returns previous page identifier
+   */
+  const PageId &GetPrevPageId() const { return prev_page_id; }
+
+  /**
+   * Set previous page ID. A value of `0` means there is no previous page.
+   *
+   * @param page_id previous page ID value to set
+   */
+  void SetPrevPageId(PageId page_id) {
+    prev_page_id = page_id;
+    Write(prev_page_id_offset, page_id);
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * @brief Check if slot with given identifier holds a record.
+   *
+   * @param slot_id Slot identifier
+   * @returns `true` if the slot is occupied else `false`
+   */
+  bool IsOccupied(PageSlotId slot_id) const {
+    return slot_id > 0 && slot_id <= capacity && IsOccupiedAt(slot_id - 1);
+  }
+
+  /**
+   * Get record stored in slot of given identifier. The returned pointer
+   * refers to `RecordSize` bytes in the page image and is valid until the
+   * page is modified or loaded.
+   *
+   * @param slot_id Slot identifier
+   * @returns Pointer to the stored record
+   * @throws PageSlotNotFoundError
+   */
+  const Byte *GetRecord(PageSlotId slot_id) const {
+    return GetSlot(Find(slot_id));
+  }
+
+  /**
+   * Insert record in the first free slot of the page.
+   *
+   * @param record Pointer to `RecordSize` bytes of record to insert
+   * @param txn Reference to active transaction
+   * @returns SlotId of the inserted record
+   * @throws PageFullError
+   */
+  PageSlotId InsertRecord(const Byte *record, Transaction &txn) {
+    size_t index = FindFree();
+    if (index == capacity) {
+      throw PageFullError(page_id);
+    }
+    PageSlotId slot_id = index + 1;
+
+    // Log insert operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot page_slot = ToPageSlot(record);
+    txn.LogInsertOp(location, page_slot, page_kind);
+
+    // Insert record at slot
+    std::memcpy(GetSlot(index), record, RecordSize);
+    SetOccupied(index, true);
+    ++count;
+
+    // Notify observers of modification
+    NotifyObservers();
+
+    return slot_id;
+  }
+
+  /**
+   * Update record stored in slot of given identifier.
+   *
+   * @param slot_id Identifier of the slot to update
+   * @param record Pointer to `RecordSize` bytes of updated record
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   */
+  void UpdateRecord(PageSlotId slot_id, const Byte *record,
+                    Transaction &txn) {
+    size_t index = Find(slot_id);
+
+    // Log update operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot old_page_slot = ToPageSlot(GetSlot(index));
+    RecordPageSlot new_page_slot = ToPageSlot(record);
+    txn.LogUpdateOp(location, old_page_slot, new_page_slot, page_kind);
+
+    // Update record at slot
+    std::memcpy(GetSlot(index), record, RecordSize);
+
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * Remove record stored in slot of given identifier.
+   *
+   * @param slot_id Identifier of the slot to remove
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   */
+  void RemoveRecord(PageSlotId slot_id, Transaction &txn) {
+    size_t index = Find(slot_id);
+
+    // Log delete operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot page_slot = ToPageSlot(GetSlot(index));
+    txn.LogDeleteOp(location, page_slot, page_kind);
+
+    // Free the slot
+    std::memset(GetSlot(index), 0, RecordSize);
+    SetOccupied(index, false);
+    --count;
+
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * Undo remove record stored in slot of given identifier. In case the slot
+   * is already occupied then no operation is performed.
+   *
+   * @param slot_id Identifier of the slot to insert back
+   * @param record Pointer to `RecordSize` bytes of record to insert back
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   */
+  void UndoRemoveRecord(PageSlotId slot_id, const Byte *record,
+                        Transaction &txn) {
+    if (slot_id == 0 || slot_id > capacity) {
+      throw PageSlotNotFoundError(page_id, slot_id);
+    }
+    size_t index = slot_id - 1;
+    if (IsOccupiedAt(index)) {
+      return;
+    }
+
+    // Log insert operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot page_slot = ToPageSlot(record);
+    txn.LogInsertOp(location, page_slot, page_kind);
+
+    // Insert record back at slot
+    std::memcpy(GetSlot(index), record, RecordSize);
+    SetOccupied(index, true);
+    ++count;
+
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * @brief Undo operation of given log record performed on the page.
+   *
+   * @param log_record Reference to the log record of the operation to undo
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   * @throws LogRecordParseError if the logged record does not match the page
+   */
+  void Undo(LogRecord &log_record, Transaction &txn) {
+    PageSlotId slot_id = log_record.GetLocation().slot_id;
+    switch (log_record.GetLogType()) {
+    case LogRecord::Type::INSERT: {
+      RemoveRecord(slot_id, txn);
+      break;
+    }
+    case LogRecord::Type::DELETE: {
+      UndoRemoveRecord(slot_id, FromPageSlot(log_record.GetPageSlotA()), txn);
+      break;
+    }
+    case LogRecord::Type::UPDATE: {
+      // Undo the update delta on the current record
+      RecordPageSlot page_slot =
+          log_record.Undo(ToPageSlot(GetSlot(Find(slot_id))));
+      UpdateRecord(slot_id, FromPageSlot(page_slot), txn);
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  /**
+   * @brief Get the storage size of the page.
+   *
+   * @returns Storage size.
+   */
+  size_t GetStorageSize() const override { return image.size(); }
+
+  /**
+   * Load page object from byte string. The page image is copied in place.
+   *
+   * @param input input buffer span to load
+   */
+  void Load(Span input) override {
+    if (input.size < image.size()) {
+      throw PageParseError();
+    }
+    std::memcpy(image.data(), input.start, image.size());
+    // Validate no slots beyond capacity are marked occupied
+    if (capacity % word_bits != 0 &&
+        GetWord(capacity) >> (capacity % word_bits) != 0) {
+      throw PageParseError();
+    }
+    page_id = Read<PageId>(0);
+    next_page_id = Read<PageId>(next_page_id_offset);
+    prev_page_id = Read<PageId>(prev_page_id_offset);
+    count = CountOccupied();
+  }
+
+  /**
+   * Dump page object as byte string. The page image is copied as is.
+   *
+   * @param output output buffer span to dump
+   */
+  void Dump(Span output) override {
+    if (output.size < image.size()) {
+      throw PageParseError();
+    }
+    std::memcpy(output.start, image.data(), image.size());
+  }
+
+#ifdef __PERSIST_DEBUG__
+  /**
+   * @brief Write page to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const FixedRecordPage &page) {
+    os << "--------- Page " << page.page_id << " ---------\n";
+    os << "next: " << page.next_page_id << "\n";
+    os << "prev: " << page.prev_page_id << "\n";
+    os << "records: " << page.count << "/" << page.capacity << "\n";
+    os << "-----------------------------";
+    return os;
+  }
+#endif
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_PAGE_FIXEDRECORDPAGE_PAGE_HPP */
@@ -25,12 +25,19 @@
 #ifndef PERSIST_CORE_PAGE_LOGPAGE_PAGE_HPP
 #define PERSIST_CORE_PAGE_LOGPAGE_PAGE_HPP
 
+#include <cstring>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <persist/core/exceptions/page.hpp>
+#include <persist/core/fixed_storable.hpp>
 #include <persist/core/page/base.hpp>
 #include <persist/core/page/log_page/slot.hpp>
 
+#include <persist/utility/mutex.hpp>
+
 namespace persist {
 
 // TODO:
@@ -44,6 +51,10 @@ namespace persist {
  *
  * The log page is a page to store log records. Log records are persisted to
  * backend storage by the log manager in pages for efficiency.
+ *
+ * Slots are indexed and decoded lazily from the page image by const readers.
+ * The lazily built state is guarded by a lock so that concurrent readers of a
+ * page are safe. Modifying the page requires exclusive access.
  */
 class LogPage : public Page {
 public:
@@ -52,7 +63,7 @@ public:
    *
    * The header contains page ID information.
    */
-  class Header : public Storable {
+  class Header : public FixedStorable<Header, PageParseError> {
   public:
     /**
      * @brief Page unique identifer
@@ -67,6 +78,14 @@ public:
      */
     SeqNumber last_seq_number;
 
+    /**
+     * @brief Format word holding the log format version of the page in its
+     * upper half. Pages written before the log format was versioned hold
+     * their slot count, which never reaches 2^32, in its place and thus read
+     * as version 0.
+     */
+    uint64_t format;
+
     /**
      * @brief Number of slots in the page
      *
@@ -83,41 +102,22 @@ public:
      *
      */
     Header(PageId page_id = 0, size_t page_size = DEFAULT_PAGE_SIZE)
-        : page_id(page_id), page_size(page_size), last_seq_number(0),
-          slot_count(0) {}
+        : page_id(page_id), last_seq_number(0),
+          format(uint64_t(LOG_FORMAT_VERSION) << 32), slot_count(0),
+          page_size(page_size) {}
 
     /**
-     * @brief Get storage size of header
-     *
+     * @brief Get the log format version of the page.
      */
-    size_t GetStorageSize() const override {
-      return sizeof(PageId) + sizeof(SeqNumber) + sizeof(uint64_t);
-    }
+    uint32_t GetVersion() const { return static_cast<uint32_t>(format >> 32); }
 
     /**
-     * Load object from byte string
+     * @brief Get the stored fields of the header.
      *
-     * @param input input buffer span to load
+     * NOTE: Page size is not stored as its part of the metadata.
      */
-    void Load(Span input) override {
-      if (input.size < GetStorageSize()) {
-        throw PageParseError();
-      }
-      // Load bytes
-      persist::load(input, page_id, last_seq_number, slot_count);
-    }
-
-    /**
-     * Dump object as byte string
-     *
-     * @param output output buffer span to dump
-     */
-    void Dump(Span output) override {
-      if (output.size < GetStorageSize()) {
-        throw PageParseError();
-      }
-      // Dump bytes
-      persist::dump(output, page_id, last_seq_number, slot_count);
+    auto GetFields() {
+      return std::tie(page_id, last_seq_number, format, slot_count);
     }
 
 #ifdef __PERSIST_DEBUG__
@@ -128,6 +128,7 @@ public:
       os << "------- Header -------\n";
       os << "id: " << header.page_id << "\n";
       os << "lastSeqNumber: " << header.last_seq_number << "\n";
+      os << "version: " << header.GetVersion() << "\n";
       os << "slotCount: " << header.slot_count << "\n";
       os << "----------------------";
       return os;
@@ -141,24 +142,77 @@ public:
    */
   Header header;
 
+  /**
+   * @brief Raw byte image of the page as last loaded or dumped. Page slots are
+   * decoded from the image on first access and bytes of slots never accessed
+   * are dumped back as is.
+   */
+  ByteBuffer image;
+
+  /**
+   * @brief Lock guarding the slot index and decoded slots built by readers.
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+  mutable Mutex cache_lock;
+
   /**
    * @brief Mapping between sequence number and corresponding log record stored
-   * as bytes in log page slots.
+   * as bytes in log page slots. Only decoded and inserted slots are mapped.
    */
   typedef typename std::unordered_map<PageSlotId, LogPageSlot> SlotMap;
-  SlotMap slots;
+  mutable SlotMap slots GUARDED_BY(cache_lock);
+
+  /**
+   * @brief List of sequence numbers of slots in the page paired with their
+   * offset in the page image. The list is built from the image on first
+   * access after load.
+   */
+  typedef typename std::vector<std::pair<SeqNumber, size_t>> OffsetList;
+  mutable OffsetList offsets GUARDED_BY(cache_lock);
+  mutable bool indexed GUARDED_BY(cache_lock);
 
   /**
    * @brief Size of free space available on the page.
    */
-  size_t data_Size;
+  mutable size_t data_Size GUARDED_BY(cache_lock);
+
+  /**
+   * @brief Build the list of slot offsets by walking the slots in the page
+   * image. Only the sequence number and data size of each slot are read. The
+   * caller must hold the cache lock.
+   *
+   * @throws PageParseError
+   */
+  void Index() const {
+    if (indexed) {
+      return;
+    }
+    const size_t slot_header_size = LogPageSlot::Header::GetFixedStorageSize();
+    offsets.clear();
+    data_Size = header.GetStorageSize();
+    for (size_t i = 0; i < header.slot_count; ++i) {
+      if (data_Size + slot_header_size + sizeof(size_t) > image.size()) {
+        throw PageParseError();
+      }
+      SeqNumber seq_number;
+      size_t size;
+      std::memcpy(&seq_number, image.data() + data_Size, sizeof(SeqNumber));
+      std::memcpy(&size, image.data() + data_Size + slot_header_size,
+                  sizeof(size_t));
+      offsets.emplace_back(seq_number, data_Size);
+      data_Size += slot_header_size + sizeof(size_t) + size;
+    }
+    indexed = true;
+  }
 
 public:
   /**
    * @brief Construct a new Log Page object
    */
   LogPage(PageId page_id = 0, size_t page_size = DEFAULT_LOG_PAGE_SIZE)
-      : header(page_id, page_size), data_Size(header.GetStorageSize()) {}
+      : header(page_id, page_size), image(page_size, 0), indexed(true),
+        data_Size(header.GetStorageSize()) {}
 
   /**
    * Get page identifier.
@@ -173,7 +227,10 @@ public:
    * @param operation Operaion to be performed
    * @returns Free space in bytes
    */
-  size_t GetFreeSpaceSize(Operation operation) const override {
+  size_t GetFreeSpaceSize(Operation) const override {
+    LockGuard guard(cache_lock);
+
+    Index();
     // If stored data size greater than page size then return 0
     if (header.page_size <= data_Size) {
       return 0;
@@ -200,19 +257,35 @@ public:
   }
 
   /**
-   * Get page slot of given identifier within the page.
+   * Get page slot of given identifier within the page. The slot is decoded
+   * from the page image on first access. The returned slot is valid until the
+   * page is loaded again.
+   *
+   * @thread_safe
    *
    * @param seq_number sequence number of the log record seeked
    * @returns Constant reference to the LogPageSlot object if found
    * @throws PageSlotNotFoundError
    */
   const LogPageSlot &GetPageSlot(SeqNumber seq_number) const {
-    // Check if slot exists
+    LockGuard guard(cache_lock);
+
+    // Check if slot is already decoded
     SlotMap::const_iterator it = slots.find(seq_number);
-    if (it == slots.end()) {
-      throw PageSlotNotFoundError(header.page_id, seq_number);
+    if (it != slots.end()) {
+      return it->second;
+    }
+    // Decode slot from page image
+    Index();
+    for (auto &element : offsets) {
+      if (element.first == seq_number) {
+        LogPageSlot &slot = slots[seq_number];
+        slot.Load(Span((Byte *)image.data() + element.second,
+                       image.size() - element.second));
+        return slot;
+      }
     }
-    return it->second;
+    throw PageSlotNotFoundError(header.page_id, seq_number);
   }
 
   /**
@@ -222,15 +295,25 @@ public:
    * @returns pointer to the inserted LogPageSlot
    */
   LogPageSlot *InsertPageSlot(LogPageSlot &page_slot) {
-    // Update data size in page
-    data_Size += page_slot.GetStorageSize();
-    // Insert record block at slot
-    auto inserted = slots.emplace(page_slot.GetSeqNumber(), page_slot);
+    LogPageSlot *inserted;
+    {
+      LockGuard guard(cache_lock);
+
+      Index();
+      // Append slot after the last slot in page
+      offsets.emplace_back(page_slot.GetSeqNumber(), data_Size);
+      header.slot_count += 1;
+      // Update data size in page
+      data_Size += page_slot.GetStorageSize();
+      // Insert record block at slot
+      inserted =
+          &slots.emplace(page_slot.GetSeqNumber(), page_slot).first->second;
+    }
 
     // Notify observers of modification
     NotifyObservers();
 
-    return &inserted.first->second;
+    return inserted;
   }
 
   /**
@@ -241,7 +324,7 @@ public:
   size_t GetStorageSize() const override { return header.page_size; }
 
   /**
-   * Load LogPage object from byte string.
+   * Load LogPage object from byte string. Only the page header is decoded.
    *
    * @param input input buffer span to load
    */
@@ -249,26 +332,27 @@ public:
     if (input.size < header.page_size) {
       throw PageParseError();
     }
-    slots.clear(); //<- clears data in case it is loaded
+    {
+      LockGuard guard(cache_lock);
+      slots.clear(); //<- clears data in case it is loaded
+      offsets.clear();
+      indexed = false;
+    }
 
     // Load Page header
     header.Load(input);
-    data_Size = header.GetStorageSize();
-    input += data_Size;
-    // Load bytes
-    for (size_t i = 0; i < header.slot_count; ++i) {
-      // Load slot
-      LogPageSlot slot;
-      slot.Load(input);
-      size_t slot_size = slot.GetStorageSize();
-      data_Size += slot_size;
-      input += slot_size;
-      slots.emplace(slot.GetSeqNumber(), slot);
+    if (header.GetVersion() != LOG_FORMAT_VERSION) {
+      std::string msg = "Unsupported log format version " +
+                        std::to_string(header.GetVersion()) + ".";
+      throw PageParseError(msg);
     }
+    // Keep page image for decoding slots on access
+    std::memcpy(image.data(), input.start, header.page_size);
   }
 
   /**
-   * Dump LogPage object as byte string.
+   * Dump LogPage object as byte string. Decoded slots are serialized into the
+   * page image while the bytes of the rest of the slots are copied as is.
    *
    * @param output output buffer span to dump
    */
@@ -277,17 +361,17 @@ public:
       throw PageParseError();
     }
     // Dump header
-    header.slot_count = slots.size();
-    header.Dump(output);
-    output += header.GetStorageSize();
-    // Dump bytes
-    for (auto &element : slots) {
-      LogPageSlot &slot = element.second;
-      slot.Dump(output);
-      output += slot.GetStorageSize();
+    header.Dump(image);
+    // Dump decoded slots
+    LockGuard guard(cache_lock);
+    for (auto &element : offsets) {
+      SlotMap::iterator it = slots.find(element.first);
+      if (it != slots.end()) {
+        it->second.Dump(Span(image.data() + element.second,
+                             image.size() - element.second));
+      }
     }
-    // Dump free space
-    std::memset((void *)output.start, 0, output.size);
+    std::memcpy(output.start, image.data(), header.page_size);
   }
 
 #ifdef __PERSIST_DEBUG__
@@ -27,6 +27,7 @@
 
 #include <persist/core/common.hpp>
 #include <persist/core/exceptions/page.hpp>
+#include <persist/core/fixed_storable.hpp>
 
 #include <persist/utility/serializer.hpp>
 
@@ -109,7 +110,7 @@ public:
    * The class represents header of a plog age slot. It contains the metadata
    * information required for facilitating read write operations of log records.
    */
-  class Header : public Storable {
+  class Header : public FixedStorable<Header, PageParseError> {
   public:
     /**
      * @brief Log record sequence number
@@ -130,34 +131,9 @@ public:
         : seq_number(seq_number), next_location(next_location) {}
 
     /**
-     * @brief Get the storage size of header
-     *
+     * @brief Get the stored fields of the slot header.
      */
-    size_t GetStorageSize() const override { return sizeof(Header); }
-
-    /**
-     * Load slot header from byte string.
-     *
-     * @param input input buffer span to load
-     */
-    void Load(Span input) override {
-      if (input.size < GetStorageSize()) {
-        throw PageParseError();
-      }
-      persist::load(input, seq_number, next_location);
-    }
-
-    /**
-     * Dump slot header as byte string.
-     *
-     * @param output output buffer span to dump
-     */
-    void Dump(Span output) override {
-      if (output.size < GetStorageSize()) {
-        throw PageParseError();
-      }
-      persist::dump(output, seq_number, next_location);
-    }
+    auto GetFields() { return std::tie(seq_number, next_location); }
 
     /**
      * @brief Equality comparision operator.
@@ -241,7 +217,7 @@ public:
    *
    */
   size_t GetStorageSize() const override {
-    return header.GetStorageSize() + sizeof(size_t) + data.size();
+    return Header::GetFixedStorageSize() + sizeof(size_t) + data.size();
   }
 
   /**
@@ -253,6 +229,8 @@ public:
     if (input.size < GetStorageSize()) {
       throw PageParseError();
     }
+    data.clear(); //<- clears data in case it is loaded
+
     // Load header
     header.Load(input);
     input += header.GetStorageSize();
@@ -0,0 +1,662 @@
+/**
+ * pax_page/page.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PERSIST_CORE_PAGE_PAXPAGE_PAGE_HPP
+#define PERSIST_CORE_PAGE_PAXPAGE_PAGE_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include <persist/core/exceptions/page.hpp>
+#include <persist/core/page/base.hpp>
+#include <persist/core/page/record_page/slot.hpp>
+#include <persist/core/transaction/transaction.hpp>
+
+namespace persist {
+
+/**
+ * @brief PAX Page
+ *
+ * The page stores fixed schema records column by column. The page is split
+ * into one minipage per column following the page header, and the minipage of
+ * a column stores the value of that column for every slot in the page. A scan
+ * over a column thus reads a contiguous array of values instead of pulling
+ * whole records through the cache. Minipages start at 8 byte aligned offsets
+ * so that the values of a column can be read in place as an array of
+ * integers or floats.
+ *
+ * Records are passed to and returned from the page in row format, i.e. the
+ * values of the columns one after another. A record is split into its columns
+ * on write and reconstructed from them on read.
+ *
+ * The page header comprises of the page identifier, the next and previous page
+ * identifiers in case the page is linked, and an occupancy bitmap with one bit
+ * per slot. Every slot has a SlotId starting from 1. Operations on the page
+ * are logged as part of transactions with the record in row format as the
+ * page slot data. The log records are marked with the PAX page kind so that
+ * the transaction manager undoes them on this page type.
+ *
+ * @tparam ColumnSizes sizes in bytes of the columns of stored records
+ */
+template <size_t... ColumnSizes> class PaxPage : public Page {
+  static_assert(sizeof...(ColumnSizes) > 0,
+                "PaxPage must have at least one column.");
+
+  PERSIST_PRIVATE
+  /**
+   * @brief Type of bitmap words
+   */
+  typedef uint64_t Word;
+
+  /**
+   * @brief Number of slots tracked by a bitmap word
+   */
+  static const size_t word_bits = 8 * sizeof(Word);
+
+  /**
+   * @brief Alignment of minipages in the page image
+   */
+  static const size_t alignment = 8;
+
+  /**
+   * @brief Offsets of header fields in the page image
+   */
+  static const size_t next_page_id_offset = sizeof(PageId);
+  static const size_t prev_page_id_offset = 2 * sizeof(PageId);
+  static const size_t bitmap_offset = 3 * sizeof(PageId);
+
+  /**
+   * @brief Byte image of the page
+   */
+  ByteBuffer image;
+
+  /**
+   * @brief Header fields mirrored from the page image
+   */
+  PageId page_id;
+  PageId next_page_id;
+  PageId prev_page_id;
+
+  /**
+   * @brief Number of slots in the page along with the number of bitmap words
+   * and the offsets of the minipages.
+   */
+  size_t capacity;
+  size_t word_count;
+  std::vector<size_t> column_offsets;
+
+  /**
+   * @brief Number of occupied slots and the number of slots up to the last
+   * occupied slot.
+   */
+  size_t count;
+  size_t slot_count;
+
+  /**
+   * @brief Round up size to the minipage alignment.
+   */
+  static size_t Align(size_t size) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  /**
+   * @brief Get total size of bitmap and minipages for given capacity.
+   */
+  static size_t GetLayoutSize(size_t capacity) {
+    size_t size = (capacity + word_bits - 1) / word_bits * sizeof(Word);
+    for (size_t column_size : {ColumnSizes...}) {
+      size += Align(capacity * column_size);
+    }
+    return size;
+  }
+
+  /**
+   * @brief Read value stored at given offset in the page image.
+   */
+  template <class T> T Read(size_t offset) const {
+    T value;
+    std::memcpy(&value, image.data() + offset, sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief Write value at given offset in the page image.
+   */
+  template <class T> void Write(size_t offset, const T &value) {
+    std::memcpy(image.data() + offset, &value, sizeof(T));
+  }
+
+  /**
+   * @brief Get bitmap word at given word index.
+   */
+  Word GetWord(size_t word_index) const {
+    return Read<Word>(bitmap_offset + word_index * sizeof(Word));
+  }
+
+  /**
+   * @brief Mark the slot at given index as occupied or free.
+   */
+  void SetOccupied(size_t index, bool occupied) {
+    Word word = GetWord(index / word_bits);
+    Word mask = Word(1) << (index % word_bits);
+    word = occupied ? word | mask : word & ~mask;
+    Write(bitmap_offset + (index / word_bits) * sizeof(Word), word);
+  }
+
+  /**
+   * @brief Check if the slot at given index is occupied.
+   */
+  bool IsOccupiedAt(size_t index) const {
+    return (GetWord(index / word_bits) >> (index % word_bits)) & 1;
+  }
+
+  /**
+   * @brief Find index of the first free slot by scanning the bitmap a word at
+   * a time.
+   *
+   * @returns index of the free slot or the capacity if the page is full
+   */
+  size_t FindFree() const {
+    for (size_t i = 0; i < word_count; ++i) {
+      Word word = ~GetWord(i);
+      if (word != 0) {
+        size_t index = i * word_bits + __builtin_ctzll(word);
+        return index < capacity ? index : capacity;
+      }
+    }
+    return capacity;
+  }
+
+  /**
+   * @brief Recount occupied slots and find the last occupied slot from the
+   * bitmap.
+   */
+  void Recount() {
+    count = 0;
+    slot_count = 0;
+    for (size_t i = 0; i < word_count; ++i) {
+      Word word = GetWord(i);
+      if (word != 0) {
+        count += __builtin_popcountll(word);
+        slot_count = (i + 1) * word_bits - __builtin_clzll(word);
+      }
+    }
+  }
+
+  /**
+   * @brief Get index of the occupied slot with given identifier.
+   *
+   * @throws PageSlotNotFoundError
+   */
+  size_t Find(PageSlotId slot_id) const {
+    if (slot_id == 0 || slot_id > capacity || !IsOccupiedAt(slot_id - 1)) {
+      throw PageSlotNotFoundError(page_id, slot_id);
+    }
+    return slot_id - 1;
+  }
+
+  /**
+   * @brief Copy record in row format to the minipages at given slot index.
+   */
+  void Scatter(size_t index, const Byte *record) {
+    size_t column = 0;
+    for (size_t column_size : {ColumnSizes...}) {
+      std::memcpy(image.data() + column_offsets[column] + index * column_size,
+                  record, column_size);
+      record += column_size;
+      ++column;
+    }
+  }
+
+  /**
+   * @brief Reconstruct record in row format from the minipages at given slot
+   * index.
+   */
+  void Gather(size_t index, Byte *record) const {
+    size_t column = 0;
+    for (size_t column_size : {ColumnSizes...}) {
+      std::memcpy(record,
+                  image.data() + column_offsets[column] + index * column_size,
+                  column_size);
+      record += column_size;
+      ++column;
+    }
+  }
+
+  /**
+   * @brief Wrap record in row format in a page slot for logging.
+   */
+  static RecordPageSlot ToPageSlot(const Byte *record) {
+    RecordPageSlot page_slot;
+    page_slot.data.assign(record, record + GetRecordSize());
+    return page_slot;
+  }
+
+  /**
+   * @brief Get record in row format carried by a logged page slot.
+   *
+   * @throws LogRecordParseError if the page slot does not carry a record
+   */
+  static const Byte *FromPageSlot(const RecordPageSlot &page_slot) {
+    if (page_slot.data.size() != GetRecordSize()) {
+      throw LogRecordParseError("Logged record size does not match the page.");
+    }
+    return page_slot.data.data();
+  }
+
+  /**
+   * @brief Store record at the free slot with given index.
+   */
+  void Occupy(size_t index, const Byte *record) {
+    Scatter(index, record);
+    SetOccupied(index, true);
+    ++count;
+    slot_count = std::max(slot_count, index + 1);
+  }
+
+public:
+  /**
+   * @brief Kind of page marked in log records of operations on the page.
+   */
+  static const LogRecord::PageKind page_kind = LogRecord::PageKind::PAX;
+
+  /**
+   * @brief Construct a new PaxPage object. The page holds as many slots as
+   * fit along with their occupancy bitmap.
+   *
+   * @param page_id page identifer
+   * @param page_size page storage size
+   */
+  PaxPage(PageId page_id = 0, size_t page_size = DEFAULT_PAGE_SIZE)
+      : image(page_size, 0), page_id(page_id), next_page_id(0),
+        prev_page_id(0), count(0), slot_count(0) {
+    size_t size = page_size > bitmap_offset ? page_size - bitmap_offset : 0;
+    capacity = (8 * size) / (8 * GetRecordSize() + 1);
+    while (capacity > 0 && GetLayoutSize(capacity) > size) {
+      --capacity;
+    }
+    word_count = (capacity + word_bits - 1) / word_bits;
+    // Lay out minipages after the bitmap
+    size_t offset = bitmap_offset + word_count * sizeof(Word);
+    for (size_t column_size : {ColumnSizes...}) {
+      column_offsets.push_back(offset);
+      offset += Align(capacity * column_size);
+    }
+    Write(0, page_id);
+  }
+
+  /**
+   * @brief Get number of columns of stored records.
+   *
+   * @returns column count
+   */
+  static constexpr size_t GetColumnCount() { return sizeof...(ColumnSizes); }
+
+  /**
+   * @brief Get size of stored records in row format.
+   *
+   * @returns record size in bytes
+   */
+  static size_t GetRecordSize() {
+    size_t size = 0;
+    for (size_t column_size : {ColumnSizes...}) {
+      size += column_size;
+    }
+    return size;
+  }
+
+  /**
+   * @brief Get size of values of given column.
+   *
+   * @param column column index
+   * @returns column size in bytes
+   */
+  static size_t GetColumnSize(size_t column) {
+    const size_t column_sizes[] = {ColumnSizes...};
+    return column_sizes[column];
+  }
+
+  /**
+   * Get page ID.
+   *
+   * @returns page identifier
+   */
+  const PageId &GetId() const override { return page_id; }
+
+  /**
+   * Get free space in bytes available in the page. This is the space of free
+   * slots in the page.
+   *
+   * @param operation The type of page operation for which free space is
+   * requested.
+   * @returns free space available in page
+   */
+  size_t GetFreeSpaceSize(Operation) const override {
+    return (capacity - count) * GetRecordSize();
+  }
+
+  /**
+   * @brief Get number of slots in the page.
+   *
+   * @returns slot capacity
+   */
+  size_t GetCapacity() const { return capacity; }
+
+  /**
+   * @brief Get number of records stored in the page.
+   *
+   * @returns record count
+   */
+  size_t GetRecordCount() const { return count; }
+
+  /**
+   * @brief Get number of slots up to and including the last occupied slot.
+   * Scans over a column need to read only this many values.
+   *
+   * @returns slot count
+   */
+  size_t GetSlotCount() const { return slot_count; }
+
+  /**
+   * Get next page ID. A value of `0` means there is no next page.
+   *
+   * @returns next page identifier
+   */
+  const PageId &GetNextPageId() const { return next_page_id; }
+
+  /**
+   * Set next page ID. A value of `0` means there is no next page.
+   *
+   * @param page_id next page ID value to set
+   */
+  void SetNextPageId(PageId page_id) {
+    next_page_id = page_id;
+    Write(next_page_id_offset, page_id);
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * Get previous page ID. A value of `0` means there is no previous page.
+   *
+   * @returns previous page identifier
+   */
+  const PageId &GetPrevPageId() const { return prev_page_id; }
+
+  /**
+   * Set previous page ID. A value of `0` means there is no previous page.
+   *
+   * @param page_id previous page ID value to set
+   */
+  void SetPrevPageId(PageId page_id) {
+    prev_page_id = page_id;
+    Write(prev_page_id_offset, page_id);
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * @brief Check if slot with given identifier holds a record.
+   *
+   * @param slot_id Slot identifier
+   * @returns `true` if the slot is occupied else `false`
+   */
+  bool IsOccupied(PageSlotId slot_id) const {
+    return slot_id > 0 && slot_id <= capacity && IsOccupiedAt(slot_id - 1);
+  }
+
+  /**
+   * @brief Get the minipage of given column. The minipage holds the values of
+   * the column for every slot, the value of slot with identifier `slot_id`
+   * being at index `slot_id - 1`. Values of free slots are zero. The returned
+   * pointer is aligned to 8 bytes and valid for the lifetime of the page.
+   *
+   * @param column column index
+   * @returns pointer to the first value in the column
+   */
+  const Byte *GetColumn(size_t column) const {
+    return image.data() + column_offsets[column];
+  }
+
+  /**
+   * Get record stored in slot of given identifier. The record is
+   * reconstructed in row format from the minipages.
+   *
+   * @param slot_id Slot identifier
+   * @returns Record in row format
+   * @throws PageSlotNotFoundError
+   */
+  ByteBuffer GetRecord(PageSlotId slot_id) const {
+    ByteBuffer record(GetRecordSize());
+    Gather(Find(slot_id), record.data());
+    return record;
+  }
+
+  /**
+   * Insert record in the first free slot of the page.
+   *
+   * @param record Pointer to record in row format to insert
+   * @param txn Reference to active transaction
+   * @returns SlotId of the inserted record
+   * @throws PageFullError
+   */
+  PageSlotId InsertRecord(const Byte *record, Transaction &txn) {
+    size_t index = FindFree();
+    if (index == capacity) {
+      throw PageFullError(page_id);
+    }
+    PageSlotId slot_id = index + 1;
+
+    // Log insert operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot page_slot = ToPageSlot(record);
+    txn.LogInsertOp(location, page_slot, page_kind);
+
+    // Insert record at slot
+    Occupy(index, record);
+
+    // Notify observers of modification
+    NotifyObservers();
+
+    return slot_id;
+  }
+
+  /**
+   * Update record stored in slot of given identifier.
+   *
+   * @param slot_id Identifier of the slot to update
+   * @param record Pointer to updated record in row format
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   */
+  void UpdateRecord(PageSlotId slot_id, const Byte *record, Transaction &txn) {
+    size_t index = Find(slot_id);
+
+    // Log update operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot old_page_slot;
+    old_page_slot.data.resize(GetRecordSize());
+    Gather(index, old_page_slot.data.data());
+    RecordPageSlot new_page_slot = ToPageSlot(record);
+    txn.LogUpdateOp(location, old_page_slot, new_page_slot, page_kind);
+
+    // Update record at slot
+    Scatter(index, record);
+
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * Remove record stored in slot of given identifier.
+   *
+   * @param slot_id Identifier of the slot to remove
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   */
+  void RemoveRecord(PageSlotId slot_id, Transaction &txn) {
+    size_t index = Find(slot_id);
+
+    // Log delete operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot page_slot;
+    page_slot.data.resize(GetRecordSize());
+    Gather(index, page_slot.data.data());
+    txn.LogDeleteOp(location, page_slot, page_kind);
+
+    // Free the slot
+    ByteBuffer zeros(GetRecordSize(), 0);
+    Scatter(index, zeros.data());
+    SetOccupied(index, false);
+    Recount();
+
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * Undo remove record stored in slot of given identifier. In case the slot
+   * is already occupied then no operation is performed.
+   *
+   * @param slot_id Identifier of the slot to insert back
+   * @param record Pointer to record in row format to insert back
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   */
+  void UndoRemoveRecord(PageSlotId slot_id, const Byte *record,
+                        Transaction &txn) {
+    if (slot_id == 0 || slot_id > capacity) {
+      throw PageSlotNotFoundError(page_id, slot_id);
+    }
+    size_t index = slot_id - 1;
+    if (IsOccupiedAt(index)) {
+      return;
+    }
+
+    // Log insert operation
+    RecordPageSlot::Location location(page_id, slot_id);
+    RecordPageSlot page_slot = ToPageSlot(record);
+    txn.LogInsertOp(location, page_slot, page_kind);
+
+    // Insert record back at slot
+    Occupy(index, record);
+
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * @brief Undo operation of given log record performed on the page.
+   *
+   * @param log_record Reference to the log record of the operation to undo
+   * @param txn Reference to active transaction
+   * @throws PageSlotNotFoundError
+   * @throws LogRecordParseError if the logged record does not match the page
+   */
+  void Undo(LogRecord &log_record, Transaction &txn) {
+    PageSlotId slot_id = log_record.GetLocation().slot_id;
+    switch (log_record.GetLogType()) {
+    case LogRecord::Type::INSERT: {
+      RemoveRecord(slot_id, txn);
+      break;
+    }
+    case LogRecord::Type::DELETE: {
+      UndoRemoveRecord(slot_id, FromPageSlot(log_record.GetPageSlotA()), txn);
+      break;
+    }
+    case LogRecord::Type::UPDATE: {
+      // Undo the update delta on the current record
+      RecordPageSlot page_slot;
+      page_slot.data.resize(GetRecordSize());
+      Gather(Find(slot_id), page_slot.data.data());
+      page_slot = log_record.Undo(page_slot);
+      UpdateRecord(slot_id, FromPageSlot(page_slot), txn);
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  /**
+   * @brief Get the storage size of the page.
+   *
+   * @returns Storage size.
+   */
+  size_t GetStorageSize() const override { return image.size(); }
+
+  /**
+   * Load page object from byte string. The page image is copied in place.
+   *
+   * @param input input buffer span to load
+   */
+  void Load(Span input) override {
+    if (input.size < image.size()) {
+      throw PageParseError();
+    }
+    std::memcpy(image.data(), input.start, image.size());
+    // Validate no slots beyond capacity are marked occupied
+    if (capacity % word_bits != 0 &&
+        GetWord(capacity / word_bits) >> (capacity % word_bits) != 0) {
+      throw PageParseError();
+    }
+    page_id = Read<PageId>(0);
+    next_page_id = Read<PageId>(next_page_id_offset);
+    prev_page_id = Read<PageId>(prev_page_id_offset);
+    Recount();
+  }
+
+  /**
+   * Dump page object as byte string. The page image is copied as is.
+   *
+   * @param output output buffer span to dump
+   */
+  void Dump(Span output) override {
+    if (output.size < image.size()) {
+      throw PageParseError();
+    }
+    std::memcpy(output.start, image.data(), image.size());
+  }
+
+#ifdef __PERSIST_DEBUG__
+  /**
+   * @brief Write page to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &os, const PaxPage &page) {
+    os << "--------- Page " << page.page_id << " ---------\n";
+    os << "next: " << page.next_page_id << "\n";
+    os << "prev: " << page.prev_page_id << "\n";
+    os << "columns: " << page.GetColumnCount() << "\n";
+    os << "records: " << page.count << "/" << page.capacity << "\n";
+    os << "-----------------------------";
+    return os;
+  }
+#endif
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_PAGE_PAXPAGE_PAGE_HPP */
@@ -25,14 +25,20 @@
 #ifndef PERSIST_CORE_PAGE_RECORDPAGE_PAGE_HPP
 #define PERSIST_CORE_PAGE_RECORDPAGE_PAGE_HPP
 
-#include <map>
+#include <algorithm>
+#include <cstring>
+#include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <persist/core/buffer/pinned_view.hpp>
 #include <persist/core/exceptions/page.hpp>
 #include <persist/core/page/base.hpp>
 #include <persist/core/page/record_page/slot.hpp>
 #include <persist/core/transaction/transaction.hpp>
 
+#include <persist/utility/mutex.hpp>
 #include <persist/utility/serializer.hpp>
 
 namespace persist {
@@ -55,8 +61,8 @@ namespace persist {
  * collections which store variable length records. It comprises of a
  * header, free space, and stored slots. The page header comprises of the
  * page unique identifier, called PageId, along with the next and previous
- * page identifiers in case the page is linked. It also contains entries of
- * offset values indicating where each slot is located within the page.
+ * page identifiers in case the page is linked. It also contains a slot
+ * directory with the offset and size of each slot within the page.
  *
  * Every slot in a page has a unique identifier called SlotId. The SlotId is
  * only unique within the context of a page. For a globally unique
@@ -69,16 +75,80 @@ namespace persist {
  * which it is linked. This information along with its own SlotId is stored
  * in its header. The rest of the slot stores the record data.
  *
+ * The page is kept in memory as its byte image so that loading a page from
+ * and dumping it to a buffer are plain copies. Page slots are parsed from the
+ * image on first access into a cache guarded by a lock, so that concurrent
+ * readers of a page are safe. Slot data can also be viewed in the image
+ * without being parsed or copied. Modifying the page requires exclusive
+ * access.
+ *
+ * Slots are stored from the end of the page towards the slot directory and
+ * never move when other slots are updated or removed. Space released by
+ * removed or shrunk slots becomes a free block linked in a free list and is
+ * re-used by later slots. The page is compacted only when the contiguous free
+ * space is not enough for a slot while the total free space is.
+ *
+ * The page header records the page format which decides the width of the
+ * in-page offsets and sizes stored in the header. Slot identifiers are not
+ * stored as a slot is addressed by its index in the slot directory.
+ *
+ * The directory entry of a removed slot is kept reserved until the slot is
+ * released once its removal commits or aborts. This way a removal rolled back
+ * never finds its slot ID taken by another slot.
+ *
  */
 class RecordPage : public Page {
 public:
+  /**
+   * @brief Page formats recorded in the page header. The compact format stores
+   * the offsets and sizes in the page header as 16-bit integers and is used
+   * for pages smaller than 64KiB. Larger pages use the large format which
+   * stores them as 32-bit integers.
+   */
+  enum class Format : uint8_t { COMPACT = 1, LARGE = 2 };
+
+  /**
+   * @brief Get format used for pages of given size.
+   *
+   * @param page_size page storage size
+   * @returns page format
+   */
+  static Format GetFormat(size_t page_size) {
+    return page_size <= UINT16_MAX ? Format::COMPACT : Format::LARGE;
+  }
+
+  /**
+   * @brief Get width in bytes of the offsets and sizes stored in the page
+   * header for given format.
+   *
+   * @param format page format
+   * @returns width of stored offsets and sizes
+   */
+  static size_t GetWidth(Format format) {
+    return format == Format::COMPACT ? sizeof(uint16_t) : sizeof(uint32_t);
+  }
+
+  /**
+   * @brief Get the word recording given format in the page header. Pages of
+   * the legacy layout, written before the page format was recorded, hold their
+   * 64-bit slot count in its place, which is always below 2^32. The format
+   * word has its upper half set so that legacy pages are told apart and
+   * converted on load.
+   *
+   * @param format page format
+   * @returns stored format word
+   */
+  static uint64_t GetFormatWord(Format format) {
+    return (uint64_t(1) << 32) | static_cast<uint64_t>(format);
+  }
+
   /**
    * Page Header Class
    *
    * The page header contains the page unique identifier along with the next
    * and previous page identifiers in case the page is linked. It also contains
-   * entries of offset values indicating where each record-block in the page is
-   * located.
+   * the free space bookkeeping of the page and the slot directory with the
+   * offset and size of each slot in the page.
    */
   class Header : public Storable {
   public:
@@ -98,131 +168,68 @@ public:
     PageId prev_page_id;
 
     /**
-     * @brief Storage size of the page.
+     * @brief Page format
      */
-    size_t page_size;
+    Format format;
 
     /**
-     * SlotSpan Class
-     *
-     * Contains offset and size of stored slots in the page.
-     */
-    struct SlotSpan {
-      size_t offset; //<- location offset from end of block
-      size_t size;   //<- size of stored data
-    };
-    /**
-     * @brief SlotSpanMap type to map slot ID to its span.
-     *
+     * @brief Ending offset of the contiguous free space in the page.
      */
-    typedef typename std::map<PageSlotId, SlotSpan> SlotSpanMap;
-    SlotSpanMap slots;
+    size_t tail;
 
     /**
-     * Constructors
+     * @brief Offset of the first free block in the free list. A value of 0
+     * means the free list is empty. Every free block starts with the offset of
+     * the next free block followed by its own size.
      */
-    Header(PageId page_id = 0, size_t page_size = DEFAULT_PAGE_SIZE)
-        : page_id(page_id), next_page_id(0), prev_page_id(0),
-          page_size(page_size) {}
+    size_t free_offset;
 
     /**
-     * Get storage size of header. The size comprises of:
-     *
-     * NOTE: Page size is not stored as its part of the metadata.
+     * @brief Total size of free space between stored slots. This includes
+     * free blocks too small to be linked in the free list.
      */
-    size_t GetStorageSize() const override {
-      return 3 * sizeof(PageId) + sizeof(size_t) +
-             (sizeof(SlotSpan) + sizeof(PageSlotId)) * slots.size();
-    }
+    size_t free_size;
 
     /**
-     * Ending offset of the free space in the page.
-     *
-     * @returns free space ending offset
+     * @brief Storage size of the page.
      */
-    size_t GetTail() const {
-      if (slots.empty()) {
-        return page_size;
-      }
-      return slots.rbegin()->second.offset;
-    }
+    size_t page_size;
 
     /**
-     * Use up chunk of space of given size from the available free space in the
-     * page. This operation allocates storage slot.
+     * SlotSpan Class
      *
-     * @param size amount of space in bytes to occupy
-     * @returns ID of the new slot
+     * Contains offset and size of stored slots in the page. An unused entry in
+     * the slot directory has a size of 0. The entry of a removed slot not yet
+     * released keeps a non-zero offset while a free entry is all zero.
      */
-    PageSlotId CreateSlot(size_t size) {
-      // Get ID of the last slot
-      PageSlotId last_id, new_id;
-      if (slots.empty()) {
-        last_id = 0;
-      } else {
-        last_id = slots.rbegin()->first;
-      }
-      // Create a new slot by adding it to the list of slots
-      new_id = last_id + 1;
-      slots.emplace(new_id, SlotSpan{GetTail() - size, size});
-
-      return new_id;
-    }
-
+    struct SlotSpan {
+      size_t offset; //<- location offset from start of block
+      size_t size;   //<- size of stored data
+    };
     /**
-     * Use up chunk of space of given size from the available free space in the
-     * page. This operation allocates storage slot with given ID. In case a slot
-     * with given ID already exists then no operation is performed.
+     * @brief SlotSpanList type for the slot directory. The span of slot with
+     * ID `n` is stored at index `n - 1`.
      *
-     * @param slot_id the slot ID to use when creating. By default set to 0 in
-     * which case an ID is generated.
-     * @param size amount of space in bytes to occupy
      */
-    void CreateSlot(PageSlotId slot_id, size_t size) {
-      size_t prev_offset;
-      if (slot_id == 1) {
-        prev_offset = page_size;
-      } else {
-        prev_offset = slots.at(slot_id - 1).offset;
-      }
-      slots.emplace(slot_id, SlotSpan{prev_offset - size, 0});
-      UpdateSlot(slot_id, size);
-    }
+    typedef typename std::vector<SlotSpan> SlotSpanList;
+    SlotSpanList slots;
 
     /**
-     * Update size of used chunk of space occupied by slot of given ID.
-     *
-     * @param slot_id identifier of slot to update
-     * @param size new size of the slot
+     * Constructors
      */
-    void UpdateSlot(PageSlotId slot_id, size_t size) {
-      // Change in size
-      size_t delta = slots.at(slot_id).size - size;
-      // Update targeted slot size
-      slots.at(slot_id).size = size;
-      // Adjsut offsets of rest of the slots
-      SlotSpanMap::iterator it = slots.find(slot_id);
-      while (it != slots.end()) {
-        it->second.offset += delta;
-        ++it;
-      }
-    }
+    Header(PageId page_id = 0, size_t page_size = DEFAULT_PAGE_SIZE)
+        : page_id(page_id), next_page_id(0), prev_page_id(0),
+          format(GetFormat(page_size)), tail(page_size), free_offset(0),
+          free_size(0), page_size(page_size) {}
 
     /**
-     * Free up used chunk of space occupied by slot of given ID.
+     * Get storage size of header.
      *
-     * @param slot_id identifier of slot to free
+     * NOTE: Page size is not stored as its part of the metadata.
      */
-    void FreeSlot(PageSlotId slot_id) {
-      // Adjust slot offsets
-      size_t size = slots.at(slot_id).size;
-      SlotSpanMap::iterator it = std::next(slots.find(slot_id));
-      while (it != slots.end()) {
-        it->second.offset += size;
-        ++it;
-      }
-      // Remove slot from the list of slots
-      slots.erase(slot_id);
+    size_t GetStorageSize() const override {
+      return 3 * sizeof(PageId) + sizeof(uint64_t) +
+             (4 + 2 * slots.size()) * GetWidth(format);
     }
 
     /**
@@ -231,12 +238,35 @@ public:
      * @param input input buffer span to load
      */
     void Load(Span input) override {
+      slots.clear(); //<- clears slots in case they are loaded
       if (input.size < GetStorageSize()) {
         throw PageParseError();
       }
-      slots.clear(); //<- clears slots in case they are loaded
       // Load bytes
-      persist::load(input, page_id, next_page_id, prev_page_id, slots);
+      uint64_t word;
+      persist::load(input, page_id, next_page_id, prev_page_id, word);
+      if (word == GetFormatWord(Format::COMPACT)) {
+        format = Format::COMPACT;
+      } else if (word == GetFormatWord(Format::LARGE)) {
+        format = Format::LARGE;
+      } else {
+        throw PageParseError();
+      }
+      size_t width = GetWidth(format);
+      if (input.size < 4 * width) {
+        throw PageParseError();
+      }
+      tail = LoadField(input, width);
+      free_offset = LoadField(input, width);
+      free_size = LoadField(input, width);
+      size_t count = LoadField(input, width);
+      if (input.size < 2 * count * width) {
+        throw PageParseError();
+      }
+      for (size_t i = 0; i < count; ++i) {
+        size_t offset = LoadField(input, width);
+        slots.push_back({offset, LoadField(input, width)});
+      }
     }
 
     /**
@@ -249,7 +279,17 @@ public:
         throw PageParseError();
       }
       // Dump bytes
-      persist::dump(output, page_id, next_page_id, prev_page_id, slots);
+      persist::dump(output, page_id, next_page_id, prev_page_id,
+                    GetFormatWord(format));
+      size_t width = GetWidth(format);
+      DumpField(output, width, tail);
+      DumpField(output, width, free_offset);
+      DumpField(output, width, free_size);
+      DumpField(output, width, slots.size());
+      for (auto &slot : slots) {
+        DumpField(output, width, slot.offset);
+        DumpField(output, width, slot.size);
+      }
     }
 
 #ifdef __PERSIST_DEBUG__
@@ -261,29 +301,521 @@ public:
       os << "id: " << header.page_id << "\n";
       os << "next: " << header.next_page_id << "\n";
       os << "prev: " << header.prev_page_id << "\n";
+      os << "format: " << static_cast<int>(header.format) << "\n";
+      os << "tail: " << header.tail << "\n";
+      os << "free: " << header.free_offset << ", " << header.free_size << "\n";
       os << "_size: " << header.page_size << "\n";
       os << "slots: \n";
-      for (auto slot : header.slots) {
-        os << "\tid: " << slot.first << ", offset: " << slot.second.offset
-           << ", size: " << slot.second.size << "\n";
+      for (size_t i = 0; i < header.slots.size(); ++i) {
+        os << "\tid: " << i + 1 << ", offset: " << header.slots[i].offset
+           << ", size: " << header.slots[i].size << "\n";
       }
       os << "----------------------";
       return os;
     }
 #endif
+
+  PERSIST_PRIVATE
+    /**
+     * @brief Load an offset or size of given width from byte string.
+     */
+    static size_t LoadField(Span &input, size_t width) {
+      if (width == sizeof(uint16_t)) {
+        uint16_t value;
+        persist::load(input, value);
+        return value;
+      }
+      uint32_t value;
+      persist::load(input, value);
+      return value;
+    }
+
+    /**
+     * @brief Dump an offset or size of given width as byte string.
+     */
+    static void DumpField(Span &output, size_t width, size_t value) {
+      if (width == sizeof(uint16_t)) {
+        persist::dump(output, static_cast<uint16_t>(value));
+      } else {
+        persist::dump(output, static_cast<uint32_t>(value));
+      }
+    }
   };
 
   PERSIST_PRIVATE
   /**
-   * @brief Page header
+   * @brief Byte image of the page in its storage format. The page operates
+   * directly on the image so that loading and dumping the page is a copy of the
+   * image. The image is laid out as the page header, the slot directory, free
+   * space and the stored slots. The contiguous free space is always kept
+   * zeroed.
    */
-  Header header;
+  ByteBuffer image;
 
   /**
-   * @brief Collection of page slots mapped to their slot_ids in page header
+   * @brief Linked page identifiers mirrored from the page image
+   */
+  PageId page_id, next_page_id, prev_page_id;
+
+  /**
+   * @brief Page format and width in bytes of the offsets and sizes stored in
+   * the page header
+   */
+  Format format;
+  size_t width;
+
+  /**
+   * @brief Offsets of header fields in the page image. The offsets of fields
+   * following the page format depend on the width of the format.
+   */
+  static const size_t next_page_id_offset = sizeof(PageId);
+  static const size_t prev_page_id_offset = 2 * sizeof(PageId);
+  static const size_t format_offset = 3 * sizeof(PageId);
+  size_t tail_offset, free_offset_offset, free_size_offset, slot_count_offset,
+      directory_offset;
+
+  /**
+   * @brief Size of a slot directory entry comprising of the offset and size of
+   * the slot.
+   */
+  size_t entry_size;
+
+  /**
+   * @brief Minimum size of a free block linked in the free list. Smaller free
+   * blocks are only reclaimed by compaction.
+   */
+  size_t free_block_size;
+
+  /**
+   * @brief Set the page format along with the layout of the page header.
+   *
+   * @param format page format
+   */
+  void SetFormat(Format format) {
+    this->format = format;
+    width = GetWidth(format);
+    tail_offset = format_offset + sizeof(uint64_t);
+    free_offset_offset = tail_offset + width;
+    free_size_offset = free_offset_offset + width;
+    slot_count_offset = free_size_offset + width;
+    directory_offset = slot_count_offset + width;
+    entry_size = 2 * width;
+    free_block_size = 2 * width;
+  }
+
+  /**
+   * @brief Lock guarding the page slot cache which is filled by readers.
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+  mutable Mutex cache_lock;
+
+  /**
+   * @brief Collection of page slots parsed from the page image mapped to their
+   * slot IDs. Slots are parsed lazily on first access.
    */
   typedef typename std::unordered_map<PageSlotId, RecordPageSlot> PageSlotMap;
-  PageSlotMap page_slots;
+  mutable PageSlotMap page_slots GUARDED_BY(cache_lock);
+
+  /**
+   * @brief IDs of the free entries in the slot directory. Inserted slots take
+   * the lowest free ID, else extend the directory. The set is rebuilt from
+   * the directory when the page is loaded.
+   */
+  std::set<PageSlotId> free_slot_ids;
+
+  /**
+   * @brief Read value stored at given offset in the page image.
+   */
+  template <class T> T Read(size_t offset) const {
+    T value;
+    std::memcpy(&value, image.data() + offset, sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief Write value at given offset in the page image.
+   */
+  template <class T> void Write(size_t offset, const T &value) {
+    std::memcpy(image.data() + offset, &value, sizeof(T));
+  }
+
+  /**
+   * @brief Read offset or size stored at given offset in the page image.
+   */
+  size_t ReadField(size_t offset) const {
+    if (width == sizeof(uint16_t)) {
+      return Read<uint16_t>(offset);
+    }
+    return Read<uint32_t>(offset);
+  }
+
+  /**
+   * @brief Write offset or size at given offset in the page image.
+   */
+  void WriteField(size_t offset, size_t value) {
+    if (width == sizeof(uint16_t)) {
+      Write(offset, static_cast<uint16_t>(value));
+    } else {
+      Write(offset, static_cast<uint32_t>(value));
+    }
+  }
+
+  /**
+   * @brief Get number of entries in the slot directory.
+   */
+  size_t GetSlotCount() const { return ReadField(slot_count_offset); }
+
+  /**
+   * @brief Get storage size of the page header including the slot directory.
+   */
+  size_t GetHeaderSize() const {
+    return directory_offset + GetSlotCount() * entry_size;
+  }
+
+  /**
+   * @brief Ending offset of the contiguous free space in the page.
+   */
+  size_t GetTail() const { return ReadField(tail_offset); }
+
+  /**
+   * @brief Get span of the slot with given ID from the slot directory.
+   */
+  Header::SlotSpan GetSlotSpan(PageSlotId slot_id) const {
+    size_t offset = directory_offset + (slot_id - 1) * entry_size;
+    return Header::SlotSpan{ReadField(offset), ReadField(offset + width)};
+  }
+
+  /**
+   * @brief Set span of the slot with given ID in the slot directory.
+   */
+  void SetSlotSpan(PageSlotId slot_id, size_t offset, size_t size) {
+    size_t entry_offset = directory_offset + (slot_id - 1) * entry_size;
+    WriteField(entry_offset, offset);
+    WriteField(entry_offset + width, size);
+  }
+
+  /**
+   * @brief Find span of the slot with given ID.
+   *
+   * @param slot_id Slot identifier
+   * @returns span of the slot
+   * @throws PageSlotNotFoundError
+   */
+  Header::SlotSpan Find(PageSlotId slot_id) const {
+    if (slot_id == 0 || slot_id > GetSlotCount() ||
+        GetSlotSpan(slot_id).size == 0) {
+      throw PageSlotNotFoundError(page_id, slot_id);
+    }
+    return GetSlotSpan(slot_id);
+  }
+
+  /**
+   * @brief Move all stored slots to the end of the page, merging the free
+   * space between them into the contiguous free space.
+   */
+  void Compact() {
+    // Slots are moved in order of decreasing offset so that no slot is
+    // overwritten before it is moved.
+    std::vector<std::pair<size_t, PageSlotId>> spans;
+    for (PageSlotId slot_id = 1; slot_id <= GetSlotCount(); ++slot_id) {
+      Header::SlotSpan span = GetSlotSpan(slot_id);
+      if (span.size > 0) {
+        spans.emplace_back(span.offset, slot_id);
+      }
+    }
+    std::sort(spans.rbegin(), spans.rend());
+
+    size_t tail = image.size();
+    for (auto &element : spans) {
+      Header::SlotSpan span = GetSlotSpan(element.second);
+      tail -= span.size;
+      std::memmove(image.data() + tail, image.data() + span.offset, span.size);
+      SetSlotSpan(element.second, tail, span.size);
+    }
+    size_t header_size = GetHeaderSize();
+    std::memset(image.data() + header_size, 0, tail - header_size);
+    WriteField(tail_offset, tail);
+    WriteField(free_offset_offset, 0);
+    WriteField(free_size_offset, 0);
+  }
+
+  /**
+   * @brief Make sure the contiguous free space has at least the given size,
+   * compacting the page if needed.
+   *
+   * @param size required size of contiguous free space
+   * @throws PageFullError
+   */
+  void Reserve(size_t size) {
+    if (GetTail() - GetHeaderSize() >= size) {
+      return;
+    }
+    Compact();
+    if (GetTail() - GetHeaderSize() < size) {
+      throw PageFullError(page_id);
+    }
+  }
+
+  /**
+   * @brief Allocate space of given size for a slot. The first block in the
+   * free list large enough is used, else the space is taken from the
+   * contiguous free space.
+   *
+   * @param size size of space to allocate
+   * @returns offset of the allocated space
+   * @throws PageFullError
+   */
+  size_t Allocate(size_t size) {
+    // Search the free list for a block large enough
+    size_t link = free_offset_offset;
+    for (size_t block = ReadField(link); block != 0;
+         link = block, block = ReadField(block)) {
+      size_t block_size = ReadField(block + width);
+      if (block_size < size) {
+        continue;
+      }
+      WriteField(free_size_offset, ReadField(free_size_offset) - size);
+      size_t remainder = block_size - size;
+      if (remainder >= free_block_size) {
+        // Use the end of the block leaving the rest linked in the free list
+        WriteField(block + width, remainder);
+        return block + remainder;
+      }
+      // Unlink the block. The remainder is left unused until compaction.
+      WriteField(link, ReadField(block));
+      std::memset(image.data() + block, 0, block_size);
+      return block;
+    }
+    // Use the contiguous free space
+    Reserve(size);
+    size_t tail = GetTail() - size;
+    WriteField(tail_offset, tail);
+    return tail;
+  }
+
+  /**
+   * @brief Release space of given size at given offset to free space. Space
+   * adjacent to the contiguous free space is merged into it, else it is linked
+   * into the free list.
+   *
+   * @param offset offset of the space to release
+   * @param size size of the space to release
+   */
+  void Release(size_t offset, size_t size) {
+    std::memset(image.data() + offset, 0, size);
+    if (offset == GetTail()) {
+      WriteField(tail_offset, offset + size);
+      return;
+    }
+    WriteField(free_size_offset, ReadField(free_size_offset) + size);
+    if (size >= free_block_size) {
+      WriteField(offset, ReadField(free_offset_offset));
+      WriteField(offset + width, size);
+      WriteField(free_offset_offset, offset);
+    }
+  }
+
+  /**
+   * @brief Check that a slot of given size with given ID fits in the page,
+   * counting the space of its current span to be released and any directory
+   * entries to be added. This is checked before a page slot is modified so
+   * that a full page is left unchanged.
+   *
+   * @param slot_id Slot identifier
+   * @param size storage size of the slot
+   * @param released size of the current span of the slot
+   * @throws PageFullError
+   */
+  void CheckFit(PageSlotId slot_id, size_t size, size_t released = 0) const {
+    size_t count = GetSlotCount();
+    size_t entries_size = slot_id > count ? (slot_id - count) * entry_size : 0;
+    size_t free_size =
+        GetTail() - GetHeaderSize() + ReadField(free_size_offset) + released;
+    if (entries_size + size > free_size) {
+      throw PageFullError(page_id);
+    }
+  }
+
+  /**
+   * @brief Extend the slot directory to hold the slot with given ID and take
+   * its entry. Entries added before it are free.
+   *
+   * @param slot_id Slot identifier
+   * @throws PageFullError
+   */
+  void Extend(PageSlotId slot_id) {
+    size_t count = GetSlotCount();
+    if (slot_id <= count) {
+      free_slot_ids.erase(slot_id);
+      return;
+    }
+    // The new entries are taken from the zeroed contiguous free space
+    Reserve((slot_id - count) * entry_size);
+    WriteField(slot_count_offset, slot_id);
+    for (PageSlotId free_slot_id = count + 1; free_slot_id < slot_id;
+         ++free_slot_id) {
+      free_slot_ids.insert(free_slot_id);
+    }
+  }
+
+  /**
+   * @brief Remove free entries from the end of the slot directory.
+   */
+  void Trim() {
+    size_t count = GetSlotCount();
+    while (count > 0 && GetSlotSpan(count).offset == 0 &&
+           GetSlotSpan(count).size == 0) {
+      free_slot_ids.erase(count);
+      count -= 1;
+    }
+    WriteField(slot_count_offset, count);
+  }
+
+  /**
+   * @brief Parse page slot with given ID from the page image into the cache.
+   * The caller must hold the cache lock.
+   *
+   * @param slot_id Slot identifier
+   * @returns reference to the parsed page slot
+   * @throws PageSlotNotFoundError
+   */
+  RecordPageSlot &ParsePageSlot(PageSlotId slot_id) const {
+    Header::SlotSpan span = Find(slot_id);
+    if (span.offset < GetHeaderSize() ||
+        span.offset + span.size > image.size()) {
+      throw PageParseError();
+    }
+    RecordPageSlot &page_slot = page_slots[slot_id];
+    page_slot.Load(Span((Byte *)image.data() + span.offset, span.size));
+    return page_slot;
+  }
+
+  /**
+   * @brief Get page slot with given ID from the cache, parsing it from the
+   * page image if not cached.
+   *
+   * @param slot_id Slot identifier
+   * @returns reference to the page slot
+   * @throws PageSlotNotFoundError
+   */
+  RecordPageSlot &LookupPageSlot(PageSlotId slot_id) const {
+    LockGuard guard(cache_lock);
+
+    PageSlotMap::iterator it = page_slots.find(slot_id);
+    if (it != page_slots.end()) {
+      return it->second;
+    }
+    return ParsePageSlot(slot_id);
+  }
+
+  /**
+   * @brief Store page slot with given ID into the page image and the cache.
+   * Space for the slot must be allocated in the slot directory entry.
+   *
+   * @param slot_id Slot identifier
+   * @param page_slot Reference to the page slot to store
+   * @returns reference to the cached page slot
+   */
+  RecordPageSlot &Store(PageSlotId slot_id, RecordPageSlot &page_slot) {
+    Header::SlotSpan span = GetSlotSpan(slot_id);
+    page_slot.Dump(Span(image.data() + span.offset, span.size));
+    LockGuard guard(cache_lock);
+    RecordPageSlot &stored = page_slots[slot_id];
+    stored = page_slot;
+    return stored;
+  }
+
+  /**
+   * @brief Convert the loaded page image from the legacy layout to the current
+   * format. The legacy layout stores the slot count as a 64-bit integer after
+   * the page IDs, followed by a directory entry of the 64-bit slot ID, offset
+   * and size for every stored slot in increasing order of slot IDs. Every slot
+   * stores its fixed-width next and previous locations padded to 40 bytes
+   * followed by the 64-bit data size and the data. The page IDs are stored
+   * alike in both layouts.
+   *
+   * @throws PageParseError
+   */
+  void ConvertLegacy() {
+    const size_t count_offset = format_offset;
+    const size_t legacy_directory_offset = count_offset + sizeof(uint64_t);
+    const size_t legacy_entry_size = 3 * sizeof(uint64_t);
+    const size_t data_size_offset = 5 * sizeof(uint64_t);
+    const size_t data_offset = data_size_offset + sizeof(uint64_t);
+
+    // Parse the stored slots
+    uint64_t count = Read<uint64_t>(count_offset);
+    if (count > (image.size() - legacy_directory_offset) / legacy_entry_size) {
+      throw PageParseError();
+    }
+    size_t header_size = legacy_directory_offset + count * legacy_entry_size;
+    std::vector<std::pair<PageSlotId, RecordPageSlot>> slots;
+    PageSlotId last_slot_id = 0;
+    for (size_t i = 0; i < count; ++i) {
+      size_t entry = legacy_directory_offset + i * legacy_entry_size;
+      PageSlotId slot_id = Read<uint64_t>(entry);
+      uint64_t offset = Read<uint64_t>(entry + sizeof(uint64_t));
+      uint64_t size = Read<uint64_t>(entry + 2 * sizeof(uint64_t));
+      if (slot_id <= last_slot_id || slot_id > image.size() ||
+          offset < header_size || offset > image.size() ||
+          size < data_offset || size > image.size() - offset ||
+          Read<uint64_t>(offset + data_size_offset) != size - data_offset) {
+        throw PageParseError();
+      }
+      last_slot_id = slot_id;
+      RecordPageSlot::Location next_location(
+          Read<PageId>(offset), Read<PageSlotId>(offset + sizeof(uint64_t)));
+      RecordPageSlot::Location prev_location(
+          Read<PageId>(offset + 2 * sizeof(uint64_t)),
+          Read<PageSlotId>(offset + 3 * sizeof(uint64_t)));
+      auto start = image.begin() + offset + data_offset;
+      RecordPageSlot page_slot(ByteBuffer(start, start + size - data_offset));
+      page_slot.SetNextLocation(next_location);
+      page_slot.SetPrevLocation(prev_location);
+      slots.emplace_back(slot_id, std::move(page_slot));
+    }
+
+    // Store the slots with their IDs in an empty page image. The current
+    // format is more compact, but slot IDs left unused by removed slots take
+    // directory entries, so the fit of every slot is checked.
+    std::fill(image.begin() + format_offset, image.end(), 0);
+    SetFormat(GetFormat(image.size()));
+    Write(format_offset, GetFormatWord(format));
+    WriteField(tail_offset, image.size());
+    for (auto &element : slots) {
+      size_t size = element.second.GetStorageSize();
+      try {
+        CheckFit(element.first, size);
+      } catch (PageFullError &) {
+        throw PageParseError();
+      }
+      Extend(element.first);
+      SetSlotSpan(element.first, Allocate(size), size);
+      Store(element.first, element.second);
+    }
+  }
+
+  /**
+   * @brief Get a view of the data of page slot with given ID in the page image
+   * along with the slot header. The view is only valid while the page is
+   * pinned, so it is handed out tied to the page handle in a `PinnedView`.
+   *
+   * @param slot_id Slot identifier
+   * @param header Reference to the slot header to load into
+   * @returns View of the page slot data
+   * @throws PageSlotNotFoundError
+   */
+  ByteView ViewPageSlot(PageSlotId slot_id,
+                        RecordPageSlot::Header &header) const {
+    Header::SlotSpan span = Find(slot_id);
+    if (span.offset < GetHeaderSize() ||
+        span.offset + span.size > image.size()) {
+      throw PageParseError();
+    }
+    return RecordPageSlot::LoadView(
+        Span((Byte *)image.data() + span.offset, span.size), header);
+  }
 
 public:
   /**
@@ -293,31 +825,44 @@ public:
    * @param page_size page storage size
    */
   RecordPage(PageId page_id = 0, size_t page_size = DEFAULT_PAGE_SIZE)
-      : header(page_id, page_size) {}
+      : image(page_size, 0), page_id(page_id), next_page_id(0),
+        prev_page_id(0) {
+    SetFormat(GetFormat(page_size));
+    Write(0, page_id);
+    Write(format_offset, GetFormatWord(format));
+    WriteField(tail_offset, page_size);
+  }
 
   /**
    * Get page ID.
    *
    * @returns block identifier
    */
-  const PageId &GetId() const override { return header.page_id; }
+  const PageId &GetId() const override { return page_id; }
+
+  /**
+   * Check if the page holds no page slots. Removed slots not yet released
+   * are counted.
+   *
+   * @returns `true` if the page is empty else `false`
+   */
+  bool IsEmpty() const { return GetSlotCount() == 0; }
 
   /**
-   * Get free space in bytes available in the page.
+   * Get free space in bytes available in the page. This includes the free
+   * space between stored slots which is made contiguous by compaction.
    *
    * @param operation The type of page operation for which free space is
    * requested.
    * @returns free space available in page
    */
   size_t GetFreeSpaceSize(Operation operation) const override {
-    size_t size = header.GetTail() - header.GetStorageSize();
+    size_t size = GetTail() - GetHeaderSize() + ReadField(free_size_offset);
     // Compute size for INSERT operation
     if (operation == Operation::INSERT) {
-      const size_t single_slot_span_size =
-          sizeof(Header::SlotSpan) + sizeof(PageSlotId);
       // Check if free space size is greater than header slot size
-      if (size > single_slot_span_size) {
-        size -= single_slot_span_size;
+      if (size > entry_size) {
+        size -= entry_size;
       } else {
         size = 0;
       }
@@ -332,7 +877,7 @@ public:
    *
    * @returns next page identifier
    */
-  const PageId &GetNextPageId() const { return header.next_page_id; }
+  const PageId &GetNextPageId() const { return next_page_id; }
 
   /**
    * Set next page ID. This is the ID for the next linked page when there is
@@ -341,7 +886,8 @@ public:
    * @param page_id next page ID value to set
    */
   void SetNextPageId(PageId page_id) {
-    header.next_page_id = page_id;
+    next_page_id = page_id;
+    Write(next_page_id_offset, page_id);
     // Notify observers of modification
     NotifyObservers();
   }
@@ -352,7 +898,7 @@ public:
    *
    * @returns previous page identifier
    */
-  const PageId &GetPrevPageId() const { return header.prev_page_id; }
+  const PageId &GetPrevPageId() const { return prev_page_id; }
 
   /**
    * Set previous page ID. This is the ID for the previous linked page when
@@ -361,13 +907,18 @@ public:
    * @param page_id previous page ID value to set
    */
   void SetPrevPageId(PageId page_id) {
-    header.prev_page_id = page_id;
+    prev_page_id = page_id;
+    Write(prev_page_id_offset, page_id);
     // Notify observers of modification
     NotifyObservers();
   }
 
   /**
-   * Get page slot of given identifier within the page.
+   * Get page slot of given identifier within the page. The slot is parsed
+   * from the page image on first access. The returned slot is valid until the
+   * slot is modified or the page is loaded again.
+   *
+   * @thread_safe
    *
    * @param slot_id Slot identifier
    * @param txn Reference to active transaction
@@ -376,113 +927,213 @@ public:
    */
   const RecordPageSlot &GetPageSlot(PageSlotId slot_id,
                                     Transaction &txn) const {
-    // Check if slot exists
-    PageSlotMap::const_iterator it = page_slots.find(slot_id);
-    if (it == page_slots.end()) {
-      throw PageSlotNotFoundError(header.page_id, slot_id);
+    return LookupPageSlot(slot_id);
+  }
+
+  /**
+   * Get a view of the data of page slot of given identifier within the handled
+   * page. The view points into the page image, so no copy is made and the slot
+   * is not cached. The view keeps the page pinned until it is destroyed, but
+   * it is not valid once the page is modified or compacted.
+   *
+   * @thread_safe
+   *
+   * @param page Handle of the page holding the slot
+   * @param slot_id Slot identifier
+   * @param txn Reference to active transaction
+   * @returns View of the page slot data pinned to its page if found
+   * @throws PageSlotNotFoundError
+   */
+  static PinnedView<RecordPage> GetPageSlotView(PageHandle<RecordPage> page,
+                                                PageSlotId slot_id,
+                                                Transaction &txn) {
+    RecordPageSlot::Header header;
+    return GetPageSlotView(std::move(page), slot_id, header, txn);
+  }
+
+  /**
+   * Get a view of the data of page slot of given identifier within the handled
+   * page along with the slot header holding its links.
+   *
+   * @thread_safe
+   *
+   * @param page Handle of the page holding the slot
+   * @param slot_id Slot identifier
+   * @param header Reference to the slot header to load into
+   * @param txn Reference to active transaction
+   * @returns View of the page slot data pinned to its page if found
+   * @throws PageSlotNotFoundError
+   */
+  static PinnedView<RecordPage> GetPageSlotView(PageHandle<RecordPage> page,
+                                                PageSlotId slot_id,
+                                                RecordPageSlot::Header &header,
+                                                Transaction &txn) {
+    return PinnedView<RecordPage>(
+        std::move(page), [&](const RecordPage &_page) {
+          return _page.ViewPageSlot(slot_id, header);
+        });
+  }
+
+  /**
+   * Get ID of the slot the next inserted page slot takes. This is the lowest
+   * free entry in the slot directory, else a new entry at its end.
+   *
+   * @returns next page slot identifier
+   */
+  PageSlotId GetNextSlotId() const {
+    if (free_slot_ids.empty()) {
+      return GetSlotCount() + 1;
     }
-    return it->second;
+    return *free_slot_ids.begin();
   }
 
   /**
-   * Insert page slot to the page.
+   * Insert page slot to the page. The slot takes the lowest free entry in the
+   * slot directory.
    *
    * @param page_slot Reference to the PageSlot object to insert
    * @param txn Reference to active transaction
    * @returns SlotId and pointer to the inserted PageSlot
+   * @throws PageFullError
    */
   std::pair<PageSlotId, RecordPageSlot *>
   InsertPageSlot(RecordPageSlot &page_slot, Transaction &txn) {
     // Create slot for record block
-    PageSlotId slot_id = header.CreateSlot(page_slot.GetStorageSize());
+    PageSlotId slot_id = GetNextSlotId();
+    size_t size = page_slot.GetStorageSize();
+    CheckFit(slot_id, size);
+    Extend(slot_id);
+    SetSlotSpan(slot_id, Allocate(size), size);
 
     // Log insert operation
-    RecordPageSlot::Location location(header.page_id, slot_id);
+    RecordPageSlot::Location location(page_id, slot_id);
     txn.LogInsertOp(location, page_slot);
 
     // Insert record block at slot
-    auto inserted = page_slots.emplace(slot_id, page_slot);
+    RecordPageSlot &inserted = Store(slot_id, page_slot);
 
     // Notify observers of modification
     NotifyObservers();
 
-    return std::pair<PageSlotId, RecordPageSlot *>(slot_id,
-                                                   &inserted.first->second);
+    return std::pair<PageSlotId, RecordPageSlot *>(slot_id, &inserted);
   }
 
   /**
-   * Update page slot in the page.
+   * Update page slot in the page. The slot is updated in place if it does not
+   * grow, else it is moved to newly allocated space.
    *
    * @param slot_id Identifier of the slot to update
    * @param page_slot Reference to updated page slot
    * @param txn Reference to active transaction
    * @throws PageSlotNotFoundError
+   * @throws PageFullError
    */
   virtual void UpdatePageSlot(PageSlotId slot_id, RecordPageSlot &page_slot,
                               Transaction &txn) {
-    // Check if slot exists
-    PageSlotMap::iterator it = page_slots.find(slot_id);
-    if (it == page_slots.end()) {
-      throw PageSlotNotFoundError(header.page_id, slot_id);
+    Header::SlotSpan span = Find(slot_id);
+    size_t size = page_slot.GetStorageSize();
+    if (size > span.size) {
+      CheckFit(slot_id, size, span.size);
     }
 
     // Log update operation
-    RecordPageSlot::Location location(header.page_id, slot_id);
-    txn.LogUpdateOp(location, it->second, page_slot);
+    RecordPageSlot::Location location(page_id, slot_id);
+    txn.LogUpdateOp(location, LookupPageSlot(slot_id), page_slot);
 
     // Update slot for record block
-    header.UpdateSlot(slot_id, page_slot.GetStorageSize());
+    if (size <= span.size) {
+      Release(span.offset + size, span.size - size);
+      SetSlotSpan(slot_id, span.offset, size);
+    } else {
+      SetSlotSpan(slot_id, 0, 0);
+      Release(span.offset, span.size);
+      SetSlotSpan(slot_id, Allocate(size), size);
+    }
     // Update record block at slot
-    it->second = std::move(page_slot);
+    Store(slot_id, page_slot);
 
     // Notify observers of modification
     NotifyObservers();
   }
 
   /**
-   * Remove page slot of given identifier within page.
+   * Remove page slot of given identifier within page. The space of the slot is
+   * freed while its entry in the slot directory stays reserved until the slot
+   * is released.
    *
    * @param slot_id Identifier of the slot to remove
    * @param txn Reference to active transaction
    * @throws PageSlotNotFoundError
    */
   void RemovePageSlot(PageSlotId slot_id, Transaction &txn) {
-    // Check if slot exists
-    PageSlotMap::iterator it = page_slots.find(slot_id);
-    if (it == page_slots.end()) {
-      throw PageSlotNotFoundError(header.page_id, slot_id);
-    }
+    Header::SlotSpan span = Find(slot_id);
 
     // Log delete operation
-    RecordPageSlot::Location location(header.page_id, slot_id);
-    txn.LogDeleteOp(location, page_slots.at(slot_id));
+    RecordPageSlot::Location location(page_id, slot_id);
+    txn.LogDeleteOp(location, LookupPageSlot(slot_id));
 
-    // Adjusting header
-    header.FreeSlot(slot_id);
+    // Release space of the slot keeping its entry reserved
+    SetSlotSpan(slot_id, span.offset, 0);
+    Release(span.offset, span.size);
     // Removing record block from cache
-    page_slots.erase(it);
+    {
+      LockGuard guard(cache_lock);
+      page_slots.erase(slot_id);
+    }
 
     // Notify observers of modification
     NotifyObservers();
   }
 
   /**
-   * Undo remove page slot of given identifier within page.
+   * Release the entry of removed page slot of given identifier so that its ID
+   * is re-used by inserted slots. This is done once the removal commits or
+   * aborts, and no operation is performed for a slot not removed.
+   *
+   * @param slot_id Identifier of the removed slot
+   */
+  void ReleasePageSlot(PageSlotId slot_id) {
+    if (slot_id == 0 || slot_id > GetSlotCount()) {
+      return;
+    }
+    Header::SlotSpan span = GetSlotSpan(slot_id);
+    if (span.offset == 0 || span.size > 0) {
+      return;
+    }
+    SetSlotSpan(slot_id, 0, 0);
+    free_slot_ids.insert(slot_id);
+    Trim();
+
+    // Notify observers of modification
+    NotifyObservers();
+  }
+
+  /**
+   * Undo remove page slot of given identifier within page. In case a slot with
+   * given ID already exists then no operation is performed.
    *
    * @param slot_id Identifier of the slot to insert back
    * @param page_slot Reference to the slot to insert back
    * @param txn Reference to active transaction
+   * @throws PageFullError
    */
   void UndoRemovePageSlot(PageSlotId slot_id, RecordPageSlot &page_slot,
                           Transaction &txn) {
+    if (slot_id <= GetSlotCount() && GetSlotSpan(slot_id).size > 0) {
+      return;
+    }
+    size_t size = page_slot.GetStorageSize();
+    CheckFit(slot_id, size);
+
     // Log insert operation
-    RecordPageSlot::Location location(header.page_id, slot_id);
+    RecordPageSlot::Location location(page_id, slot_id);
     txn.LogInsertOp(location, page_slot);
 
-    // Update slot for record block
-    header.CreateSlot(slot_id, page_slot.GetStorageSize());
+    // Create slot for record block
+    Extend(slot_id);
+    SetSlotSpan(slot_id, Allocate(size), size);
     // Update record block at slot
-    page_slots.emplace(slot_id, page_slot);
+    Store(slot_id, page_slot);
 
     // Notify observers of modification
     NotifyObservers();
@@ -493,53 +1144,57 @@ public:
    *
    * @returns Storage size.
    */
-  size_t GetStorageSize() const override { return header.page_size; }
+  size_t GetStorageSize() const override { return image.size(); }
 
   /**
-   * Load Block object from byte string.
+   * Load Block object from byte string. The page image is copied in place and
+   * page slots are parsed lazily on access.
    *
    * @param input input buffer span to load
    */
   void Load(Span input) override {
-    if (input.size < header.page_size) {
+    if (input.size < image.size()) {
       throw PageParseError();
     }
-    page_slots.clear(); //<- clears record blocks in case they are loaded
-
-    // Load Page header
-    header.Load(input);
-    // Load record blocks
-    for (auto &element : header.slots) {
-      Header::SlotSpan &slot = element.second;
-      Span span(input.start + slot.offset, slot.size);
-      RecordPageSlot page_slot;
-      page_slot.Load(span);
-      page_slots.emplace(element.first, page_slot);
+    std::memcpy(image.data(), input.start, image.size());
+    page_id = Read<PageId>(0);
+    next_page_id = Read<PageId>(next_page_id_offset);
+    prev_page_id = Read<PageId>(prev_page_id_offset);
+    // Validate page format and slot directory
+    uint64_t word = Read<uint64_t>(format_offset);
+    if ((word >> 32) == 0) {
+      ConvertLegacy();
+    } else if (word != GetFormatWord(GetFormat(image.size()))) {
+      throw PageParseError();
+    }
+    SetFormat(GetFormat(image.size()));
+    if (GetSlotCount() > (image.size() - directory_offset) / entry_size ||
+        GetTail() < GetHeaderSize() || GetTail() > image.size()) {
+      throw PageParseError();
     }
+    // Collect the free entries of the slot directory
+    free_slot_ids.clear();
+    for (PageSlotId slot_id = 1; slot_id <= GetSlotCount(); ++slot_id) {
+      Header::SlotSpan span = GetSlotSpan(slot_id);
+      if (span.offset == 0 && span.size == 0) {
+        free_slot_ids.insert(slot_id);
+      }
+    }
+    // Drop page slots parsed from the previously loaded image
+    LockGuard guard(cache_lock);
+    page_slots.clear();
   }
 
   /**
-   * Dump Block object as byte string.
+   * Dump Block object as byte string. The page image is copied as is.
    *
    * @param output output buffer span to dump
    */
   void Dump(Span output) override {
-    if (output.size < header.page_size) {
+    if (output.size < image.size()) {
       throw PageParseError();
     }
-    // Dump header
-    header.Dump(output);
-    // Dump free space
-    Span span(output.start, header.GetTail());
-    span += header.GetStorageSize();
-    std::memset((void *)span.start, 0, span.size);
-    // Dump record blocks
-    for (auto &element : header.slots) {
-      Header::SlotSpan &slot = element.second;
-      RecordPageSlot &page_slot = page_slots.at(element.first);
-      Span span(output.start + slot.offset, slot.size);
-      page_slot.Dump(span);
-    }
+    std::memcpy(output.start, image.data(), image.size());
   }
 
 #ifdef __PERSIST_DEBUG__
@@ -547,11 +1202,16 @@ public:
    * @brief Write page to output stream
    */
   friend std::ostream &operator<<(std::ostream &os, const RecordPage &page) {
-    os << "--------- Page " << page.header.page_id << " ---------\n";
-    os << page.header << "\n";
-    for (auto element : page.page_slots) {
-      os << ":--> [" << page.header.page_id << ", " << element.first << "]\n";
-      os << element.second << "\n";
+    ByteBuffer image = page.image;
+    Header header(page.page_id, image.size());
+    header.Load(image);
+    os << "--------- Page " << page.page_id << " ---------\n";
+    os << header << "\n";
+    for (PageSlotId slot_id = 1; slot_id <= header.slots.size(); ++slot_id) {
+      if (header.slots[slot_id - 1].size > 0) {
+        os << ":--> [" << page.page_id << ", " << slot_id << "]\n";
+        os << page.LookupPageSlot(slot_id) << "\n";
+      }
     }
     os << "-----------------------------";
 
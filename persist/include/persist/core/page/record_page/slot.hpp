@@ -25,6 +25,8 @@
 #ifndef PERSIST_CORE_PAGE_RECORDPAGE_SLOT_HPP
 #define PERSIST_CORE_PAGE_RECORDPAGE_SLOT_HPP
 
+#include <cstring>
+
 #include <persist/core/common.hpp>
 #include <persist/core/exceptions/page.hpp>
 
@@ -117,6 +119,8 @@ public:
    *
    * The class represents header of a page slot. It contains the metadata
    * information required for facilitating read write operations of records.
+   * The locations are stored using variable length encoding so that a slot
+   * which is not linked takes only a few bytes of header.
    */
   class Header : public Storable {
   public:
@@ -137,7 +141,12 @@ public:
     /**
      * Get storage size of header.
      */
-    size_t GetStorageSize() const override { return sizeof(Header); }
+    size_t GetStorageSize() const override {
+      return persist::varint_size(next_location.page_id) +
+             persist::varint_size(next_location.slot_id) +
+             persist::varint_size(prev_location.page_id) +
+             persist::varint_size(prev_location.slot_id);
+    }
 
     /**
      * Load slot header from byte string.
@@ -145,11 +154,13 @@ public:
      * @param input input buffer span to load
      */
     void Load(Span input) override {
-      if (input.size < GetStorageSize()) {
+      // Load bytes
+      if (!persist::load_varint(input, next_location.page_id) ||
+          !persist::load_varint(input, next_location.slot_id) ||
+          !persist::load_varint(input, prev_location.page_id) ||
+          !persist::load_varint(input, prev_location.slot_id)) {
         throw PageParseError();
       }
-      // Load bytes
-      persist::load(input, next_location, prev_location);
     }
 
     /**
@@ -162,7 +173,10 @@ public:
         throw PageParseError();
       }
       // Dump bytes
-      persist::dump(output, next_location, prev_location);
+      persist::dump_varint(output, next_location.page_id);
+      persist::dump_varint(output, next_location.slot_id);
+      persist::dump_varint(output, prev_location.page_id);
+      persist::dump_varint(output, prev_location.slot_id);
     }
 
     /**
@@ -220,7 +234,8 @@ public:
    *
    */
   size_t GetStorageSize() const override {
-    return header.GetStorageSize() + sizeof(size_t) + data.size();
+    return header.GetStorageSize() + persist::varint_size(data.size()) +
+           data.size();
   }
 
   /**
@@ -257,14 +272,47 @@ public:
    * @param input input buffer span to load
    */
   void Load(Span input) override {
-    if (input.size < GetStorageSize()) {
+    // Load header
+    header.Load(input);
+    input += header.GetStorageSize();
+    // Load data
+    uint64_t size;
+    if (!persist::load_varint(input, size) || input.size < size) {
       throw PageParseError();
     }
+    data.assign(input.start, input.start + size);
+  }
+
+  /**
+   * View data of a page slot stored in byte string without loading the page
+   * slot. The returned view points into the input buffer.
+   *
+   * @param input input buffer span of the stored page slot
+   * @returns view of the page slot data
+   */
+  static ByteView LoadView(Span input) {
+    Header header;
+    return LoadView(input, header);
+  }
+
+  /**
+   * View data of a page slot stored in byte string loading only its header.
+   * The returned view points into the input buffer.
+   *
+   * @param input input buffer span of the stored page slot
+   * @param header reference to the slot header to load into
+   * @returns view of the page slot data
+   */
+  static ByteView LoadView(Span input, Header &header) {
     // Load header
     header.Load(input);
     input += header.GetStorageSize();
-    // Load data
-    persist::load(input, data);
+    // View data
+    uint64_t size;
+    if (!persist::load_varint(input, size) || input.size < size) {
+      throw PageParseError();
+    }
+    return ByteView(input.start, size);
   }
 
   /**
@@ -280,7 +328,8 @@ public:
     header.Dump(output);
     output += header.GetStorageSize();
     // Dump data
-    persist::dump(output, data);
+    persist::dump_varint(output, data.size());
+    std::memcpy(output.start, data.data(), data.size());
   }
 
   /**
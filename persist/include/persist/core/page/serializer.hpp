@@ -35,16 +35,62 @@
 
 namespace persist {
 
+/**
+ * @brief The method verifies the checksum of a dumped page.
+ *
+ * @param input Input buffer span of the dumped page.
+ * @param type Checksum algorithm used to protect the page.
+ * @returns `true` if the checksum matches else `false`
+ */
+static bool VerifyPage(Span input, ChecksumType type = ChecksumType::ALDER32) {
+  if (input.size < sizeof(Checksum)) {
+    throw PageParseError();
+  }
+  // Load checksum
+  Checksum _checksum;
+  persist::load(input, _checksum);
+  // Validate checksum
+  return checksum(input, type) == _checksum;
+}
+
+/**
+ * @brief The method loads an existing page object in place from byte buffer.
+ * The page object is re-used, avoiding the creation of a new page on every
+ * load.
+ *
+ * @param input Input buffer span to load.
+ * @param page Reference to the page object to load.
+ * @param type Checksum algorithm used to validate the page.
+ * @param verify Flag indicating whether to validate the page checksum.
+ */
+inline void LoadPage(Span input, Page &page,
+                     ChecksumType type = ChecksumType::ALDER32,
+                     bool verify = true) {
+  if (input.size < sizeof(Checksum)) {
+    throw PageParseError();
+  }
+  // Validate checksum
+  if (verify && !VerifyPage(input, type)) {
+    throw PageCorruptError();
+  }
+  // Load page
+  page.Load(input + sizeof(Checksum));
+}
+
 /**
  * @brief The method loads a page from byte buffer.
  *
  * @tparam PageType Type of page to load.
  * @param input Input buffer span to load.
+ * @param type Checksum algorithm used to validate the page.
+ * @param verify Flag indicating whether to validate the page checksum.
  * @returns Unique pointer of base type to the created page object. The user
  * should cast the pointer to that of the desired page type.
  */
 template <class PageType>
-static std::unique_ptr<PageType> LoadPage(Span input) {
+static std::unique_ptr<PageType>
+LoadPage(Span input, ChecksumType type = ChecksumType::ALDER32,
+         bool verify = true) {
   static_assert(std::is_base_of<Page, PageType>::value,
                 "Page must be derived from persist::Page");
 
@@ -53,15 +99,8 @@ static std::unique_ptr<PageType> LoadPage(Span input) {
   }
   // Create empty page
   auto page = persist::CreatePage<PageType>(0, input.size);
-  // Load checksum
-  Checksum _checksum;
-  persist::load(input, _checksum);
-  // Validate checksum
-  if (checksum(input) != _checksum) {
-    throw PageCorruptError();
-  }
   // Load page
-  page->Load(input);
+  LoadPage(input, *page, type, verify);
 
   return page;
 }
@@ -71,8 +110,10 @@ static std::unique_ptr<PageType> LoadPage(Span input) {
  *
  * @param page Reference to the page object to dump.
  * @param output Output buffer span to dump.
+ * @param type Checksum algorithm used to protect the page.
  */
-static void DumpPage(Page &page, Span output) {
+static void DumpPage(Page &page, Span output,
+                     ChecksumType type = ChecksumType::ALDER32) {
   if (output.size < sizeof(Checksum)) {
     throw PageParseError();
   }
@@ -80,7 +121,7 @@ static void DumpPage(Page &page, Span output) {
   Span span = output + sizeof(Checksum);
   page.Dump(span);
   // Dump checksum
-  Checksum _checksum = checksum(span);
+  Checksum _checksum = checksum(span, type);
   persist::dump(output, _checksum);
 }
 
@@ -39,9 +39,12 @@ namespace persist {
  * Default set to LRUReplacer.
  * @tparam FreeSpaceManagerType The type of free space manager. Default set to
  * FSLManager.
+ * @tparam StorageType The type of backend storage used by buffer manager.
+ * Default set to the storage base class.
  */
 template <class ReplacerType = LRUReplacer,
-          class FreeSpaceManagerType = FSLManager>
+          class FreeSpaceManagerType = FSLManager,
+          class StorageType = Storage<RecordPage>>
 class PageAllocator {
   static_assert(std::is_base_of<FreeSpaceManager, FreeSpaceManagerType>::value,
                 "FreeSpaceManagerType must be derived from "
@@ -52,7 +55,7 @@ class PageAllocator {
    * @brief Reference to buffer manager containing buffer of pages.
    *
    */
-  BufferManager<RecordPage, ReplacerType> &buffer_manager;
+  BufferManager<RecordPage, ReplacerType, StorageType> &buffer_manager;
 
   /**
    * @brief Reference to free space manager
@@ -73,8 +76,9 @@ public:
    * @param buffer_manager Reference to buffer manager.
    * @param fsm Reference to free space manager.
    */
-  PageAllocator(BufferManager<RecordPage, ReplacerType> &buffer_manager,
-                FreeSpaceManagerType &fsm)
+  PageAllocator(
+      BufferManager<RecordPage, ReplacerType, StorageType> &buffer_manager,
+      FreeSpaceManagerType &fsm)
       : buffer_manager(buffer_manager), fsm(fsm) {}
 
   /**
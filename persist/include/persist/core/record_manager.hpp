@@ -25,6 +25,8 @@
 #ifndef PERSIST_CORE_RECORDMANAGER_HPP
 #define PERSIST_CORE_RECORDMANAGER_HPP
 
+#include <persist/core/buffer/pinned_view.hpp>
+#include <persist/core/page/record_page/page.hpp>
 #include <persist/core/page/record_page/slot.hpp>
 #include <persist/core/transaction/transaction.hpp>
 
@@ -75,6 +77,19 @@ public:
   virtual void Get(RecordType &record, RecordLocation location,
                    Transaction &txn) = 0;
 
+  /**
+   * @brief Get a read-only view of the record data stored at given location
+   * without copying it. The view keeps the page holding the record pinned
+   * until it is destroyed. Implementations get the view of the record page
+   * slot with `RecordPage::GetPageSlotView` from the handle of its page.
+   *
+   * @param location Location of the stored record.
+   * @param txn Reference to an active transaction.
+   * @returns View of the stored record data pinned to its page.
+   */
+  virtual PinnedView<RecordPage> GetView(RecordLocation location,
+                                         Transaction &txn) = 0;
+
   /**
    * @brief Insert record stored in buffer to storage. The method returns the
    * inserted location of the record.
@@ -34,9 +34,17 @@
 #ifndef PERSIST_CORE_STORAGE_BASE_HPP
 #define PERSIST_CORE_STORAGE_BASE_HPP
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_set>
 
+#include <persist/core/exceptions/storage.hpp>
 #include <persist/core/page/base.hpp>
+#include <persist/core/page/serializer.hpp>
+
+#include <persist/utility/mutex.hpp>
 
 // TODO: Add interface for segmenting storage. Instead of storing all the data
 // into one big chunk of persistent memory, split into multiple smaller chunks.
@@ -44,6 +52,20 @@
 
 namespace persist {
 
+/**
+ * @brief Page checksum verification policies
+ *
+ * - ALWAYS: The checksum is verified on every page load.
+ * - FIRST_LOAD: The checksum is verified on the first load of a page after the
+ *   storage is opened. Pages written since then are trusted.
+ * - SAMPLED: The checksum is verified on one in every sample interval loads.
+ * - NEVER: The checksum is never verified on page load.
+ *
+ * Pages not verified on load can still be verified in the background using a
+ * scrubber.
+ */
+enum class VerifyPolicy { ALWAYS, FIRST_LOAD, SAMPLED, NEVER };
+
 /**
  * @brief Storage Abstract Class
  *
@@ -68,6 +90,62 @@ template <class PageType> class Storage {
    */
   size_t page_count;
 
+  /**
+   * @brief Sorted set of identifiers of de-allocated pages available for
+   * re-use. A set is used so that the lowest free page ID is re-used first,
+   * keeping live pages packed towards the start of the storage.
+   *
+   */
+  std::set<PageId> free_pages;
+
+  /**
+   * @brief Checksum algorithm used to protect pages in storage. New storages
+   * use the algorithm selected for the CPU while persistent storages use the
+   * algorithm recorded in their header.
+   *
+   */
+  ChecksumType checksum_type;
+
+  /**
+   * @brief Lock guarding the verification state
+   *
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  Mutex verify_lock;
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+
+  /**
+   * @brief Verification policy state
+   *
+   */
+  VerifyPolicy verify_policy GUARDED_BY(verify_lock);
+  size_t sample_interval GUARDED_BY(verify_lock);
+  size_t load_count GUARDED_BY(verify_lock);
+  std::unordered_set<PageId> verified GUARDED_BY(verify_lock);
+
+  /**
+   * @brief Forget pages verified or written so far. Storages call this on open
+   * so that pages are verified on their first load after open.
+   */
+  void ForgetVerified() {
+    LockGuard guard(verify_lock);
+    verified.clear();
+  }
+
+  /**
+   * @brief Set the checksum algorithm recorded in a loaded storage header.
+   * Storages call this on open before any page is read.
+   *
+   * @param type checksum algorithm recorded in the header
+   * @throws StorageError if the checksum algorithm is unknown
+   */
+  void LoadChecksumType(ChecksumType type) {
+    if (!IsKnownChecksumType(type)) {
+      throw StorageError("Unknown checksum type in storage header.");
+    }
+    checksum_type = type;
+  }
+
 public:
   /**
    * @brief Construct a new Storage object.
@@ -75,7 +153,10 @@ public:
    * @param page_size Page size.
    */
   Storage(size_t page_size = DEFAULT_PAGE_SIZE)
-      : page_size(page_size), page_count(0) {}
+      : page_size(page_size), page_count(0),
+        checksum_type(DefaultChecksumType()),
+        verify_policy(VerifyPolicy::ALWAYS),
+        sample_interval(DEFAULT_VERIFY_SAMPLE_INTERVAL), load_count(0) {}
 
   /**
    * @brief Destroy the Storage object.
@@ -103,20 +184,174 @@ public:
    */
   virtual void Remove() = 0;
 
+  /**
+   * @brief Make all blocks written to storage durable. Storages without
+   * durable backing do nothing.
+   */
+  virtual void Sync() {}
+
+  /**
+   * @brief Read the raw block of page with given identifier from storage into
+   * the given memory. The block is read as stored, including the page
+   * checksum computed using the storage checksum algorithm. This allows
+   * callers like the buffer manager to read pages directly into memory they
+   * own and re-use.
+   *
+   * @param page_id Page identifier
+   * @param output Output buffer span of at least page size to read into
+   */
+  virtual void ReadBlock(PageId page_id, Span output) = 0;
+
+  /**
+   * @brief Write the raw block of page with given identifier to storage from
+   * the given memory. The block must be a dumped page image including the
+   * page checksum.
+   *
+   * @param page_id Page identifier
+   * @param input Input buffer span of at least page size to write from
+   */
+  virtual void WriteBlock(PageId page_id, Span input) = 0;
+
   /**
    * @brief Read Page with given identifier from storage.
    *
    * @param page_id Page identifier
    * @returns Unique pointer to Page object
    */
-  virtual std::unique_ptr<PageType> Read(PageId page_id) = 0;
+  virtual std::unique_ptr<PageType> Read(PageId page_id) {
+    ByteBuffer buffer(page_size);
+    ReadBlock(page_id, buffer);
+    std::unique_ptr<PageType> page = persist::LoadPage<PageType>(
+        buffer, checksum_type, IsVerifyRequired(page_id));
+    MarkVerified(page_id);
+    return page;
+  }
 
   /**
    * @brief Write Page object to storage.
    *
    * @param page reference to Page object to be written
    */
-  virtual void Write(PageType &page) = 0;
+  virtual void Write(PageType &page) {
+    ByteBuffer buffer(page_size);
+    persist::DumpPage(page, buffer, checksum_type);
+    WriteBlock(page.GetId(), buffer);
+    MarkVerified(page.GetId());
+  }
+
+  /**
+   * @brief Check if the storage keeps live page objects. Page objects are
+   * exchanged with such a storage by transfer of ownership using `Release` and
+   * `Adopt`, avoiding serialization.
+   *
+   * @returns `true` if the storage keeps page objects else `false`
+   */
+  virtual bool IsObjectStore() const { return false; }
+
+  /**
+   * @brief Release ownership of the page object with given identifier to the
+   * caller. Storages not keeping page objects return a loaded copy.
+   *
+   * @param page_id Page identifier
+   * @returns Unique pointer to Page object
+   */
+  virtual std::unique_ptr<PageType> Release(PageId page_id) {
+    return Read(page_id);
+  }
+
+  /**
+   * @brief Adopt ownership of the given page object. Storages not keeping page
+   * objects write the page.
+   *
+   * @param page Unique pointer to Page object
+   */
+  virtual void Adopt(std::unique_ptr<PageType> page) { Write(*page); }
+
+  /**
+   * @brief Get checksum verification policy.
+   */
+  VerifyPolicy GetVerifyPolicy() {
+    LockGuard guard(verify_lock);
+    return verify_policy;
+  }
+
+  /**
+   * @brief Set checksum verification policy.
+   *
+   * @param policy verification policy
+   */
+  void SetVerifyPolicy(VerifyPolicy policy) {
+    LockGuard guard(verify_lock);
+    verify_policy = policy;
+    verified.clear();
+  }
+
+  /**
+   * @brief Get number of page loads per checksum verification when sampling.
+   */
+  size_t GetVerifySampleInterval() {
+    LockGuard guard(verify_lock);
+    return sample_interval;
+  }
+
+  /**
+   * @brief Set number of page loads per checksum verification when sampling.
+   *
+   * @param interval number of page loads per verification
+   */
+  void SetVerifySampleInterval(size_t interval) {
+    LockGuard guard(verify_lock);
+    sample_interval = std::max<size_t>(interval, 1);
+  }
+
+  /**
+   * @brief Check if the checksum of the page with given identifier needs to be
+   * verified on load as per the verification policy. Each call is counted as a
+   * page load.
+   *
+   * @param page_id Page identifier
+   * @returns `true` if the checksum needs to be verified else `false`
+   */
+  bool IsVerifyRequired(PageId page_id) {
+    LockGuard guard(verify_lock);
+
+    switch (verify_policy) {
+    case VerifyPolicy::FIRST_LOAD:
+      return verified.find(page_id) == verified.end();
+    case VerifyPolicy::SAMPLED:
+      return load_count++ % sample_interval == 0;
+    case VerifyPolicy::NEVER:
+      return false;
+    default:
+      return true;
+    }
+  }
+
+  /**
+   * @brief Mark the page with given identifier as trusted after it has been
+   * verified or written. Only tracked for the first load policy.
+   *
+   * @param page_id Page identifier
+   */
+  void MarkVerified(PageId page_id) {
+    LockGuard guard(verify_lock);
+
+    if (verify_policy == VerifyPolicy::FIRST_LOAD) {
+      verified.insert(page_id);
+    }
+  }
+
+  /**
+   * @brief Check if the page with given identifier is de-allocated.
+   *
+   * @thread_unsafe
+   *
+   * @param page_id Page identifier
+   * @returns `true` if the page is free else `false`
+   */
+  bool IsFree(PageId page_id) const {
+    return free_pages.find(page_id) != free_pages.end();
+  }
 
   /**
    * @brief Get page size.
@@ -125,6 +360,13 @@ public:
    */
   size_t GetPageSize() const { return page_size; }
 
+  /**
+   * @brief Get checksum algorithm used to protect pages in storage.
+   *
+   * @returns Checksum algorithm used in storage
+   */
+  ChecksumType GetChecksumType() const { return checksum_type; }
+
   /**
    * @brief Get page count.
    *
@@ -132,13 +374,33 @@ public:
    */
   size_t GetPageCount() const { return page_count; }
 
+  /**
+   * @brief Get number of de-allocated pages available for re-use.
+   *
+   * @thread_unsafe
+   *
+   * @returns Number of free pages in storage
+   */
+  size_t GetFreePageCount() const { return free_pages.size(); }
+
   /**
    * @brief Allocate a new page in storage. The identifier of the newly created
-   * page is returned.
+   * page is returned. Previously de-allocated pages are re-used before the
+   * storage is extended.
+   *
+   * @thread_unsafe The free page list is not locked. Callers sharing a
+   * storage, like the buffer manager, serialize allocations. Storages
+   * allocating from background threads lock their overrides.
    *
    * @returns identifier of the newly allocated page
    */
-  PageId Allocate() {
+  virtual PageId Allocate() {
+    // Re-use the lowest de-allocated page if any
+    if (!free_pages.empty()) {
+      PageId page_id = *free_pages.begin();
+      free_pages.erase(free_pages.begin());
+      return page_id;
+    }
     // Increase page count by 1. No need to write an empty page to storage since
     // it will be automatically handled by buffer manager.
     page_count += 1;
@@ -146,12 +408,22 @@ public:
   }
 
   /**
-   * @brief Deallocate page with given identifier.
+   * @brief Deallocate page with given identifier. The page is added to the
+   * free page list and re-used by a later allocation. No operation is
+   * performed for the NULL page ID or IDs beyond the page count.
+   *
+   * NOTE: The caller must make sure the page is not loaded in any buffer
+   * before de-allocating it. The buffer manager does so in its `Deallocate`.
+   *
+   * @thread_unsafe The free page list is not locked. See `Allocate`.
    *
    * @param page_id identifier of the page to deallocate
    */
-  void Deallocate(PageId page_id) {
-    // TODO: No operation performed for now
+  virtual void Deallocate(PageId page_id) {
+    if (page_id == 0 || page_id > page_count) {
+      return;
+    }
+    free_pages.insert(page_id);
   }
 };
 
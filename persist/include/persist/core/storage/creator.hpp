@@ -25,14 +25,32 @@
 #ifndef PERSIST_CORE_STORAGE_CREATOR_HPP
 #define PERSIST_CORE_STORAGE_CREATOR_HPP
 
+#include <string>
+#include <unordered_map>
+
+#include <persist/core/exceptions/storage.hpp>
 #include <persist/core/storage/base.hpp>
 #include <persist/core/storage/file_storage.hpp>
+#include <persist/core/storage/log_structured_storage.hpp>
 #include <persist/core/storage/memory_storage.hpp>
+#include <persist/core/storage/segmented_file_storage.hpp>
 
 /**
  * Storage type seperator in connection string
  */
 #define STORAGE_TYPE_SEPERATOR "://"
+/**
+ * Arguments seperator in connection string
+ */
+#define STORAGE_ARGS_SEPERATOR "?"
+/**
+ * Seperator between two arguments in connection string
+ */
+#define STORAGE_ARG_SEPERATOR "&"
+/**
+ * Seperator between argument name and value in connection string
+ */
+#define STORAGE_ARG_VALUE_SEPERATOR "="
 
 namespace persist {
 
@@ -51,10 +69,25 @@ namespace persist {
  * - arg_1..n [optional]: Additional arguments
  * - val_1..n [optional]: Values associated with the additional arguments
  *
- * NOTE: Currently simple parser is implemented which just detects the `type`.
+ * Supported arguments:
+ * - punch_threshold [file]: Minimum run of free pages for which a hole is
+ *   punched in the storage file. Hole punching is disabled by default.
+ * - segment_size [segment, lss]: Size in bytes of each segment file. Default
+ *   set to 1 GiB for segment and 64 MiB for lss.
+ * - clean_threshold [lss]: Fraction of live pages below which a segment is
+ *   cleaned. Default set to 0.5.
+ * - clean_interval [lss]: Interval in milliseconds between background
+ *   cleaner runs. Set to 0 to disable the cleaner. Default set to 1000.
+ * - mode [memory]: Storage mode, either `serialized` or `object`. In object
+ *   mode page objects are kept without serialization. Default set to
+ *   `serialized`.
+ * - verify [all]: Page checksum verification policy on load, one of `always`,
+ *   `first_load`, `sampled` or `never`. Default set to `always`.
+ * - verify_sample_interval [all]: Number of page loads per checksum
+ *   verification for the `sampled` policy. Default set to 16.
  *
  * TODO:
- *  - Prase arguments like `pageSize`.
+ *  - Support arguments like `pageSize`.
  *  - Exception for incorrectly formated connection string.
  */
 class ConnectionString {
@@ -62,6 +95,7 @@ public:
   std::string raw;
   std::string type;
   std::string path;
+  std::unordered_map<std::string, std::string> args;
 
   // Constructor
   ConnectionString(const std::string &connection_string)
@@ -70,6 +104,69 @@ public:
     std::string::size_type loc = raw.find(seperator);
     type = raw.substr(0, loc);
     path = raw.substr(loc + seperator.size());
+
+    // Parse arguments
+    std::string::size_type args_loc = path.find(STORAGE_ARGS_SEPERATOR);
+    if (args_loc != std::string::npos) {
+      std::string _args = path.substr(args_loc + 1);
+      path = path.substr(0, args_loc);
+      std::string::size_type start = 0;
+      while (start < _args.size()) {
+        std::string::size_type end = _args.find(STORAGE_ARG_SEPERATOR, start);
+        if (end == std::string::npos) {
+          end = _args.size();
+        }
+        std::string arg = _args.substr(start, end - start);
+        std::string::size_type value_loc =
+            arg.find(STORAGE_ARG_VALUE_SEPERATOR);
+        if (value_loc != std::string::npos) {
+          args[arg.substr(0, value_loc)] = arg.substr(value_loc + 1);
+        } else if (!arg.empty()) {
+          args[arg] = "";
+        }
+        start = end + 1;
+      }
+    }
+  }
+
+  /**
+   * @brief Check if argument with given name is present.
+   *
+   * @param name name of the argument
+   */
+  bool Has(const std::string &name) const {
+    return args.find(name) != args.end();
+  }
+
+  /**
+   * @brief Get the value of argument with given name.
+   *
+   * @param name name of the argument
+   * @returns value of the argument
+   */
+  const std::string &Get(const std::string &name) const {
+    return args.at(name);
+  }
+
+  /**
+   * @brief Get the value of argument with given name out of the given values
+   * it can take.
+   *
+   * @param name name of the argument
+   * @param values values of the argument mapped to their names
+   * @returns value of the argument
+   * @throws StorageError if the argument has none of the given values
+   */
+  template <class T>
+  T Get(const std::string &name,
+        const std::unordered_map<std::string, T> &values) const {
+    auto it = values.find(Get(name));
+    if (it == values.end()) {
+      std::string msg = "Unknown value '" + Get(name) + "' of argument '" +
+                        name + "' in connection string.";
+      throw StorageError(msg);
+    }
+    return it->second;
   }
 };
 
@@ -78,9 +175,28 @@ public:
 /**
  * @brief Supported Backend Storages
  */
-enum class StorageType { FILE, MEMORY };
+enum class StorageType { FILE, MEMORY, SEGMENT, LOG_STRUCTURED };
 const std::unordered_map<std::string, StorageType> StorageTypeMap = {
-    {"file", StorageType::FILE}, {"memory", StorageType::MEMORY}};
+    {"file", StorageType::FILE},
+    {"memory", StorageType::MEMORY},
+    {"segment", StorageType::SEGMENT},
+    {"lss", StorageType::LOG_STRUCTURED}};
+
+/**
+ * @brief Supported Memory Storage Modes
+ */
+const std::unordered_map<std::string, MemoryStorageMode> MemoryStorageModeMap =
+    {{"serialized", MemoryStorageMode::SERIALIZED},
+     {"object", MemoryStorageMode::OBJECT}};
+
+/**
+ * @brief Supported Checksum Verification Policies
+ */
+const std::unordered_map<std::string, VerifyPolicy> VerifyPolicyMap = {
+    {"always", VerifyPolicy::ALWAYS},
+    {"first_load", VerifyPolicy::FIRST_LOAD},
+    {"sampled", VerifyPolicy::SAMPLED},
+    {"never", VerifyPolicy::NEVER}};
 
 /**
  * @brief Factory method to create backend storage object
@@ -89,6 +205,13 @@ const std::unordered_map<std::string, StorageType> StorageTypeMap = {
  * arguments. The url schema is `<type>://<host>/<path>?<args>`. For example a
  * file storage url looks like `file:///myCollection.db` where the backend
  * uses the file `myCollection.db` in the root folder `/` to store data.
+ * Optional arguments are passed as query parameters, for example
+ * `file:///myCollection.db?punch_threshold=64`. A segmented file storage
+ * splitting pages across multiple files uses the `segment` type, for example
+ * `segment:///myCollection.db?segment_size=1073741824`. A log-structured
+ * storage appending page writes to segment files uses the `lss` type, for
+ * example `lss:///myCollection.db?clean_threshold=0.25`. A memory storage
+ * keeping page objects without serialization uses `memory://?mode=object`.
  *
  * @tparam PageType The type of page stored by the created storage.
  */
@@ -97,13 +220,67 @@ static std::unique_ptr<Storage<PageType>>
 CreateStorage(std::string connection_string) {
   ConnectionString _connection_string(connection_string);
 
+  std::unique_ptr<Storage<PageType>> storage;
   switch (StorageTypeMap.at(_connection_string.type)) {
-  case StorageType::FILE:
-    return std::make_unique<FileStorage<PageType>>(_connection_string.path);
+  case StorageType::FILE: {
+    auto file_storage =
+        std::make_unique<FileStorage<PageType>>(_connection_string.path);
+    if (_connection_string.Has("punch_threshold")) {
+      file_storage->SetPunchThreshold(
+          std::stoull(_connection_string.Get("punch_threshold")));
+    }
+    storage = std::move(file_storage);
+    break;
+  }
+  case StorageType::MEMORY: {
+    MemoryStorageMode mode = MemoryStorageMode::SERIALIZED;
+    if (_connection_string.Has("mode")) {
+      mode = _connection_string.Get("mode", MemoryStorageModeMap);
+    }
+    storage =
+        std::make_unique<MemoryStorage<PageType>>(DEFAULT_PAGE_SIZE, mode);
+    break;
+  }
+  case StorageType::SEGMENT: {
+    uint64_t segment_size = DEFAULT_SEGMENT_SIZE;
+    if (_connection_string.Has("segment_size")) {
+      segment_size = std::stoull(_connection_string.Get("segment_size"));
+    }
+    storage = std::make_unique<SegmentedFileStorage<PageType>>(
+        _connection_string.path, DEFAULT_PAGE_SIZE, segment_size);
     break;
-  case StorageType::MEMORY:
-    return std::make_unique<MemoryStorage<PageType>>();
   }
+  case StorageType::LOG_STRUCTURED: {
+    uint64_t segment_size = DEFAULT_LOG_SEGMENT_SIZE;
+    if (_connection_string.Has("segment_size")) {
+      segment_size = std::stoull(_connection_string.Get("segment_size"));
+    }
+    auto log_storage = std::make_unique<LogStructuredStorage<PageType>>(
+        _connection_string.path, DEFAULT_PAGE_SIZE, segment_size);
+    if (_connection_string.Has("clean_threshold")) {
+      log_storage->SetCleanThreshold(
+          std::stod(_connection_string.Get("clean_threshold")));
+    }
+    if (_connection_string.Has("clean_interval")) {
+      log_storage->SetCleanInterval(
+          std::stoull(_connection_string.Get("clean_interval")));
+    }
+    storage = std::move(log_storage);
+    break;
+  }
+  }
+
+  // Checksum verification policy applies to all storages
+  if (_connection_string.Has("verify")) {
+    storage->SetVerifyPolicy(
+        _connection_string.Get("verify", VerifyPolicyMap));
+  }
+  if (_connection_string.Has("verify_sample_interval")) {
+    storage->SetVerifySampleInterval(
+        std::stoull(_connection_string.Get("verify_sample_interval")));
+  }
+
+  return storage;
 }
 
 } // namespace persist
@@ -31,16 +31,31 @@
 
 #include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <persist/core/exceptions/storage.hpp>
+#include <persist/core/fixed_storable.hpp>
 #include <persist/core/page/serializer.hpp>
 #include <persist/core/storage/base.hpp>
 
+#include <persist/utility/mutex.hpp>
 #include <persist/utility/serializer.hpp>
 
 #define FILE_STORAGE_DATA_FILE_EXTENTION ".stg"
+#define FILE_STORAGE_FREE_LIST_FILE_EXTENTION ".fpl"
 
 namespace persist {
 
@@ -58,7 +73,7 @@ namespace file {
  * @param mode open mode
  * @returns opened file stream object
  */
-static std::fstream open(std::string path, std::ios_base::openmode mode) {
+inline std::fstream open(std::string path, std::ios_base::openmode mode) {
   // TODO: Use cross-platform solution for creating sub-directories
   std::fstream file;
   // Creating file if it does not exist
@@ -75,7 +90,7 @@ static std::fstream open(std::string path, std::ios_base::openmode mode) {
  * @param file opened file stream object
  * @returns size of the file
  */
-static size_t size(std::fstream &file) {
+inline size_t size(std::fstream &file) {
   std::streampos file_size;
   file.seekg(0, std::ios_base::end);
   file_size = file.tellg();
@@ -85,44 +100,268 @@ static size_t size(std::fstream &file) {
 }
 
 /**
- * Read file content starting at given postion into a ByteBuffer. The amount of
- * data read is determined by the size of the passed ByteBuffer.
+ * Read file content starting at given postion into a buffer span. The amount
+ * of data read is determined by the size of the passed span.
  *
  * Note:
- * - If the size of the ByteBuffer is zero then no data will be read.
- * - The content of the ByteBuffer will be overwritten
+ * - If the size of the span is zero then no data will be read.
+ * - The content of the span will be overwritten
  *
  * @param file opened file stream object
- * @param buffer reference to the ByteBuffer where read data is stored
+ * @param buffer span of the buffer where read data is stored
  * @param offset offset within the file from where to start reading
  */
-static void read(std::fstream &file, ByteBuffer &buffer,
-                 std::streampos offset) {
+inline void read(std::fstream &file, Span buffer, std::streampos offset) {
   // Get current position of the stream cursor before moving
   std::streampos original = file.tellg();
   file.seekg(offset);
-  file.read(reinterpret_cast<char *>(&buffer[0]), buffer.size());
+  file.read(reinterpret_cast<char *>(buffer.start), buffer.size);
   // Place the moved cursor back to its original postion
   file.seekg(original);
 }
 
 /**
- * Write given ByteBuffer to file starting at specifed offset.
+ * Write given buffer span to file starting at specifed offset.
  *
  * @param file opened file stream object
- * @param buffer reference to the ByteBuffer from which data is stored
+ * @param buffer span of the buffer from which data is stored
  * @param offset offset within the file from where to start writing
  */
-static void write(std::fstream &file, ByteBuffer &buffer,
-                  std::streampos offset) {
+inline void write(std::fstream &file, Span buffer, std::streampos offset) {
   // Get current position of the stream cursor before moving
   std::streampos original = file.tellg();
   file.seekg(offset);
-  file.write(reinterpret_cast<char *>(&buffer[0]), buffer.size());
+  file.write(reinterpret_cast<char *>(buffer.start), buffer.size);
   // Place the moved cursor back to its original postion
   file.seekg(original);
 }
 
+/**
+ * Punch a hole of given size in the file starting at specified offset. The
+ * file size remains unchanged while the filesystem releases the space used by
+ * the punched range. Reading from a punched range returns zeros.
+ *
+ * NOTE: Hole punching is only supported on Linux. On other platforms, or
+ * filesystems without support, no operation is performed.
+ *
+ * @param path path of the file
+ * @param offset offset within the file from where to start punching
+ * @param size size of the range to punch
+ * @returns `true` if the hole was punched else `false`
+ */
+inline bool punch(const std::string &path, size_t offset, size_t size) {
+#if defined(__linux__) && defined(FALLOC_FL_PUNCH_HOLE)
+  int fd = ::open(path.c_str(), O_WRONLY);
+  if (fd < 0) {
+    return false;
+  }
+  int rvalue = ::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                           offset, size);
+  ::close(fd);
+  return rvalue == 0;
+#else
+  return false;
+#endif
+}
+
+/**
+ * List numbers of the existing files named by a common prefix followed by an
+ * underscore, a number and an extension, i.e. `<prefix>_<number><extension>`.
+ *
+ * NOTE: On platforms other than Linux the numbers are probed in order starting
+ * from `0`, so files after the first missing number are not listed.
+ *
+ * @param prefix path prefix of the files
+ * @param extension extension of the files
+ * @returns ordered set of the file numbers
+ */
+inline std::set<uint64_t> list_numbered(const std::string &prefix,
+                                        const std::string &extension) {
+  std::set<uint64_t> numbers;
+#ifdef __linux__
+  size_t separator = prefix.find_last_of('/');
+  std::string directory =
+      separator == std::string::npos ? "." : prefix.substr(0, separator + 1);
+  std::string name = (separator == std::string::npos
+                          ? prefix
+                          : prefix.substr(separator + 1)) +
+                     "_";
+  DIR *dir = ::opendir(directory.c_str());
+  if (dir == nullptr) {
+    return numbers;
+  }
+  while (struct dirent *entry = ::readdir(dir)) {
+    std::string entry_name = entry->d_name;
+    if (entry_name.size() <= name.size() + extension.size() ||
+        entry_name.compare(0, name.size(), name) != 0 ||
+        entry_name.compare(entry_name.size() - extension.size(),
+                           extension.size(), extension) != 0) {
+      continue;
+    }
+    std::string number = entry_name.substr(
+        name.size(), entry_name.size() - name.size() - extension.size());
+    if (number.find_first_not_of("0123456789") == std::string::npos) {
+      numbers.insert(std::stoull(number));
+    }
+  }
+  ::closedir(dir);
+#else
+  for (uint64_t number = 0;
+       std::ifstream(prefix + "_" + std::to_string(number) + extension).good();
+       ++number) {
+    numbers.insert(number);
+  }
+#endif
+  return numbers;
+}
+
+/**
+ * Sync written data of the file at given path to durable media. Data buffered
+ * in file streams of the file is not written out.
+ *
+ * NOTE: On platforms other than Linux all data and metadata of the file is
+ * synced. On platforms without POSIX file sync the file can not be synced and
+ * `false` is always returned.
+ *
+ * @param path path of the file
+ * @returns `true` if the file was synced else `false`
+ */
+inline bool sync(const std::string &path) {
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+  int fd = ::open(path.c_str(), O_WRONLY);
+  if (fd < 0) {
+    return false;
+  }
+#ifdef __linux__
+  int rvalue = ::fdatasync(fd);
+#else
+  int rvalue = ::fsync(fd);
+#endif
+  ::close(fd);
+  return rvalue == 0;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Sync written data of the file at given path to durable media. Data buffered
+ * in the file stream is written out first.
+ *
+ * NOTE: On platforms without POSIX file sync the file can not be synced and
+ * `false` is always returned.
+ *
+ * @param file reference to the file stream
+ * @param path path of the file
+ * @returns `true` if the file was synced else `false`
+ */
+inline bool sync(std::fstream &file, const std::string &path) {
+  // Write out buffered data before syncing
+  file.flush();
+  return sync(path);
+}
+
+/**
+ * Sync the directory containing the file at given path to durable media, so
+ * that files created in or renamed into the directory are not lost.
+ *
+ * NOTE: On platforms without POSIX file sync the directory can not be synced
+ * and `false` is always returned.
+ *
+ * @param path path of the file in the directory
+ * @returns `true` if the directory was synced else `false`
+ */
+inline bool sync_directory(const std::string &path) {
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+  size_t separator = path.find_last_of('/');
+  std::string directory =
+      separator == std::string::npos ? "." : path.substr(0, separator + 1);
+  int fd = ::open(directory.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  int rvalue = ::fsync(fd);
+  ::close(fd);
+  return rvalue == 0;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Preallocate space on the filesystem for the file at given path so that it is
+ * at least of the given size. The file is created if it does not exist.
+ *
+ * NOTE: On platforms other than Linux the file is only extended to the given
+ * size without allocating space.
+ *
+ * @param path path of the file
+ * @param size size of the file in bytes
+ * @returns `true` if the space was allocated else `false`
+ */
+inline bool allocate(const std::string &path, size_t size) {
+#ifdef __linux__
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  int rvalue = ::posix_fallocate(fd, 0, size);
+  ::close(fd);
+  return rvalue == 0;
+#else
+  std::fstream file =
+      open(path, std::ios::binary | std::ios::in | std::ios::out);
+  if (size > 0 && file::size(file) < size) {
+    Byte byte = 0;
+    write(file, Span(&byte, 1), size - 1);
+  }
+  return file.good();
+#endif
+}
+
+/**
+ * Load set of page identifiers stored in the file at given path. The file is
+ * truncated after loading so that a stale set is never loaded twice, for
+ * example after a crash.
+ *
+ * @param path path of the file
+ * @param page_ids reference to the set to load page identifiers into
+ */
+inline void load_page_ids(const std::string &path,
+                          std::set<PageId> &page_ids) {
+  std::fstream file = open(path, std::ios::binary | std::ios::in);
+  size_t file_size = size(file);
+  page_ids.clear();
+  if (file_size != 0) {
+    ByteBuffer buffer(file_size);
+    read(file, buffer, 0);
+    Span span(buffer);
+    persist::load(span, page_ids);
+  }
+  file.close();
+  // Truncate file
+  open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+}
+
+/**
+ * Dump set of page identifiers to the file at given path. Any existing content
+ * of the file is replaced.
+ *
+ * @param path path of the file
+ * @param page_ids reference to the set of page identifiers to dump
+ */
+inline void dump_page_ids(const std::string &path,
+                          const std::set<PageId> &page_ids) {
+  std::fstream file =
+      open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+  if (!page_ids.empty()) {
+    ByteBuffer buffer(sizeof(size_t) + sizeof(PageId) * page_ids.size());
+    Span span(buffer);
+    persist::dump(span, page_ids);
+    write(file, buffer, 0);
+  }
+}
+
 } // namespace file
 
 /************************************************************/
@@ -134,35 +373,32 @@ static void write(std::fstream &file, ByteBuffer &buffer,
 /**
  * @brief File Header
  *
- * The file header contains basic information about the storage file.
+ * The file header contains basic information about the storage file. The
+ * header takes up 16 bytes, the page size followed by the checksum algorithm
+ * and 4 reserved bytes. The checksum algorithm is stored as a 32-bit integer
+ * like in the other storage headers. Files created before pluggable checksums
+ * have the checksum bytes set to 0, that is Alder-32.
  */
-struct FileHeader : public Storable {
-  size_t page_size; //<- page size used in the storage file
-
-  /**
-   * @brief Get the storage size of header.
-   *
-   */
-  size_t GetStorageSize() const override { return sizeof(FileHeader); }
+struct FileHeader : public FixedStorable<FileHeader, StorageError> {
+  size_t page_size;           //<- page size used in the storage file
+  ChecksumType checksum_type; //<- checksum algorithm used in the storage file
+  uint32_t reserved;          //<- reserved bytes padding header to 16 bytes
 
   /**
-   * Load object from byte string
+   * @brief Construct a new FileHeader object
    *
-   * @param input input buffer span to load
    */
-  void Load(Span input) override {
-    // Load bytes
-    persist::load(input, page_size);
-  }
+  FileHeader()
+      : page_size(0), checksum_type(ChecksumType::ALDER32), reserved(0) {}
 
   /**
-   * Dump object as byte string
+   * @brief Get the stored fields of the header.
    *
-   * @param output output buffer span to dump
    */
-  void Dump(Span output) override {
-    // Dump bytes
-    persist::dump(output, page_size);
+  auto GetFields() {
+    return std::make_tuple(std::ref(page_size),
+                           stored_as<uint32_t>(checksum_type),
+                           std::ref(reserved));
   }
 
 #ifdef __PERSIST_DEBUG__
@@ -173,6 +409,8 @@ struct FileHeader : public Storable {
                                   const FileHeader &file_header) {
     os << "--------- FileHeader ---------\n";
     os << "Page Size: " << file_header.page_size << "\n";
+    os << "Checksum Type: "
+       << static_cast<uint32_t>(file_header.checksum_type) << "\n";
     os << "----------------------------";
     return os;
   }
@@ -185,17 +423,55 @@ struct FileHeader : public Storable {
  * The class implements Block IO operations for a file stored on
  * a local disk. This is the default storage used by the package.
  *
+ * De-allocated pages are tracked in a free page list which is persisted in a
+ * separate file on close. The list is only trusted after a clean close; on
+ * open the persisted list is loaded and the file truncated so that a crash
+ * can at most leak free pages but never hand out a page which is in use.
+ * Optionally, holes can be punched in the data file for long runs of free
+ * pages so that the filesystem reclaims the space.
+ *
  * @tparam PageType The type of page stored by storage.
  */
-template <class PageType> class FileStorage : public Storage<PageType> {
+template <class PageType>
+class FileStorage final : public Storage<PageType> {
   using Storage<PageType>::page_size;
   using Storage<PageType>::page_count;
+  using Storage<PageType>::free_pages;
+  using Storage<PageType>::checksum_type;
 
   PERSIST_PRIVATE
-  std::string path;       //<- Storage path
-  std::fstream data_file; //<- IO file stream for data
+  /**
+   * @brief Lock guarding IO on the data file stream so that the storage can be
+   * synced while blocks are read and written.
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+  Mutex lock;
+
+  std::string path;                         //<- Storage path
+  std::fstream data_file GUARDED_BY(lock); //<- IO file stream for data
   static const size_t offset =
-      sizeof(FileHeader); //<- Offset after which pages are stored
+      2 * sizeof(uint64_t); //<- Offset after which pages are stored
+  size_t punch_threshold; //<- Minimum run of free pages to punch a hole for
+
+  /**
+   * @brief Load persisted free page list. The free list file is truncated
+   * after loading so that a stale list is never used after a crash.
+   */
+  void LoadFreePages() {
+    file::load_page_ids(path + FILE_STORAGE_FREE_LIST_FILE_EXTENTION,
+                        free_pages);
+    // Drop page IDs not backed by the data file
+    free_pages.erase(free_pages.upper_bound(page_count), free_pages.end());
+  }
+
+  /**
+   * @brief Persist free page list.
+   */
+  void DumpFreePages() {
+    file::dump_page_ids(path + FILE_STORAGE_FREE_LIST_FILE_EXTENTION,
+                        free_pages);
+  }
 
 public:
   /**
@@ -208,12 +484,12 @@ public:
    * @param path path to storage file
    * @param page_size storage size of data block. Default set to 1024
    */
-  FileStorage(const std::string &path) : path(path) {}
-  FileStorage(const char *path) : path(path) {}
+  FileStorage(const std::string &path) : path(path), punch_threshold(0) {}
+  FileStorage(const char *path) : path(path), punch_threshold(0) {}
   FileStorage(const std::string &path, uint64_t page_size)
-      : path(path), Storage<PageType>(page_size) {}
+      : path(path), Storage<PageType>(page_size), punch_threshold(0) {}
   FileStorage(const char *path, uint64_t page_size)
-      : path(path), Storage<PageType>(page_size) {}
+      : path(path), Storage<PageType>(page_size), punch_threshold(0) {}
 
   /**
    * Destructor
@@ -228,10 +504,26 @@ public:
    */
   std::string GetPath() const { return path; }
 
+  /**
+   * @brief Get the minimum number of contiguous free pages for which a hole is
+   * punched in the data file. A value of 0 means hole punching is disabled.
+   */
+  size_t GetPunchThreshold() const { return punch_threshold; }
+
+  /**
+   * @brief Set the minimum number of contiguous free pages for which a hole is
+   * punched in the data file. Set to 0 to disable hole punching.
+   *
+   * @param threshold minimum run of free pages
+   */
+  void SetPunchThreshold(size_t threshold) { punch_threshold = threshold; }
+
   /**
    * Opens storage file.
    */
   void Open() override {
+    LockGuard guard(lock);
+
     data_file = file::open(path + FILE_STORAGE_DATA_FILE_EXTENTION,
                            std::ios::binary | std::ios::in | std::ios::out);
 
@@ -245,6 +537,8 @@ public:
       // Load header
       file::read(data_file, buffer, 0);
       header.Load(buffer);
+      // Pages are verified using the checksum algorithm they were written with
+      Storage<PageType>::LoadChecksumType(header.checksum_type);
       // Set page size value to that obtained from file header
       // TODO: Maybe we need to log warning or throw exception for incompatible
       // page size
@@ -258,23 +552,37 @@ public:
     } else {
       // Write header
       header.page_size = page_size;
+      header.checksum_type = checksum_type;
       header.Dump(buffer);
       file::write(data_file, buffer, 0);
     }
+
+    // Load list of free pages
+    LoadFreePages();
+    // Pages are verified on first load after open
+    Storage<PageType>::ForgetVerified();
   }
 
   /**
    * Checks if storage file is open
    */
-  bool IsOpen() override { return data_file.is_open(); }
+  bool IsOpen() override {
+    LockGuard guard(lock);
+    return data_file.is_open();
+  }
 
   /**
    * Closes opened storage file. No operation is performed if
    * no file is opened.
    */
   void Close() override {
-    // Close storage file if opened
-    data_file.close();
+    LockGuard guard(lock);
+
+    // Persist free page list and close storage file if opened
+    if (data_file.is_open()) {
+      DumpFreePages();
+      data_file.close();
+    }
   }
 
   /**
@@ -283,56 +591,129 @@ public:
   void Remove() override {
     Close();
     std::remove((path + FILE_STORAGE_DATA_FILE_EXTENTION).c_str());
+    std::remove((path + FILE_STORAGE_FREE_LIST_FILE_EXTENTION).c_str());
+    free_pages.clear();
   }
 
   /**
-   * Reads Page with given identifier from storage file.
+   * Reads block of page with given identifier from storage file directly into
+   * the given memory. No intermediate buffer is allocated.
    *
    * @param page_id page identifier
-   * @returns pointer to requested Page object
+   * @param output output buffer span to read the page block into
    */
-  std::unique_ptr<PageType> Read(PageId page_id) override {
+  void ReadBlock(PageId page_id, Span output) override {
+    // Page ID of 0 is considered NULL
+    if (page_id == 0) {
+      throw PageNotFoundError(page_id);
+    }
+    if (output.size < page_size) {
+      throw StorageError("Buffer too small to read page.");
+    }
+
     // The page ID and page_size is used to compute the offset of the page in
     // the file.
     size_t page_offset = offset + page_size * (page_id - 1);
 
-    // If offset is negative that means page_id is 0 so return null pointer.
-    // This is because page_id of 0 is considered NULL.
-    if (page_offset < 0) {
-      return nullptr;
-    }
+    LockGuard guard(lock);
 
     // Check if page offset is greater than equal to the file size.
     if (page_offset >= file::size(data_file)) {
       throw PageNotFoundError(page_id);
     }
 
-    ByteBuffer buffer;
-    buffer.resize(page_size);
-    file::read(data_file, buffer, page_offset);
-
-    return persist::LoadPage<PageType>(buffer);
+    file::read(data_file, Span(output.start, page_size), page_offset);
   }
 
   /**
-   * Writes Page to storage file.
+   * Writes block of page with given identifier to storage file directly from
+   * the given memory.
    *
-   * @param page reference to Page object to be written
+   * @param page_id page identifier
+   * @param input input buffer span of the page block to write
    */
-  void Write(PageType &page) override {
-    // The block ID and blockSize is used to compute the offset of the block
-    // in the file.
-    size_t page_offset = offset + page_size * (page.GetId() - 1);
-
-    // If offset is negative that means blockId is 0 so return. This is because
-    // blockId of 0 is considered NULL.
-    if (page_offset < 0) {
+  void WriteBlock(PageId page_id, Span input) override {
+    // Page ID of 0 is considered NULL
+    if (page_id == 0) {
       throw StorageError("Can not write page with invalid ID.");
     }
+    if (input.size < page_size) {
+      throw StorageError("Buffer too small to write page.");
+    }
+
+    // The page ID and page_size is used to compute the offset of the page in
+    // the file.
+    size_t page_offset = offset + page_size * (page_id - 1);
+
+    LockGuard guard(lock);
+    file::write(data_file, Span(input.start, page_size), page_offset);
+  }
 
-    ByteBuffer buffer(page_size);
-    persist::DumpPage(page, buffer);
-    file::write(data_file, buffer, page_offset);
+  /**
+   * Syncs written data of the storage file to durable media. Only buffered
+   * data is written out under the lock, so that blocks can be read and written
+   * while the file is synced.
+   *
+   * @thread_safe
+   */
+  void Sync() override {
+    {
+      LockGuard guard(lock);
+      if (!data_file.is_open()) {
+        return;
+      }
+      // Write out buffered data before syncing
+      data_file.flush();
+    }
+    if (!file::sync(path + FILE_STORAGE_DATA_FILE_EXTENTION)) {
+      throw StorageError("Failed to sync storage file.");
+    }
+  }
+
+  /**
+   * Deallocate page with given identifier. If hole punching is enabled and the
+   * page is part of a run of free pages at least as long as the threshold, a
+   * hole is punched for the pages of the run not punched yet. Runs as long as
+   * the threshold are punched when they reach it, so only the page and the
+   * shorter runs it joins are punched.
+   *
+   * @param page_id identifier of the page to deallocate
+   */
+  void Deallocate(PageId page_id) override {
+    Storage<PageType>::Deallocate(page_id);
+
+    auto it = free_pages.find(page_id);
+    if (punch_threshold == 0 || it == free_pages.end()) {
+      return;
+    }
+    // Count free pages adjacent to the page up to the threshold on each side
+    size_t before = 0, after = 0;
+    for (auto prev = std::make_reverse_iterator(it);
+         before < punch_threshold && prev != free_pages.rend() &&
+         *prev == page_id - before - 1;
+         ++prev) {
+      ++before;
+    }
+    for (auto next = std::next(it);
+         after < punch_threshold && next != free_pages.end() &&
+         *next == page_id + after + 1;
+         ++next) {
+      ++after;
+    }
+    if (before + after + 1 < punch_threshold) {
+      return;
+    }
+    // Punch hole for the page and adjacent runs shorter than the threshold
+    PageId first = before < punch_threshold ? page_id - before : page_id;
+    PageId last = after < punch_threshold ? page_id + after : page_id;
+    // Write out any buffered data before punching
+    {
+      LockGuard guard(lock);
+      data_file.flush();
+    }
+    file::punch(path + FILE_STORAGE_DATA_FILE_EXTENTION,
+                offset + page_size * (first - 1),
+                page_size * (last - first + 1));
   }
 };
 
@@ -0,0 +1,802 @@
+/**
+ * log_structured_storage.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Log-Structured Storage
+ */
+
+#ifndef PERSIST_CORE_LOG_STRUCTURED_STORAGE_HPP
+#define PERSIST_CORE_LOG_STRUCTURED_STORAGE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <persist/core/exceptions/storage.hpp>
+#include <persist/core/fixed_storable.hpp>
+#include <persist/core/storage/base.hpp>
+#include <persist/core/storage/file_storage.hpp>
+
+#include <persist/utility/mutex.hpp>
+#include <persist/utility/serializer.hpp>
+
+#define LOG_STRUCTURED_STORAGE_SEGMENT_FILE_EXTENTION ".lss"
+#define LOG_STRUCTURED_STORAGE_CHECKPOINT_FILE_EXTENTION ".lsc"
+
+// Default fraction of live pages below which a segment is cleaned
+#define DEFAULT_LOG_CLEAN_THRESHOLD 0.5
+// Default interval in milliseconds between runs of the segment cleaner
+#define DEFAULT_LOG_CLEAN_INTERVAL 1000
+// Number of records relocated by the segment cleaner at a time
+#define LOG_STRUCTURED_STORAGE_CLEAN_BATCH_SIZE 64
+
+namespace persist {
+
+/**
+ * @brief Log-Structured Storage Header
+ *
+ * The header contains basic information about the storage. It is stored at the
+ * start of the checkpoint file followed by the page map and free page list.
+ */
+struct LogStructuredHeader
+    : public FixedStorable<LogStructuredHeader, StorageError> {
+  size_t page_size;            //<- page size used in the storage
+  size_t segment_record_count; //<- number of page records in each segment
+  size_t page_count;           //<- number of pages at checkpoint
+  uint64_t active_segment;     //<- segment being appended at checkpoint
+  size_t active_record_count;  //<- records in active segment at checkpoint
+  ChecksumType checksum_type;  //<- checksum algorithm used in the storage
+
+  /**
+   * @brief Get the stored fields of the header.
+   *
+   */
+  auto GetFields() {
+    return std::make_tuple(std::ref(page_size), std::ref(segment_record_count),
+                           std::ref(page_count), std::ref(active_segment),
+                           std::ref(active_record_count),
+                           stored_as<uint32_t>(checksum_type));
+  }
+};
+
+/**
+ * Log-Structured Storage Class
+ *
+ * The class implements Block IO operations by appending page writes to the end
+ * of the active segment file, turning random page updates into sequential
+ * writes. Each page record in a segment is the page ID followed by the page
+ * block. An in-memory map tracks the location of the latest record of each
+ * page.
+ *
+ * The page map is checkpointed to a file on close or on demand. On open the
+ * checkpoint is loaded and records appended after it are replayed to bring the
+ * map up to date.
+ *
+ * Overwritten and de-allocated pages leave dead records behind. A background
+ * cleaner periodically re-appends the live pages of segments whose fraction of
+ * live records is below a threshold, and removes those segment files. The
+ * re-appended records are checkpointed before any segment file is removed.
+ * The cleaner relocates a batch of records at a time and syncs files without
+ * holding the storage lock, so that page IO is not blocked while cleaning.
+ *
+ * @tparam PageType The type of page stored by storage.
+ */
+template <class PageType>
+class LogStructuredStorage final : public Storage<PageType> {
+  using Storage<PageType>::page_size;
+  using Storage<PageType>::page_count;
+  using Storage<PageType>::free_pages;
+  using Storage<PageType>::checksum_type;
+
+  PERSIST_PRIVATE
+  /**
+   * @brief Lock for thread safety
+   *
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+
+  /**
+   * Location Struct
+   *
+   * The location of a page record in storage.
+   */
+  struct Location {
+    uint64_t segment; //<- segment number
+    uint64_t record;  //<- index of record in the segment
+  };
+
+  /**
+   * Segment Struct
+   *
+   * The data structure contains the file stream and bookkeeping of a segment.
+   */
+  struct Segment {
+    std::fstream file;   //<- IO file stream for segment
+    size_t record_count; //<- number of records appended to segment
+    size_t live_count;   //<- number of records which are latest for a page
+
+    /**
+     * @brief Construct a new Segment object
+     *
+     */
+    Segment() : record_count(0), live_count(0) {}
+  };
+
+  Mutex lock; //<- lock for achieving thread safety via mutual exclusion
+  Mutex checkpoint_lock; //<- lock serializing checkpoints and cleaning
+  std::string path;            //<- Storage path
+  size_t segment_size;         //<- Requested size of a segment in bytes
+  size_t segment_record_count; //<- Number of page records in each segment
+  std::unordered_map<PageId, Location>
+      page_map GUARDED_BY(lock); //<- Location of latest record of each page
+  std::map<uint64_t, Segment> segments GUARDED_BY(lock); //<- Open segments
+  uint64_t active_segment GUARDED_BY(lock); //<- Segment being appended
+  bool open GUARDED_BY(lock); //<- Flag indicating storage is open
+
+  double clean_threshold; //<- Live fraction below which segment is cleaned
+  size_t clean_interval;  //<- Interval in milliseconds between cleaner runs
+  std::thread cleaner;    //<- Background segment cleaner thread
+  std::condition_variable_any cleaner_cv; //<- Used to wake up the cleaner
+  bool cleaner_stop GUARDED_BY(lock);     //<- Flag to stop the cleaner
+
+  /**
+   * @brief Get size of a page record in a segment.
+   */
+  size_t GetRecordSize() const { return sizeof(PageId) + page_size; }
+
+  /**
+   * @brief Get path of the segment file with given number.
+   *
+   * @param segment segment number
+   */
+  std::string GetSegmentPath(uint64_t segment) const {
+    return path + "_" + std::to_string(segment) +
+           LOG_STRUCTURED_STORAGE_SEGMENT_FILE_EXTENTION;
+  }
+
+  /**
+   * @brief Get numbers of all existing segment files in order.
+   */
+  std::set<uint64_t> ListSegmentFiles() const {
+    return file::list_numbered(path,
+                               LOG_STRUCTURED_STORAGE_SEGMENT_FILE_EXTENTION);
+  }
+
+  /**
+   * @brief Open segment with given number. The segment file is created if it
+   * does not exist.
+   *
+   * @param segment segment number
+   * @returns reference to the opened segment
+   */
+  Segment &OpenSegment(uint64_t segment) {
+    auto it = segments.find(segment);
+    if (it == segments.end()) {
+      it = segments.emplace(segment, Segment()).first;
+      it->second.file =
+          file::open(GetSegmentPath(segment),
+                     std::ios::binary | std::ios::in | std::ios::out);
+      it->second.record_count = file::size(it->second.file) / GetRecordSize();
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Get open segment with given number holding stored pages. The
+   * segment file is opened for reading if not open yet. The caller must hold
+   * the lock.
+   *
+   * @param segment segment number
+   * @returns reference to the open segment
+   * @throws StorageError if the segment file is missing
+   */
+  Segment &GetSegment(uint64_t segment) {
+    auto it = segments.find(segment);
+    if (it == segments.end()) {
+      std::fstream file(GetSegmentPath(segment).c_str(),
+                        std::ios::binary | std::ios::in);
+      if (!file.is_open()) {
+        throw StorageError("Missing segment file of stored pages.");
+      }
+      it = segments.emplace(segment, Segment()).first;
+      it->second.file = std::move(file);
+      it->second.record_count = file::size(it->second.file) / GetRecordSize();
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Append page block to the active segment. A new segment is started
+   * if the active segment is full. The caller must hold the lock.
+   *
+   * @param page_id page identifier
+   * @param input input buffer span of the page block to append
+   */
+  void Append(PageId page_id, Span input) {
+    Segment *segment = &OpenSegment(active_segment);
+    // Start a new segment if active segment is full
+    if (segment->record_count >= segment_record_count) {
+      segment->file.flush();
+      segment = &OpenSegment(++active_segment);
+    }
+    // Write page record at the end of the segment
+    size_t offset = segment->record_count * GetRecordSize();
+    file::write(segment->file,
+                Span(reinterpret_cast<Byte *>(&page_id), sizeof(PageId)),
+                offset);
+    file::write(segment->file, Span(input.start, page_size),
+                offset + sizeof(PageId));
+    // Mark previous record of the page as dead
+    auto it = page_map.find(page_id);
+    if (it != page_map.end()) {
+      Kill(it->second);
+    }
+    // Update page map
+    page_map[page_id] = {active_segment, segment->record_count};
+    segment->record_count += 1;
+    segment->live_count += 1;
+  }
+
+  /**
+   * @brief Mark the record at given location as dead.
+   *
+   * @param location location of the record
+   */
+  void Kill(const Location &location) {
+    auto it = segments.find(location.segment);
+    if (it != segments.end() && it->second.live_count > 0) {
+      it->second.live_count -= 1;
+    }
+  }
+
+  /**
+   * @brief Replay records appended to segments since the last checkpoint to
+   * bring the page map up to date. All existing segments from the one being
+   * appended at checkpoint onwards are replayed in order.
+   *
+   * @param segment segment being appended at checkpoint
+   * @param record number of records in that segment at checkpoint
+   */
+  void Replay(uint64_t segment, size_t record) {
+    ByteBuffer buffer(sizeof(PageId));
+    std::set<uint64_t> numbers = ListSegmentFiles();
+    for (auto it = numbers.lower_bound(segment); it != numbers.end(); ++it) {
+      std::fstream segment_file =
+          file::open(GetSegmentPath(*it), std::ios::binary | std::ios::in);
+      size_t record_count = file::size(segment_file) / GetRecordSize();
+      for (size_t index = *it == segment ? record : 0; index < record_count;
+           ++index) {
+        file::read(segment_file, buffer, index * GetRecordSize());
+        Span span(buffer);
+        PageId page_id;
+        persist::load(span, page_id);
+        page_map[page_id] = {*it, index};
+        page_count = std::max<size_t>(page_count, page_id);
+        free_pages.erase(page_id);
+      }
+      active_segment = *it;
+    }
+  }
+
+  /**
+   * @brief Move live records out of the given segment by re-appending them to
+   * the active segment. At most the given number of records are visited
+   * starting at the given record. The segment is dropped from the open
+   * segments once all its records are visited. The caller must hold the lock.
+   *
+   * @param number segment number
+   * @param record reference to the index of the next record to visit
+   * @param count maximum number of records to visit
+   * @returns `true` if all records of the segment are visited else `false`
+   */
+  bool RelocateSegment(uint64_t number, size_t &record, size_t count) {
+    Segment &segment = segments.at(number);
+    ByteBuffer buffer(GetRecordSize());
+    for (size_t end = record + count; record < segment.record_count &&
+                                      segment.live_count > 0 && record < end;
+         ++record) {
+      file::read(segment.file, buffer, record * GetRecordSize());
+      Span span(buffer);
+      PageId page_id;
+      persist::load(span, page_id);
+      // Re-append record if it is the latest one of the page
+      auto it = page_map.find(page_id);
+      if (it != page_map.end() && it->second.segment == number &&
+          it->second.record == record) {
+        Append(page_id, span);
+      }
+    }
+    if (record < segment.record_count && segment.live_count > 0) {
+      return false;
+    }
+    segments.erase(number);
+    return true;
+  }
+
+  /**
+   * @brief Take a checkpoint of the page map. Records appended to segments are
+   * written out of the file streams so that the segment files can be synced
+   * without holding the lock. The caller must hold the lock.
+   *
+   * @param buffer reference to the buffer to dump the checkpoint into
+   * @returns numbers of the segments to sync before writing the checkpoint
+   */
+  std::vector<uint64_t> TakeCheckpoint(ByteBuffer &buffer) {
+    LogStructuredHeader header;
+    header.page_size = page_size;
+    header.segment_record_count = segment_record_count;
+    header.page_count = page_count;
+    header.active_segment = active_segment;
+    header.active_record_count = OpenSegment(active_segment).record_count;
+    header.checksum_type = checksum_type;
+
+    buffer.resize(header.GetStorageSize() + sizeof(size_t) +
+                  (sizeof(PageId) + sizeof(Location)) * page_map.size() +
+                  sizeof(size_t) + sizeof(PageId) * free_pages.size());
+    header.Dump(buffer);
+    Span span = Span(buffer) + header.GetStorageSize();
+    persist::dump(span, page_map, free_pages);
+
+    std::vector<uint64_t> numbers;
+    for (auto &element : segments) {
+      element.second.file.flush();
+      numbers.push_back(element.first);
+    }
+    return numbers;
+  }
+
+  /**
+   * @brief Write a checkpoint taken of the page map. The given segments are
+   * synced first so that the checkpoint never points past durable data. The
+   * checkpoint is written to a temporary file which then replaces the existing
+   * checkpoint. The caller must hold the checkpoint lock, while the lock need
+   * not be held.
+   *
+   * @param buffer input buffer span of the checkpoint
+   * @param numbers numbers of the segments to sync
+   */
+  void WriteCheckpoint(Span buffer, const std::vector<uint64_t> &numbers) {
+    for (auto number : numbers) {
+      if (!file::sync(GetSegmentPath(number))) {
+        throw StorageError("Failed to sync segment file.");
+      }
+    }
+    std::string checkpoint_path =
+        path + LOG_STRUCTURED_STORAGE_CHECKPOINT_FILE_EXTENTION;
+    {
+      std::fstream checkpoint_file =
+          file::open(checkpoint_path + ".tmp",
+                     std::ios::binary | std::ios::out | std::ios::trunc);
+      file::write(checkpoint_file, buffer, 0);
+      if (!file::sync(checkpoint_file, checkpoint_path + ".tmp")) {
+        throw StorageError("Failed to sync checkpoint file.");
+      }
+    }
+    std::rename((checkpoint_path + ".tmp").c_str(), checkpoint_path.c_str());
+  }
+
+  /**
+   * @brief Dump checkpoint of the page map. The lock is only held while the
+   * checkpoint is taken. The caller must hold the checkpoint lock.
+   */
+  void DumpCheckpoint() {
+    ByteBuffer buffer;
+    std::vector<uint64_t> numbers;
+    {
+      LockGuard guard(lock);
+      numbers = TakeCheckpoint(buffer);
+    }
+    WriteCheckpoint(buffer, numbers);
+  }
+
+  /**
+   * @brief Run the segment cleaner until stopped. The lock is released while
+   * cleaning.
+   */
+  void RunCleaner() {
+    while (true) {
+      {
+        LockGuard guard(lock);
+        if (!cleaner_stop) {
+          cleaner_cv.wait_for(lock, std::chrono::milliseconds(clean_interval));
+        }
+        if (cleaner_stop) {
+          return;
+        }
+      }
+      CleanSegments();
+    }
+  }
+
+  /**
+   * @brief Clean all segments below the clean threshold. Live records are
+   * relocated and checkpointed before the segment files are removed, so that
+   * a crash never loses a relocated page. Records are relocated a batch at a
+   * time and the lock is released between batches and while the checkpoint is
+   * written. The caller must not hold the lock.
+   *
+   * @returns number of segments cleaned
+   */
+  size_t CleanSegments() {
+    LockGuard checkpoint_guard(checkpoint_lock);
+
+    std::vector<uint64_t> to_clean;
+    {
+      LockGuard guard(lock);
+      for (auto &element : segments) {
+        if (element.first != active_segment &&
+            element.second.live_count <
+                clean_threshold * element.second.record_count) {
+          to_clean.push_back(element.first);
+        }
+      }
+    }
+    if (to_clean.empty()) {
+      return 0;
+    }
+    for (auto number : to_clean) {
+      size_t record = 0;
+      bool relocated = false;
+      while (!relocated) {
+        LockGuard guard(lock);
+        relocated = RelocateSegment(number, record,
+                                    LOG_STRUCTURED_STORAGE_CLEAN_BATCH_SIZE);
+      }
+    }
+    DumpCheckpoint();
+    for (auto number : to_clean) {
+      std::remove(GetSegmentPath(number).c_str());
+    }
+    return to_clean.size();
+  }
+
+public:
+  /**
+   * Constructors
+   *
+   * @param path path to storage files
+   * @param page_size storage size of data block. Default set to 1024
+   * @param segment_size size of each segment in bytes. Default set to 64 MiB
+   */
+  LogStructuredStorage(const std::string &path,
+                       uint64_t page_size = DEFAULT_PAGE_SIZE,
+                       uint64_t segment_size = DEFAULT_LOG_SEGMENT_SIZE)
+      : Storage<PageType>(page_size), path(path), segment_size(segment_size),
+        segment_record_count(0), active_segment(0), open(false),
+        clean_threshold(DEFAULT_LOG_CLEAN_THRESHOLD),
+        clean_interval(DEFAULT_LOG_CLEAN_INTERVAL), cleaner_stop(false) {}
+
+  /**
+   * Destructor
+   */
+  ~LogStructuredStorage() {
+    // Close any/all opened files
+    Close();
+  }
+
+  /**
+   * @brief Get path to storage files
+   */
+  std::string GetPath() const { return path; }
+
+  /**
+   * @brief Get the requested size of each segment in bytes.
+   */
+  size_t GetSegmentSize() const { return segment_size; }
+
+  /**
+   * @brief Get the number of segment files in use.
+   */
+  size_t GetSegmentCount() {
+    LockGuard guard(lock);
+
+    return segments.size();
+  }
+
+  /**
+   * @brief Get the fraction of live records below which a segment is cleaned.
+   */
+  double GetCleanThreshold() const { return clean_threshold; }
+
+  /**
+   * @brief Set the fraction of live records below which a segment is cleaned.
+   *
+   * @param threshold live fraction between 0 and 1
+   */
+  void SetCleanThreshold(double threshold) { clean_threshold = threshold; }
+
+  /**
+   * @brief Get the interval in milliseconds between background cleaner runs.
+   */
+  size_t GetCleanInterval() const { return clean_interval; }
+
+  /**
+   * @brief Set the interval in milliseconds between background cleaner runs.
+   * Set to 0 to disable the background cleaner. The value takes effect the
+   * next time the storage is opened.
+   *
+   * @param interval interval in milliseconds
+   */
+  void SetCleanInterval(size_t interval) { clean_interval = interval; }
+
+  /**
+   * Opens storage. The checkpoint is loaded and records appended after it are
+   * replayed. The background cleaner is started if enabled.
+   */
+  void Open() override {
+    LockGuard guard(lock);
+
+    if (open) {
+      return;
+    }
+
+    // Load checkpoint
+    LogStructuredHeader header;
+    std::fstream checkpoint_file =
+        file::open(path + LOG_STRUCTURED_STORAGE_CHECKPOINT_FILE_EXTENTION,
+                   std::ios::binary | std::ios::in);
+    size_t file_size = file::size(checkpoint_file);
+    page_map.clear();
+    free_pages.clear();
+    if (file_size >= header.GetStorageSize()) {
+      ByteBuffer buffer(file_size);
+      file::read(checkpoint_file, buffer, 0);
+      header.Load(buffer);
+      Storage<PageType>::LoadChecksumType(header.checksum_type);
+      page_size = header.page_size;
+      segment_record_count = header.segment_record_count;
+      page_count = header.page_count;
+      Span span = Span(buffer) + header.GetStorageSize();
+      persist::load(span, page_map, free_pages);
+    } else {
+      segment_record_count =
+          std::max<size_t>(segment_size / GetRecordSize(), 1);
+      page_count = 0;
+      header.active_segment = 0;
+      header.active_record_count = 0;
+    }
+    checkpoint_file.close();
+    active_segment = header.active_segment;
+
+    // Replay records appended after checkpoint
+    Replay(header.active_segment, header.active_record_count);
+
+    // Open segments holding live pages and count live records. A page stored
+    // in a missing segment or past the end of its segment fails the open.
+    OpenSegment(active_segment);
+    try {
+      for (auto &element : page_map) {
+        Segment &segment = GetSegment(element.second.segment);
+        if (element.second.record >= segment.record_count) {
+          throw StorageError("Missing record of stored page in segment.");
+        }
+        segment.live_count += 1;
+      }
+    } catch (StorageError &) {
+      segments.clear();
+      throw;
+    }
+    // Remove files of older segments without live pages. These hold only dead
+    // records, e.g. of segments cleaned just before a crash.
+    for (auto number : ListSegmentFiles()) {
+      if (number < active_segment && segments.find(number) == segments.end()) {
+        std::remove(GetSegmentPath(number).c_str());
+      }
+    }
+
+    // Pages are verified on first load after open
+    Storage<PageType>::ForgetVerified();
+
+    open = true;
+
+    // Start background cleaner
+    if (clean_interval > 0) {
+      cleaner_stop = false;
+      cleaner = std::thread(&LogStructuredStorage::RunCleaner, this);
+    }
+  }
+
+  /**
+   * Checks if storage is open
+   */
+  bool IsOpen() override {
+    LockGuard guard(lock);
+
+    return open;
+  }
+
+  /**
+   * Closes storage. The background cleaner is stopped and the page map
+   * checkpointed. No operation is performed if the storage is not open.
+   */
+  void Close() override {
+    // Stop background cleaner
+    {
+      LockGuard guard(lock);
+      cleaner_stop = true;
+    }
+    cleaner_cv.notify_all();
+    if (cleaner.joinable()) {
+      cleaner.join();
+    }
+
+    LockGuard checkpoint_guard(checkpoint_lock);
+    LockGuard guard(lock);
+
+    if (open) {
+      ByteBuffer buffer;
+      std::vector<uint64_t> numbers = TakeCheckpoint(buffer);
+      WriteCheckpoint(buffer, numbers);
+      segments.clear();
+      open = false;
+    }
+  }
+
+  /**
+   * Remove storage files.
+   */
+  void Remove() override {
+    Close();
+
+    LockGuard guard(lock);
+
+    std::remove(
+        (path + LOG_STRUCTURED_STORAGE_CHECKPOINT_FILE_EXTENTION).c_str());
+    for (auto segment : ListSegmentFiles()) {
+      std::remove(GetSegmentPath(segment).c_str());
+    }
+    page_map.clear();
+    free_pages.clear();
+    page_count = 0;
+    active_segment = 0;
+  }
+
+  /**
+   * @brief Checkpoint the page map to storage.
+   *
+   * @thread_safe
+   */
+  void Checkpoint() {
+    LockGuard checkpoint_guard(checkpoint_lock);
+
+    DumpCheckpoint();
+  }
+
+  /**
+   * @brief Clean segments whose fraction of live records is below the clean
+   * threshold. The live records are re-appended to the active segment and the
+   * cleaned segment files are removed.
+   *
+   * @thread_safe
+   *
+   * @returns number of segments cleaned
+   */
+  size_t Clean() { return CleanSegments(); }
+
+  /**
+   * Reads block of page with given identifier from the location of its latest
+   * record.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifier
+   * @param output output buffer span to read the page block into
+   */
+  void ReadBlock(PageId page_id, Span output) override {
+    LockGuard guard(lock);
+
+    if (output.size < page_size) {
+      throw StorageError("Buffer too small to read page.");
+    }
+    auto it = page_map.find(page_id);
+    if (it == page_map.end()) {
+      throw PageNotFoundError(page_id);
+    }
+    Segment &segment = GetSegment(it->second.segment);
+    file::read(segment.file, Span(output.start, page_size),
+               it->second.record * GetRecordSize() + sizeof(PageId));
+  }
+
+  /**
+   * Writes block of page with given identifier by appending it to the active
+   * segment.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifier
+   * @param input input buffer span of the page block to write
+   */
+  void WriteBlock(PageId page_id, Span input) override {
+    LockGuard guard(lock);
+
+    // Page ID of 0 is considered NULL
+    if (page_id == 0) {
+      throw StorageError("Can not write page with invalid ID.");
+    }
+    if (input.size < page_size) {
+      throw StorageError("Buffer too small to write page.");
+    }
+    Append(page_id, input);
+  }
+
+  /**
+   * Syncs written data of all open segment files to durable media.
+   *
+   * @thread_safe
+   */
+  void Sync() override {
+    LockGuard guard(lock);
+
+    for (auto &element : segments) {
+      if (!file::sync(element.second.file, GetSegmentPath(element.first))) {
+        throw StorageError("Failed to sync segment file.");
+      }
+    }
+  }
+
+  /**
+   * @brief Allocate a new page in storage.
+   *
+   * @thread_safe
+   *
+   * @returns identifier of the newly allocated page
+   */
+  PageId Allocate() override {
+    LockGuard guard(lock);
+
+    return Storage<PageType>::Allocate();
+  }
+
+  /**
+   * @brief Deallocate page with given identifier. The latest record of the
+   * page becomes dead and is dropped by the cleaner.
+   *
+   * @thread_safe
+   *
+   * @param page_id identifier of the page to deallocate
+   */
+  void Deallocate(PageId page_id) override {
+    LockGuard guard(lock);
+
+    Storage<PageType>::Deallocate(page_id);
+    auto it = page_map.find(page_id);
+    if (it != page_map.end() && free_pages.count(page_id)) {
+      Kill(it->second);
+      page_map.erase(it);
+    }
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_LOG_STRUCTURED_STORAGE_HPP */
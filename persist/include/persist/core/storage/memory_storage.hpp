@@ -25,6 +25,7 @@
 #ifndef PERSIST_CORE_STORAGE_MEMORY_STORAGE_HPP
 #define PERSIST_CORE_STORAGE_MEMORY_STORAGE_HPP
 
+#include <cstring>
 #include <memory>
 #include <unordered_map>
 
@@ -32,30 +33,72 @@
 #include <persist/core/page/serializer.hpp>
 #include <persist/core/storage/base.hpp>
 
+#include <persist/utility/mutex.hpp>
+
 namespace persist {
+
+/**
+ * @brief Memory storage modes
+ *
+ * - SERIALIZED: Pages are stored as dumped page blocks. Every read and write
+ *   serializes the page and verifies its checksum.
+ * - OBJECT: Live page objects are stored. Page objects are exchanged with the
+ *   buffer manager by transfer of ownership, without serialization.
+ */
+enum class MemoryStorageMode { SERIALIZED, OBJECT };
+
 /**
  * Memory Storage
  *
  * In memory backend storage to store data in RAM. Note that this is a volatile
  * storage and should be used accordingly.
  *
+ * In object mode, a page released to the buffer manager is not held by the
+ * storage until it is adopted back on eviction or written by a flush. Reads
+ * and writes of page objects or blocks are still supported in object mode by
+ * serializing a copy of the page.
+ *
+ * Stored pages are guarded by a lock so that blocks can be read concurrently
+ * with writes, for example by a buffer manager scrubbing pages.
+ *
  * @tparam PageType The type of page stored by storage.
  */
-template <class PageType> class MemoryStorage : public Storage<PageType> {
+template <class PageType>
+class MemoryStorage final : public Storage<PageType> {
   using Storage<PageType>::page_size;
   using Storage<PageType>::page_count;
+  using Storage<PageType>::free_pages;
+  using Storage<PageType>::checksum_type;
+  using Storage<PageType>::IsVerifyRequired;
+  using Storage<PageType>::MarkVerified;
 
   PERSIST_PRIVATE
-  std::unordered_map<PageId, ByteBuffer> data; //<- pages stored as map
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  Mutex lock; //<- lock for achieving thread safety via mutual exclusion
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+
+  MemoryStorageMode mode; //<- storage mode
+  std::unordered_map<PageId, ByteBuffer>
+      data GUARDED_BY(lock); //<- pages stored as map
+  std::unordered_map<PageId, std::unique_ptr<PageType>>
+      pages GUARDED_BY(lock); //<- page objects stored as map in object mode
 
 public:
   /**
    * Constructor a new MemoryStorage object.
    *
    * @param page_size storage size of data block. Default set to 1024
+   * @param mode storage mode. Default set to serialized mode
    */
-  MemoryStorage() = default;
-  MemoryStorage(size_t page_size) : Storage<PageType>(page_size) {}
+  MemoryStorage() : mode(MemoryStorageMode::SERIALIZED) {}
+  MemoryStorage(size_t page_size,
+                MemoryStorageMode mode = MemoryStorageMode::SERIALIZED)
+      : Storage<PageType>(page_size), mode(mode) {}
+
+  /**
+   * @brief Get storage mode.
+   */
+  MemoryStorageMode GetMode() const { return mode; }
 
   /**
    * @brief Open memory storage. No operation is performed.
@@ -76,35 +119,167 @@ public:
    * Remove storage. Data is cleared.
    */
   void Remove() override {
+    LockGuard guard(lock);
+
     data.clear();
+    pages.clear();
+    free_pages.clear();
     page_count = 0;
   }
 
   /**
-   * Read Page with given identifier from storage.
+   * Check if the storage keeps live page objects. Returns `true` in object
+   * mode.
+   */
+  bool IsObjectStore() const override {
+    return mode == MemoryStorageMode::OBJECT;
+  }
+
+  /**
+   * Read block of page with given identifier from storage into the given
+   * memory. In object mode the page object is dumped into the memory.
+   *
+   * @param page_id page identifier
+   * @param output output buffer span to read the page block into
+   */
+  void ReadBlock(PageId page_id, Span output) override {
+    if (output.size < page_size) {
+      throw StorageError("Buffer too small to read page.");
+    }
+    LockGuard guard(lock);
+
+    if (mode == MemoryStorageMode::OBJECT) {
+      auto it = pages.find(page_id);
+      if (it == pages.end()) {
+        throw PageNotFoundError(page_id);
+      }
+      std::memset(output.start, 0, page_size);
+      persist::DumpPage(*it->second, Span(output.start, page_size),
+                        checksum_type);
+      return;
+    }
+    auto it = data.find(page_id);
+    if (it == data.end()) {
+      throw PageNotFoundError(page_id);
+    }
+    std::memcpy(output.start, it->second.data(), it->second.size());
+  }
+
+  /**
+   * Write block of page with given identifier to storage from the given
+   * memory. In object mode the page object is loaded from the memory.
+   *
+   * @param page_id page identifier
+   * @param input input buffer span of the page block to write
+   */
+  void WriteBlock(PageId page_id, Span input) override {
+    if (input.size < page_size) {
+      throw StorageError("Buffer too small to write page.");
+    }
+    LockGuard guard(lock);
+
+    if (mode == MemoryStorageMode::OBJECT) {
+      pages[page_id] = persist::LoadPage<PageType>(
+          Span(input.start, page_size), checksum_type);
+      return;
+    }
+    data[page_id] = ByteBuffer(input.start, input.start + page_size);
+  }
+
+  /**
+   * Read Page with given identifier from storage. The page is loaded directly
+   * from the stored block without an intermediate copy. In object mode a copy
+   * of the page object is returned.
    *
    * @param page_id page identifier
    * @returns pointer to Page object
    */
   std::unique_ptr<PageType> Read(PageId page_id) override {
+    if (mode == MemoryStorageMode::OBJECT) {
+      return Storage<PageType>::Read(page_id);
+    }
+    LockGuard guard(lock);
+
     if (data.find(page_id) == data.end()) {
       throw PageNotFoundError(page_id);
     }
-    std::unique_ptr<PageType> page =
-        persist::LoadPage<PageType>(data.at(page_id));
+    std::unique_ptr<PageType> page = persist::LoadPage<PageType>(
+        data.at(page_id), checksum_type, IsVerifyRequired(page_id));
+    MarkVerified(page_id);
 
     return page;
   }
 
   /**
-   * Write Page object to storage.
+   * Write Page object to storage. In object mode a copy of the page object is
+   * stored.
    *
    * @param page reference to Page object to be written
    */
   void Write(PageType &page) override {
+    if (mode == MemoryStorageMode::OBJECT) {
+      Storage<PageType>::Write(page);
+      return;
+    }
+    LockGuard guard(lock);
+
     PageId page_id = page.GetId();
     data[page_id] = ByteBuffer(page_size);
-    persist::DumpPage(page, data.at(page_id));
+    persist::DumpPage(page, data.at(page_id), checksum_type);
+    MarkVerified(page_id);
+  }
+
+  /**
+   * Release ownership of the page object with given identifier. In object
+   * mode the stored page object is moved out of the storage.
+   *
+   * @param page_id page identifier
+   * @returns pointer to Page object
+   */
+  std::unique_ptr<PageType> Release(PageId page_id) override {
+    if (mode != MemoryStorageMode::OBJECT) {
+      return Read(page_id);
+    }
+    LockGuard guard(lock);
+
+    auto it = pages.find(page_id);
+    if (it == pages.end()) {
+      throw PageNotFoundError(page_id);
+    }
+    std::unique_ptr<PageType> page = std::move(it->second);
+    pages.erase(it);
+
+    return page;
+  }
+
+  /**
+   * Adopt ownership of the given page object. In object mode the page object
+   * is moved into the storage.
+   *
+   * @param page pointer to Page object
+   */
+  void Adopt(std::unique_ptr<PageType> page) override {
+    if (mode != MemoryStorageMode::OBJECT) {
+      Write(*page);
+      return;
+    }
+    LockGuard guard(lock);
+
+    PageId page_id = page->GetId();
+    pages[page_id] = std::move(page);
+  }
+
+  /**
+   * Deallocate page with given identifier. The memory used by the stored page
+   * is released.
+   *
+   * @param page_id identifier of the page to deallocate
+   */
+  void Deallocate(PageId page_id) override {
+    Storage<PageType>::Deallocate(page_id);
+    LockGuard guard(lock);
+    data.erase(page_id);
+    pages.erase(page_id);
   }
 };
 
@@ -0,0 +1,515 @@
+/**
+ * segmented_file_storage.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Segmented File Storage
+ */
+
+#ifndef PERSIST_CORE_SEGMENTED_FILE_STORAGE_HPP
+#define PERSIST_CORE_SEGMENTED_FILE_STORAGE_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <persist/core/exceptions/storage.hpp>
+#include <persist/core/fixed_storable.hpp>
+#include <persist/core/storage/base.hpp>
+#include <persist/core/storage/file_storage.hpp>
+
+#include <persist/utility/mutex.hpp>
+#include <persist/utility/serializer.hpp>
+
+#define SEGMENTED_FILE_STORAGE_META_FILE_EXTENTION ".stm"
+#define SEGMENTED_FILE_STORAGE_SEGMENT_FILE_EXTENTION ".seg"
+
+namespace persist {
+
+/**
+ * @brief Segmented File Header
+ *
+ * The header contains basic information about the segmented storage. It is
+ * stored in a separate meta file.
+ */
+struct SegmentedFileHeader
+    : public FixedStorable<SegmentedFileHeader, StorageError> {
+  size_t page_size;          //<- page size used in the storage
+  size_t segment_page_count; //<- number of pages stored in each segment
+  size_t page_count;         //<- number of pages at last close
+  size_t segment_count;      //<- number of segment files created
+  ChecksumType checksum_type; //<- checksum algorithm used in the storage
+
+  /**
+   * @brief Get the stored fields of the header.
+   *
+   */
+  auto GetFields() {
+    return std::make_tuple(std::ref(page_size), std::ref(segment_page_count),
+                           std::ref(page_count), std::ref(segment_count),
+                           stored_as<uint32_t>(checksum_type));
+  }
+
+#ifdef __PERSIST_DEBUG__
+  /**
+   * @brief Write segmented file header to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const SegmentedFileHeader &header) {
+    os << "--------- SegmentedFileHeader ---------\n";
+    os << "Page Size: " << header.page_size << "\n";
+    os << "Segment Page Count: " << header.segment_page_count << "\n";
+    os << "Page Count: " << header.page_count << "\n";
+    os << "Segment Count: " << header.segment_count << "\n";
+    os << "Checksum Type: " << static_cast<uint32_t>(header.checksum_type)
+       << "\n";
+    os << "----------------------------";
+    return os;
+  }
+#endif
+};
+
+/**
+ * Segmented File Storage Class
+ *
+ * The class implements Block IO operations for pages split across multiple
+ * fixed size segment files stored on a local disk. The page ID space is split
+ * into consecutive ranges, one per segment, so that the page with ID `n` is
+ * stored in the segment `(n - 1) / segment_page_count`. Segment files are
+ * created lazily on first write and opened on demand. Each segment has its own
+ * lock so that IO to different segments can proceed in parallel.
+ *
+ * Since segment files are created lazily, there can be gaps between them. The
+ * number of segment files created is recorded in the meta file before a new
+ * segment file is created, so that all segments can be found on open.
+ *
+ * The page size, number of pages per segment and checksum algorithm are stored
+ * in a meta file and take precedence over the values passed at construction
+ * when an existing storage is opened.
+ *
+ * @tparam PageType The type of page stored by storage.
+ */
+template <class PageType>
+class SegmentedFileStorage final : public Storage<PageType> {
+  using Storage<PageType>::page_size;
+  using Storage<PageType>::page_count;
+  using Storage<PageType>::free_pages;
+  using Storage<PageType>::checksum_type;
+
+  PERSIST_PRIVATE
+  /**
+   * @brief Lock for thread safety
+   *
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+
+  /**
+   * Segment Struct
+   *
+   * The data structure contains the file stream of an opened segment.
+   */
+  struct Segment {
+    Mutex lock;                         //<- lock for IO on the segment
+    std::fstream file GUARDED_BY(lock); //<- IO file stream for segment
+  };
+
+  Mutex lock;                //<- lock guarding segments and allocation
+  std::string path;          //<- Storage path
+  size_t segment_size;       //<- Requested size of a segment in bytes
+  size_t segment_page_count; //<- Number of pages stored in each segment
+  size_t segment_count GUARDED_BY(lock); //<- Number of segment files created
+  std::vector<std::shared_ptr<Segment>> segments
+      GUARDED_BY(lock); //<- Table of opened segments
+  bool open GUARDED_BY(lock); //<- Flag indicating storage is open
+
+  /**
+   * @brief Get path of the segment file with given index.
+   *
+   * @param index segment index
+   */
+  std::string GetSegmentPath(size_t index) const {
+    return path + "_" + std::to_string(index) +
+           SEGMENTED_FILE_STORAGE_SEGMENT_FILE_EXTENTION;
+  }
+
+  /**
+   * @brief Check if the segment file with given index exists.
+   *
+   * @param index segment index
+   */
+  bool HasSegmentFile(size_t index) const {
+    return std::ifstream(GetSegmentPath(index).c_str()).good();
+  }
+
+  /**
+   * @brief Get segment with given index. The segment file is opened on demand.
+   * The caller must hold the storage lock. The segment is shared with the
+   * caller so that it stays valid for IO outside the lock even if the storage
+   * is closed meanwhile.
+   *
+   * @param index segment index
+   * @param create flag to create the segment file if it does not exist
+   * @returns pointer to the segment or `nullptr` if the segment file does not
+   * exist and is not created
+   */
+  std::shared_ptr<Segment> GetSegment(size_t index, bool create) {
+    if (index >= segments.size()) {
+      segments.resize(index + 1);
+    }
+    if (segments[index] == nullptr) {
+      if (!create && !HasSegmentFile(index)) {
+        return nullptr;
+      }
+      // Record the segment in the meta file before creating its file
+      if (index >= segment_count) {
+        segment_count = index + 1;
+        DumpHeader();
+      }
+      segments[index] = std::make_shared<Segment>();
+      segments[index]->file =
+          file::open(GetSegmentPath(index),
+                     std::ios::binary | std::ios::in | std::ios::out);
+    }
+    return segments[index];
+  }
+
+  /**
+   * @brief Load storage header from the meta file.
+   *
+   * @param header reference to the header to load into
+   * @returns `true` if the header is loaded else `false` if the meta file
+   * does not hold a header
+   */
+  bool LoadHeader(SegmentedFileHeader &header) {
+    std::fstream meta_file =
+        file::open(path + SEGMENTED_FILE_STORAGE_META_FILE_EXTENTION,
+                   std::ios::binary | std::ios::in | std::ios::out);
+    if (file::size(meta_file) < header.GetStorageSize()) {
+      return false;
+    }
+    ByteBuffer buffer(header.GetStorageSize());
+    file::read(meta_file, buffer, 0);
+    header.Load(buffer);
+    return true;
+  }
+
+  /**
+   * @brief Dump storage header to the meta file.
+   */
+  void DumpHeader() {
+    SegmentedFileHeader header;
+    header.page_size = page_size;
+    header.segment_page_count = segment_page_count;
+    header.page_count = page_count;
+    header.segment_count = segment_count;
+    header.checksum_type = checksum_type;
+    ByteBuffer buffer(header.GetStorageSize());
+    header.Dump(buffer);
+    std::fstream meta_file =
+        file::open(path + SEGMENTED_FILE_STORAGE_META_FILE_EXTENTION,
+                   std::ios::binary | std::ios::out | std::ios::trunc);
+    file::write(meta_file, buffer, 0);
+  }
+
+public:
+  /**
+   * Constructors
+   *
+   * The segmented file storage stores data in blocks of fixed size spread
+   * across segment files of fixed size. The size of the blocks and segments
+   * can be specified at initiation. The segment size is rounded down to a
+   * multiple of the page size. In case of an existing storage the sizes
+   * stored in its metadata are used.
+   *
+   * @param path path to storage files
+   * @param page_size storage size of data block. Default set to 1024
+   * @param segment_size size of each segment in bytes. Default set to 1 GiB
+   */
+  SegmentedFileStorage(const std::string &path,
+                       uint64_t page_size = DEFAULT_PAGE_SIZE,
+                       uint64_t segment_size = DEFAULT_SEGMENT_SIZE)
+      : Storage<PageType>(page_size), path(path), segment_size(segment_size),
+        segment_page_count(0), segment_count(0), open(false) {}
+
+  /**
+   * Destructor
+   */
+  ~SegmentedFileStorage() {
+    // Close any/all opened files
+    Close();
+  }
+
+  /**
+   * @brief Get path to storage files
+   */
+  std::string GetPath() const { return path; }
+
+  /**
+   * @brief Get the requested size of each segment in bytes.
+   */
+  size_t GetSegmentSize() const { return segment_size; }
+
+  /**
+   * @brief Get the number of pages stored in each segment. The value is only
+   * available after the storage is opened.
+   */
+  size_t GetSegmentPageCount() const { return segment_page_count; }
+
+  /**
+   * @brief Get the number of segments spanned by the allocated pages.
+   */
+  size_t GetSegmentCount() const {
+    if (segment_page_count == 0) {
+      return 0;
+    }
+    return (page_count + segment_page_count - 1) / segment_page_count;
+  }
+
+  /**
+   * Opens storage. Only the meta file is opened; segment files are opened on
+   * demand.
+   */
+  void Open() override {
+    LockGuard guard(lock);
+
+    if (open) {
+      return;
+    }
+
+    SegmentedFileHeader header;
+    if (LoadHeader(header)) {
+      Storage<PageType>::LoadChecksumType(header.checksum_type);
+      page_size = header.page_size;
+      segment_page_count = header.segment_page_count;
+      page_count = header.page_count;
+      segment_count = header.segment_count;
+    } else {
+      segment_page_count = std::max<size_t>(segment_size / page_size, 1);
+      page_count = 0;
+      segment_count = 0;
+    }
+
+    // The page count in the header is only updated on close. Pages written
+    // after that are accounted for using the size of the segment files. All
+    // recorded segments are checked as there can be gaps between them.
+    for (size_t index = page_count / segment_page_count;
+         index < segment_count; ++index) {
+      if (!HasSegmentFile(index)) {
+        continue;
+      }
+      std::fstream segment_file =
+          file::open(GetSegmentPath(index), std::ios::binary | std::ios::in);
+      page_count = std::max(page_count, index * segment_page_count +
+                                            file::size(segment_file) /
+                                                page_size);
+    }
+    DumpHeader();
+
+    // Load list of free pages
+    file::load_page_ids(path + FILE_STORAGE_FREE_LIST_FILE_EXTENTION,
+                        free_pages);
+    // Drop page IDs not backed by the storage
+    free_pages.erase(free_pages.upper_bound(page_count), free_pages.end());
+
+    // Pages are verified on first load after open
+    Storage<PageType>::ForgetVerified();
+
+    open = true;
+  }
+
+  /**
+   * Checks if storage is open
+   */
+  bool IsOpen() override {
+    LockGuard guard(lock);
+
+    return open;
+  }
+
+  /**
+   * Closes opened segment files and persists storage metadata. No operation
+   * is performed if the storage is not open.
+   */
+  void Close() override {
+    LockGuard guard(lock);
+
+    if (open) {
+      DumpHeader();
+      file::dump_page_ids(path + FILE_STORAGE_FREE_LIST_FILE_EXTENTION,
+                          free_pages);
+      segments.clear();
+      open = false;
+    }
+  }
+
+  /**
+   * Remove storage files.
+   */
+  void Remove() override {
+    Close();
+
+    LockGuard guard(lock);
+
+    // Segments recorded by a storage which is not opened
+    SegmentedFileHeader header;
+    if (LoadHeader(header)) {
+      segment_count = std::max(segment_count, header.segment_count);
+    }
+    std::remove((path + SEGMENTED_FILE_STORAGE_META_FILE_EXTENTION).c_str());
+    std::remove((path + FILE_STORAGE_FREE_LIST_FILE_EXTENTION).c_str());
+    for (size_t index = 0; HasSegmentFile(index) || index < segment_count;
+         ++index) {
+      std::remove(GetSegmentPath(index).c_str());
+    }
+    free_pages.clear();
+    page_count = 0;
+    segment_count = 0;
+  }
+
+  /**
+   * Reads block of page with given identifier from its segment file.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifier
+   * @param output output buffer span to read the page block into
+   */
+  void ReadBlock(PageId page_id, Span output) override {
+    // Page ID of 0 is considered NULL
+    if (page_id == 0) {
+      throw PageNotFoundError(page_id);
+    }
+    if (output.size < page_size) {
+      throw StorageError("Buffer too small to read page.");
+    }
+
+    std::shared_ptr<Segment> segment;
+    {
+      LockGuard guard(lock);
+      segment = GetSegment((page_id - 1) / segment_page_count, false);
+    }
+    // Segment file not created yet
+    if (segment == nullptr) {
+      throw PageNotFoundError(page_id);
+    }
+
+    LockGuard guard(segment->lock);
+    size_t page_offset = page_size * ((page_id - 1) % segment_page_count);
+    // Check if page offset is greater than equal to the segment size.
+    if (page_offset >= file::size(segment->file)) {
+      throw PageNotFoundError(page_id);
+    }
+    file::read(segment->file, Span(output.start, page_size), page_offset);
+  }
+
+  /**
+   * Writes block of page with given identifier to its segment file. The
+   * segment file is created if it does not exist.
+   *
+   * @thread_safe
+   *
+   * @param page_id page identifier
+   * @param input input buffer span of the page block to write
+   */
+  void WriteBlock(PageId page_id, Span input) override {
+    // Page ID of 0 is considered NULL
+    if (page_id == 0) {
+      throw StorageError("Can not write page with invalid ID.");
+    }
+    if (input.size < page_size) {
+      throw StorageError("Buffer too small to write page.");
+    }
+
+    std::shared_ptr<Segment> segment;
+    {
+      LockGuard guard(lock);
+      segment = GetSegment((page_id - 1) / segment_page_count, true);
+    }
+
+    LockGuard guard(segment->lock);
+    size_t page_offset = page_size * ((page_id - 1) % segment_page_count);
+    file::write(segment->file, Span(input.start, page_size), page_offset);
+  }
+
+  /**
+   * Syncs written data of all opened segment files to durable media. Only
+   * buffered data is written out under the segment lock, so that pages can be
+   * allocated, read and written while the segments are synced.
+   *
+   * @thread_safe
+   */
+  void Sync() override {
+    std::vector<std::shared_ptr<Segment>> opened;
+    {
+      LockGuard guard(lock);
+      opened = segments;
+    }
+    for (size_t index = 0; index < opened.size(); ++index) {
+      if (opened[index] == nullptr) {
+        continue;
+      }
+      {
+        LockGuard segment_guard(opened[index]->lock);
+        // Write out buffered data before syncing
+        opened[index]->file.flush();
+      }
+      if (!file::sync(GetSegmentPath(index))) {
+        throw StorageError("Failed to sync segment file.");
+      }
+    }
+  }
+
+  /**
+   * @brief Allocate a new page in storage.
+   *
+   * @thread_safe
+   *
+   * @returns identifier of the newly allocated page
+   */
+  PageId Allocate() override {
+    LockGuard guard(lock);
+
+    return Storage<PageType>::Allocate();
+  }
+
+  /**
+   * @brief Deallocate page with given identifier.
+   *
+   * @thread_safe
+   *
+   * @param page_id identifier of the page to deallocate
+   */
+  void Deallocate(PageId page_id) override {
+    LockGuard guard(lock);
+
+    Storage<PageType>::Deallocate(page_id);
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_SEGMENTED_FILE_STORAGE_HPP */
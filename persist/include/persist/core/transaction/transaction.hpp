@@ -25,6 +25,7 @@
 #ifndef PERSIST_CORE_TRANSACTION_HPP
 #define PERSIST_CORE_TRANSACTION_HPP
 
+#include <map>
 #include <set>
 
 #include <persist/core/defs.hpp>
@@ -82,9 +83,22 @@ public:
   State state;
 
   /**
-   * @brief Set of staged page ID.
+   * @brief Sets of staged page IDs mapped to the kind of the pages.
    */
-  std::set<PageId> staged;
+  std::map<LogRecord::PageKind, std::set<PageId>> staged;
+
+  /**
+   * @brief Set of IDs of pages emptied by the transaction, which are
+   * deallocated once the transaction commits.
+   */
+  std::set<PageId> freed;
+
+  /**
+   * @brief Sets of IDs of record page slots removed by the transaction mapped
+   * to the ID of their page. The slots are released once the transaction
+   * commits or aborts.
+   */
+  std::map<PageId, std::set<PageSlotId>> removed;
 
   /**
    * @brief Location of the latest log record in the transaction. This is used
@@ -109,14 +123,16 @@ public:
    *
    * @param location location where record is inserted
    * @param page_slot page slot inserted
+   * @param page_kind kind of page where record is inserted
    */
-  void LogInsertOp(RecordPageSlot::Location &location,
-                   RecordPageSlot &page_slot) {
+  void LogInsertOp(
+      RecordPageSlot::Location &location, RecordPageSlot &page_slot,
+      LogRecord::PageKind page_kind = LogRecord::PageKind::RECORD) {
     // Stage Page ID
-    staged.insert(location.page_id);
+    staged[page_kind].insert(location.page_id);
     // Log record for insert operation
     LogRecord log_record(id, log_location, LogRecord::Type::INSERT, location,
-                         page_slot);
+                         page_slot, page_kind);
     log_location = log_manager.Add(log_record);
   }
 
@@ -126,15 +142,17 @@ public:
    * @param location location where record is located
    * @param old_page_slot old page slot
    * @param new_page_slot new page slot
+   * @param page_kind kind of page where record is located
    */
-  void LogUpdateOp(RecordPageSlot::Location &location,
-                   RecordPageSlot &old_page_slot,
-                   RecordPageSlot &new_page_slot) {
+  void LogUpdateOp(
+      RecordPageSlot::Location &location, RecordPageSlot &old_page_slot,
+      RecordPageSlot &new_page_slot,
+      LogRecord::PageKind page_kind = LogRecord::PageKind::RECORD) {
     // Stage Page ID
-    staged.insert(location.page_id);
+    staged[page_kind].insert(location.page_id);
     // Log record for update operation
     LogRecord log_record(id, log_location, LogRecord::Type::UPDATE, location,
-                         old_page_slot, new_page_slot);
+                         old_page_slot, new_page_slot, page_kind);
     log_location = log_manager.Add(log_record);
   }
 
@@ -143,23 +161,76 @@ public:
    *
    * @param location location where record is located
    * @param page_slot page slot deleted
+   * @param page_kind kind of page where record is located
    */
-  void LogDeleteOp(RecordPageSlot::Location &location,
-                   RecordPageSlot &page_slot) {
+  void LogDeleteOp(
+      RecordPageSlot::Location &location, RecordPageSlot &page_slot,
+      LogRecord::PageKind page_kind = LogRecord::PageKind::RECORD) {
     // Stage Page ID
-    staged.insert(location.page_id);
+    staged[page_kind].insert(location.page_id);
+    if (page_kind == LogRecord::PageKind::RECORD) {
+      removed[location.page_id].insert(location.slot_id);
+    }
     // Log record for delete operation
     LogRecord log_record(id, log_location, LogRecord::Type::DELETE, location,
-                         page_slot);
+                         page_slot, page_kind);
     log_location = log_manager.Add(log_record);
   }
 
+  /**
+   * @brief Log DEALLOCATE operation.
+   *
+   * @param page_id ID of the deallocated page
+   */
+  void LogDeallocateOp(PageId page_id) {
+    // Log record for page deallocation
+    RecordPageSlot::Location location(page_id, 0);
+    LogRecord log_record(id, log_location, LogRecord::Type::DEALLOCATE,
+                         location, RecordPageSlot());
+    log_location = log_manager.Add(log_record);
+  }
+
+  /**
+   * @brief Get the log manager to which the transaction logs its records.
+   *
+   * @returns reference to the log manager
+   */
+  LogManager &GetLogManager() { return log_manager; }
+
+  /**
+   * @brief Mark page with given ID to be deallocated once the transaction
+   * commits. The page is kept until then so that an abort can restore it.
+   *
+   * @param page_id ID of the page emptied by the transaction
+   */
+  void FreePage(PageId page_id) { freed.insert(page_id); }
+
+  /**
+   * @brief Get the IDs of pages to deallocate once the transaction commits.
+   *
+   * @returns constant reference to set of page IDs
+   */
+  const std::set<PageId> &GetFreed() const { return freed; }
+
+  /**
+   * @brief Get the IDs of record page slots to release once the transaction
+   * commits or aborts.
+   *
+   * @returns constant reference to sets of slot IDs mapped to their page ID
+   */
+  const std::map<PageId, std::set<PageSlotId>> &GetRemoved() const {
+    return removed;
+  }
+
   /**
    * @brief Get the staged page IDs in the transaction.
    *
-   * @returns constant reference to set of staged page IDs
+   * @returns constant reference to sets of staged page IDs mapped to the kind
+   * of the pages
    */
-  const std::set<PageId> &GetStaged() const { return staged; }
+  const std::map<LogRecord::PageKind, std::set<PageId>> &GetStaged() const {
+    return staged;
+  }
 
   /**
    * @brief Get the transaction ID
@@ -25,10 +25,16 @@
 #ifndef PERSIST_CORE_TRANSACTION_MANAGER_HPP
 #define PERSIST_CORE_TRANSACTION_MANAGER_HPP
 
+#include <functional>
+#include <map>
+#include <vector>
+
 #include <persist/core/buffer/base.hpp>
+#include <persist/core/exceptions/wal.hpp>
 #include <persist/core/page/record_page/page.hpp>
 #include <persist/core/transaction/transaction.hpp>
 #include <persist/core/wal/log_manager.hpp>
+#include <persist/core/wal/parallel_log_manager.hpp>
 
 #include <persist/utility/uid.hpp>
 
@@ -55,10 +61,30 @@ class TransactionManager {
   BufferManagerBase<RecordPage> &buffer_manager;
 
   /**
-   * @brief Reference to Log Manager
+   * @brief Operations on registered pages of kinds other than record pages.
+   * The page kind marked in a log record selects the pages on which the
+   * logged operation is undone.
+   *
+   */
+  struct PageOps {
+    std::function<void(Transaction &, LogRecord &)> undo;
+    std::function<bool(PageId)> flush;
+  };
+  std::map<LogRecord::PageKind, PageOps> page_ops;
+
+  /**
+   * @brief Pointer to Log Manager. Set only when log records are appended to
+   * a single log.
    *
    */
-  LogManager &log_manager;
+  LogManager *log_manager;
+
+  /**
+   * @brief Pointer to Parallel Log Manager. Set only when log records are
+   * appended to parallel log streams.
+   *
+   */
+  ParallelLogManager *parallel_log_manager;
 
   /**
    * @brief Flag indicating transaction manager started.
@@ -76,7 +102,7 @@ class TransactionManager {
     LogRecord log_record(txn.GetId(), txn.GetLogLocation(),
                          LogRecord::Type::BEGIN);
     // Add log record and update the location in the transaction
-    txn.SetLogLocation(log_manager.Add(log_record));
+    txn.SetLogLocation(txn.GetLogManager().Add(log_record));
   }
 
   /**
@@ -89,7 +115,7 @@ class TransactionManager {
     LogRecord log_record(txn.GetId(), txn.GetLogLocation(),
                          LogRecord::Type::ABORT);
     // Add log record and update the location in the transaction
-    txn.SetLogLocation(log_manager.Add(log_record));
+    txn.SetLogLocation(txn.GetLogManager().Add(log_record));
   }
 
   /**
@@ -102,7 +128,33 @@ class TransactionManager {
     LogRecord log_record(txn.GetId(), txn.GetLogLocation(),
                          LogRecord::Type::COMMIT);
     // Add log record and update the location in the transaction
-    txn.SetLogLocation(log_manager.Add(log_record));
+    txn.SetLogLocation(txn.GetLogManager().Add(log_record));
+  }
+
+  /**
+   * @brief Get the log manager for a new transaction. With parallel log
+   * streams this is the stream of the calling thread.
+   *
+   * @returns reference to the log manager
+   */
+  LogManager &GetLogManager() {
+    return parallel_log_manager ? parallel_log_manager->GetStream()
+                                : *log_manager;
+  }
+
+  /**
+   * @brief Get operations on registered pages of given kind.
+   *
+   * @param page_kind kind of pages
+   * @returns reference to the page operations
+   * @throws LogRecordUndoError if no pages of given kind are registered
+   */
+  PageOps &GetPageOps(LogRecord::PageKind page_kind) {
+    auto it = page_ops.find(page_kind);
+    if (it == page_ops.end()) {
+      throw LogRecordUndoError("No pages registered for the logged page kind.");
+    }
+    return it->second;
   }
 
   /**
@@ -112,6 +164,18 @@ class TransactionManager {
    * @param log_record log record of the operation to undo
    */
   void Undo(Transaction &txn, LogRecord &log_record) {
+    if (log_record.GetPageKind() != LogRecord::PageKind::RECORD) {
+      switch (log_record.GetLogType()) {
+      case LogRecord::Type::INSERT:
+      case LogRecord::Type::DELETE:
+      case LogRecord::Type::UPDATE:
+        GetPageOps(log_record.GetPageKind()).undo(txn, log_record);
+        break;
+      default:
+        break;
+      }
+      return;
+    }
     switch (log_record.GetLogType()) {
     case LogRecord::Type::INSERT: {
       auto page = buffer_manager.Get(log_record.GetLocation().page_id);
@@ -126,9 +190,10 @@ class TransactionManager {
     }
     case LogRecord::Type::UPDATE: {
       auto page = buffer_manager.Get(log_record.GetLocation().page_id);
-      // NOTE: The value from log record object is being moved
-      page->UpdatePageSlot(log_record.GetLocation().slot_id,
-                           log_record.GetPageSlotA(), txn);
+      // Undo the update delta on the current page slot
+      RecordPageSlot page_slot = log_record.Undo(
+          page->GetPageSlot(log_record.GetLocation().slot_id, txn));
+      page->UpdatePageSlot(log_record.GetLocation().slot_id, page_slot, txn);
       break;
     }
     default:
@@ -136,6 +201,23 @@ class TransactionManager {
     }
   }
 
+  /**
+   * @brief Release the record page slots removed during given transaction so
+   * that their IDs are re-used. This is done only once the transaction
+   * commits or aborts, else another slot could take the ID of a slot whose
+   * removal is rolled back.
+   *
+   * @param txn reference to the completed transaction
+   */
+  void Release(Transaction &txn) {
+    for (auto &element : txn.GetRemoved()) {
+      auto page = buffer_manager.Get(element.first);
+      for (auto slot_id : element.second) {
+        page->ReleasePageSlot(slot_id);
+      }
+    }
+  }
+
 public:
   /**
    * @brief Construct a new Transaction Manager object
@@ -145,10 +227,50 @@ public:
    * @param buffer_manager Reference to record page buffer manager.
    * @param log_manager Reference to log manager.
    */
-  TransactionManager(BufferManager<RecordPage> &buffer_manager,
+  TransactionManager(BufferManagerBase<RecordPage> &buffer_manager,
                      LogManager &log_manager)
-      : buffer_manager(buffer_manager), log_manager(log_manager),
-        started(false) {}
+      : buffer_manager(buffer_manager), log_manager(&log_manager),
+        parallel_log_manager(nullptr), started(false) {}
+
+  /**
+   * @brief Construct a new Transaction Manager object appending log records
+   * to parallel log streams. Each transaction logs to the stream of the
+   * thread beginning it, and its commit waits only on that stream.
+   *
+   * @param buffer_manager Reference to record page buffer manager.
+   * @param log_manager Reference to parallel log manager.
+   */
+  TransactionManager(BufferManagerBase<RecordPage> &buffer_manager,
+                     ParallelLogManager &log_manager)
+      : buffer_manager(buffer_manager), log_manager(nullptr),
+        parallel_log_manager(&log_manager), started(false) {}
+
+  /**
+   * @brief Register the buffer manager of pages of a type other than record
+   * pages whose operations are logged as part of transactions. Operations
+   * logged on these pages are undone through the buffer manager when a
+   * transaction aborts, and the modified pages are flushed through it on a
+   * force mode commit. Pages of a single type are registered for every page
+   * kind.
+   *
+   * @tparam PageType type of pages which declares the kind of page marked in
+   * its log records and undoes logged operations
+   * @param buffer_manager Reference to buffer manager of the pages.
+   */
+  template <class PageType>
+  void Register(BufferManagerBase<PageType> &buffer_manager) {
+    static_assert(PageType::page_kind != LogRecord::PageKind::RECORD,
+                  "Record pages are managed by the transaction manager.");
+    LogRecord::PageKind page_kind = PageType::page_kind;
+    PageOps &ops = page_ops[page_kind];
+    ops.undo = [&buffer_manager](Transaction &txn, LogRecord &log_record) {
+      auto page = buffer_manager.Get(log_record.GetLocation().page_id);
+      page->Undo(log_record, txn);
+    };
+    ops.flush = [&buffer_manager](PageId page_id) {
+      return buffer_manager.Flush(page_id);
+    };
+  }
 
   /**
    * @brief Start transaction manager.
@@ -157,7 +279,12 @@ public:
   void Start() {
     if (!started) {
       // Start log manager.
-      log_manager.Start();
+      if (parallel_log_manager) {
+        parallel_log_manager->Start();
+      } else {
+        log_manager->Start();
+      }
+      started = true;
     }
   }
 
@@ -168,7 +295,38 @@ public:
   void Stop() {
     if (started) {
       // Stop log manager.
-      log_manager.Stop();
+      if (parallel_log_manager) {
+        parallel_log_manager->Stop();
+      } else {
+        log_manager->Stop();
+      }
+      started = false;
+    }
+  }
+
+  /**
+   * @brief Get the log sync policy used on commit.
+   */
+  SyncPolicy GetSyncPolicy() {
+    return parallel_log_manager ? parallel_log_manager->GetSyncPolicy()
+                                : log_manager->GetSyncPolicy();
+  }
+
+  /**
+   * @brief Set the log sync policy used on commit. This trades commit latency
+   * for durability of committed transactions on a power loss. The policy
+   * takes effect the next time the transaction manager is started.
+   *
+   * @param policy log sync policy
+   * @param interval interval in milliseconds between background log syncs for
+   * interval sync policy
+   */
+  void SetSyncPolicy(SyncPolicy policy,
+                     size_t interval = DEFAULT_LOG_SYNC_INTERVAL) {
+    if (parallel_log_manager) {
+      parallel_log_manager->SetSyncPolicy(policy, interval);
+    } else {
+      log_manager->SetSyncPolicy(policy, interval);
     }
   }
 
@@ -179,7 +337,8 @@ public:
    */
   Transaction Begin() {
     // Create a new transaction
-    Transaction txn(log_manager, persist::uid(), Transaction::State::ACTIVE);
+    Transaction txn(GetLogManager(), persist::uid(),
+                    Transaction::State::ACTIVE);
     // Log transaction begin record
     LogBegin(txn);
 
@@ -198,15 +357,16 @@ public:
     if (txn.GetState() != Transaction::State::COMMITED &&
         txn.GetState() != Transaction::State::ABORTED) {
       // Undo all operations performed as part of the transaction
-      auto log_record = log_manager.Get(txn.GetLogLocation());
+      auto log_record = txn.GetLogManager().Get(txn.GetLogLocation());
       Undo(txn, *log_record);
       while (!log_record->GetPrevLocation().IsNull()) {
-        log_record = log_manager.Get(log_record->GetPrevLocation());
+        log_record = txn.GetLogManager().Get(log_record->GetPrevLocation());
         Undo(txn, *log_record);
       }
 
       // Log transaction abort record
       LogAbort(txn);
+      Release(txn);
 
       // NOTE: No need to flush log records and staged pages since the recovery
       // manager will always abort any unfinished transaction.
@@ -234,12 +394,34 @@ public:
         txn.GetState() != Transaction::State::ABORTED) {
       // Log transaction commit record
       LogCommit(txn);
-      // Flush all log records to stable storage
-      log_manager.Flush();
+      // Flush log records up to the commit record to stable storage. The
+      // flush is shared with concurrently committing transactions logging to
+      // the same log.
+      txn.GetLogManager().Flush(txn.GetLogLocation().seq_number);
       // Set transaction to partially commited state. This is in compliance
       // with the requirement that all log records are flushed to backend
       // storage on transaction commit.
       txn.SetState(Transaction::State::PARTIALLY_COMMITED);
+      Release(txn);
+
+      // Deallocate pages emptied by the transaction now that it can no longer
+      // be rolled back. The deallocations are logged and flushed together
+      // before any page is freed. Pages refilled or pinned in the meantime
+      // are kept.
+      std::vector<PageId> empty_page_ids;
+      for (auto page_id : txn.GetFreed()) {
+        if (buffer_manager.Get(page_id)->IsEmpty()) {
+          txn.LogDeallocateOp(page_id);
+          empty_page_ids.push_back(page_id);
+        }
+      }
+      if (!empty_page_ids.empty()) {
+        txn.GetLogManager().Flush(txn.GetLogLocation().seq_number);
+      }
+      for (auto page_id : empty_page_ids) {
+        buffer_manager.DeallocateIf(
+            page_id, [](RecordPage &page) { return page.IsEmpty(); });
+      }
 
       // Flush all staged pages if force mode commit
       if (force) {
@@ -247,8 +429,14 @@ public:
         // TODO: Use page IDs in log records instead of a staged list?
 
         // Flush all staged pages
-        for (auto page_id : txn.GetStaged()) {
-          buffer_manager.Flush(page_id);
+        for (auto &element : txn.GetStaged()) {
+          for (auto page_id : element.second) {
+            if (element.first == LogRecord::PageKind::RECORD) {
+              buffer_manager.Flush(page_id);
+            } else {
+              GetPageOps(element.first).flush(page_id);
+            }
+          }
         }
         // Set transaction to commited state as all modified pages by the
         // transaction have been flushed to disk.
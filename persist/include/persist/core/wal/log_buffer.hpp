@@ -0,0 +1,223 @@
+/**
+ * log/log_buffer.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Log Buffer
+ *
+ * The header file exposes an in-memory buffer that concurrent writers append
+ * log entries to without taking a lock.
+ */
+
+#ifndef PERSIST_CORE_WAL_LOG_BUFFER_HPP
+#define PERSIST_CORE_WAL_LOG_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+#include <persist/core/common.hpp>
+#include <persist/core/exceptions/wal.hpp>
+
+namespace persist {
+
+/**
+ * @brief Log Buffer
+ *
+ * The log buffer is a ring of bytes addressed by a monotonically increasing
+ * offset. Writers reserve space for an entry with an atomic fetch-add on the
+ * tail offset, copy the entry into the reserved space in parallel and then
+ * publish its completion by storing the entry size in the completion mark of
+ * its offset. A single consumer at a time consumes the contiguous prefix of
+ * completed entries from the head offset, which frees their space for reuse.
+ *
+ * Entries are aligned to 8 bytes and must fit in the capacity of the buffer.
+ * Callers check larger entries with `Fits` and handle them elsewhere.
+ */
+class LogBuffer {
+  PERSIST_PRIVATE
+  /**
+   * @brief Alignment of entries in bytes.
+   */
+  static const size_t alignment = 8;
+
+  /**
+   * @brief Capacity of the buffer in bytes.
+   */
+  size_t capacity;
+
+  /**
+   * @brief Ring of entry bytes.
+   */
+  std::unique_ptr<Byte[]> data;
+
+  /**
+   * @brief Completion marks, one for each aligned offset in the ring. The
+   * mark of the offset of an entry holds the entry size once the entry is
+   * completely written, and `0` otherwise.
+   */
+  std::unique_ptr<std::atomic<size_t>[]> marks;
+
+  /**
+   * @brief Offsets of the end of reserved space and of the start of space not
+   * yet consumed.
+   */
+  std::atomic<uint64_t> tail;
+  std::atomic<uint64_t> head;
+
+  /**
+   * @brief Buffer to join entries wrapping around the end of the ring for the
+   * consumer.
+   */
+  ByteBuffer scratch;
+
+  /**
+   * @brief Get size of an entry rounded up to the entry alignment.
+   *
+   * @param size entry size in bytes
+   */
+  static size_t Align(size_t size) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+public:
+  /**
+   * @brief Construct a new Log Buffer object
+   *
+   * @param capacity capacity of the buffer in bytes
+   */
+  explicit LogBuffer(size_t capacity = DEFAULT_LOG_BUFFER_CAPACITY)
+      : capacity(Align(capacity > 0 ? capacity : 1)),
+        data(new Byte[this->capacity]),
+        marks(new std::atomic<size_t>[this->capacity / alignment]), tail(0),
+        head(0) {
+    for (size_t i = 0; i < this->capacity / alignment; ++i) {
+      marks[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Get capacity of the buffer in bytes.
+   */
+  size_t GetCapacity() const { return capacity; }
+
+  /**
+   * @brief Check if an entry of given size fits in the buffer.
+   *
+   * @thread_safe
+   *
+   * @param size entry size in bytes
+   */
+  bool Fits(size_t size) const { return size > 0 && Align(size) <= capacity; }
+
+  /**
+   * @brief Reserve space for an entry of given size.
+   *
+   * @thread_safe
+   *
+   * @param size entry size in bytes
+   * @returns offset of the reserved space
+   * @throws LogBufferError if the entry is empty or does not fit in the
+   * buffer
+   */
+  uint64_t Reserve(size_t size) {
+    if (!Fits(size)) {
+      throw LogBufferError("Log entry does not fit in log buffer.");
+    }
+    return tail.fetch_add(Align(size), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Check if the reserved space at given offset has been freed by the
+   * consumer and can be written.
+   *
+   * @thread_safe
+   *
+   * @param offset offset of the reserved space
+   * @param size entry size in bytes
+   */
+  bool IsWritable(uint64_t offset, size_t size) const {
+    return offset + Align(size) <=
+           head.load(std::memory_order_acquire) + capacity;
+  }
+
+  /**
+   * @brief Write an entry into its reserved space and publish its completion.
+   * The reserved space must be writable.
+   *
+   * @thread_safe
+   *
+   * @param offset offset of the reserved space
+   * @param input input buffer span of the entry
+   */
+  void Write(uint64_t offset, Span input) {
+    size_t position = offset % capacity;
+    size_t size = std::min(input.size, capacity - position);
+    std::memcpy(data.get() + position, input.start, size);
+    std::memcpy(data.get(), input.start + size, input.size - size);
+    marks[position / alignment].store(input.size, std::memory_order_release);
+  }
+
+  /**
+   * @brief Consume the contiguous prefix of completed entries in order of
+   * their offsets. The space of each entry is freed once the handler returns.
+   *
+   * @thread_unsafe Only one consumer may consume entries at a time.
+   *
+   * @param handler callable invoked with the offset and the input buffer span
+   * of each consumed entry
+   * @returns number of consumed entries
+   */
+  template <class Handler> size_t Consume(Handler handler) {
+    uint64_t offset = head.load(std::memory_order_relaxed);
+    size_t count = 0;
+    while (true) {
+      size_t position = offset % capacity;
+      std::atomic<size_t> &mark = marks[position / alignment];
+      size_t size = mark.load(std::memory_order_acquire);
+      if (size == 0) {
+        break;
+      }
+      if (position + size <= capacity) {
+        handler(offset, Span(data.get() + position, size));
+      } else {
+        // Join entry wrapping around the end of the ring
+        scratch.resize(size);
+        std::memcpy(scratch.data(), data.get() + position, capacity - position);
+        std::memcpy(scratch.data() + capacity - position, data.get(),
+                    size - (capacity - position));
+        handler(offset, Span(scratch));
+      }
+      mark.store(0, std::memory_order_relaxed);
+      offset += Align(size);
+      head.store(offset, std::memory_order_release);
+      ++count;
+    }
+    return count;
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_WAL_LOG_BUFFER_HPP */
@@ -25,17 +25,40 @@
 #ifndef PERSIST_CORE_LOG_MANAGER_HPP
 #define PERSIST_CORE_LOG_MANAGER_HPP
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
 #include <memory>
+#include <thread>
 
 #include <persist/core/buffer/buffer_manager.hpp>
 #include <persist/core/page/log_page/page.hpp>
+#include <persist/core/wal/log_buffer.hpp>
 #include <persist/core/wal/log_record.hpp>
+#include <persist/core/wal/sequential_log.hpp>
 
 #include <persist/utility/mutex.hpp>
 
 namespace persist {
 
+/**
+ * @brief Log sync policy.
+ *
+ * The policy decides when log records flushed to the log storage are synced
+ * to durable media.
+ *
+ * - ALWAYS: The log is synced on every flush, i.e. on every group commit.
+ * Committed transactions survive a power loss.
+ * - INTERVAL: The log is synced in the background once every sync interval.
+ * Transactions committed within the last interval may be lost on a power
+ * loss.
+ * - NEVER: The log is only synced when the log manager is stopped.
+ */
+enum class SyncPolicy { ALWAYS, INTERVAL, NEVER };
+
 /**
  * @brief Log Manager Class
  *
@@ -59,26 +82,109 @@ class LogManager {
    *
    */
   std::atomic<SeqNumber> seq_number;
+  /**
+   * @brief Pointer to the clock shared by parallel log streams. Set only when
+   * the log manager is a stream of a parallel log manager, in which case the
+   * sequence numbers of log records are drawn from the shared clock so that
+   * they are ordered across all streams.
+   *
+   */
+  std::atomic<SeqNumber> *clock;
+  /**
+   * @brief Sequence number of the latest log record flushed to storage.
+   *
+   */
+  std::atomic<SeqNumber> flushed_seq_number;
+  /**
+   * @brief Group commit lock and condition variable. Committers waiting for
+   * their log records to be flushed sleep on the condition variable while a
+   * single leader flushes the log on their behalf.
+   *
+   */
+  typedef typename persist::Mutex<std::mutex> FlushMutex;
+  FlushMutex flush_lock; //<- lock guarding the state of the group flush
+  typedef typename persist::LockGuard<FlushMutex> FlushLockGuard;
+  std::condition_variable_any flush_cv; //<- Used to release waiting committers
+  bool flushing GUARDED_BY(flush_lock); //<- Flag indicating a leader flushing
+  /**
+   * @brief Lock serializing syncs of the log storage. It is held across the
+   * sync instead of the log manager lock so that log records can be added
+   * while the log is synced.
+   *
+   */
+  FlushMutex sync_lock;
   /**
    * @brief Identifer of the last page in the backend storage of the log.
    *
    */
   PageId last_page_id GUARDED_BY(lock);
   /**
-   * @brief Reference to backend log storage.
+   * @brief Pointer to backend log storage of log pages.
+   *
+   */
+  Storage<LogPage> *storage GUARDED_BY(lock);
+  /**
+   * @brief Log record buffer manager. Set only when log records are stored in
+   * log pages.
+   *
+   */
+  std::unique_ptr<BufferManager<LogPage>> buffer_manager;
+  /**
+   * @brief Pointer to sequential log. Set only when log records are stored in
+   * the sequential log instead of log pages.
+   *
+   */
+  SequentialLog *log GUARDED_BY(lock);
+  /**
+   * @brief Log record added by a writer waiting to be drained from the log
+   * buffer.
    *
    */
-  Storage<LogPage> &storage GUARDED_BY(lock);
+  struct PendingRecord {
+    LogRecord::Location location; //<- Location of the stored log record
+    std::exception_ptr error;     //<- Error raised storing the log record
+    std::atomic<bool> stored;     //<- Flag indicating log record is handled
+
+    PendingRecord() : stored(false) {}
+  };
   /**
-   * @brief Log record buffer manager.
+   * @brief Buffer of log records being added. Each entry holds the address of
+   * the pending record of its writer followed by the log record bytes.
    *
    */
-  BufferManager<LogPage> buffer_manager;
+  LogBuffer log_buffer;
   /**
    * @brief Flag indicating log manager started.
    *
    */
   bool started GUARDED_BY(lock);
+  /**
+   * @brief Log sync policy and interval in milliseconds between background
+   * syncs for interval sync policy.
+   *
+   */
+  SyncPolicy sync_policy GUARDED_BY(lock);
+  size_t sync_interval GUARDED_BY(lock);
+  /**
+   * @brief Sequence numbers of the latest log records written to and synced
+   * with the log storage.
+   *
+   */
+  SeqNumber written_seq_number GUARDED_BY(lock);
+  SeqNumber synced_seq_number GUARDED_BY(lock);
+  /**
+   * @brief Background log syncer for interval sync policy.
+   *
+   */
+  std::thread syncer;                    //<- Background log syncer thread
+  std::condition_variable_any syncer_cv; //<- Used to wake up the syncer
+  bool syncer_stop GUARDED_BY(lock);     //<- Flag to stop the syncer
+  /**
+   * @brief Log compression threshold in bytes. Log records larger than the
+   * threshold are compressed. Compression is disabled if set to `0`.
+   *
+   */
+  std::atomic<size_t> compression_threshold;
 
   /**
    * @brief Get a page with free space or a new page.
@@ -89,10 +195,12 @@ class LogManager {
     LockGuard guard(lock);
 
     // Get last page
-    auto page = buffer_manager.Get(last_page_id);
-    // Check if last page has free space else return a new page.
-    if (!page->GetFreeSpaceSize(Operation::INSERT)) {
-      auto new_page = buffer_manager.GetNew();
+    auto page = buffer_manager->Get(last_page_id);
+    // Check if last page has free space to store at least one byte of data in
+    // a page slot else return a new page.
+    if (page->GetFreeSpaceSize(Operation::INSERT) <=
+        LogPageSlot().GetStorageSize()) {
+      auto new_page = buffer_manager->GetNew();
       // Set the ID of the new page as last page ID.
       last_page_id = new_page->GetId();
 
@@ -102,81 +210,80 @@ class LogManager {
     return page;
   }
 
-public:
   /**
-   * @brief Construct a new log manager object.
+   * @brief Sync written log records with durable media. The log records
+   * written so far are synced without holding the lock. The caller must not
+   * hold the lock.
    *
-   * @param storage Reference to backend log storage
-   * @param cache_size Log buffer cache size
    */
-  LogManager(Storage<LogPage> &storage,
-             size_t cache_size = DEFAULT_LOG_BUFFER_SIZE)
-      : seq_number(0), last_page_id(0), started(false), storage(storage),
-        buffer_manager(storage, cache_size) {}
+  void Sync() {
+    FlushLockGuard sync_guard(sync_lock);
+
+    SeqNumber last_seq_number;
+    {
+      LockGuard guard(lock);
+      if (synced_seq_number >= written_seq_number) {
+        return;
+      }
+      last_seq_number = written_seq_number;
+    }
+    if (log) {
+      log->Sync();
+    } else {
+      storage->Sync();
+    }
+
+    LockGuard guard(lock);
+    synced_seq_number = last_seq_number;
+  }
 
   /**
-   * @brief Start log manager.
-   *
-   * @thread_unsafe The method is not thread safe as it is expected that the
-   * user starts the log manager before spawning any threads.
+   * @brief Write all log records to the log storage. The caller must hold the
+   * lock.
    *
    */
-  void Start() NO_THREAD_SAFETY_ANALYSIS {
-    LockGuard guard(lock);
-
-    if (!started) {
-      // Start buffer manager
-      buffer_manager.Start();
-      // Load last page in buffer
-      last_page_id = storage.GetPageCount();
-      // Get last sequence number if last page ID is not 0 else create a new
-      // page and set its ID to the last page ID.
-      if (last_page_id) {
-        auto page = buffer_manager.Get(last_page_id);
-        seq_number = page->GetLastSeqNumber();
-      } else {
-        auto new_page = buffer_manager.GetNew();
-        last_page_id = new_page->GetId();
-      }
-      // Set state to started
-      started = true;
+  void Write() {
+    if (log) {
+      log->Flush();
+    } else {
+      buffer_manager->FlushAll();
     }
+    written_seq_number = seq_number;
   }
 
   /**
-   * @brief Stop log manager.
-   *
-   * @thread_unsafe The method is not thread safe as it is expected that the
-   * user stops the log manager after joining all the threads.
+   * @brief Run the log syncer until stopped.
    *
    */
-  void Stop() NO_THREAD_SAFETY_ANALYSIS {
-    LockGuard guard(lock);
-
-    if (started) {
-      // Stop buffer manager
-      buffer_manager.Stop();
-      // Set state to stopped
-      started = false;
+  void RunSyncer() {
+    while (true) {
+      {
+        LockGuard guard(lock);
+        if (!syncer_stop) {
+          syncer_cv.wait_for(lock, std::chrono::milliseconds(sync_interval));
+        }
+        if (syncer_stop) {
+          return;
+        }
+      }
+      Sync();
     }
   }
 
   /**
-   * @brief Add log record to transaction logs
-   *
-   * @thread_safe
+   * @brief Store log record bytes with given sequence number in log pages or
+   * in the sequential log. The caller must hold the lock.
    *
-   * @param log_record reference to the log record object to add
-   * @returns sequence number of the added log record
+   * @param seq_number sequence number of the log record
+   * @param data input buffer span of the log record bytes
+   * @returns location of the stored log record
    */
-  LogRecord::Location Add(LogRecord &log_record) {
-    LockGuard guard(lock);
-
-    // Set log record sequence number
-    log_record.SetSeqNumber(++seq_number);
-    // Dump log record bytes
-    ByteBuffer data(log_record.GetStorageSize());
-    log_record.Dump(data);
+  LogRecord::Location Store(SeqNumber seq_number, Span data) {
+    // The location of a log record in the sequential log holds its LSN in
+    // place of the page ID.
+    if (log) {
+      return LogRecord::Location(log->Append(data), seq_number);
+    }
 
     // Check free space in page and size of log record. If the log record is
     // larger than the free space, split and store it into multiple page slots.
@@ -186,7 +293,7 @@ public:
     // Null page slot representing a virtual previous from first slot
     LogPageSlot null_slot;
     // Bookkeeping variables
-    size_t to_write_size = data.size(), written_size = 0;
+    size_t to_write_size = data.size, written_size = 0;
     // Pointer to previous page slot in the linked list. Begins with
     // pointing to the null slot.
     LogPageSlot *prev_slot = &null_slot;
@@ -197,7 +304,7 @@ public:
       PageId page_id = page->GetId();
 
       // Create slot to add to page
-      LogPageSlot slot(log_record.GetSeqNumber());
+      LogPageSlot slot(seq_number);
       // Compute availble space to write data in page. Here the greedy approach
       // is utilized where all the available free space can be used to store the
       // data. The amount of data that can be stored in the page is the
@@ -209,13 +316,11 @@ public:
       }
       // Write data to slot and add to page
       slot.data.resize(write_space);
-      for (int i = 0; i < write_space; i++) {
-        slot.data[i] = data[written_size + i];
-      }
+      std::memcpy(slot.data.data(), data.start + written_size, write_space);
       auto inserted = page->InsertPageSlot(slot);
 
       // Create linkage between slots
-      LogPageSlot::Location next_location(page_id, log_record.GetSeqNumber());
+      LogPageSlot::Location next_location(page_id, seq_number);
       // TODO: This will cause data race unless a slot level lock is used.
       prev_slot->SetNextLocation(next_location);
 
@@ -230,6 +335,337 @@ public:
     return null_slot.GetNextLocation();
   }
 
+  /**
+   * @brief Assign the next sequence number to log record bytes and store
+   * them. The caller must hold the lock.
+   *
+   * @param data input buffer span of the log record bytes
+   * @returns location of the stored log record
+   */
+  LogRecord::Location Store(Span data) {
+    // Set log record sequence number
+    LogRecord::Header header;
+    header.Load(data);
+    header.seq_number = clock ? ++*clock : seq_number + 1;
+    seq_number = header.seq_number;
+    header.Dump(data);
+
+    return Store(header.seq_number, data);
+  }
+
+  /**
+   * @brief Drain the completed log records from the log buffer into the log
+   * storage in the order their space was reserved. Sequence numbers are
+   * assigned in the same order. An error storing a log record is handed to
+   * its writer instead of the draining thread. The caller must hold the lock.
+   *
+   * @returns number of drained log records
+   */
+  size_t Drain() {
+    return log_buffer.Consume([this](uint64_t, Span entry) {
+      PendingRecord *pending;
+      std::memcpy(&pending, entry.start, sizeof(pending));
+      entry += sizeof(pending);
+      // Store log record and release the waiting writer
+      try {
+        pending->location = Store(entry);
+      } catch (...) {
+        pending->error = std::current_exception();
+      }
+      pending->stored.store(true, std::memory_order_release);
+    });
+  }
+
+  /**
+   * @brief Drain the log buffer unless another thread is draining it. The
+   * thread yields if no log record was drained.
+   *
+   */
+  void TryDrain() {
+    size_t count = 0;
+    if (lock.try_lock()) {
+      try {
+        count = Drain();
+      } catch (...) {
+        lock.unlock();
+        throw;
+      }
+      lock.unlock();
+    }
+    if (count == 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  /**
+   * @brief Stop the log syncer if running.
+   *
+   */
+  void StopSyncer() {
+    {
+      LockGuard guard(lock);
+      syncer_stop = true;
+    }
+    syncer_cv.notify_all();
+    if (syncer.joinable()) {
+      syncer.join();
+    }
+  }
+
+public:
+  /**
+   * @brief Construct a new log manager object.
+   *
+   * @param storage Reference to backend log storage
+   * @param cache_size Log buffer cache size
+   */
+  LogManager(Storage<LogPage> &storage,
+             size_t cache_size = DEFAULT_LOG_BUFFER_SIZE)
+      : seq_number(0), clock(nullptr), flushed_seq_number(0),
+        flushing(false), last_page_id(0), storage(&storage),
+        buffer_manager(std::make_unique<BufferManager<LogPage>>(storage,
+                                                                 cache_size)),
+        log(nullptr), started(false), sync_policy(SyncPolicy::ALWAYS),
+        sync_interval(DEFAULT_LOG_SYNC_INTERVAL), written_seq_number(0),
+        synced_seq_number(0), syncer_stop(false), compression_threshold(0) {}
+
+  /**
+   * @brief Construct a new log manager object storing log records in a
+   * sequential log.
+   *
+   * @param log Reference to sequential log
+   */
+  LogManager(SequentialLog &log)
+      : seq_number(0), clock(nullptr), flushed_seq_number(0),
+        flushing(false), last_page_id(0), storage(nullptr), log(&log),
+        started(false), sync_policy(SyncPolicy::ALWAYS),
+        sync_interval(DEFAULT_LOG_SYNC_INTERVAL), written_seq_number(0),
+        synced_seq_number(0), syncer_stop(false), compression_threshold(0) {}
+
+  /**
+   * @brief Construct a new log manager object storing log records in a
+   * sequential log as one of several parallel log streams. Sequence numbers
+   * of log records are drawn from the clock shared by the streams.
+   *
+   * @param log Reference to sequential log of the stream
+   * @param clock Reference to the clock shared by the streams
+   */
+  LogManager(SequentialLog &log, std::atomic<SeqNumber> &clock)
+      : LogManager(log) {
+    this->clock = &clock;
+  }
+
+  /**
+   * @brief Destroy the log manager object. The background syncer is stopped.
+   *
+   */
+  ~LogManager() { StopSyncer(); }
+
+  /**
+   * @brief Get log sync policy.
+   *
+   * @thread_safe
+   */
+  SyncPolicy GetSyncPolicy() {
+    LockGuard guard(lock);
+    return sync_policy;
+  }
+
+  /**
+   * @brief Get the interval in milliseconds between background log syncs.
+   *
+   * @thread_safe
+   */
+  size_t GetSyncInterval() {
+    LockGuard guard(lock);
+    return sync_interval;
+  }
+
+  /**
+   * @brief Set log sync policy. The policy takes effect the next time the log
+   * manager is started.
+   *
+   * @thread_safe
+   *
+   * @param policy log sync policy
+   * @param interval interval in milliseconds between background log syncs for
+   * interval sync policy
+   */
+  void SetSyncPolicy(SyncPolicy policy,
+                     size_t interval = DEFAULT_LOG_SYNC_INTERVAL) {
+    LockGuard guard(lock);
+    sync_policy = policy;
+    sync_interval = std::max<size_t>(interval, 1);
+  }
+
+  /**
+   * @brief Check if log compression is enabled.
+   *
+   * @thread_safe
+   */
+  bool IsCompressionEnabled() const { return compression_threshold > 0; }
+
+  /**
+   * @brief Enable or disable log compression. Log records added afterwards
+   * which are larger than the threshold are stored compressed. Compressed and
+   * uncompressed log records can be read from the same log.
+   *
+   * @thread_safe
+   *
+   * @param enabled `true` to enable compression else `false`
+   * @param threshold size in bytes beyond which log records are compressed
+   */
+  void SetCompression(bool enabled,
+                      size_t threshold = DEFAULT_LOG_COMPRESSION_THRESHOLD) {
+    compression_threshold = enabled ? std::max<size_t>(threshold, 1) : 0;
+  }
+
+  /**
+   * @brief Start log manager.
+   *
+   * @thread_unsafe The method is not thread safe as it is expected that the
+   * user starts the log manager before spawning any threads.
+   *
+   */
+  void Start() NO_THREAD_SAFETY_ANALYSIS {
+    LockGuard guard(lock);
+
+    if (!started) {
+      if (log) {
+        // Open sequential log and get last sequence number from the header of
+        // the last log record.
+        log->Open();
+        if (!log->IsEmpty()) {
+          ByteBuffer read = log->Read(log->GetLastLsn());
+          LogRecord::Header header;
+          header.Load(read);
+          seq_number = header.seq_number;
+        }
+      } else {
+        // Start buffer manager
+        buffer_manager->Start();
+        // Load last page in buffer
+        last_page_id = storage->GetPageCount();
+        // Get last sequence number if last page ID is not 0 else create a new
+        // page and set its ID to the last page ID.
+        if (last_page_id) {
+          auto page = buffer_manager->Get(last_page_id);
+          seq_number = page->GetLastSeqNumber();
+        } else {
+          auto new_page = buffer_manager->GetNew();
+          last_page_id = new_page->GetId();
+        }
+      }
+      // Advance the shared clock past the log records of the stream
+      if (clock) {
+        SeqNumber time = *clock;
+        while (time < seq_number &&
+               !clock->compare_exchange_weak(time, seq_number)) {
+        }
+      }
+      // Log records present in storage are already durable
+      flushed_seq_number = seq_number.load();
+      written_seq_number = seq_number;
+      synced_seq_number = seq_number;
+      // Set state to started
+      started = true;
+
+      // Start background syncer
+      if (sync_policy == SyncPolicy::INTERVAL) {
+        syncer_stop = false;
+        syncer = std::thread(&LogManager::RunSyncer, this);
+      }
+    }
+  }
+
+  /**
+   * @brief Stop log manager.
+   *
+   * @thread_unsafe The method is not thread safe as it is expected that the
+   * user stops the log manager after joining all the threads.
+   *
+   */
+  void Stop() NO_THREAD_SAFETY_ANALYSIS {
+    StopSyncer();
+
+    {
+      LockGuard guard(lock);
+      if (!started) {
+        return;
+      }
+      // Write all log records
+      Write();
+    }
+    // Sync all log records
+    Sync();
+
+    LockGuard guard(lock);
+
+    // Close sequential log or stop buffer manager
+    if (log) {
+      log->Close();
+    } else {
+      buffer_manager->Stop();
+    }
+    // Set state to stopped
+    started = false;
+  }
+
+  /**
+   * @brief Add log record to transaction logs. The log record is dumped,
+   * compressed if enabled, and copied into the log buffer without holding the
+   * lock, after which the writer waits for it to be drained into the log
+   * storage by any of the waiting writers. A log record too large for the log
+   * buffer is stored directly under the lock after draining the log buffer.
+   *
+   * @thread_safe
+   *
+   * @param log_record reference to the log record object to add
+   * @returns location of the added log record
+   */
+  LogRecord::Location Add(LogRecord &log_record) {
+    // Dump log record bytes behind the address of the pending record
+    PendingRecord pending;
+    PendingRecord *address = &pending;
+    ByteBuffer entry(sizeof(address) + log_record.GetStorageSize());
+    std::memcpy(entry.data(), &address, sizeof(address));
+    log_record.Dump(Span(entry) + sizeof(address));
+    size_t threshold = compression_threshold;
+    if (threshold > 0 && log_record.GetStorageSize() > threshold) {
+      LogRecord::Compress(entry, sizeof(address));
+    }
+
+    // Store log record too large for the log buffer after the log records
+    // drained before it
+    if (!log_buffer.Fits(entry.size())) {
+      LockGuard guard(lock);
+      Drain();
+      LogRecord::Location location = Store(Span(entry) + sizeof(address));
+      log_record.SetSeqNumber(location.seq_number);
+
+      return location;
+    }
+
+    // Reserve space in the log buffer and write once the space is freed
+    uint64_t offset = log_buffer.Reserve(entry.size());
+    while (!log_buffer.IsWritable(offset, entry.size())) {
+      TryDrain();
+    }
+    log_buffer.Write(offset, entry);
+
+    // Wait for the log record to be stored
+    while (!pending.stored.load(std::memory_order_acquire)) {
+      TryDrain();
+    }
+    if (pending.error) {
+      std::rethrow_exception(pending.error);
+    }
+    // Set log record sequence number
+    log_record.SetSeqNumber(pending.location.seq_number);
+
+    return pending.location;
+  }
+
   /**
    * @brief Get Log record of given sequence number.
    *
@@ -244,13 +680,22 @@ public:
     // Get the first page slot from the given location and create the log record
     // by joining all related slots.
 
+    // Read log record from sequential log
+    if (log) {
+      ByteBuffer read = log->Read(location.page_id);
+      std::unique_ptr<LogRecord> log_record = std::make_unique<LogRecord>();
+      log_record->Load(read);
+
+      return log_record;
+    }
+
     // Byte buffer to read
     ByteBuffer read;
     // Start reading record blocks
     LogPageSlot::Location read_location = location;
     while (!read_location.IsNull()) {
       // Get page
-      auto page = buffer_manager.Get(read_location.page_id);
+      auto page = buffer_manager->Get(read_location.page_id);
       // Get page slot
       const LogPageSlot &slot = page->GetPageSlot(read_location.seq_number);
       // Append data stored in slot to output buffer
@@ -267,15 +712,96 @@ public:
   }
 
   /**
-   * @brief Flush all log records to storage. This method is used by transaction
-   * manager when a transaction is committed.
+   * @brief Flush log records up to the given sequence number to storage. This
+   * method is used by transaction manager when a transaction is committed.
+   *
+   * Concurrent callers are grouped together. The first caller becomes the
+   * leader and flushes all log records added so far, while the remaining
+   * callers wait. Every caller whose log record is covered by the flush is
+   * released once it completes, and the others elect a new leader. Callers
+   * whose log record has already been flushed return immediately.
    *
    * @thread_safe
+   *
+   * @param seq_number sequence number of the log record to flush
    */
-  void Flush() {
-    LockGuard guard(lock);
+  void Flush(SeqNumber seq_number) {
+    // Return without locking if the log record is already durable
+    if (flushed_seq_number >= seq_number) {
+      return;
+    }
+
+    FlushLockGuard guard(flush_lock);
+    while (flushed_seq_number < seq_number) {
+      // Wait for the current leader to finish flushing
+      if (flushing) {
+        flush_cv.wait(flush_lock);
+        continue;
+      }
 
-    buffer_manager.FlushAll();
+      // Become leader and flush the log without holding the flush lock so
+      // that new committers can queue up for the next flush. The log is
+      // synced without holding the log manager lock so that log records can
+      // be added meanwhile.
+      flushing = true;
+      flush_lock.unlock();
+      SeqNumber last_seq_number;
+      try {
+        bool sync;
+        {
+          LockGuard log_guard(lock);
+          last_seq_number = this->seq_number;
+          Write();
+          sync = sync_policy == SyncPolicy::ALWAYS;
+        }
+        if (sync) {
+          Sync();
+        }
+      } catch (...) {
+        flush_lock.lock();
+        flushing = false;
+        flush_cv.notify_all();
+        throw;
+      }
+      flush_lock.lock();
+
+      // Release all committers covered by the flush
+      if (flushed_seq_number < last_seq_number) {
+        flushed_seq_number = last_seq_number;
+      }
+      flushing = false;
+      flush_cv.notify_all();
+    }
+  }
+
+  /**
+   * @brief Flush all log records to storage.
+   *
+   * @thread_safe
+   */
+  void Flush() { Flush(seq_number); }
+
+  /**
+   * @brief Get the sequence number of the latest log record flushed to
+   * storage.
+   *
+   * @thread_safe
+   *
+   * @returns sequence number of the latest flushed log record
+   */
+  SeqNumber GetFlushedSeqNumber() const { return flushed_seq_number; }
+
+  /**
+   * @brief Get the sequence number of the latest log record synced with
+   * durable media.
+   *
+   * @thread_safe
+   *
+   * @returns sequence number of the latest synced log record
+   */
+  SeqNumber GetSyncedSeqNumber() {
+    LockGuard guard(lock);
+    return synced_seq_number;
   }
 
 #ifdef __PERSIST_DEBUG__
@@ -37,9 +37,12 @@
 
 #include <persist/core/common.hpp>
 #include <persist/core/exceptions/wal.hpp>
+#include <persist/core/fixed_storable.hpp>
 #include <persist/core/page/log_page/slot.hpp>
 #include <persist/core/page/record_page/slot.hpp>
+#include <persist/core/wal/page_slot_delta.hpp>
 
+#include <persist/utility/compression.hpp>
 #include <persist/utility/serializer.hpp>
 
 namespace persist {
@@ -62,7 +65,7 @@ public:
    *
    * The header contains the metadata information of the record.
    */
-  class Header : public Storable {
+  class Header : public FixedStorable<Header, LogRecordParseError> {
   public:
     /**
      * @brief Record sequence number
@@ -90,36 +93,10 @@ public:
           transaction_id(transaction_id) {}
 
     /**
-     * @brief Get size of the log record header.
+     * @brief Get the stored fields of the log record header.
      */
-    size_t GetStorageSize() const override { return sizeof(Header); }
-
-    /**
-     * Load record block header from byte string.
-     *
-     * @param input input buffer span to load
-     */
-    void Load(Span input) override {
-      if (input.size < GetStorageSize()) {
-        throw LogRecordParseError();
-      }
-      // Load bytes
-      persist::load(input, seq_number, prev_log_record_location,
-                    transaction_id);
-    }
-
-    /**
-     * Dump record block header as byte string.
-     *
-     * @param output output buffer span to dump
-     */
-    void Dump(Span output) override {
-      if (output.size < GetStorageSize()) {
-        throw LogRecordParseError();
-      }
-      // Dump bytes
-      persist::dump(output, seq_number, prev_log_record_location,
-                    transaction_id);
+    auto GetFields() {
+      return std::tie(seq_number, prev_log_record_location, transaction_id);
     }
 
     /**
@@ -164,17 +141,45 @@ public:
     INSERT,    //<- The log record represents insert operation as part of a
                // transaction.
     UPDATE,    //<- The log record represents update operation as part of a
-               // transaction.
+               // transaction. It stores the delta between the old and new
+               // page slots instead of the page slots.
     DELETE,    //<- The log record represents remove operation as part of a
                // transaction.
     ABORT, //<- The log record represents that a transaction has successfully
            // aborted. This implies that the transaction is in `ABORTED` state.
-    COMMIT //<- The log record represents a transaction has successfully
-           // comitted.
-           // This implies that the transaction is in `COMMITTED` state.
+    COMMIT, //<- The log record represents a transaction has successfully
+            // comitted.
+            // This implies that the transaction is in `COMMITTED` state.
+    DEALLOCATE //<- The log record represents deallocation of a page emptied
+               // by a committed transaction. The page is kept if it is
+               // pinned or refilled by the time it is freed.
+  };
+
+  /**
+   * @brief Kinds of pages targeted by INSERT, UPDATE and DELETE log records.
+   * The page kind decides how the logged operation is undone.
+   */
+  enum class PageKind : uint8_t {
+    RECORD = 0,   //<- The log record targets a record page.
+    FIXED_RECORD, //<- The log record targets a fixed record page.
+    PAX           //<- The log record targets a PAX page.
   };
 
   PERSIST_PRIVATE
+  /**
+   * @brief Flag set in the stored log record type of compressed log records.
+   * The rest of a compressed log record following the type is stored as its
+   * size followed by the compressed bytes.
+   */
+  static const uint32_t compressed_flag = 0x80000000;
+
+  /**
+   * @brief Position and mask of the page kind in the stored log record type.
+   * The page kind of log records written before page kinds were stored reads
+   * as a record page.
+   */
+  static const uint32_t page_kind_shift = 16;
+  static const uint32_t page_kind_mask = 0xFF << page_kind_shift;
 
   /**
    * @brief Log record header
@@ -187,6 +192,11 @@ public:
    */
   Type type;
 
+  /**
+   * @brief Kind of page targeted by log record
+   */
+  PageKind page_kind;
+
   /**
    * @brief Record page slot location
    */
@@ -197,11 +207,34 @@ public:
    */
   RecordPageSlot page_slot_a, page_slot_b;
 
+  /**
+   * @brief Delta between the old and new page slots of an UPDATE log record
+   */
+  PageSlotDelta delta;
+
+  /**
+   * @brief Get the stored image of a page slot.
+   */
+  static ByteBuffer GetImage(RecordPageSlot &page_slot) {
+    ByteBuffer image(page_slot.GetStorageSize());
+    page_slot.Dump(image);
+    return image;
+  }
+
+  /**
+   * @brief Get the page slot stored in an image.
+   */
+  static RecordPageSlot GetPageSlot(ByteBuffer image) {
+    RecordPageSlot page_slot;
+    page_slot.Load(image);
+    return page_slot;
+  }
+
 public:
   /**
    * Default constructor
    */
-  LogRecord() = default;
+  LogRecord() : page_kind(PageKind::RECORD) {}
 
   /**
    * @brief Construct a new Log Record object
@@ -211,30 +244,36 @@ public:
    */
   LogRecord(TransactionId transaction_id,
             Location prev_log_record_location = {0, 0}, Type type = Type::BEGIN)
-      : header(0, prev_log_record_location, transaction_id), type(type) {}
+      : header(0, prev_log_record_location, transaction_id), type(type),
+        page_kind(PageKind::RECORD) {}
 
   /**
    * @brief Construct a new Log Record object
    *
-   * This constructor is used to create INSERT and DELETE type log
+   * This constructor is used to create INSERT, DELETE and DEALLOCATE type log
    * records.
    */
   LogRecord(TransactionId transaction_id, Location prev_log_record_location,
             Type type, RecordPageSlot::Location location,
-            RecordPageSlot pageSlot)
+            RecordPageSlot pageSlot, PageKind page_kind = PageKind::RECORD)
       : header(0, prev_log_record_location, transaction_id), type(type),
-        location(location), page_slot_a(pageSlot) {}
+        page_kind(page_kind), location(location), page_slot_a(pageSlot) {}
 
   /**
    * @brief Construct a new Log Record object
    *
-   * This constructor is used to create UPDATE type log record.
+   * This constructor is used to create UPDATE type log record. Only the delta
+   * between the old and new page slots is stored.
    */
   LogRecord(TransactionId transaction_id, Location prev_log_record_location,
             Type type, RecordPageSlot::Location location,
-            RecordPageSlot oldPageSlot, RecordPageSlot newPageSlot)
+            RecordPageSlot oldPageSlot, RecordPageSlot newPageSlot,
+            PageKind page_kind = PageKind::RECORD)
       : header(0, prev_log_record_location, transaction_id), type(type),
-        location(location), page_slot_a(oldPageSlot), page_slot_b(newPageSlot) {
+        page_kind(page_kind), location(location) {
+    ByteBuffer old_image = GetImage(oldPageSlot);
+    ByteBuffer new_image = GetImage(newPageSlot);
+    delta = PageSlotDelta(old_image, new_image);
   }
 
   /**
@@ -276,6 +315,13 @@ public:
    */
   const Type &GetLogType() const { return type; }
 
+  /**
+   * @brief Get the kind of page targeted by log record
+   *
+   * @returns Consant reference to kind of targeted page
+   */
+  const PageKind &GetPageKind() const { return page_kind; }
+
   /**
    * @brief Get the page slot location targeted by log record
    *
@@ -299,17 +345,53 @@ public:
    */
   RecordPageSlot &GetPageSlotB() { return page_slot_b; }
 
+  /**
+   * @brief Get the page slot delta of an UPDATE log record
+   *
+   * @return Consant reference to page slot delta
+   */
+  const PageSlotDelta &GetDelta() const { return delta; }
+
+  /**
+   * @brief Redo the update of an UPDATE log record on the old page slot.
+   *
+   * @param page_slot old page slot
+   * @returns new page slot
+   * @throws LogRecordParseError if the page slot does not match the log record
+   */
+  RecordPageSlot Redo(RecordPageSlot page_slot) const {
+    ByteBuffer image = GetImage(page_slot);
+    return GetPageSlot(delta.Redo(image));
+  }
+
+  /**
+   * @brief Undo the update of an UPDATE log record on the new page slot.
+   *
+   * @param page_slot new page slot
+   * @returns old page slot
+   * @throws LogRecordParseError if the page slot does not match the log record
+   */
+  RecordPageSlot Undo(RecordPageSlot page_slot) const {
+    ByteBuffer image = GetImage(page_slot);
+    return GetPageSlot(delta.Undo(image));
+  }
+
   /**
    * @brief Get size of log record.
    * - sizeof(header)
    * - sizeof(type)
    * - sizeof(location)
+   * - delta.GetSize() for UPDATE log records, else
    * - page_slot_a.GetSize()
    * - page_slot_b.GetSize()
    */
   size_t GetStorageSize() const override {
-    return header.GetStorageSize() + sizeof(type) + sizeof(location) +
-           page_slot_a.GetStorageSize() + page_slot_b.GetStorageSize();
+    size_t size = Header::GetFixedStorageSize() + sizeof(type) +
+                  sizeof(location);
+    if (type == Type::UPDATE) {
+      return size + delta.GetStorageSize();
+    }
+    return size + page_slot_a.GetStorageSize() + page_slot_b.GetStorageSize();
   }
 
   /**
@@ -318,14 +400,40 @@ public:
    * @param input input buffer span to load
    */
   void Load(Span input) override {
-    if (input.size < GetStorageSize()) {
+    if (input.size < Header::GetFixedStorageSize() + sizeof(type)) {
       throw LogRecordParseError();
     }
     // Load header
     header.Load(input);
     input += header.GetStorageSize();
+    // Load type with page kind and decompress rest of the log record if
+    // compressed
+    uint32_t stored_type;
+    persist::load(input, stored_type);
+    type = static_cast<Type>(stored_type & ~(compressed_flag | page_kind_mask));
+    page_kind = static_cast<PageKind>((stored_type & page_kind_mask) >>
+                                      page_kind_shift);
+    ByteBuffer body;
+    if (stored_type & compressed_flag) {
+      uint64_t size;
+      if (!persist::load_varint(input, size)) {
+        throw LogRecordParseError();
+      }
+      body.resize(size);
+      if (!LzCodec::Decompress(input, body)) {
+        throw LogRecordParseError("Compressed log record is corrupt.");
+      }
+      input = Span(body);
+    }
     // Load bytes
-    persist::load(input, type, location);
+    if (input.size < sizeof(location)) {
+      throw LogRecordParseError();
+    }
+    persist::load(input, location);
+    if (type == Type::UPDATE) {
+      delta.Load(input);
+      return;
+    }
     page_slot_a.Load(input);
     input += page_slot_a.GetStorageSize();
     page_slot_b.Load(input);
@@ -345,20 +453,63 @@ public:
     header.Dump(output);
     output += header.GetStorageSize();
     // Dump bytes
-    persist::dump(output, type, location);
+    uint32_t stored_type = static_cast<uint32_t>(type) |
+                           static_cast<uint32_t>(page_kind) << page_kind_shift;
+    persist::dump(output, stored_type, location);
+    if (type == Type::UPDATE) {
+      delta.Dump(output);
+      return;
+    }
     page_slot_a.Dump(output);
     output += page_slot_a.GetStorageSize();
     page_slot_b.Dump(output);
     output += page_slot_b.GetStorageSize();
   }
 
+  /**
+   * @brief Compress a log record dumped in the buffer at given offset. The
+   * header and type of the log record are kept as is, so the header can still
+   * be read and updated, while the rest is replaced by its compressed bytes.
+   * The log record is left as is if it does not get smaller.
+   *
+   * @param buffer reference to the buffer containing the dumped log record
+   * at its end
+   * @param offset offset of the log record in the buffer
+   * @returns `true` if the log record was compressed else `false`
+   */
+  static bool Compress(ByteBuffer &buffer, size_t offset = 0) {
+    size_t type_offset = offset + Header::GetFixedStorageSize();
+    size_t body_offset = type_offset + sizeof(uint32_t);
+    if (buffer.size() <= body_offset) {
+      return false;
+    }
+    Span body(buffer.data() + body_offset, buffer.size() - body_offset);
+    ByteBuffer compressed(persist::varint_size(body.size));
+    Span output(compressed);
+    persist::dump_varint(output, body.size);
+    LzCodec::Compress(body, compressed);
+    if (compressed.size() >= body.size) {
+      return false;
+    }
+    // Flag the stored type and replace the rest by its compressed bytes
+    Span type_span(buffer.data() + type_offset, sizeof(uint32_t));
+    uint32_t stored_type;
+    persist::load(type_span, stored_type);
+    type_span = Span(buffer.data() + type_offset, sizeof(uint32_t));
+    persist::dump(type_span, stored_type | compressed_flag);
+    buffer.resize(body_offset);
+    buffer.insert(buffer.end(), compressed.begin(), compressed.end());
+    return true;
+  }
+
   /**
    * @brief Equality comparision operator.
    */
   bool operator==(const LogRecord &other) const {
     return header == other.header && type == other.type &&
-           location == other.location && page_slot_a == other.page_slot_a &&
-           page_slot_b == other.page_slot_b;
+           page_kind == other.page_kind && location == other.location &&
+           page_slot_a == other.page_slot_a &&
+           page_slot_b == other.page_slot_b && delta == other.delta;
   }
 
   /**
@@ -366,8 +517,9 @@ public:
    */
   bool operator!=(const LogRecord &other) const {
     return header != other.header || type != other.type ||
-           location != other.location || page_slot_a != other.page_slot_a ||
-           page_slot_b != other.page_slot_b;
+           page_kind != other.page_kind || location != other.location ||
+           page_slot_a != other.page_slot_a ||
+           page_slot_b != other.page_slot_b || delta != other.delta;
   }
 
 #ifdef __PERSIST_DEBUG__
@@ -0,0 +1,325 @@
+/**
+ * log/page_slot_delta.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Page Slot Delta
+ *
+ * The header file exposes the byte-range difference between two page slot
+ * images, used by update log records in place of full before and after images.
+ */
+
+#ifndef PERSIST_CORE_WAL_PAGE_SLOT_DELTA_HPP
+#define PERSIST_CORE_WAL_PAGE_SLOT_DELTA_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <persist/core/common.hpp>
+#include <persist/core/exceptions/wal.hpp>
+
+#include <persist/utility/serializer.hpp>
+
+namespace persist {
+
+/**
+ * @brief Page Slot Delta
+ *
+ * The delta stores the byte ranges in which the old and new stored images of a
+ * page slot differ. Each range holds its offset along with both the old and the
+ * new bytes, so the delta can be applied forwards to redo the update from the
+ * old image and backwards to undo it from the new image.
+ *
+ * Bytes common to the start and end of both images are never stored. If the
+ * changed part of the images is of the same size, it is further split into
+ * runs of changed bytes, so a small change to a large page slot produces a
+ * small delta.
+ */
+class PageSlotDelta : public Storable {
+  PERSIST_PRIVATE
+  /**
+   * @brief Unchanged gaps between changed runs shorter than this are stored as
+   * part of a single range, since a range costs about as much to store.
+   */
+  static const size_t min_gap_size = 4;
+
+  /**
+   * @brief Size of blocks of bytes compared at once when skipping unchanged
+   * bytes.
+   */
+  static const size_t block_size = 64;
+
+  /**
+   * @brief Get the number of equal bytes at the start of given byte arrays.
+   */
+  static size_t CountEqual(const Byte *a, const Byte *b, size_t size) {
+    size_t count = 0;
+    while (count + block_size <= size &&
+           std::memcmp(a + count, b + count, block_size) == 0) {
+      count += block_size;
+    }
+    while (count < size && a[count] == b[count]) {
+      ++count;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Get the number of equal bytes at the end of given byte arrays.
+   */
+  static size_t CountEqualReverse(const Byte *a_end, const Byte *b_end,
+                                  size_t size) {
+    size_t count = 0;
+    while (count + block_size <= size &&
+           std::memcmp(a_end - count - block_size, b_end - count - block_size,
+                       block_size) == 0) {
+      count += block_size;
+    }
+    while (count < size && a_end[-1 - count] == b_end[-1 - count]) {
+      ++count;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Changed byte range
+   */
+  struct Range {
+    size_t offset;   //<- offset of the range in the old image
+    size_t old_size; //<- size of the range in the old image
+    size_t new_size; //<- size of the range in the new image
+
+    /**
+     * @brief Equality comparision operator.
+     */
+    bool operator==(const Range &other) const {
+      return offset == other.offset && old_size == other.old_size &&
+             new_size == other.new_size;
+    }
+  };
+
+  /**
+   * @brief Changed byte ranges ordered by offset
+   */
+  std::vector<Range> ranges;
+
+  /**
+   * @brief Old bytes followed by new bytes of each range in order
+   */
+  ByteBuffer data;
+
+  /**
+   * @brief Add a changed range.
+   */
+  void AddRange(Span old_image, Span new_image, size_t offset,
+                size_t old_size, size_t new_size) {
+    ranges.push_back({offset, old_size, new_size});
+    data.insert(data.end(), old_image.start + offset,
+                old_image.start + offset + old_size);
+    data.insert(data.end(), new_image.start + offset,
+                new_image.start + offset + new_size);
+  }
+
+  /**
+   * @brief Apply the delta to an image in given direction.
+   *
+   * @param input input buffer span of the image to apply the delta to
+   * @param forward `true` to apply the delta to the old image and `false` to
+   * apply it to the new image
+   * @returns image with the delta applied
+   * @throws LogRecordParseError if the image does not match the delta
+   */
+  ByteBuffer Apply(Span input, bool forward) const {
+    ByteBuffer output;
+    output.reserve(input.size);
+    // Offsets of ranges are given in the old image and are shifted by the
+    // change in size of previous ranges in the new image.
+    size_t cursor = 0, shift = 0;
+    const Byte *bytes = data.data();
+    for (const Range &range : ranges) {
+      const Byte *from = forward ? bytes : bytes + range.old_size;
+      const Byte *to = forward ? bytes + range.old_size : bytes;
+      size_t from_size = forward ? range.old_size : range.new_size;
+      size_t to_size = forward ? range.new_size : range.old_size;
+      size_t offset = forward ? range.offset : range.offset + shift;
+      if (offset < cursor || offset + from_size > input.size ||
+          std::memcmp(input.start + offset, from, from_size) != 0) {
+        throw LogRecordParseError("Page slot does not match log record.");
+      }
+      output.insert(output.end(), input.start + cursor, input.start + offset);
+      output.insert(output.end(), to, to + to_size);
+      cursor = offset + from_size;
+      shift += range.new_size - range.old_size;
+      bytes += range.old_size + range.new_size;
+    }
+    output.insert(output.end(), input.start + cursor,
+                  input.start + input.size);
+    return output;
+  }
+
+public:
+  /**
+   * @brief Construct a new empty Page Slot Delta object
+   *
+   */
+  PageSlotDelta() {}
+
+  /**
+   * @brief Construct a new Page Slot Delta object from the difference between
+   * given images.
+   *
+   * @param old_image input buffer span of the old image
+   * @param new_image input buffer span of the new image
+   */
+  PageSlotDelta(Span old_image, Span new_image) {
+    size_t size = std::min(old_image.size, new_image.size);
+    // Skip common prefix and suffix
+    size_t prefix = CountEqual(old_image.start, new_image.start, size);
+    size_t suffix = CountEqualReverse(old_image.start + old_image.size,
+                                      new_image.start + new_image.size,
+                                      size - prefix);
+    size_t old_size = old_image.size - prefix - suffix;
+    size_t new_size = new_image.size - prefix - suffix;
+    if (old_size != new_size) {
+      AddRange(old_image, new_image, prefix, old_size, new_size);
+      return;
+    }
+    // Split changed part into runs of changed bytes
+    size_t end = prefix + old_size, offset = prefix;
+    while (offset < end) {
+      size_t run_end = offset + 1, gap = 0;
+      for (size_t i = run_end; i < end && gap < min_gap_size; ++i) {
+        if (old_image.start[i] != new_image.start[i]) {
+          run_end = i + 1;
+          gap = 0;
+        } else {
+          ++gap;
+        }
+      }
+      AddRange(old_image, new_image, offset, run_end - offset,
+               run_end - offset);
+      offset = run_end + CountEqual(old_image.start + run_end,
+                                    new_image.start + run_end, end - run_end);
+    }
+  }
+
+  /**
+   * @brief Check if the delta has no changes.
+   */
+  bool IsEmpty() const { return ranges.empty(); }
+
+  /**
+   * @brief Redo the change on the old image.
+   *
+   * @param old_image input buffer span of the old image
+   * @returns new image
+   * @throws LogRecordParseError if the old image does not match the delta
+   */
+  ByteBuffer Redo(Span old_image) const { return Apply(old_image, true); }
+
+  /**
+   * @brief Undo the change on the new image.
+   *
+   * @param new_image input buffer span of the new image
+   * @returns old image
+   * @throws LogRecordParseError if the new image does not match the delta
+   */
+  ByteBuffer Undo(Span new_image) const { return Apply(new_image, false); }
+
+  /**
+   * @brief Get storage size of the delta.
+   */
+  size_t GetStorageSize() const override {
+    size_t size = varint_size(ranges.size()) + data.size();
+    for (const Range &range : ranges) {
+      size += varint_size(range.offset) + varint_size(range.old_size) +
+              varint_size(range.new_size);
+    }
+    return size;
+  }
+
+  /**
+   * Load delta from byte string.
+   *
+   * @param input input buffer span to load
+   */
+  void Load(Span input) override {
+    uint64_t count;
+    if (!load_varint(input, count)) {
+      throw LogRecordParseError();
+    }
+    ranges.clear();
+    data.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+      uint64_t offset, old_size, new_size;
+      if (!load_varint(input, offset) || !load_varint(input, old_size) ||
+          !load_varint(input, new_size) ||
+          input.size < old_size + new_size) {
+        throw LogRecordParseError();
+      }
+      ranges.push_back({offset, old_size, new_size});
+      data.insert(data.end(), input.start, input.start + old_size + new_size);
+      input += old_size + new_size;
+    }
+  }
+
+  /**
+   * Dump delta as byte string.
+   *
+   * @param output output buffer span to dump
+   */
+  void Dump(Span output) override {
+    if (output.size < GetStorageSize()) {
+      throw LogRecordParseError();
+    }
+    dump_varint(output, ranges.size());
+    const Byte *bytes = data.data();
+    for (Range &range : ranges) {
+      dump_varint(output, range.offset);
+      dump_varint(output, range.old_size);
+      dump_varint(output, range.new_size);
+      std::memcpy(output.start, bytes, range.old_size + range.new_size);
+      output += range.old_size + range.new_size;
+      bytes += range.old_size + range.new_size;
+    }
+  }
+
+  /**
+   * @brief Equality comparision operator.
+   */
+  bool operator==(const PageSlotDelta &other) const {
+    return ranges == other.ranges && data == other.data;
+  }
+
+  /**
+   * @brief Non-equality comparision operator.
+   */
+  bool operator!=(const PageSlotDelta &other) const {
+    return !(*this == other);
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_WAL_PAGE_SLOT_DELTA_HPP */
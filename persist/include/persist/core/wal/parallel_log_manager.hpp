@@ -0,0 +1,302 @@
+/**
+ * log/parallel_log_manager.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Parallel Log Manager
+ *
+ * The header file exposes a log manager which appends log records to several
+ * parallel log streams, so that concurrent transactions do not contend on a
+ * single log.
+ */
+
+#ifndef PERSIST_CORE_WAL_PARALLEL_LOG_MANAGER_HPP
+#define PERSIST_CORE_WAL_PARALLEL_LOG_MANAGER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <persist/core/wal/log_manager.hpp>
+#include <persist/core/wal/sequential_log.hpp>
+
+namespace persist {
+
+/**
+ * @brief Parallel Log Manager Class
+ *
+ * The parallel log manager splits the log into streams. Each stream is a log
+ * manager backed by a sequential log of its own, and so has its own files,
+ * log buffer, tail buffer and group flush. Threads are assigned to streams in
+ * round robin order and a transaction logs all its records to the stream of
+ * the thread beginning it. Committing a transaction thus flushes only the
+ * stream of the transaction.
+ *
+ * The only state shared by the streams is a clock from which the sequence
+ * numbers of log records are drawn. Log records are therefore ordered across
+ * streams, and the global order of the log is reconstructed at recovery by
+ * merging the streams on sequence numbers.
+ */
+class ParallelLogManager {
+  PERSIST_PRIVATE
+  /**
+   * @brief Clock shared by the streams holding the sequence number of the
+   * latest log record in any stream.
+   */
+  std::atomic<SeqNumber> clock;
+
+  /**
+   * @brief Sequential logs backing the streams.
+   */
+  std::vector<std::unique_ptr<SequentialLog>> logs;
+
+  /**
+   * @brief Log managers of the streams.
+   */
+  std::vector<std::unique_ptr<LogManager>> streams;
+
+  /**
+   * @brief Identifier of the log manager, unique within the process.
+   */
+  uint64_t id;
+
+  /**
+   * @brief Number of threads assigned to streams so far.
+   */
+  std::atomic<size_t> thread_count;
+
+  /**
+   * @brief Get a new log manager identifier.
+   *
+   * @thread_safe
+   */
+  static uint64_t GetNextId() {
+    static std::atomic<uint64_t> next_id(0);
+    return ++next_id;
+  }
+
+public:
+  /**
+   * @brief Construct a new Parallel Log Manager object
+   *
+   * @param path path prefix of the log files. The files of each stream are
+   * suffixed with the index of the stream.
+   * @param stream_count number of log streams. Defaults to one stream per
+   * hardware thread.
+   * @param segment_size size of a segment of each stream in bytes
+   * @param tail_size capacity of the tail buffer of each stream in bytes
+   */
+  ParallelLogManager(
+      const std::string &path,
+      size_t stream_count = std::thread::hardware_concurrency(),
+      size_t segment_size = DEFAULT_LOG_FILE_SEGMENT_SIZE,
+      size_t tail_size = DEFAULT_LOG_TAIL_SIZE)
+      : clock(0), id(GetNextId()), thread_count(0) {
+    stream_count = std::max<size_t>(stream_count, 1);
+    for (size_t i = 0; i < stream_count; ++i) {
+      logs.push_back(std::make_unique<SequentialLog>(
+          path + "_" + std::to_string(i), segment_size, tail_size));
+      streams.push_back(std::make_unique<LogManager>(*logs.back(), clock));
+    }
+  }
+
+  /**
+   * @brief Get the number of log streams.
+   */
+  size_t GetStreamCount() const { return streams.size(); }
+
+  /**
+   * @brief Get the log stream of given index.
+   *
+   * @param index index of the log stream
+   * @returns reference to the log manager of the stream
+   */
+  LogManager &GetStream(size_t index) { return *streams.at(index); }
+
+  /**
+   * @brief Get the log stream assigned to the calling thread. A thread is
+   * assigned a stream the first time it calls the method, in round robin
+   * order of the threads using this log manager.
+   *
+   * @thread_safe
+   *
+   * @returns reference to the log manager of the stream
+   */
+  LogManager &GetStream() {
+    // Stream index of the thread for each log manager the thread uses
+    static thread_local std::unordered_map<uint64_t, size_t> thread_streams;
+    auto it = thread_streams.find(id);
+    if (it == thread_streams.end()) {
+      it = thread_streams.emplace(id, thread_count++ % streams.size()).first;
+    }
+    return *streams[it->second];
+  }
+
+  /**
+   * @brief Get the sequential log backing the log stream of given index.
+   *
+   * @param index index of the log stream
+   * @returns reference to the sequential log of the stream
+   */
+  SequentialLog &GetLog(size_t index) { return *logs.at(index); }
+
+  /**
+   * @brief Get log sync policy of the streams.
+   *
+   * @thread_safe
+   */
+  SyncPolicy GetSyncPolicy() { return streams.front()->GetSyncPolicy(); }
+
+  /**
+   * @brief Set log sync policy of all streams. The policy takes effect the
+   * next time the log manager is started.
+   *
+   * @thread_safe
+   *
+   * @param policy log sync policy
+   * @param interval interval in milliseconds between background log syncs for
+   * interval sync policy
+   */
+  void SetSyncPolicy(SyncPolicy policy,
+                     size_t interval = DEFAULT_LOG_SYNC_INTERVAL) {
+    for (auto &stream : streams) {
+      stream->SetSyncPolicy(policy, interval);
+    }
+  }
+
+  /**
+   * @brief Enable or disable log compression on all streams.
+   *
+   * @thread_safe
+   *
+   * @param enabled `true` to enable compression else `false`
+   * @param threshold size in bytes beyond which log records are compressed
+   */
+  void SetCompression(bool enabled,
+                      size_t threshold = DEFAULT_LOG_COMPRESSION_THRESHOLD) {
+    for (auto &stream : streams) {
+      stream->SetCompression(enabled, threshold);
+    }
+  }
+
+  /**
+   * @brief Start all log streams. The clock is advanced past the latest log
+   * record in any stream.
+   *
+   * @thread_unsafe
+   */
+  void Start() {
+    for (auto &stream : streams) {
+      stream->Start();
+    }
+  }
+
+  /**
+   * @brief Stop all log streams.
+   *
+   * @thread_unsafe
+   */
+  void Stop() {
+    for (auto &stream : streams) {
+      stream->Stop();
+    }
+  }
+
+  /**
+   * @brief Remove the log files of all streams. The log manager must be
+   * stopped.
+   *
+   * @thread_unsafe
+   */
+  void Remove() {
+    for (auto &log : logs) {
+      log->Remove();
+    }
+  }
+
+  /**
+   * @brief Flush all log streams.
+   *
+   * @thread_safe
+   */
+  void Flush() {
+    for (auto &stream : streams) {
+      stream->Flush();
+    }
+  }
+
+  /**
+   * @brief Scan the log records of all streams in the global order of their
+   * sequence numbers. The log manager must be started.
+   *
+   * The log records of each stream are in order already, so the streams are
+   * merged by reading the next log record of each stream side by side and
+   * handling the one with the lowest sequence number first. Each log record
+   * is read once.
+   *
+   * @param handler callable invoked with the index of the stream and a
+   * reference to each log record
+   */
+  template <class Handler> void Scan(Handler handler) {
+    std::vector<SequentialLog::Reader> readers;
+    readers.reserve(logs.size());
+    std::vector<LogRecord> log_records(logs.size());
+    // Heap of the sequence number of the next log record of each stream
+    typedef std::pair<SeqNumber, size_t> Head;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+
+    // Read the next log record of the stream of given index
+    auto read = [&](size_t index) {
+      SequentialLog::Lsn lsn;
+      Span record;
+      if (readers[index].Next(lsn, record)) {
+        log_records[index] = LogRecord();
+        log_records[index].Load(record);
+        heads.push({log_records[index].GetSeqNumber(), index});
+      }
+    };
+    for (size_t i = 0; i < logs.size(); ++i) {
+      readers.emplace_back(*logs[i], logs[i]->GetStartLsn());
+      read(i);
+    }
+
+    // Merge the streams on sequence numbers
+    while (!heads.empty()) {
+      size_t index = heads.top().second;
+      heads.pop();
+      handler(index, log_records[index]);
+      read(index);
+    }
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_WAL_PARALLEL_LOG_MANAGER_HPP */
@@ -0,0 +1,804 @@
+/**
+ * log/sequential_log.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Sequential Log
+ *
+ * The header file exposes a purpose-built file format for the write-ahead
+ * log, storing records as an append-only stream of bytes.
+ */
+
+#ifndef PERSIST_CORE_WAL_SEQUENTIAL_LOG_HPP
+#define PERSIST_CORE_WAL_SEQUENTIAL_LOG_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+
+#include <persist/core/exceptions/storage.hpp>
+#include <persist/core/exceptions/wal.hpp>
+#include <persist/core/fixed_storable.hpp>
+#include <persist/core/storage/file_storage.hpp>
+
+#include <persist/utility/checksum.hpp>
+#include <persist/utility/mutex.hpp>
+
+#define SEQUENTIAL_LOG_SEGMENT_FILE_EXTENTION ".wal"
+#define SEQUENTIAL_LOG_META_FILE_EXTENTION ".wam"
+
+namespace persist {
+
+/**
+ * @brief Sequential Log Header
+ *
+ * The header is stored in the meta file of the log. Segments from the start
+ * segment onwards hold the log. Segments from the spare segment up to the
+ * start segment have been truncated and are recycled for new segments.
+ */
+struct SequentialLogHeader
+    : public FixedStorable<SequentialLogHeader, StorageError> {
+  size_t segment_size;    //<- size of a segment in bytes
+  uint64_t start_segment; //<- first segment holding the log
+  uint64_t spare_segment; //<- first truncated segment available for reuse
+  uint64_t version;       //<- log format version
+
+  SequentialLogHeader()
+      : segment_size(0), start_segment(0), spare_segment(0),
+        version(LOG_FORMAT_VERSION) {}
+
+  /**
+   * @brief Get the stored fields of the header.
+   *
+   */
+  auto GetFields() {
+    return std::tie(segment_size, start_segment, spare_segment, version);
+  }
+};
+
+/**
+ * @brief Sequential Log
+ *
+ * The log is an append-only stream of records stored in segment files of
+ * fixed size. Each record is addressed by its log sequence number (LSN), the
+ * byte offset of the record in the stream, so that the segment and offset of
+ * a record follow directly from its LSN.
+ *
+ * A record is framed by its length and a CRC-32C checksum computed over the
+ * LSN, the length and the record. A frame never spans segments; if a record
+ * does not fit in the rest of a segment, a frame of length 0 marks the rest of
+ * the segment as skipped and the record is stored at the start of the next
+ * segment.
+ *
+ * Records are appended to an in-memory tail buffer, which is written out to
+ * the segment files as is on flush. Segment files are preallocated when
+ * created. Segments truncated from the start of the log are recycled as new
+ * segments. Stale records in a recycled segment carry a different LSN and are
+ * thus rejected by their checksum.
+ *
+ * On open the log is scanned from the start and the end of the log is found at
+ * the first invalid frame, which drops any torn write at the tail.
+ */
+class SequentialLog {
+public:
+  /**
+   * @brief Log sequence number type. The LSN of a record is its byte offset
+   * in the log stream.
+   */
+  typedef uint64_t Lsn;
+
+  PERSIST_PRIVATE
+  /**
+   * @brief Lock for thread safety
+   *
+   */
+  typedef typename persist::Mutex<std::mutex> Mutex;
+  typedef typename persist::LockGuard<Mutex> LockGuard;
+
+  /**
+   * @brief Size of a frame header holding the record length and checksum.
+   */
+  static const size_t frame_header_size = 2 * sizeof(uint32_t);
+
+  Mutex lock;             //<- lock for achieving thread safety
+  Mutex sync_lock;        //<- lock serializing syncs of segment files
+  std::string path;       //<- Log path
+  size_t segment_size;    //<- Size of a segment in bytes
+  size_t tail_size;       //<- Capacity of the tail buffer in bytes
+  SequentialLogHeader header GUARDED_BY(lock); //<- Log header
+  std::map<uint64_t, std::fstream> segments GUARDED_BY(lock); //<- Open files
+  std::set<uint64_t> unsynced GUARDED_BY(lock); //<- Segments not synced
+  ByteBuffer tail GUARDED_BY(lock); //<- Records not yet written to segments
+  Lsn flushed_lsn GUARDED_BY(lock); //<- LSN up to which the log is written
+  Lsn end_lsn GUARDED_BY(lock);     //<- LSN of the end of the log
+  Lsn last_lsn GUARDED_BY(lock);    //<- LSN of the last record
+  bool open GUARDED_BY(lock);       //<- Flag indicating log is open
+
+  /**
+   * @brief Get path of the segment file with given index.
+   *
+   * @param segment segment index
+   */
+  std::string GetSegmentPath(uint64_t segment) const {
+    return path + "_" + std::to_string(segment) +
+           SEQUENTIAL_LOG_SEGMENT_FILE_EXTENTION;
+  }
+
+  /**
+   * @brief Check if the segment file with given index exists.
+   *
+   * @param segment segment index
+   */
+  bool HasSegmentFile(uint64_t segment) const {
+    return std::ifstream(GetSegmentPath(segment).c_str()).good();
+  }
+
+  /**
+   * @brief Compute the checksum of a frame.
+   *
+   * @param lsn LSN of the frame
+   * @param length length of the framed record
+   * @param record input buffer span of the framed record
+   */
+  static uint32_t Checksum(Lsn lsn, uint32_t length, Span record) {
+    uint32_t crc = 0xFFFFFFFF;
+    crc = Crc32cHash::Update(crc, Span(reinterpret_cast<Byte *>(&lsn),
+                                       sizeof(lsn)));
+    crc = Crc32cHash::Update(crc, Span(reinterpret_cast<Byte *>(&length),
+                                       sizeof(length)));
+    crc = Crc32cHash::Update(crc, record);
+    return crc ^ 0xFFFFFFFF;
+  }
+
+  /**
+   * @brief Dump frame header of a record at given LSN.
+   *
+   * @param output output buffer span to dump the frame header to
+   * @param lsn LSN of the frame
+   * @param record input buffer span of the framed record
+   */
+  static void DumpFrameHeader(Span output, Lsn lsn, Span record) {
+    uint32_t length = record.size;
+    uint32_t checksum = Checksum(lsn, length, record);
+    persist::dump(output, length, checksum);
+  }
+
+  /**
+   * @brief Parse the frame at given LSN.
+   *
+   * @param input input buffer span starting at the frame
+   * @param lsn LSN of the frame
+   * @param record output span set to the framed record if the frame is valid
+   * @returns `true` if the frame is valid else `false`
+   */
+  static bool ParseFrame(Span input, Lsn lsn, Span &record) {
+    if (input.size < frame_header_size) {
+      return false;
+    }
+    uint32_t length, checksum;
+    persist::load(input, length, checksum);
+    if (length > input.size) {
+      return false;
+    }
+    record = Span(input.start, length);
+    return checksum == Checksum(lsn, length, record);
+  }
+
+  /**
+   * @brief Open segment with given index. A segment file which does not exist
+   * is created from a recycled segment if one is available, or else created
+   * and preallocated. The log directory is synced after the segment file is
+   * created so that the file is not lost. The caller must hold the lock.
+   *
+   * @param segment segment index
+   * @returns reference to the file stream of the segment
+   */
+  std::fstream &OpenSegment(uint64_t segment) {
+    auto it = segments.find(segment);
+    if (it != segments.end()) {
+      return it->second;
+    }
+    std::string segment_path = GetSegmentPath(segment);
+    if (!HasSegmentFile(segment)) {
+      // Recycle a truncated segment
+      bool recycled = false;
+      while (!recycled && header.spare_segment < header.start_segment) {
+        recycled = std::rename(GetSegmentPath(header.spare_segment).c_str(),
+                               segment_path.c_str()) == 0;
+        ++header.spare_segment;
+      }
+      if (recycled) {
+        // Dumping the header syncs the log directory
+        DumpHeader();
+      } else {
+        file::allocate(segment_path, segment_size);
+        if (!file::sync(segment_path) || !file::sync_directory(segment_path)) {
+          throw StorageError("Failed to sync log segment file.");
+        }
+      }
+    }
+    std::fstream &file = segments[segment];
+    file = file::open(segment_path,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    return file;
+  }
+
+  /**
+   * @brief Dump log header to the meta file. The meta file is replaced
+   * atomically and durably by syncing the written temporary file before
+   * renaming it, and the log directory after.
+   */
+  void DumpHeader() {
+    ByteBuffer buffer(header.GetStorageSize());
+    header.Dump(buffer);
+    std::string meta_path = path + SEQUENTIAL_LOG_META_FILE_EXTENTION;
+    {
+      std::fstream meta_file =
+          file::open(meta_path + ".tmp",
+                     std::ios::binary | std::ios::out | std::ios::trunc);
+      file::write(meta_file, buffer, 0);
+      if (!file::sync(meta_file, meta_path + ".tmp")) {
+        throw StorageError("Failed to sync log meta file.");
+      }
+    }
+    if (std::rename((meta_path + ".tmp").c_str(), meta_path.c_str()) != 0 ||
+        !file::sync_directory(meta_path)) {
+      throw StorageError("Failed to replace log meta file.");
+    }
+  }
+
+  /**
+   * @brief Write out the tail buffer to the segment files. The caller must
+   * hold the lock.
+   */
+  void WriteTail() {
+    Span input(tail);
+    while (input.size > 0) {
+      uint64_t segment = flushed_lsn / segment_size;
+      size_t offset = flushed_lsn % segment_size;
+      size_t size = std::min(input.size, segment_size - offset);
+      file::write(OpenSegment(segment), Span(input.start, size), offset);
+      unsynced.insert(segment);
+      input += size;
+      flushed_lsn += size;
+    }
+    tail.clear();
+  }
+
+  /**
+   * @brief Scan valid records from given LSN up to given end LSN. The scan
+   * stops early at the first invalid frame. The caller must hold the lock
+   * and the tail buffer must be written out.
+   *
+   * @param lsn LSN of the first record to scan
+   * @param until LSN at which to stop the scan
+   * @param handler callable invoked with the LSN and the input buffer span of
+   * each scanned record
+   * @returns LSN of the end of the scanned records
+   */
+  template <class Handler> Lsn ScanSegments(Lsn lsn, Lsn until,
+                                            Handler handler) {
+    ByteBuffer buffer;
+    while (lsn < until) {
+      uint64_t segment = lsn / segment_size;
+      if (segments.find(segment) == segments.end() &&
+          !HasSegmentFile(segment)) {
+        break;
+      }
+      // Read the rest of the segment at once
+      size_t offset = lsn % segment_size;
+      size_t size = std::min<Lsn>(segment_size - offset, until - lsn);
+      buffer.resize(size);
+      file::read(OpenSegment(segment), buffer, offset);
+      Span input(buffer);
+      while (true) {
+        Span record;
+        if (!ParseFrame(input, lsn, record)) {
+          // Frame header does not fit in the rest of the segment
+          if (input.size < frame_header_size && size == segment_size - offset) {
+            lsn += input.size;
+            break;
+          }
+          return lsn;
+        }
+        if (record.size == 0) {
+          // Rest of the segment is skipped
+          lsn += input.size;
+          break;
+        }
+        handler(lsn, record);
+        input += frame_header_size + record.size;
+        lsn += frame_header_size + record.size;
+      }
+    }
+    return lsn;
+  }
+
+public:
+  /**
+   * @brief Sequential Log Reader
+   *
+   * The reader reads the records of the log one at a time in order. Segment
+   * bytes are read in chunks of at most the tail buffer size, so that several
+   * logs can be read side by side without holding whole segments in memory.
+   * The reader stops at the end of the log as of its construction.
+   */
+  class Reader {
+    PERSIST_PRIVATE
+    SequentialLog &log; //<- Log being read
+    Lsn lsn;            //<- LSN of the next frame
+    Lsn end_lsn;        //<- LSN at which reading stops
+    Lsn buffer_lsn;     //<- LSN of the first byte in the buffer
+    ByteBuffer buffer;  //<- Bytes read from the segment of the next frame
+
+    /**
+     * @brief Read bytes from the next frame into the buffer unless already
+     * buffered. Bytes are read up to the end of the segment or the log.
+     *
+     * @param size number of bytes needed from the next frame
+     * @returns `true` if the bytes are in the buffer else `false`
+     */
+    bool Fill(size_t size) {
+      if (lsn >= buffer_lsn && lsn + size <= buffer_lsn + buffer.size()) {
+        return true;
+      }
+      size_t rest = log.segment_size - lsn % log.segment_size;
+      Lsn read_size = std::min<Lsn>(std::max(size, log.tail_size), rest);
+      read_size = std::min(read_size, end_lsn - lsn);
+      buffer.resize(read_size);
+      buffer_lsn = lsn;
+      {
+        LockGuard guard(log.lock);
+        file::read(log.OpenSegment(lsn / log.segment_size), buffer,
+                   lsn % log.segment_size);
+      }
+      return size <= read_size;
+    }
+
+  public:
+    /**
+     * @brief Construct a new Reader object. The tail buffer of the log is
+     * written out so that all records are read from the segment files.
+     *
+     * @param log reference to the log to read
+     * @param lsn LSN of the first record to read
+     */
+    Reader(SequentialLog &log, Lsn lsn) : log(log), buffer_lsn(0) {
+      LockGuard guard(log.lock);
+
+      log.WriteTail();
+      this->lsn = std::max<Lsn>(lsn, log.header.start_segment *
+                                         log.segment_size);
+      end_lsn = log.end_lsn;
+    }
+
+    /**
+     * @brief Read the next record.
+     *
+     * @param record_lsn set to the LSN of the read record
+     * @param record set to the input buffer span of the read record. The span
+     * is valid until the next read.
+     * @returns `true` if a record was read, `false` at the end of the log
+     */
+    bool Next(Lsn &record_lsn, Span &record) {
+      while (lsn < end_lsn) {
+        size_t rest = log.segment_size - lsn % log.segment_size;
+        if (rest < frame_header_size) {
+          // Frame header does not fit in the rest of the segment
+          lsn += rest;
+          continue;
+        }
+        if (!Fill(frame_header_size)) {
+          break;
+        }
+        Span input = Span(buffer) + (lsn - buffer_lsn);
+        uint32_t length;
+        persist::load(input, length);
+        if (length > rest - frame_header_size) {
+          break;
+        }
+        if (!Fill(frame_header_size + length)) {
+          break;
+        }
+        input = Span(buffer) + (lsn - buffer_lsn);
+        if (!ParseFrame(input, lsn, record)) {
+          break;
+        }
+        if (record.size == 0) {
+          // Rest of the segment is skipped
+          lsn += rest;
+          continue;
+        }
+        record_lsn = lsn;
+        lsn += frame_header_size + record.size;
+        return true;
+      }
+      lsn = end_lsn;
+      return false;
+    }
+  };
+
+  /**
+   * @brief Construct a new Sequential Log object
+   *
+   * @param path path of the log files
+   * @param segment_size size of a segment in bytes. The size stored in an
+   * existing log is used instead.
+   * @param tail_size capacity of the tail buffer in bytes
+   */
+  SequentialLog(const std::string &path,
+                size_t segment_size = DEFAULT_LOG_FILE_SEGMENT_SIZE,
+                size_t tail_size = DEFAULT_LOG_TAIL_SIZE)
+      : path(path), segment_size(segment_size), tail_size(tail_size),
+        flushed_lsn(0), end_lsn(0), last_lsn(0), open(false) {}
+
+  /**
+   * @brief Destroy the Sequential Log object
+   */
+  ~SequentialLog() { Close(); }
+
+  /**
+   * @brief Get path of the log files.
+   */
+  std::string GetPath() const { return path; }
+
+  /**
+   * @brief Get size of a segment in bytes.
+   */
+  size_t GetSegmentSize() const { return segment_size; }
+
+  /**
+   * @brief Open the log. The log is scanned to find its end.
+   *
+   * @thread_safe
+   */
+  void Open() {
+    LockGuard guard(lock);
+
+    if (open) {
+      return;
+    }
+
+    // Load header
+    std::fstream meta_file =
+        file::open(path + SEQUENTIAL_LOG_META_FILE_EXTENTION,
+                   std::ios::binary | std::ios::in);
+    size_t meta_size = file::size(meta_file);
+    if (meta_size != 0) {
+      // Headers written before the log format was versioned end before the
+      // version and thus read as version 0
+      ByteBuffer buffer(header.GetStorageSize());
+      file::read(meta_file,
+                 Span(buffer.data(), std::min(meta_size, buffer.size())), 0);
+      header.Load(buffer);
+      if (header.version != LOG_FORMAT_VERSION) {
+        std::string msg = "Unsupported log format version " +
+                          std::to_string(header.version) + ".";
+        throw StorageError(msg);
+      }
+      segment_size = header.segment_size;
+    } else {
+      header = SequentialLogHeader();
+      header.segment_size = segment_size;
+      DumpHeader();
+    }
+    meta_file.close();
+
+    // Scan to the end of the log
+    Lsn start_lsn = header.start_segment * segment_size;
+    last_lsn = start_lsn;
+    end_lsn = ScanSegments(start_lsn, UINT64_MAX,
+                           [this](Lsn lsn, Span) { last_lsn = lsn; });
+    flushed_lsn = end_lsn;
+    tail.clear();
+    tail.reserve(tail_size);
+    unsynced.clear();
+
+    open = true;
+  }
+
+  /**
+   * @brief Check if the log is open.
+   *
+   * @thread_safe
+   */
+  bool IsOpen() {
+    LockGuard guard(lock);
+
+    return open;
+  }
+
+  /**
+   * @brief Close the log. Records in the tail buffer are written out.
+   *
+   * @thread_safe
+   */
+  void Close() {
+    LockGuard guard(lock);
+
+    if (open) {
+      WriteTail();
+      segments.clear();
+      open = false;
+    }
+  }
+
+  /**
+   * @brief Remove the log files.
+   *
+   * @thread_safe
+   */
+  void Remove() {
+    Close();
+
+    LockGuard guard(lock);
+
+    for (uint64_t segment = header.spare_segment;
+         segment <= end_lsn / segment_size || HasSegmentFile(segment);
+         ++segment) {
+      std::remove(GetSegmentPath(segment).c_str());
+    }
+    std::remove((path + SEQUENTIAL_LOG_META_FILE_EXTENTION).c_str());
+    header = SequentialLogHeader();
+    flushed_lsn = end_lsn = last_lsn = 0;
+  }
+
+  /**
+   * @brief Get LSN of the start of the log.
+   *
+   * @thread_safe
+   */
+  Lsn GetStartLsn() {
+    LockGuard guard(lock);
+
+    return header.start_segment * segment_size;
+  }
+
+  /**
+   * @brief Get LSN of the end of the log. The next record is appended at or
+   * after this LSN.
+   *
+   * @thread_safe
+   */
+  Lsn GetEndLsn() {
+    LockGuard guard(lock);
+
+    return end_lsn;
+  }
+
+  /**
+   * @brief Get LSN of the last record of the log. The LSN is equal to the
+   * start of the log if the log is empty.
+   *
+   * @thread_safe
+   */
+  Lsn GetLastLsn() {
+    LockGuard guard(lock);
+
+    return last_lsn;
+  }
+
+  /**
+   * @brief Check if the log has no records.
+   *
+   * @thread_safe
+   */
+  bool IsEmpty() {
+    LockGuard guard(lock);
+
+    return end_lsn == header.start_segment * segment_size;
+  }
+
+  /**
+   * @brief Append a record to the log. The record is stored in the tail
+   * buffer, which is written out when full.
+   *
+   * @thread_safe
+   *
+   * @param record input buffer span of the record to append
+   * @returns LSN of the appended record
+   * @throws LogBufferError if the record is empty, does not fit in a segment
+   * or its length does not fit in the 32-bit length of a frame
+   */
+  Lsn Append(Span record) {
+    LockGuard guard(lock);
+
+    if (record.size > std::numeric_limits<uint32_t>::max()) {
+      throw LogBufferError("Log record is too large for a log frame.");
+    }
+    size_t frame_size = frame_header_size + record.size;
+    if (record.size == 0 || frame_size > segment_size) {
+      throw LogBufferError("Log record does not fit in log segment.");
+    }
+
+    // Skip the rest of the segment if the frame does not fit in it
+    size_t rest = segment_size - end_lsn % segment_size;
+    if (frame_size > rest) {
+      WriteTail();
+      if (rest >= frame_header_size) {
+        ByteBuffer skip(frame_header_size);
+        DumpFrameHeader(skip, end_lsn, Span(nullptr, 0));
+        file::write(OpenSegment(end_lsn / segment_size), skip,
+                    end_lsn % segment_size);
+        unsynced.insert(end_lsn / segment_size);
+      }
+      end_lsn += rest;
+      flushed_lsn = end_lsn;
+    }
+    // Write out the tail buffer if full
+    if (tail.size() + frame_size > tail_size) {
+      WriteTail();
+    }
+
+    // Append frame to the tail buffer
+    Lsn lsn = end_lsn;
+    size_t offset = tail.size();
+    tail.resize(offset + frame_size);
+    DumpFrameHeader(Span(tail) + offset, lsn, record);
+    std::memcpy(tail.data() + offset + frame_header_size, record.start,
+                record.size);
+    end_lsn += frame_size;
+    last_lsn = lsn;
+
+    return lsn;
+  }
+
+  /**
+   * @brief Read the record at given LSN.
+   *
+   * @thread_safe
+   *
+   * @param lsn LSN of the record
+   * @returns record bytes
+   * @throws LogRecordParseError if there is no valid record at the LSN
+   */
+  ByteBuffer Read(Lsn lsn) {
+    LockGuard guard(lock);
+
+    if (lsn < header.start_segment * segment_size || lsn >= end_lsn) {
+      throw LogRecordParseError("Log record not found.");
+    }
+    Span record;
+    // Read record from the tail buffer
+    if (lsn >= flushed_lsn) {
+      if (!ParseFrame(Span(tail) + (lsn - flushed_lsn), lsn, record)) {
+        throw LogRecordParseError("Log record frame is corrupt.");
+      }
+      return ByteBuffer(record.start, record.start + record.size);
+    }
+    // Read record from its segment file
+    std::fstream &file = OpenSegment(lsn / segment_size);
+    size_t offset = lsn % segment_size;
+    size_t rest = segment_size - offset;
+    ByteBuffer buffer(rest < frame_header_size ? rest : frame_header_size);
+    file::read(file, buffer, offset);
+    if (buffer.size() == frame_header_size) {
+      uint32_t length;
+      Span input(buffer);
+      persist::load(input, length);
+      if (length <= rest - frame_header_size) {
+        buffer.resize(frame_header_size + length);
+        file::read(file, buffer, offset);
+      }
+    }
+    if (!ParseFrame(buffer, lsn, record) || record.size == 0) {
+      throw LogRecordParseError("Log record frame is corrupt.");
+    }
+    return ByteBuffer(record.start, record.start + record.size);
+  }
+
+  /**
+   * @brief Scan the records of the log in order starting at given LSN.
+   *
+   * @thread_safe
+   *
+   * @param lsn LSN of the first record to scan
+   * @param handler callable invoked with the LSN and the input buffer span of
+   * each record
+   */
+  template <class Handler> void Scan(Lsn lsn, Handler handler) {
+    LockGuard guard(lock);
+
+    WriteTail();
+    ScanSegments(std::max<Lsn>(lsn, header.start_segment * segment_size),
+                 end_lsn, handler);
+  }
+
+  /**
+   * @brief Write out the tail buffer to the segment files.
+   *
+   * @thread_safe
+   */
+  void Flush() {
+    LockGuard guard(lock);
+
+    WriteTail();
+  }
+
+  /**
+   * @brief Write out the tail buffer and sync the written segment files to
+   * durable media. The segment files are synced without holding the lock so
+   * that records can be appended meanwhile.
+   *
+   * @thread_safe
+   */
+  void Sync() {
+    LockGuard sync_guard(sync_lock);
+
+    std::set<uint64_t> syncing;
+    {
+      LockGuard guard(lock);
+      WriteTail();
+      for (uint64_t segment : unsynced) {
+        OpenSegment(segment).flush();
+      }
+      syncing.swap(unsynced);
+    }
+    for (auto it = syncing.begin(); it != syncing.end(); ++it) {
+      if (file::sync(GetSegmentPath(*it))) {
+        continue;
+      }
+      // Segments truncated meanwhile need no sync
+      LockGuard guard(lock);
+      if (*it >= header.start_segment) {
+        unsynced.insert(it, syncing.end());
+        throw StorageError("Failed to sync log segment file.");
+      }
+    }
+  }
+
+  /**
+   * @brief Truncate the log before given LSN. Segments holding only records
+   * before the LSN are released for reuse as new segments.
+   *
+   * @thread_safe
+   *
+   * @param lsn LSN before which the log is truncated
+   */
+  void Truncate(Lsn lsn) {
+    LockGuard guard(lock);
+
+    uint64_t start_segment = std::min(lsn, end_lsn) / segment_size;
+    if (start_segment <= header.start_segment) {
+      return;
+    }
+    for (uint64_t segment = header.start_segment; segment < start_segment;
+         ++segment) {
+      segments.erase(segment);
+      unsynced.erase(segment);
+    }
+    header.start_segment = start_segment;
+    if (last_lsn < start_segment * segment_size) {
+      last_lsn = start_segment * segment_size;
+    }
+    DumpHeader();
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_CORE_WAL_SEQUENTIAL_LOG_HPP */
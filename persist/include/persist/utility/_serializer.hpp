@@ -35,6 +35,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -51,18 +52,49 @@ template <class T> inline void _copy(Span &input, T &data) {
   input += sizeof(T);
 }
 
+// Internal method to copy elements of trivially copyable type from memory
+// location specified by span object to the end of a vector in a single copy.
+template <class T>
+inline void _copy(Span &input, std::vector<T> &data, size_t size,
+                  std::true_type) {
+  size_t offset = data.size();
+  data.resize(offset + size);
+  std::memcpy((void *)(data.data() + offset), (const void *)input.start,
+              size * sizeof(T));
+  input += size * sizeof(T);
+}
+
+// Internal method to copy elements from memory location specified by span
+// object to the end of a vector one at a time.
+template <class T>
+inline void _copy(Span &input, std::vector<T> &data, size_t size,
+                  std::false_type) {
+  data.reserve(data.size() + size);
+  for (int i = 0; i < size; i++) {
+    T element;
+    _copy(input, element);
+    data.insert(data.end(), element);
+  }
+}
+
 // Internal method to copy content from memory location specified by span object
 // to a data variable.
 template <class T> inline void _copy(Span &input, std::vector<T> &data) {
   // Copy number of elements in the container
   size_t size;
   _copy(input, size);
-  // Copy each element in the container
-  for (int i = 0; i < size; i++) {
-    T element;
-    _copy(input, element);
-    data.insert(data.end(), element);
-  }
+  // Copy elements in bulk if trivially copyable
+  _copy(input, data, size, std::is_trivially_copyable<T>());
+}
+
+// Internal method to view content at memory location specified by span object
+// stored as a byte buffer. The bytes are not copied and the view points into
+// the span.
+inline void _copy(Span &input, ByteView &data) {
+  size_t size;
+  _copy(input, size);
+  data = ByteView(input.start, size);
+  input += size;
 }
 
 // Internal method to copy content from memory location specified by span object
@@ -164,6 +196,41 @@ inline void _copy(const C<T, Args...> &data, Span &output) {
   }
 }
 
+// Internal method to copy viewed bytes to memory location specified by span
+// object in the same format as a byte buffer.
+inline void _copy(const ByteView &data, Span &output) {
+  _copy(data.size, output);
+  std::memcpy((void *)output.start, (const void *)data.start, data.size);
+  output += data.size;
+}
+
+// Internal method to copy elements of trivially copyable type from a vector to
+// memory location specified by span object in a single copy.
+template <class T>
+inline void _copy(const std::vector<T> &data, Span &output, std::true_type) {
+  std::memcpy((void *)output.start, (const void *)data.data(),
+              data.size() * sizeof(T));
+  output += data.size() * sizeof(T);
+}
+
+// Internal method to copy elements from a vector to memory location specified
+// by span object one at a time.
+template <class T>
+inline void _copy(const std::vector<T> &data, Span &output, std::false_type) {
+  for (auto &element : data) {
+    _copy(element, output);
+  }
+}
+
+// Internal method to copy content from data variable to memory location
+// specified by span object
+template <class T> inline void _copy(const std::vector<T> &data, Span &output) {
+  // Copy number of elements in the container
+  _copy(data.size(), output);
+  // Copy elements in bulk if trivially copyable
+  _copy(data, output, std::is_trivially_copyable<T>());
+}
+
 } // namespace persist
 
 #endif /* PERSIST_UTILITY__SERIALIZER_HPP */
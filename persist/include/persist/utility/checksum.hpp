@@ -25,11 +25,26 @@
 #ifndef PERSIST_UTILITY_CHECKSUM_HPP
 #define PERSIST_UTILITY_CHECKSUM_HPP
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
 #include <persist/core/common.hpp>
 
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define PERSIST_CHECKSUM_SSE42
+#endif
+
 namespace persist {
 
-// TODO: Implement efficient Alder32 hash function
+/**
+ * @brief Supported checksum algorithms. The value of the algorithm is stored
+ * in storage headers so it must not be changed. Storages created before
+ * pluggable checksums have the value 0, that is Alder-32.
+ */
+enum class ChecksumType : uint32_t { ALDER32 = 0, CRC32C = 1, XXHASH64 = 2 };
 
 /**
  * @brief The function object computes the Alder32 hash value for given byte
@@ -41,22 +56,240 @@ namespace persist {
 class Alder32Hash {
 private:
   const uint32_t mod = 65521;
+  // Largest number of bytes which can be summed before the modulo is needed
+  // for the sums to not overflow 32 bits.
+  const size_t max_run = 5552;
 
 public:
   uint32_t operator()(Span input) {
     uint32_t a = 1, b = 0;
-    size_t index;
+    size_t index = 0;
 
-    // Process each byte of the data in order
-    for (index = 0; index < input.size; ++index) {
-      a = (a + input.start[index]) % mod;
-      b = (b + a) % mod;
+    // Process the data in runs, deferring the modulo to the end of each run
+    while (index < input.size) {
+      size_t end = std::min(input.size, index + max_run);
+      for (; index < end; ++index) {
+        a += input.start[index];
+        b += a;
+      }
+      a %= mod;
+      b %= mod;
     }
 
     return (b << 16) | a;
   }
 };
 
+/**
+ * @brief The function object computes the CRC-32C (Castagnoli) hash value for
+ * given byte buffer. The SSE4.2 CRC32 instruction is used if supported by the
+ * CPU, otherwise a portable table driven implementation is used.
+ *
+ * @param input Span object of the byte buffer for which to hash
+ * @returns CRC-32C hash value
+ */
+class Crc32cHash {
+private:
+  /**
+   * @brief Lookup table of CRC-32C remainders for each byte value.
+   */
+  static const uint32_t *Table() {
+    static const struct Lookup {
+      uint32_t values[256];
+      Lookup() {
+        for (uint32_t i = 0; i < 256; ++i) {
+          uint32_t crc = i;
+          for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+          }
+          values[i] = crc;
+        }
+      }
+    } lookup;
+    return lookup.values;
+  }
+
+public:
+  /**
+   * @brief Update the CRC-32C value with the given byte buffer using the
+   * portable table driven implementation.
+   *
+   * @param crc CRC value to update
+   * @param input Span object of the byte buffer
+   * @returns Updated CRC value
+   */
+  static uint32_t Portable(uint32_t crc, Span input) {
+    const uint32_t *table = Table();
+    for (size_t index = 0; index < input.size; ++index) {
+      crc = table[(crc ^ input.start[index]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+  }
+
+#ifdef PERSIST_CHECKSUM_SSE42
+  /**
+   * @brief Update the CRC-32C value with the given byte buffer using the SSE4.2
+   * CRC32 instruction. The caller must make sure the instruction is supported.
+   *
+   * @param crc CRC value to update
+   * @param input Span object of the byte buffer
+   * @returns Updated CRC value
+   */
+  __attribute__((target("sse4.2"))) static uint32_t Hardware(uint32_t crc,
+                                                             Span input) {
+    size_t index = 0;
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    for (; index + sizeof(uint64_t) <= input.size; index += sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, input.start + index, sizeof(word));
+      crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for (; index < input.size; ++index) {
+      crc = _mm_crc32_u8(crc, input.start[index]);
+    }
+    return crc;
+  }
+#endif
+
+  /**
+   * @brief Check if the CRC32 instruction is supported by the CPU.
+   */
+  static bool IsHardwareSupported() {
+#ifdef PERSIST_CHECKSUM_SSE42
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Update the CRC-32C value with the given byte buffer. This allows
+   * computing the hash value of data spread over multiple buffers starting
+   * with a CRC value of `0xFFFFFFFF` and finishing with its complement.
+   *
+   * @param crc CRC value to update
+   * @param input Span object of the byte buffer
+   * @returns Updated CRC value
+   */
+  static uint32_t Update(uint32_t crc, Span input) {
+#ifdef PERSIST_CHECKSUM_SSE42
+    if (IsHardwareSupported()) {
+      return Hardware(crc, input);
+    }
+#endif
+    return Portable(crc, input);
+  }
+
+  uint32_t operator()(Span input) {
+    return Update(0xFFFFFFFF, input) ^ 0xFFFFFFFF;
+  }
+};
+
+/**
+ * @brief The function object computes the XXH64 hash value for given byte
+ * buffer. The input is consumed in stripes of four independent 64-bit lanes
+ * which the CPU processes in parallel.
+ *
+ * @param input Span object of the byte buffer for which to hash
+ * @returns XXH64 hash value
+ */
+class XXHash64 {
+private:
+  static const uint64_t prime_1 = 11400714785074694791ULL;
+  static const uint64_t prime_2 = 14029467366897019727ULL;
+  static const uint64_t prime_3 = 1609587929392839161ULL;
+  static const uint64_t prime_4 = 9650029242287828579ULL;
+  static const uint64_t prime_5 = 2870177450012600261ULL;
+
+  static uint64_t Rotate(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+  }
+
+  static uint64_t Read64(const Byte *start) {
+    uint64_t value;
+    std::memcpy(&value, start, sizeof(value));
+    return value;
+  }
+
+  static uint32_t Read32(const Byte *start) {
+    uint32_t value;
+    std::memcpy(&value, start, sizeof(value));
+    return value;
+  }
+
+  static uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * prime_2;
+    acc = Rotate(acc, 31);
+    return acc * prime_1;
+  }
+
+  static uint64_t Merge(uint64_t acc, uint64_t lane) {
+    acc ^= Round(0, lane);
+    return acc * prime_1 + prime_4;
+  }
+
+public:
+  uint64_t operator()(Span input) {
+    const Byte *start = input.start;
+    const Byte *end = input.start + input.size;
+    uint64_t hash;
+
+    if (input.size >= 32) {
+      // Four independent lanes for instruction level parallelism
+      uint64_t lane_1 = prime_1 + prime_2;
+      uint64_t lane_2 = prime_2;
+      uint64_t lane_3 = 0;
+      uint64_t lane_4 = 0 - prime_1;
+      const Byte *limit = end - 32;
+      do {
+        lane_1 = Round(lane_1, Read64(start));
+        lane_2 = Round(lane_2, Read64(start + 8));
+        lane_3 = Round(lane_3, Read64(start + 16));
+        lane_4 = Round(lane_4, Read64(start + 24));
+        start += 32;
+      } while (start <= limit);
+
+      hash = Rotate(lane_1, 1) + Rotate(lane_2, 7) + Rotate(lane_3, 12) +
+             Rotate(lane_4, 18);
+      hash = Merge(hash, lane_1);
+      hash = Merge(hash, lane_2);
+      hash = Merge(hash, lane_3);
+      hash = Merge(hash, lane_4);
+    } else {
+      hash = prime_5;
+    }
+    hash += input.size;
+
+    // Process remaining bytes
+    for (; start + 8 <= end; start += 8) {
+      hash ^= Round(0, Read64(start));
+      hash = Rotate(hash, 27) * prime_1 + prime_4;
+    }
+    if (start + 4 <= end) {
+      hash ^= Read32(start) * prime_1;
+      hash = Rotate(hash, 23) * prime_2 + prime_3;
+      start += 4;
+    }
+    for (; start < end; ++start) {
+      hash ^= (*start) * prime_5;
+      hash = Rotate(hash, 11) * prime_1;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= prime_2;
+    hash ^= hash >> 29;
+    hash *= prime_3;
+    hash ^= hash >> 32;
+
+    return hash;
+  }
+};
+
 /**
  * @brief The method returns checksum of a byte buffer located by the given span
  * object.
@@ -70,6 +303,60 @@ template <typename H = Alder32Hash> Checksum checksum(Span input) {
   return H{}(input);
 }
 
+/**
+ * @brief Check if the given checksum algorithm is known. Checksum algorithms
+ * loaded from stored headers are checked before use.
+ *
+ * @param type Checksum algorithm to check.
+ * @returns `true` if the checksum algorithm is known else `false`
+ */
+inline bool IsKnownChecksumType(ChecksumType type) {
+  switch (type) {
+  case ChecksumType::ALDER32:
+  case ChecksumType::CRC32C:
+  case ChecksumType::XXHASH64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief The method returns checksum of a byte buffer located by the given span
+ * object using the given checksum algorithm.
+ *
+ * @param input Span object of the byte buffer for which to compute checksum.
+ * @param type Checksum algorithm to use.
+ * @returns Computed checksum value.
+ * @throws std::invalid_argument if the checksum algorithm is unknown
+ */
+inline Checksum checksum(Span input, ChecksumType type) {
+  switch (type) {
+  case ChecksumType::ALDER32:
+    return checksum<Alder32Hash>(input);
+  case ChecksumType::CRC32C:
+    return checksum<Crc32cHash>(input);
+  case ChecksumType::XXHASH64:
+    return checksum<XXHash64>(input);
+  default:
+    throw std::invalid_argument("Unknown checksum type.");
+  }
+}
+
+/**
+ * @brief The method returns the checksum algorithm to be used for new storages
+ * based on the features supported by the CPU. CRC-32C is used if the CRC32
+ * instruction is supported, otherwise XXH64.
+ *
+ * @returns Checksum algorithm
+ */
+inline ChecksumType DefaultChecksumType() {
+  if (Crc32cHash::IsHardwareSupported()) {
+    return ChecksumType::CRC32C;
+  }
+  return ChecksumType::XXHASH64;
+}
+
 } // namespace persist
 
 #endif /* PERSIST_UTILITY_CHECKSUM_HPP */
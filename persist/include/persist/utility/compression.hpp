@@ -0,0 +1,221 @@
+/**
+ * utility/compression.hpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PERSIST_UTILITY_COMPRESSION_HPP
+#define PERSIST_UTILITY_COMPRESSION_HPP
+
+#include <algorithm>
+#include <cstring>
+
+#include <persist/core/common.hpp>
+
+namespace persist {
+
+/**
+ * @brief LZ Codec
+ *
+ * A fast LZ77 family byte codec in the spirit of LZ4. Compressed data is a list
+ * of sequences, each made of a token byte, a run of literal bytes copied as is
+ * and a match given by a 2 byte offset back into the decompressed data. The
+ * high nibble of the token is the number of literals and the low nibble is the
+ * match length less the minimum match length. A nibble of 15 is extended by
+ * following bytes which are added to it until a byte other than 255. The last
+ * sequence has literals only.
+ *
+ * Matches are found using a hash table of the positions of the last seen 4
+ * byte sequences, trading compression ratio for speed.
+ */
+class LzCodec {
+private:
+  static const size_t min_match = 4;
+  static const size_t max_offset = 65535;
+  static const size_t hash_bits = 12;
+
+  /**
+   * @brief Hash the 4 bytes at given position.
+   */
+  static uint32_t Hash(const Byte *position) {
+    uint32_t value;
+    std::memcpy(&value, position, sizeof(value));
+    return (value * 2654435761U) >> (32 - hash_bits);
+  }
+
+  /**
+   * @brief Append a length of which the first 15 are stored in a token nibble.
+   */
+  static void DumpLength(ByteBuffer &output, size_t length) {
+    for (length -= 15; length >= 255; length -= 255) {
+      output.push_back(255);
+    }
+    output.push_back(static_cast<Byte>(length));
+  }
+
+  /**
+   * @brief Load a length stored in a token nibble and the following bytes.
+   */
+  static bool LoadLength(Span &input, size_t &length) {
+    if (length < 15) {
+      return true;
+    }
+    Byte byte;
+    do {
+      if (input.size == 0) {
+        return false;
+      }
+      byte = *input.start;
+      input += 1;
+      length += byte;
+    } while (byte == 255);
+    return true;
+  }
+
+  /**
+   * @brief Append a sequence of literals followed by a match.
+   */
+  static void DumpSequence(ByteBuffer &output, const Byte *literals,
+                           size_t literal_length, size_t offset,
+                           size_t match_length) {
+    size_t match_code = match_length ? match_length - min_match : 0;
+    Byte token = static_cast<Byte>(
+        (std::min<size_t>(literal_length, 15) << 4) |
+        std::min<size_t>(match_code, 15));
+    output.push_back(token);
+    if (literal_length >= 15) {
+      DumpLength(output, literal_length);
+    }
+    output.insert(output.end(), literals, literals + literal_length);
+    if (match_length) {
+      output.push_back(static_cast<Byte>(offset));
+      output.push_back(static_cast<Byte>(offset >> 8));
+      if (match_code >= 15) {
+        DumpLength(output, match_code);
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Compress given byte buffer.
+   *
+   * @param input Span object of the byte buffer to compress
+   * @param output byte buffer to append the compressed data to
+   * @returns size of the compressed data
+   */
+  static size_t Compress(Span input, ByteBuffer &output) {
+    size_t start = output.size();
+    uint32_t table[1 << hash_bits] = {0};
+    const Byte *base = input.start;
+    size_t anchor = 0, position = 0;
+    // Matches are searched while a full match fits in the input
+    while (input.size >= min_match && position <= input.size - min_match) {
+      uint32_t hash = Hash(base + position);
+      size_t candidate = table[hash];
+      table[hash] = static_cast<uint32_t>(position);
+      if (candidate >= position || position - candidate > max_offset ||
+          std::memcmp(base + candidate, base + position, min_match) != 0) {
+        ++position;
+        continue;
+      }
+      // Extend the match forwards and backwards
+      size_t length = min_match;
+      while (position + length < input.size &&
+             base[candidate + length] == base[position + length]) {
+        ++length;
+      }
+      while (position > anchor && candidate > 0 &&
+             base[candidate - 1] == base[position - 1]) {
+        --position;
+        --candidate;
+        ++length;
+      }
+      DumpSequence(output, base + anchor, position - anchor,
+                   position - candidate, length);
+      position += length;
+      anchor = position;
+    }
+    // Trailing literals
+    DumpSequence(output, base + anchor, input.size - anchor, 0, 0);
+    return output.size() - start;
+  }
+
+  /**
+   * @brief Decompress given byte buffer.
+   *
+   * @param input Span object of the compressed data
+   * @param output Span object of the byte buffer to decompress into. The size
+   * of the span must be the size of the decompressed data.
+   * @returns `true` if the data decompressed to exactly the output size else
+   * `false`
+   */
+  static bool Decompress(Span input, Span output) {
+    size_t position = 0;
+    while (input.size > 0) {
+      Byte token = *input.start;
+      input += 1;
+      // Copy literals
+      size_t literal_length = token >> 4;
+      if (!LoadLength(input, literal_length) || literal_length > input.size ||
+          literal_length > output.size - position) {
+        return false;
+      }
+      std::memcpy(output.start + position, input.start, literal_length);
+      input += literal_length;
+      position += literal_length;
+      if (input.size == 0) {
+        break;
+      }
+      // Copy match
+      if (input.size < 2) {
+        return false;
+      }
+      size_t offset = input.start[0] | (input.start[1] << 8);
+      input += 2;
+      size_t match_length = token & 0x0F;
+      if (!LoadLength(input, match_length)) {
+        return false;
+      }
+      match_length += min_match;
+      if (offset == 0 || offset > position ||
+          match_length > output.size - position) {
+        return false;
+      }
+      Byte *source = output.start + position - offset;
+      Byte *target = output.start + position;
+      if (offset >= match_length) {
+        std::memcpy(target, source, match_length);
+      } else {
+        // Copy byte by byte as the match overlaps the bytes being copied
+        for (size_t i = 0; i < match_length; ++i) {
+          target[i] = source[i];
+        }
+      }
+      position += match_length;
+    }
+    return position == output.size;
+  }
+};
+
+} // namespace persist
+
+#endif /* PERSIST_UTILITY_COMPRESSION_HPP */
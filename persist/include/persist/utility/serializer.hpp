@@ -96,6 +96,62 @@ static void dump0(Span &output, size_t n = 1) {
   }
 }
 
+/**
+ * @brief Get number of bytes used by the variable length encoding of an
+ * unsigned integer.
+ *
+ * @param value Value to encode.
+ * @returns Size of the encoded value.
+ */
+inline size_t varint_size(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+/**
+ * @brief Dump an unsigned integer to byte buffer using variable length
+ * encoding. Each byte stores 7 bits of the value starting from the least
+ * significant bits, with the high bit set on all but the last byte. Small
+ * values thus take a single byte.
+ *
+ * @param output Span of byte buffer to dump data.
+ * @param value Value to dump.
+ */
+inline void dump_varint(Span &output, uint64_t value) {
+  while (value >= 0x80) {
+    const Byte byte = static_cast<Byte>(value | 0x80);
+    _copy(byte, output);
+    value >>= 7;
+  }
+  const Byte byte = static_cast<Byte>(value);
+  _copy(byte, output);
+}
+
+/**
+ * @brief Load an unsigned integer dumped using variable length encoding from
+ * byte buffer.
+ *
+ * @param input Span of byte buffer to load data.
+ * @param value Loaded value.
+ * @returns `false` if the buffer ends before the value else `true`
+ */
+inline bool load_varint(Span &input, uint64_t &value) {
+  value = 0;
+  for (size_t shift = 0; input.size > 0 && shift < 64; shift += 7) {
+    Byte byte;
+    _copy(input, byte);
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 } // namespace persist
 
 #endif /* PERSIST_UTILITY_SERIALIZER_HPP */
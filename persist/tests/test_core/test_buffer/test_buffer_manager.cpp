@@ -112,6 +112,76 @@ TEST_F(BufferManagerTestFixture, TestGetNew) {
   ASSERT_EQ(page->GetId(), 4);
 }
 
+TEST_F(BufferManagerTestFixture, TestDeallocate) {
+  {
+    auto page = buffer_manager->Get(2);
+    page->SetRecord("testing"_bb);
+  }
+
+  // Modified page is dropped from the buffer without being written back
+  buffer_manager->Deallocate(2);
+  ASSERT_FALSE(buffer_manager->IsPageLoaded(2));
+  ASSERT_TRUE(storage->IsFree(2));
+
+  // Freed page ID is handed out again as a new page
+  auto page = buffer_manager->GetNew();
+  ASSERT_EQ(page->GetId(), 2);
+  ASSERT_EQ(page->GetRecord(), ""_bb);
+}
+
+TEST_F(BufferManagerTestFixture, TestDeallocateReuseEvicted) {
+  {
+    auto page = buffer_manager->Get(2);
+    page->SetRecord("testing"_bb);
+  }
+  ASSERT_TRUE(buffer_manager->Flush(2));
+  buffer_manager->Deallocate(2);
+
+  // Re-used page ID is evicted without being modified
+  ASSERT_EQ(buffer_manager->GetNew()->GetId(), 2);
+  buffer_manager->Get(1);
+  buffer_manager->Get(3);
+  ASSERT_FALSE(buffer_manager->IsPageLoaded(2));
+
+  // The stale block of the de-allocated page is never loaded back
+  auto page = buffer_manager->Get(2);
+  ASSERT_EQ(page->GetRecord(), ""_bb);
+}
+
+TEST_F(BufferManagerTestFixture, TestDeallocatePinned) {
+  auto page = buffer_manager->Get(1);
+
+  ASSERT_THROW(buffer_manager->Deallocate(1), BufferManagerError);
+  ASSERT_FALSE(storage->IsFree(1));
+}
+
+TEST_F(BufferManagerTestFixture, TestDeallocateIf) {
+  auto is_empty = [](SimplePage &page) { return page.GetRecord().empty(); };
+  {
+    auto page = buffer_manager->Get(2);
+    page->SetRecord("testing"_bb);
+  }
+
+  // Page not satisfying the predicate is kept
+  ASSERT_FALSE(buffer_manager->DeallocateIf(2, is_empty));
+  ASSERT_FALSE(storage->IsFree(2));
+
+  // Pinned page is skipped without raising an error
+  {
+    auto page = buffer_manager->Get(1);
+    ASSERT_FALSE(buffer_manager->DeallocateIf(1, is_empty));
+    ASSERT_FALSE(storage->IsFree(1));
+  }
+
+  // Page evicted from buffer is loaded to be checked
+  ASSERT_TRUE(buffer_manager->DeallocateIf(3, is_empty));
+  ASSERT_TRUE(storage->IsFree(3));
+  ASSERT_FALSE(buffer_manager->IsPageLoaded(3));
+
+  // Deallocated page is skipped
+  ASSERT_FALSE(buffer_manager->DeallocateIf(3, is_empty));
+}
+
 TEST_F(BufferManagerTestFixture, TestFlush) {
   ByteBuffer record;
 
@@ -169,3 +239,160 @@ TEST_F(BufferManagerTestFixture, TestPageReplacement) {
     ASSERT_EQ(_page->GetRecord(), ""_bb);
   }
 }
+
+TEST_F(BufferManagerTestFixture, TestPageReuse) {
+  SimplePage *page_ptr;
+  {
+    auto page = buffer_manager->Get(1);
+    page_ptr = page.operator->();
+  }
+  buffer_manager->Get(2);
+
+  // Page 1 is replaced and its page object re-used for page 3
+  auto page = buffer_manager->Get(3);
+  ASSERT_FALSE(buffer_manager->IsPageLoaded(1));
+  ASSERT_EQ(page.operator->(), page_ptr);
+  ASSERT_EQ(page->GetId(), 3);
+  ASSERT_EQ(page->GetRecord(), ""_bb);
+}
+
+TEST_F(BufferManagerTestFixture, TestPageReuseModified) {
+  ByteBuffer record = "testing"_bb;
+  {
+    auto page = buffer_manager->Get(3);
+    page->SetRecord(record);
+  }
+  buffer_manager->Get(1);
+  buffer_manager->Get(2);
+
+  // Page 3 is written back on replacement and loaded again in place
+  auto page = buffer_manager->Get(3);
+  ASSERT_EQ(page->GetId(), 3);
+  ASSERT_EQ(page->GetRecord(), record);
+}
+
+/********************************
+ * Testing for Object Storage
+ ********************************/
+
+class ObjectBufferManagerTestFixture : public ::testing::Test {
+protected:
+  const uint64_t page_size = DEFAULT_PAGE_SIZE;
+  const uint64_t max_size = 2;
+  std::unique_ptr<BufferManager<SimplePage>> buffer_manager;
+  std::unique_ptr<MemoryStorage<SimplePage>> storage;
+
+  void SetUp() override {
+    storage = std::make_unique<MemoryStorage<SimplePage>>(
+        page_size, MemoryStorageMode::OBJECT);
+    for (PageId page_id = 1; page_id <= 3; ++page_id) {
+      storage->Adopt(persist::CreatePage<SimplePage>(storage->Allocate(),
+                                                     page_size));
+    }
+
+    buffer_manager =
+        std::make_unique<BufferManager<SimplePage>>(*storage, max_size);
+    buffer_manager->Start();
+  }
+
+  void TearDown() override {
+    buffer_manager->Stop();
+    storage->Remove();
+  }
+};
+
+TEST_F(ObjectBufferManagerTestFixture, TestPageObjectKept) {
+  ByteBuffer record = "testing"_bb;
+  SimplePage *page_ptr;
+  {
+    auto page = buffer_manager->Get(1);
+    page->SetRecord(record);
+    page_ptr = page.operator->();
+  }
+  buffer_manager->Get(2);
+  buffer_manager->Get(3);
+  ASSERT_FALSE(buffer_manager->IsPageLoaded(1));
+
+  // Page 1 is handed back to storage on replacement and taken over again
+  auto page = buffer_manager->Get(1);
+  ASSERT_EQ(page.operator->(), page_ptr);
+  ASSERT_EQ(page->GetRecord(), record);
+}
+
+TEST_F(ObjectBufferManagerTestFixture, TestStop) {
+  ByteBuffer record = "testing"_bb;
+  {
+    auto page = buffer_manager->GetNew();
+    page->SetRecord(record);
+  }
+  buffer_manager->Stop();
+  ASSERT_TRUE(buffer_manager->IsEmpty());
+
+  // Pages are handed over to storage on stop
+  auto page = storage->Release(4);
+  ASSERT_EQ(page->GetRecord(), record);
+}
+
+TEST_F(BufferManagerTestFixture, TestScrub) {
+  // New page not yet written is skipped while a later page is written
+  PageId page_id = buffer_manager->GetNew()->GetId();
+  PageId next_page_id = buffer_manager->GetNew()->GetId();
+  ASSERT_TRUE(buffer_manager->Flush(next_page_id));
+  ASSERT_TRUE(buffer_manager->Scrub(page_id));
+  ASSERT_TRUE(buffer_manager->Flush(page_id));
+  ASSERT_TRUE(buffer_manager->Scrub(page_id));
+
+  // Zeroed block of a written page is corrupt
+  ByteBuffer block(page_size);
+  storage->WriteBlock(2, block);
+  ASSERT_FALSE(buffer_manager->Scrub(2));
+
+  // De-allocated page is skipped
+  buffer_manager->Deallocate(2);
+  ASSERT_TRUE(buffer_manager->Scrub(2));
+}
+
+TEST_F(BufferManagerTestFixture, TestVerifyPolicy) {
+  // Corrupt page 3 in storage
+  ByteBuffer block(page_size);
+  storage->ReadBlock(3, block);
+  block[page_size - 1] ^= 0xFF;
+  storage->WriteBlock(3, block);
+
+  ASSERT_THROW(buffer_manager->Get(3), PageCorruptError);
+  ASSERT_FALSE(buffer_manager->Scrub(3));
+  ASSERT_TRUE(buffer_manager->Scrub(1));
+
+  // Page is loaded without verification
+  storage->SetVerifyPolicy(VerifyPolicy::NEVER);
+  ASSERT_EQ(buffer_manager->Get(3)->GetId(), 3);
+}
+
+/********************************
+ * Testing for Concrete Storage Type
+ ********************************/
+
+TEST(StaticBufferManagerTest, TestFetch) {
+  MemoryStorage<SimplePage> storage;
+  BufferManager<SimplePage, LRUReplacer, MemoryStorage<SimplePage>>
+      buffer_manager(storage, 2);
+  buffer_manager.Start();
+
+  ByteBuffer record = "testing"_bb;
+  PageId page_id;
+  {
+    auto page = buffer_manager.GetNew();
+    page->SetRecord(record);
+    page_id = page->GetId();
+  }
+  // Replace the page in buffer
+  buffer_manager.GetNew();
+  buffer_manager.GetNew();
+  ASSERT_FALSE(buffer_manager.IsPageLoaded(page_id));
+
+  // Handle of the concrete replacer type converts to the base handle type
+  PageHandle<SimplePage> page = buffer_manager.Fetch(page_id);
+  ASSERT_EQ(page->GetRecord(), record);
+
+  buffer_manager.Stop();
+}
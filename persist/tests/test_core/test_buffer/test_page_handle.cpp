@@ -31,6 +31,7 @@
 #include <memory>
 
 #include <persist/core/buffer/page_handle.hpp>
+#include <persist/core/buffer/pinned_view.hpp>
 #include <persist/core/buffer/replacer/lru_replacer.hpp>
 #include <persist/core/page/creator.hpp>
 
@@ -114,3 +115,25 @@ TEST_F(PageHandleTestFixture, TestMoveAssignment) {
   ASSERT_TRUE(!replacer->IsPinned(page_id_1));
   ASSERT_TRUE(!replacer->IsPinned(page_id_2));
 }
+
+TEST_F(PageHandleTestFixture, TestPinnedView) {
+  page_1->SetRecord("testing"_bb);
+  auto get_record = [](const SimplePage &page) {
+    return ByteView(page.GetRecord());
+  };
+
+  {
+    PinnedView<SimplePage> view(GetPageHandle(page_id_1), get_record);
+    ASSERT_TRUE(replacer->IsPinned(page_id_1));
+    ASSERT_EQ(view.ToBuffer(), "testing"_bb);
+
+    // Moved view keeps the page pinned
+    PinnedView<SimplePage> _view(std::move(view));
+    ASSERT_TRUE(replacer->IsPinned(page_id_1));
+    ASSERT_EQ(_view.data(), page_1->GetRecord().data());
+    ASSERT_EQ(_view.size(), page_1->GetRecord().size());
+    ASSERT_EQ(view.size(), 0);
+  }
+
+  ASSERT_TRUE(!replacer->IsPinned(page_id_1));
+}
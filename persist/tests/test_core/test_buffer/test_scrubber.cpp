@@ -0,0 +1,125 @@
+/**
+ * test_scrubber.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <persist/core/buffer/scrubber.hpp>
+#include <persist/core/page/creator.hpp>
+#include <persist/core/storage/memory_storage.hpp>
+
+#include "persist/test/simple_page.hpp"
+
+using namespace persist;
+using namespace persist::test;
+
+class ScrubberTestFixture : public ::testing::Test {
+protected:
+  const uint64_t page_size = DEFAULT_PAGE_SIZE;
+  const uint64_t max_size = 2;
+  std::unique_ptr<MemoryStorage<SimplePage>> storage;
+  std::unique_ptr<BufferManager<SimplePage>> buffer_manager;
+  std::unique_ptr<Scrubber<SimplePage>> scrubber;
+
+  void SetUp() override {
+    storage = std::make_unique<MemoryStorage<SimplePage>>(page_size);
+    for (size_t i = 0; i < 3; ++i) {
+      auto page = CreatePage<SimplePage>(storage->Allocate(), page_size);
+      page->SetRecord("testing"_bb);
+      storage->Write(*page);
+    }
+    // Corrupt page 2
+    ByteBuffer block(page_size);
+    storage->ReadBlock(2, block);
+    block[page_size - 1] ^= 0xFF;
+    storage->WriteBlock(2, block);
+
+    buffer_manager =
+        std::make_unique<BufferManager<SimplePage>>(*storage, max_size);
+    buffer_manager->Start();
+    scrubber = std::make_unique<Scrubber<SimplePage>>(*buffer_manager);
+  }
+
+  void TearDown() override {
+    scrubber->Stop();
+    buffer_manager->Stop();
+  }
+};
+
+TEST_F(ScrubberTestFixture, TestScrubNext) {
+  scrubber->ScrubNext(3);
+
+  ASSERT_EQ(scrubber->GetScrubbedCount(), 3);
+  ASSERT_EQ(scrubber->GetCorruptPages(), std::set<PageId>({2}));
+}
+
+TEST_F(ScrubberTestFixture, TestScrubRepaired) {
+  scrubber->ScrubNext(3);
+  {
+    // Page is written back intact when flushed
+    storage->SetVerifyPolicy(VerifyPolicy::NEVER);
+    auto page = buffer_manager->Get(2);
+    page->SetRecord("repaired"_bb);
+  }
+  buffer_manager->FlushAll();
+
+  // Scrubbing wraps around to the first page
+  scrubber->ScrubNext(3);
+  ASSERT_EQ(scrubber->GetScrubbedCount(), 6);
+  ASSERT_TRUE(scrubber->GetCorruptPages().empty());
+}
+
+TEST_F(ScrubberTestFixture, TestScrubSkipsFreePages) {
+  storage->Deallocate(2);
+  scrubber->ScrubNext(3);
+
+  ASSERT_TRUE(scrubber->GetCorruptPages().empty());
+}
+
+TEST_F(ScrubberTestFixture, TestConcreteStorage) {
+  // Buffer manager calling the concrete storage type can be scrubbed
+  typedef MemoryStorage<SimplePage> StorageType;
+  BufferManager<SimplePage, LRUReplacer, StorageType> _buffer_manager(
+      *storage, max_size);
+  _buffer_manager.Start();
+  Scrubber<SimplePage, LRUReplacer, StorageType> _scrubber(_buffer_manager);
+  _scrubber.ScrubNext(3);
+
+  ASSERT_EQ(_scrubber.GetCorruptPages(), std::set<PageId>({2}));
+}
+
+TEST_F(ScrubberTestFixture, TestStartStop) {
+  scrubber->SetRate(10000);
+  scrubber->Start();
+  while (scrubber->GetScrubbedCount() < 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  scrubber->Stop();
+
+  ASSERT_EQ(scrubber->GetCorruptPages(), std::set<PageId>({2}));
+}
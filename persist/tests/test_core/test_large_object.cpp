@@ -0,0 +1,221 @@
+/**
+ * test_large_object.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Large object unit tests
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+
+#include <persist/core/buffer/buffer_manager.hpp>
+#include <persist/core/large_object.hpp>
+#include <persist/core/storage/creator.hpp>
+#include <persist/core/storage/memory_storage.hpp>
+
+using namespace persist;
+
+class LargeObjectManagerTestFixture : public ::testing::Test {
+protected:
+  const size_t object_size = 5000;
+  ByteBuffer object;
+  std::unique_ptr<MemoryStorage<LogPage>> log_storage;
+  std::unique_ptr<LogManager> log_manager;
+  std::unique_ptr<MemoryStorage<RecordPage>> storage;
+  std::unique_ptr<BufferManager<RecordPage>> buffer_manager;
+  std::unique_ptr<LargeObjectManager> manager;
+  RecordPageSlot::Location location;
+
+  void SetUp() override {
+    log_storage = std::make_unique<MemoryStorage<LogPage>>();
+    log_manager = std::make_unique<LogManager>(*log_storage, 2);
+    log_manager->Start();
+    storage = std::make_unique<MemoryStorage<RecordPage>>();
+    buffer_manager = std::make_unique<BufferManager<RecordPage>>(*storage, 2);
+    buffer_manager->Start();
+    manager = std::make_unique<LargeObjectManager>(*buffer_manager);
+
+    // Write object in chunks smaller than a page
+    for (size_t i = 0; i < object_size; ++i) {
+      object.push_back(static_cast<Byte>(i));
+    }
+    Transaction txn(*log_manager, 0);
+    auto writer = manager->GetWriter(txn);
+    for (size_t offset = 0; offset < object_size; offset += 300) {
+      size_t size = std::min<size_t>(300, object_size - offset);
+      writer.Write(Span(object.data() + offset, size));
+    }
+    location = writer.Close();
+  }
+
+  void TearDown() override {
+    buffer_manager->Stop();
+    log_manager->Stop();
+  }
+
+  /**
+   * @brief Read object at test location in chunks of given size.
+   */
+  ByteBuffer ReadObject(size_t size) {
+    Transaction txn(*log_manager, 0);
+    auto reader = manager->GetReader(location, txn);
+    ByteBuffer output, buffer(size);
+    while (size_t read = reader.Read(buffer)) {
+      output.insert(output.end(), buffer.begin(), buffer.begin() + read);
+    }
+    return output;
+  }
+};
+
+TEST_F(LargeObjectManagerTestFixture, TestIsLarge) {
+  ASSERT_FALSE(manager->IsLarge(DEFAULT_LARGE_OBJECT_THRESHOLD));
+  ASSERT_TRUE(manager->IsLarge(DEFAULT_LARGE_OBJECT_THRESHOLD + 1));
+}
+
+TEST_F(LargeObjectManagerTestFixture, TestReadWrite) {
+  // Object spans multiple overflow pages
+  ASSERT_GT(storage->GetPageCount(), object_size / DEFAULT_PAGE_SIZE);
+  ASSERT_EQ(ReadObject(700), object);
+  ASSERT_EQ(ReadObject(object_size * 2), object);
+}
+
+TEST_F(LargeObjectManagerTestFixture, TestUpdate) {
+  Transaction txn(*log_manager, 0);
+  auto first_page = buffer_manager->Get(location.page_id);
+  size_t chunk_size =
+      first_page->GetPageSlot(location.slot_id, txn).data.size();
+
+  // Update a range across the boundary of the first two chunks
+  ByteBuffer data(100, 'A');
+  manager->Update(location, chunk_size - 50, data, txn);
+  std::copy(data.begin(), data.end(), object.begin() + chunk_size - 50);
+  ASSERT_EQ(ReadObject(1000), object);
+
+  // Only the changed ranges of the two changed chunks are logged
+  auto log_record = log_manager->Get(txn.GetLogLocation());
+  ASSERT_EQ(log_record->GetLogType(), LogRecord::Type::UPDATE);
+  ASSERT_LE(log_record->GetDelta().GetStorageSize(), data.size() + 8);
+  log_record = log_manager->Get(log_record->GetPrevLocation());
+  ASSERT_EQ(log_record->GetLogType(), LogRecord::Type::UPDATE);
+  ASSERT_EQ(log_record->GetLocation(), location);
+  ASSERT_LE(log_record->GetDelta().GetStorageSize(), data.size() + 8);
+  ASSERT_TRUE(log_record->GetPrevLocation().IsNull());
+}
+
+TEST_F(LargeObjectManagerTestFixture, TestRemove) {
+  Transaction txn(*log_manager, 0);
+  manager->Remove(location, txn);
+
+  auto reader = manager->GetReader(location, txn);
+  ByteBuffer buffer(100);
+  ASSERT_THROW(reader.Read(buffer), PageSlotNotFoundError);
+}
+
+TEST_F(LargeObjectManagerTestFixture, TestRemoveFreePages) {
+  Transaction txn(*log_manager, 0);
+  std::set<PageId> page_ids;
+  for (RecordPageSlot::Location chunk_location = location;
+       !chunk_location.IsNull();) {
+    page_ids.insert(chunk_location.page_id);
+    auto page = buffer_manager->Get(chunk_location.page_id);
+    chunk_location =
+        page->GetPageSlot(chunk_location.slot_id, txn).GetNextLocation();
+  }
+  manager->Remove(location, txn);
+
+  // All overflow pages of the object are emptied
+  ASSERT_GT(page_ids.size(), 1);
+  ASSERT_EQ(txn.GetFreed(), page_ids);
+}
+
+TEST_F(LargeObjectManagerTestFixture, TestWriterLocation) {
+  // Object starts at the slot taken by the first chunk in its page
+  ASSERT_EQ(location.slot_id, 1);
+  Transaction txn(*log_manager, 0);
+  auto page = buffer_manager->Get(location.page_id);
+  RecordPageSlot::Location next_location =
+      page->GetPageSlot(location.slot_id, txn).GetNextLocation();
+  auto next_page = buffer_manager->Get(next_location.page_id);
+  ASSERT_EQ(next_page->GetPageSlot(next_location.slot_id, txn)
+                .GetPrevLocation(),
+            location);
+}
+
+TEST_F(LargeObjectManagerTestFixture, TestRemoveReuse) {
+  // File storage so that evicted pages are loaded back from stored blocks
+  auto file_storage =
+      persist::CreateStorage<RecordPage>("file://test_large_object_reuse");
+  BufferManager<RecordPage> file_buffer_manager(*file_storage, 2);
+  file_buffer_manager.Start();
+  LargeObjectManager file_manager(file_buffer_manager);
+
+  auto write = [&](ByteBuffer &data, Transaction &txn) {
+    auto writer = file_manager.GetWriter(txn);
+    writer.Write(data);
+    return writer.Close();
+  };
+  auto read = [&](RecordPageSlot::Location location, Transaction &txn) {
+    auto reader = file_manager.GetReader(location, txn);
+    ByteBuffer output, buffer(100);
+    while (size_t read = reader.Read(buffer)) {
+      output.insert(output.end(), buffer.begin(), buffer.begin() + read);
+    }
+    return output;
+  };
+
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot::Location old_location = write(object, txn);
+  file_buffer_manager.FlushAll();
+  file_manager.Remove(old_location, txn);
+  for (PageId page_id : txn.GetFreed()) {
+    file_buffer_manager.Deallocate(page_id);
+  }
+
+  // New object re-uses the freed pages and is read back through evictions
+  ByteBuffer new_object(object_size, 'A');
+  RecordPageSlot::Location new_location = write(new_object, txn);
+  ASSERT_EQ(new_location.page_id, old_location.page_id);
+  ASSERT_EQ(read(new_location, txn), new_object);
+
+  file_buffer_manager.Stop();
+  file_storage->Remove();
+}
+
+TEST_F(LargeObjectManagerTestFixture, TestWriterDestroyed) {
+  Transaction txn(*log_manager, 0);
+  PageId page_id;
+  {
+    auto writer = manager->GetWriter(txn);
+    writer.Write(Span(object.data(), 100));
+    page_id = buffer_manager->GetNew()->GetId() - 1;
+  }
+
+  // Last chunk is dropped and its empty overflow page freed on commit
+  auto page = buffer_manager->Get(page_id);
+  ASSERT_TRUE(page->IsEmpty());
+  ASSERT_EQ(txn.GetFreed(), std::set<PageId>({page_id}));
+}
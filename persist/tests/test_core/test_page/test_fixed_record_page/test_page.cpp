@@ -0,0 +1,186 @@
+/**
+ * test_page.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief FixedRecordPage unit tests
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+/**
+ * Enabled intrusive testing
+ */
+#define PERSIST_INTRUSIVE_TESTING
+
+#include <persist/core/buffer/buffer_manager.hpp>
+#include <persist/core/page/fixed_record_page/page.hpp>
+#include <persist/core/storage/memory_storage.hpp>
+
+using namespace persist;
+
+class FixedRecordPageTestFixture : public ::testing::Test {
+protected:
+  static const size_t record_size = 16;
+  typedef FixedRecordPage<record_size> PageType;
+  const PageId page_id = 12;
+  const uint64_t page_size = DEFAULT_PAGE_SIZE;
+  std::unique_ptr<PageType> page;
+  ByteBuffer record_1, record_2;
+  PageSlotId slot_id_1, slot_id_2;
+  std::unique_ptr<MemoryStorage<LogPage>> storage;
+  std::unique_ptr<LogManager> log_manager;
+
+  void SetUp() override {
+    // Setup log manager
+    storage = std::make_unique<MemoryStorage<LogPage>>();
+    log_manager = std::make_unique<LogManager>(*storage, 2);
+    log_manager->Start();
+
+    // Setup valid page
+    page = std::make_unique<PageType>(page_id, page_size);
+    record_1 = ByteBuffer(record_size, 'A');
+    record_2 = ByteBuffer(record_size, 'B');
+    Transaction txn(*log_manager, 0);
+    slot_id_1 = page->InsertRecord(record_1.data(), txn);
+    slot_id_2 = page->InsertRecord(record_2.data(), txn);
+  }
+
+  void TearDown() override { log_manager->Stop(); }
+};
+
+TEST_F(FixedRecordPageTestFixture, TestCapacity) {
+  // Bitmap and slots fit in the page
+  ASSERT_EQ(page->GetCapacity(), 62);
+  ASSERT_EQ(page->records_offset, 3 * sizeof(PageId) + sizeof(uint64_t));
+  ASSERT_EQ(page->GetRecordCount(), 2);
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::INSERT), 60 * record_size);
+  ASSERT_EQ(FixedRecordPage<1>(0, page_size).GetCapacity(), 888);
+}
+
+TEST_F(FixedRecordPageTestFixture, TestGetRecord) {
+  ASSERT_EQ(slot_id_1, 1);
+  ASSERT_EQ(slot_id_2, 2);
+  ASSERT_EQ(ByteBuffer(page->GetRecord(slot_id_1),
+                       page->GetRecord(slot_id_1) + record_size),
+            record_1);
+  ASSERT_THROW(page->GetRecord(3), PageSlotNotFoundError);
+  ASSERT_THROW(page->GetRecord(0), PageSlotNotFoundError);
+}
+
+TEST_F(FixedRecordPageTestFixture, TestInsertRecord) {
+  Transaction txn(*log_manager, 0);
+  page->RemoveRecord(slot_id_1, txn);
+
+  // Lowest free slot is re-used
+  ASSERT_EQ(page->InsertRecord(record_2.data(), txn), slot_id_1);
+  ASSERT_EQ(page->InsertRecord(record_2.data(), txn), 3);
+
+  // Insert operation is logged
+  auto log_record = log_manager->Get(txn.GetLogLocation());
+  ASSERT_EQ(log_record->GetLogType(), LogRecord::Type::INSERT);
+  ASSERT_EQ(log_record->GetLocation(), RecordPageSlot::Location(page_id, 3));
+  ASSERT_EQ(log_record->GetPageSlotA().data, record_2);
+}
+
+TEST_F(FixedRecordPageTestFixture, TestPageFullError) {
+  Transaction txn(*log_manager, 0);
+  while (page->GetRecordCount() < page->GetCapacity()) {
+    page->InsertRecord(record_1.data(), txn);
+  }
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::INSERT), 0);
+  ASSERT_THROW(page->InsertRecord(record_1.data(), txn), PageFullError);
+}
+
+TEST_F(FixedRecordPageTestFixture, TestUpdateRecord) {
+  Transaction txn(*log_manager, 0);
+  page->UpdateRecord(slot_id_1, record_2.data(), txn);
+
+  ASSERT_EQ(ByteBuffer(page->GetRecord(slot_id_1),
+                       page->GetRecord(slot_id_1) + record_size),
+            record_2);
+  auto log_record = log_manager->Get(txn.GetLogLocation());
+  ASSERT_EQ(log_record->GetLogType(), LogRecord::Type::UPDATE);
+  ASSERT_EQ(log_record->Redo(RecordPageSlot(record_1)).data, record_2);
+  ASSERT_EQ(log_record->Undo(RecordPageSlot(record_2)).data, record_1);
+}
+
+TEST_F(FixedRecordPageTestFixture, TestRemoveRecord) {
+  Transaction txn(*log_manager, 0);
+  page->RemoveRecord(slot_id_1, txn);
+
+  ASSERT_FALSE(page->IsOccupied(slot_id_1));
+  ASSERT_EQ(page->GetRecordCount(), 1);
+  ASSERT_THROW(page->RemoveRecord(slot_id_1, txn), PageSlotNotFoundError);
+
+  // Removed record is inserted back
+  page->UndoRemoveRecord(slot_id_1, record_1.data(), txn);
+  ASSERT_TRUE(page->IsOccupied(slot_id_1));
+  ASSERT_EQ(page->GetRecordCount(), 2);
+}
+
+TEST_F(FixedRecordPageTestFixture, TestLoadDump) {
+  Transaction txn(*log_manager, 0);
+  page->RemoveRecord(slot_id_1, txn);
+  ByteBuffer output(page_size);
+  page->Dump(output);
+
+  PageType _page(0, page_size);
+  _page.Load(output);
+  ASSERT_EQ(_page.GetId(), page_id);
+  ASSERT_EQ(_page.GetRecordCount(), 1);
+  ASSERT_FALSE(_page.IsOccupied(slot_id_1));
+  ASSERT_EQ(ByteBuffer(_page.GetRecord(slot_id_2),
+                       _page.GetRecord(slot_id_2) + record_size),
+            record_2);
+
+  // Slots beyond capacity must be free
+  output[page->bitmap_offset + sizeof(uint64_t) - 1] = 0xFF;
+  ASSERT_THROW(_page.Load(output), PageParseError);
+}
+
+TEST_F(FixedRecordPageTestFixture, TestBufferManager) {
+  MemoryStorage<PageType> page_storage(page_size);
+  BufferManager<PageType> buffer_manager(page_storage, 2);
+  buffer_manager.Start();
+  Transaction txn(*log_manager, 0);
+
+  PageId _page_id;
+  {
+    auto _page = buffer_manager.GetNew();
+    _page_id = _page->GetId();
+    _page->InsertRecord(record_1.data(), txn);
+  }
+  buffer_manager.FlushAll();
+
+  // Page is written to and read from storage
+  auto _page = page_storage.Read(_page_id);
+  ASSERT_EQ(_page->GetRecordCount(), 1);
+  ASSERT_EQ(
+      ByteBuffer(_page->GetRecord(1), _page->GetRecord(1) + record_size),
+      record_1);
+  buffer_manager.Stop();
+}
@@ -30,6 +30,8 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <persist/core/page/log_page/page.hpp>
 
@@ -59,8 +61,8 @@ protected:
     header->last_seq_number = last_seq_number;
     header->slot_count = slot_count;
 
-    input = {12, 0, 0, 0, 0,  0, 0, 0, 1, 0, 0, 0,
-             0,  0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0};
+    input = {12, 0, 0, 0, 0, 0, 0, 0, 1,  0, 0, 0, 0, 0, 0, 0,
+             0,  0, 0, 0, 1, 0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0};
     extra = {42, 0, 0, 0, 21, 48, 4};
   }
 };
@@ -130,66 +132,74 @@ protected:
     page->InsertPageSlot(*page_slot_2);
 
     input = {
-        12,  0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   2,
-        0,   0,   0,   0,  0,  0, 0, 2, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  9, 0, 0, 0, 0, 0, 0,   0,   116, 101, 115, 116,
-        105, 110, 103, 95, 50, 1, 0, 0, 0, 0, 0, 0,   0,   10,  0,   0,   0,
-        0,   0,   0,   0,  4,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   9,  0,  0, 0, 0, 0, 0, 0, 116, 101, 115, 116, 105, 110,
-        103, 95,  49,  0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,  0,  0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,
+        12,  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   1,   0,   0,   0,   2,   0,   0,  0,  0, 0,
+        0,   0,   1,   0,   0,   0,   0,   0,   0,   0,   10,  0,  0,  0, 0,
+        0,   0,   0,   4,   0,   0,   0,   0,   0,   0,   0,   9,  0,  0, 0,
+        0,   0,   0,   0,   116, 101, 115, 116, 105, 110, 103, 95, 49, 2, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   9,   0,   0,   0,   0,  0,  0, 0,
+        116, 101, 115, 116, 105, 110, 103, 95,  50,  0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0,
         0,   0,   0,   0};
   }
 };
@@ -254,9 +264,68 @@ TEST_F(LogPageTestFixture, TestLoadError) {
   ASSERT_THROW(_page.Load(_input), PageParseError);
 }
 
+TEST_F(LogPageTestFixture, TestLoadVersionError) {
+  // Pages written before the log format was versioned hold their slot count
+  // in place of the format word
+  ByteBuffer _input = input;
+  std::fill(_input.begin() + 16, _input.begin() + 24, 0);
+  _input[16] = 2;
+  LogPage _page;
+  ASSERT_THROW(_page.Load(_input), PageParseError);
+}
+
 TEST_F(LogPageTestFixture, TestDump) {
   ByteBuffer output(page_size);
   page->Dump(output);
 
   ASSERT_EQ(input, output);
 }
+
+TEST_F(LogPageTestFixture, TestDumpUntouched) {
+  // Slots not accessed after load are dumped as is
+  LogPage _page;
+  _page.Load(input);
+  ByteBuffer output(page_size);
+  _page.Dump(output);
+
+  ASSERT_EQ(input, output);
+}
+
+TEST_F(LogPageTestFixture, TestInsertAfterLoad) {
+  LogPage _page;
+  _page.Load(input);
+  LogPageSlot page_slot(100);
+  page_slot.data = "testing_3"_bb;
+  size_t free_space = _page.GetFreeSpaceSize(Operation::INSERT);
+  _page.InsertPageSlot(page_slot);
+
+  ASSERT_EQ(free_space, page->GetFreeSpaceSize(Operation::INSERT));
+
+  ByteBuffer output(page_size);
+  _page.Dump(output);
+  LogPage loaded_page;
+  loaded_page.Load(output);
+
+  ASSERT_EQ(loaded_page.GetPageSlot(seq_number_1).data, page_slot_data_1);
+  ASSERT_EQ(loaded_page.GetPageSlot(seq_number_2).data, page_slot_data_2);
+  ASSERT_EQ(loaded_page.GetPageSlot(100), page_slot);
+}
+
+TEST_F(LogPageTestFixture, TestConcurrentGetPageSlot) {
+  // Readers of a loaded page decode its slots concurrently
+  LogPage _page;
+  _page.Load(input);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 100; ++j) {
+        EXPECT_EQ(_page.GetPageSlot(seq_number_1).data, page_slot_data_1);
+        EXPECT_EQ(_page.GetPageSlot(seq_number_2).data, page_slot_data_2);
+        EXPECT_GT(_page.GetFreeSpaceSize(Operation::INSERT), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
@@ -57,8 +57,8 @@ protected:
     header->next_location.page_id = next_page_id;
     header->next_location.seq_number = next_seq_number;
 
-    input = {0,   0, 0, 0, 0, 0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0,
-             100, 0, 0, 0, 0, 0, 0, 0, 0,  0, 0, 0, 0, 0, 0, 0};
+    input = {0, 0, 0, 0, 0, 0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 100, 0, 0, 0, 0,
+             0, 0, 0};
     extra = {41, 0, 6, 0, 21, 48, 4};
   }
 };
@@ -106,9 +106,9 @@ protected:
     slot = std::make_unique<LogPageSlot>(seq_number, location);
     slot->data = data;
 
-    input = {0,   0, 0, 0, 0, 0, 0, 0, 10,  0,   0,   0,   0,   0,   0,  0,
-             100, 0, 0, 0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,  0,
-             7,   0, 0, 0, 0, 0, 0, 0, 116, 101, 115, 116, 105, 110, 103};
+    input = {0,   0,   0,   0,   0,   0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0,   100,
+             0,   0,   0,   0,   0,   0, 0, 7, 0,  0, 0, 0, 0, 0, 0, 116, 101,
+             115, 116, 105, 110, 103};
   }
 };
 
@@ -143,7 +143,8 @@ TEST_F(LogPageSlotTestFixture, TestMoveLogPageSlot) {
 
 TEST_F(LogPageSlotTestFixture, TestGetStorageSize) {
   ASSERT_EQ(slot->GetStorageSize(),
-            data.size() + sizeof(size_t) + sizeof(LogPageSlot::Header));
+            data.size() + sizeof(size_t) +
+                LogPageSlot::Header::GetFixedStorageSize());
 }
 
 TEST_F(LogPageSlotTestFixture, TestGetNextLocation) {
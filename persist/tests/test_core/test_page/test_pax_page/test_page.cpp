@@ -0,0 +1,185 @@
+/**
+ * test_page.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief PaxPage unit tests
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+/**
+ * Enabled intrusive testing
+ */
+#define PERSIST_INTRUSIVE_TESTING
+
+#include <persist/core/page/pax_page/page.hpp>
+#include <persist/core/storage/memory_storage.hpp>
+
+using namespace persist;
+
+class PaxPageTestFixture : public ::testing::Test {
+protected:
+  typedef PaxPage<8, 4, 2> PageType;
+  const PageId page_id = 12;
+  const uint64_t page_size = DEFAULT_PAGE_SIZE;
+  std::unique_ptr<PageType> page;
+  ByteBuffer record_1, record_2;
+  PageSlotId slot_id_1, slot_id_2;
+  std::unique_ptr<MemoryStorage<LogPage>> storage;
+  std::unique_ptr<LogManager> log_manager;
+
+  void SetUp() override {
+    // Setup log manager
+    storage = std::make_unique<MemoryStorage<LogPage>>();
+    log_manager = std::make_unique<LogManager>(*storage, 2);
+    log_manager->Start();
+
+    // Setup valid page
+    page = std::make_unique<PageType>(page_id, page_size);
+    record_1 = "AAAAAAAABBBBCC"_bb;
+    record_2 = "aaaaaaaabbbbcc"_bb;
+    Transaction txn(*log_manager, 0);
+    slot_id_1 = page->InsertRecord(record_1.data(), txn);
+    slot_id_2 = page->InsertRecord(record_2.data(), txn);
+  }
+
+  void TearDown() override { log_manager->Stop(); }
+};
+
+TEST_F(PaxPageTestFixture, TestLayout) {
+  ASSERT_EQ(PageType::GetColumnCount(), 3);
+  ASSERT_EQ(PageType::GetRecordSize(), 14);
+  ASSERT_EQ(PageType::GetColumnSize(1), 4);
+  ASSERT_EQ(page->GetCapacity(), 70);
+  ASSERT_EQ(page->GetRecordCount(), 2);
+  ASSERT_EQ(page->GetSlotCount(), 2);
+  // Minipages are aligned and fit in the page
+  for (size_t column = 0; column < PageType::GetColumnCount(); ++column) {
+    ASSERT_EQ(page->column_offsets[column] % 8, 0);
+  }
+  ASSERT_LE(page->column_offsets[2] + 2 * page->GetCapacity(), page_size);
+}
+
+TEST_F(PaxPageTestFixture, TestGetColumn) {
+  // Values of a column are stored contiguously
+  const Byte *column = page->GetColumn(1);
+  ASSERT_EQ(ByteBuffer(column, column + 8), "BBBBbbbb"_bb);
+  column = page->GetColumn(2);
+  ASSERT_EQ(ByteBuffer(column, column + 4), "CCcc"_bb);
+}
+
+TEST_F(PaxPageTestFixture, TestGetRecord) {
+  ASSERT_EQ(page->GetRecord(slot_id_1), record_1);
+  ASSERT_EQ(page->GetRecord(slot_id_2), record_2);
+  ASSERT_THROW(page->GetRecord(3), PageSlotNotFoundError);
+}
+
+TEST_F(PaxPageTestFixture, TestUpdateRecord) {
+  Transaction txn(*log_manager, 0);
+  page->UpdateRecord(slot_id_1, record_2.data(), txn);
+
+  ASSERT_EQ(page->GetRecord(slot_id_1), record_2);
+  auto log_record = log_manager->Get(txn.GetLogLocation());
+  ASSERT_EQ(log_record->GetLogType(), LogRecord::Type::UPDATE);
+  ASSERT_EQ(log_record->Redo(RecordPageSlot(record_1)).data, record_2);
+  ASSERT_EQ(log_record->Undo(RecordPageSlot(record_2)).data, record_1);
+}
+
+TEST_F(PaxPageTestFixture, TestRemoveRecord) {
+  Transaction txn(*log_manager, 0);
+  page->RemoveRecord(slot_id_2, txn);
+
+  ASSERT_EQ(page->GetRecordCount(), 1);
+  ASSERT_EQ(page->GetSlotCount(), 1);
+  ASSERT_EQ(page->GetColumn(0)[8], 0);
+  auto log_record = log_manager->Get(txn.GetLogLocation());
+  ASSERT_EQ(log_record->GetLogType(), LogRecord::Type::DELETE);
+  ASSERT_EQ(log_record->GetPageSlotA().data, record_2);
+
+  // Removed record is inserted back
+  page->UndoRemoveRecord(slot_id_2, record_2.data(), txn);
+  ASSERT_EQ(page->GetRecord(slot_id_2), record_2);
+  ASSERT_EQ(page->GetSlotCount(), 2);
+}
+
+TEST_F(PaxPageTestFixture, TestUndo) {
+  Transaction txn(*log_manager, 0);
+
+  // Operations are logged for the PAX page kind and undone on the page
+  page->UpdateRecord(slot_id_1, record_2.data(), txn);
+  auto log_record = log_manager->Get(txn.GetLogLocation());
+  ASSERT_EQ(log_record->GetPageKind(), LogRecord::PageKind::PAX);
+  page->Undo(*log_record, txn);
+  ASSERT_EQ(page->GetRecord(slot_id_1), record_1);
+
+  page->RemoveRecord(slot_id_2, txn);
+  log_record = log_manager->Get(txn.GetLogLocation());
+  page->Undo(*log_record, txn);
+  ASSERT_EQ(page->GetRecord(slot_id_2), record_2);
+
+  PageSlotId slot_id = page->InsertRecord(record_1.data(), txn);
+  log_record = log_manager->Get(txn.GetLogLocation());
+  page->Undo(*log_record, txn);
+  ASSERT_FALSE(page->IsOccupied(slot_id));
+  ASSERT_EQ(page->GetRecordCount(), 2);
+
+  // Logged record of another size is not undone
+  RecordPageSlot::Location location(page_id, slot_id_1);
+  RecordPageSlot page_slot("short"_bb);
+  txn.LogDeleteOp(location, page_slot, LogRecord::PageKind::PAX);
+  log_record = log_manager->Get(txn.GetLogLocation());
+  page->RemoveRecord(slot_id_1, txn);
+  ASSERT_THROW(page->Undo(*log_record, txn), LogRecordParseError);
+}
+
+TEST_F(PaxPageTestFixture, TestPageFullError) {
+  Transaction txn(*log_manager, 0);
+  while (page->GetRecordCount() < page->GetCapacity()) {
+    page->InsertRecord(record_1.data(), txn);
+  }
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::INSERT), 0);
+  ASSERT_THROW(page->InsertRecord(record_1.data(), txn), PageFullError);
+}
+
+TEST_F(PaxPageTestFixture, TestLoadDump) {
+  Transaction txn(*log_manager, 0);
+  page->RemoveRecord(slot_id_1, txn);
+  ByteBuffer output(page_size);
+  page->Dump(output);
+
+  PageType _page(0, page_size);
+  _page.Load(output);
+  ASSERT_EQ(_page.GetId(), page_id);
+  ASSERT_EQ(_page.GetRecordCount(), 1);
+  ASSERT_EQ(_page.GetSlotCount(), 2);
+  ASSERT_FALSE(_page.IsOccupied(slot_id_1));
+  ASSERT_EQ(_page.GetRecord(slot_id_2), record_2);
+
+  // Slots beyond capacity must be free
+  output[page->bitmap_offset + sizeof(uint64_t) + 7] = 0xFF;
+  ASSERT_THROW(_page.Load(output), PageParseError);
+}
@@ -30,15 +30,20 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <memory>
+#include <thread>
+#include <vector>
 
 /**
  * Enabled intrusive testing
  */
 #define PERSIST_INTRUSIVE_TESTING
 
+#include <persist/core/buffer/buffer_manager.hpp>
 #include <persist/core/page/record_page/page.hpp>
 #include <persist/core/storage/creator.hpp>
+#include <persist/core/storage/memory_storage.hpp>
 
 #include "persist/test/mocks/page_observer.hpp"
 
@@ -66,19 +71,16 @@ protected:
     // setup valid header
     header->next_page_id = next_page_id;
     header->prev_page_id = prev_page_id;
-    header->slots[1] =
-        RecordPage::Header::SlotSpan({DEFAULT_PAGE_SIZE - 10, 10});
-    header->slots[2] =
-        RecordPage::Header::SlotSpan({DEFAULT_PAGE_SIZE - 15, 5});
-    header->slots[3] =
-        RecordPage::Header::SlotSpan({DEFAULT_PAGE_SIZE - 18, 3});
-
-    input = {12, 0, 0, 0, 0,   0, 0, 0, 15, 0, 0,   0, 0,  0, 0, 0, 1,   0,
-             0,  0, 0, 0, 0,   0, 3, 0, 0,  0, 0,   0, 0,  0, 1, 0, 0,   0,
-             0,  0, 0, 0, 246, 3, 0, 0, 0,  0, 0,   0, 10, 0, 0, 0, 0,   0,
-             0,  0, 2, 0, 0,   0, 0, 0, 0,  0, 241, 3, 0,  0, 0, 0, 0,   0,
-             5,  0, 0, 0, 0,   0, 0, 0, 3,  0, 0,   0, 0,  0, 0, 0, 238, 3,
-             0,  0, 0, 0, 0,   0, 3, 0, 0,  0, 0,   0, 0,  0};
+    header->tail = DEFAULT_PAGE_SIZE - 18;
+    header->slots.push_back({DEFAULT_PAGE_SIZE - 10, 10});
+    header->slots.push_back({DEFAULT_PAGE_SIZE - 15, 5});
+    header->slots.push_back({DEFAULT_PAGE_SIZE - 18, 3});
+
+    input = {
+        12,  0, 0, 0, 0, 0, 0, 0, 15,  0, 0,  0, 0,   0, 0, 0,
+        1,   0, 0, 0, 0, 0, 0, 0, 1,   0, 0,  0, 1,   0, 0, 0,
+        238, 3, 0, 0, 0, 0, 3, 0, 246, 3, 10, 0, 241, 3, 5, 0,
+        238, 3, 3, 0};
     extra = {42, 0, 0, 0, 21, 48, 4};
   }
 };
@@ -91,15 +93,11 @@ TEST_F(RecordPageHeaderTestFixture, TestLoad) {
   _header.Load(_input);
 
   ASSERT_EQ(_header.page_id, header->page_id);
+  ASSERT_EQ(_header.tail, header->tail);
   ASSERT_EQ(_header.slots.size(), header->slots.size());
-  RecordPage::Header::SlotSpanMap::iterator _it = _header.slots.begin();
-  RecordPage::Header::SlotSpanMap::iterator it = header->slots.begin();
-  while (_it != _header.slots.end() && it != header->slots.end()) {
-    ASSERT_EQ(_it->first, it->first);
-    ASSERT_EQ(_it->second.offset, it->second.offset);
-    ASSERT_EQ(_it->second.size, it->second.size);
-    ++_it;
-    ++it;
+  for (size_t i = 0; i < header->slots.size(); ++i) {
+    ASSERT_EQ(_header.slots[i].offset, header->slots[i].offset);
+    ASSERT_EQ(_header.slots[i].size, header->slots[i].size);
   }
 }
 
@@ -120,50 +118,6 @@ TEST_F(RecordPageHeaderTestFixture, TestSize) {
   ASSERT_EQ(header->GetStorageSize(), input.size());
 }
 
-TEST_F(RecordPageHeaderTestFixture, TestCreateSlot) {
-  size_t size = 100;
-  size_t tail = header->GetTail();
-  PageSlotId slot_id = header->CreateSlot(size);
-  ASSERT_EQ(header->GetTail(), tail - size);
-  ASSERT_EQ(slot_id, 4);
-  ASSERT_EQ(header->slots.rbegin()->first, slot_id);
-  ASSERT_EQ(header->slots.rbegin()->second.offset, DEFAULT_PAGE_SIZE - 118);
-  ASSERT_EQ(header->slots.rbegin()->second.size, size);
-}
-
-TEST_F(RecordPageHeaderTestFixture, TestUpdateSlot) {
-  size_t old_size = header->slots.at(2).size;
-  size_t new_size = 100;
-  size_t tail = header->GetTail();
-
-  header->UpdateSlot(2, new_size);
-
-  // Test update in tail
-  ASSERT_EQ(header->GetTail(), tail + (old_size - new_size));
-
-  // Test no change in first slot
-  ASSERT_EQ(header->slots.at(1).offset, DEFAULT_PAGE_SIZE - 10);
-  ASSERT_EQ(header->slots.at(1).size, 10);
-
-  // Test change in 2nd slot
-  ASSERT_EQ(header->slots.at(2).offset, DEFAULT_PAGE_SIZE - 110);
-  ASSERT_EQ(header->slots.at(2).size, new_size);
-
-  // Test change in 3rd slot
-  ASSERT_EQ(header->slots.at(3).offset, DEFAULT_PAGE_SIZE - 113);
-  ASSERT_EQ(header->slots.at(3).size, 3);
-}
-
-TEST_F(RecordPageHeaderTestFixture, TestFreeSlot) {
-  uint64_t tail = header->GetTail();
-  RecordPage::Header::SlotSpanMap::iterator it = header->slots.begin();
-  ++it;
-  size_t entry_size = it->second.size;
-
-  header->FreeSlot(it->first);
-  ASSERT_EQ(header->GetTail(), tail + entry_size);
-}
-
 /***********************************************
  * Slotted Page Unit Tests
  ***********************************************/
@@ -175,8 +129,6 @@ protected:
   const PageId next_page_id = 15;
   const PageId prev_page_id = 1;
   const uint64_t page_size = DEFAULT_PAGE_SIZE;
-  const size_t single_slot_span_size =
-      sizeof(RecordPage::Header::SlotSpan) + sizeof(PageSlotId);
   std::unique_ptr<RecordPage> page;
   PageSlotId slot_id_1, slot_id_2;
   std::unique_ptr<RecordPageSlot> page_slot_1, page_slot_2;
@@ -207,75 +159,71 @@ protected:
     page_slot_2->data = page_slot_date_2;
     slot_id_2 = page->InsertPageSlot(*page_slot_2, txn).first;
 
-    input = {12,  0,   0,   0,   0,   0,  0,  0, 15, 0, 0,   0,   0,   0,   0,
-             0,   1,   0,   0,   0,   0,  0,  0, 0,  2, 0,   0,   0,   0,   0,
-             0,   0,   1,   0,   0,   0,  0,  0, 0,  0, 199, 3,   0,   0,   0,
-             0,   0,   0,   57,  0,   0,  0,  0, 0,  0, 0,   2,   0,   0,   0,
-             0,   0,   0,   0,   142, 3,  0,  0, 0,  0, 0,   0,   57,  0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   9,  0,  0, 0,  0, 0,   0,   0,   116, 101,
-             115, 116, 105, 110, 103, 95, 50, 0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   0,   0,   0,   0,  0,  0, 0,  0, 0,   0,   0,   0,   0,
-             0,   0,   9,   0,   0,   0,  0,  0, 0,  0, 116, 101, 115, 116, 105,
-             110, 103, 95,  49};
+    input = {
+        12,  0,  0, 0, 0, 0, 0, 0,   15,  0,   0,   0,   0,   0,   0,   0,
+        1,   0,  0, 0, 0, 0, 0, 0,   1,   0,   0,   0,   1,   0,   0,   0,
+        228, 3,  0, 0, 0, 0, 2, 0,   242, 3,   14,  0,   228, 3,   14,  0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,  0, 0, 0, 0, 0, 0,   9,   116, 101, 115, 116, 105, 110, 103,
+        95,  50, 0, 0, 0, 0, 9, 116, 101, 115, 116, 105, 110, 103, 95,  49};
   }
 
   void TearDown() override {
@@ -323,7 +271,7 @@ TEST_F(RecordPageTestFixture, TestFreeSpace) {
   ASSERT_EQ(_page.GetFreeSpaceSize(Operation::UPDATE),
             page_size - header.GetStorageSize());
   ASSERT_EQ(_page.GetFreeSpaceSize(Operation::INSERT),
-            page_size - header.GetStorageSize() - single_slot_span_size);
+            page_size - header.GetStorageSize() - page->entry_size);
 }
 
 TEST_F(RecordPageTestFixture, TestGetPageSlot) {
@@ -335,6 +283,69 @@ TEST_F(RecordPageTestFixture, TestGetPageSlot) {
   ASSERT_TRUE(_page_slot.GetPrevLocation().IsNull());
 }
 
+TEST_F(RecordPageTestFixture, TestGetPageSlotView) {
+  Transaction txn(*log_manager, 0);
+  MemoryStorage<RecordPage> storage;
+  BufferManager<RecordPage> buffer_manager(storage, 2);
+  buffer_manager.Start();
+  PageId _page_id;
+  PageSlotId slot_id;
+  {
+    auto _page = buffer_manager.GetNew();
+    _page_id = _page->GetId();
+    slot_id = _page->InsertPageSlot(*page_slot_1, txn).first;
+  }
+
+  {
+    auto view = RecordPage::GetPageSlotView(buffer_manager.Get(_page_id),
+                                            slot_id, txn);
+    // View points into the image of the page pinned in buffer
+    ASSERT_TRUE(buffer_manager.replacer.IsPinned(_page_id));
+    ASSERT_EQ(view.ToBuffer(), page_slot_date_1);
+    auto _page = buffer_manager.Get(_page_id);
+    ASSERT_GE(view.begin(), _page->image.data());
+    ASSERT_LE(view.end(), _page->image.data() + _page->image.size());
+  }
+  // Page is unpinned once the view is destroyed
+  ASSERT_FALSE(buffer_manager.replacer.IsPinned(_page_id));
+
+  ASSERT_THROW(
+      RecordPage::GetPageSlotView(buffer_manager.Get(_page_id), 10, txn),
+      PageSlotNotFoundError);
+  ASSERT_FALSE(buffer_manager.replacer.IsPinned(_page_id));
+}
+
+TEST_F(RecordPageTestFixture, TestGetPageSlotViewCompacted) {
+  Transaction txn(*log_manager, 0);
+  MemoryStorage<RecordPage> storage;
+  BufferManager<RecordPage> buffer_manager(storage, 2);
+  buffer_manager.Start();
+  PageId _page_id;
+  PageSlotId slot_id_a, slot_id_b;
+  {
+    auto _page = buffer_manager.GetNew();
+    _page_id = _page->GetId();
+    slot_id_a = _page->InsertPageSlot(*page_slot_1, txn).first;
+    slot_id_b = _page->InsertPageSlot(*page_slot_2, txn).first;
+  }
+
+  auto view =
+      RecordPage::GetPageSlotView(buffer_manager.Get(_page_id), slot_id_b, txn);
+  ByteBuffer copy = view.ToBuffer();
+  ASSERT_EQ(copy, page_slot_date_2);
+
+  // Pin does not keep the page from being compacted, which moves the viewed
+  // slot and leaves the view pointing at other bytes. Copied bytes are kept.
+  {
+    auto _page = buffer_manager.Get(_page_id);
+    _page->RemovePageSlot(slot_id_a, txn);
+    _page->Compact();
+    ASSERT_EQ(_page->GetPageSlot(slot_id_b, txn).data, page_slot_date_2);
+  }
+  ASSERT_NE(view.ToBuffer(), page_slot_date_2);
+  ASSERT_EQ(copy, page_slot_date_2);
+}
+
 TEST_F(RecordPageTestFixture, TestGetPageSlotError) {
   Transaction txn(*log_manager, 0);
   ASSERT_THROW(page->GetPageSlot(10, txn), PageSlotNotFoundError);
@@ -362,7 +373,7 @@ TEST_F(RecordPageTestFixture, TestAddPageSlot) {
   ASSERT_EQ(log_record->page_slot_a, page_slot);
   ASSERT_EQ(log_record->page_slot_b, RecordPageSlot());
 
-  size_t new_free_size = page->header.GetTail() - page->header.GetStorageSize();
+  size_t new_free_size = page->GetFreeSpaceSize(Operation::UPDATE);
   ASSERT_EQ(old_free_space - new_free_size, page_slot.GetStorageSize());
   ASSERT_EQ(page->GetPageSlot(slot_id, txn), page_slot);
 }
@@ -387,10 +398,10 @@ TEST_F(RecordPageTestFixture, TestUpdatePageSlot) {
   ASSERT_EQ(log_record->type, LogRecord::Type::UPDATE);
   ASSERT_EQ(log_record->location,
             RecordPageSlot::Location(page->GetId(), slot_id_1));
-  ASSERT_EQ(log_record->page_slot_a, *page_slot_1);
-  ASSERT_EQ(log_record->page_slot_b, page_slot_copy);
+  ASSERT_EQ(log_record->Redo(*page_slot_1), page_slot_copy);
+  ASSERT_EQ(log_record->Undo(page_slot_copy), *page_slot_1);
 
-  size_t new_free_size = page->header.GetTail() - page->header.GetStorageSize();
+  size_t new_free_size = page->GetFreeSpaceSize(Operation::UPDATE);
   RecordPageSlot page_slot_;
   page_slot_.data = "testing_1-update"_bb;
   ASSERT_EQ(old_free_space - new_free_size,
@@ -398,6 +409,50 @@ TEST_F(RecordPageTestFixture, TestUpdatePageSlot) {
   ASSERT_EQ(page->GetPageSlot(slot_id_1, txn), page_slot_copy);
 }
 
+TEST_F(RecordPageTestFixture, TestUpdatePageSlotFull) {
+  Transaction txn(*log_manager, 0);
+  // Grow the slot beyond the free space of the page
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(page->GetFreeSpaceSize(Operation::UPDATE) +
+                                  page_slot_1->GetStorageSize(),
+                              'A');
+  size_t free_space = page->GetFreeSpaceSize(Operation::UPDATE);
+  LogRecord::Location log_location = txn.log_location;
+  ASSERT_THROW(page->UpdatePageSlot(slot_id_1, page_slot, txn),
+               PageFullError);
+
+  // Page is left unchanged and nothing is logged
+  ASSERT_EQ(page->GetPageSlot(slot_id_1, txn).data, page_slot_date_1);
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::UPDATE), free_space);
+  ASSERT_EQ(txn.log_location, log_location);
+}
+
+TEST_F(RecordPageTestFixture, TestInsertPageSlotFull) {
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(page->GetFreeSpaceSize(Operation::INSERT), 'A');
+  size_t free_space = page->GetFreeSpaceSize(Operation::UPDATE);
+  ASSERT_THROW(page->InsertPageSlot(page_slot, txn), PageFullError);
+
+  // No slot directory entry is added
+  ASSERT_EQ(page->GetSlotCount(), 2);
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::UPDATE), free_space);
+  ASSERT_TRUE(txn.log_location.IsNull());
+}
+
+TEST_F(RecordPageTestFixture, TestUndoRemovePageSlotFull) {
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(page->GetFreeSpaceSize(Operation::INSERT), 'A');
+  size_t free_space = page->GetFreeSpaceSize(Operation::UPDATE);
+  ASSERT_THROW(page->UndoRemovePageSlot(4, page_slot, txn), PageFullError);
+
+  // No slot directory entries are added
+  ASSERT_EQ(page->GetSlotCount(), 2);
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::UPDATE), free_space);
+  ASSERT_TRUE(txn.log_location.IsNull());
+}
+
 TEST_F(RecordPageTestFixture, TestRemovePageSlot) {
   page->RegisterObserver(&observer);
   EXPECT_CALL(observer, HandleModifiedPage(testing::Ref(*page)))
@@ -416,10 +471,41 @@ TEST_F(RecordPageTestFixture, TestRemovePageSlot) {
   ASSERT_EQ(log_record->page_slot_a, *page_slot_2);
   ASSERT_EQ(log_record->page_slot_b, RecordPageSlot());
 
-  size_t new_free_size = page->header.GetTail() - page->header.GetStorageSize();
+  size_t new_free_size = page->GetFreeSpaceSize(Operation::UPDATE);
   ASSERT_THROW(page->GetPageSlot(slot_id_2, txn), PageSlotNotFoundError);
-  ASSERT_EQ(new_free_size - old_free_space,
-            page_slot_2->GetStorageSize() + single_slot_span_size);
+  ASSERT_EQ(new_free_size - old_free_space, page_slot_2->GetStorageSize());
+
+  // Entry of the slot is freed once released
+  page->ReleasePageSlot(slot_id_2);
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::UPDATE) - old_free_space,
+            page_slot_2->GetStorageSize() + page->entry_size);
+}
+
+TEST_F(RecordPageTestFixture, TestRemovePageSlotReserved) {
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot removed_slot = page->GetPageSlot(slot_id_1, txn);
+  page->RemovePageSlot(slot_id_1, txn);
+
+  // Slot ID of a removed slot not released is not re-used, also once the page
+  // is loaded back
+  ByteBuffer output(page_size);
+  page->Dump(output);
+  RecordPage _page;
+  _page.Load(output);
+  ASSERT_NE(_page.GetNextSlotId(), slot_id_1);
+  RecordPageSlot page_slot;
+  page_slot.data = "test"_bb;
+  PageSlotId slot_id = page->InsertPageSlot(page_slot, txn).first;
+  ASSERT_NE(slot_id, slot_id_1);
+
+  // Removal is undone in place of the reserved entry
+  page->UndoRemovePageSlot(slot_id_1, removed_slot, txn);
+  ASSERT_EQ(page->GetPageSlot(slot_id_1, txn).data, page_slot_date_1);
+  ASSERT_EQ(page->GetPageSlot(slot_id, txn).data, "test"_bb);
+
+  // Releasing a stored slot does nothing
+  page->ReleasePageSlot(slot_id_1);
+  ASSERT_EQ(page->GetPageSlot(slot_id_1, txn).data, page_slot_date_1);
 }
 
 TEST_F(RecordPageTestFixture, TestRemovePageSlotError) {
@@ -446,6 +532,25 @@ TEST_F(RecordPageTestFixture, TestLoad) {
   ASSERT_TRUE(_page_slot_2.GetPrevLocation().IsNull());
 }
 
+TEST_F(RecordPageTestFixture, TestLoadInPlace) {
+  // Page object with stale slots is re-used to load another page
+  RecordPage _page(page_id + 1, page_size);
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot page_slot;
+  page_slot.data = "stale_1"_bb;
+  _page.InsertPageSlot(page_slot, txn);
+  page_slot.data = "stale_2"_bb;
+  _page.InsertPageSlot(page_slot, txn);
+  page_slot.data = "stale_3"_bb;
+  PageSlotId stale_slot_id = _page.InsertPageSlot(page_slot, txn).first;
+  _page.Load(input);
+
+  ASSERT_EQ(_page.GetId(), page->GetId());
+  ASSERT_EQ(_page.GetPageSlot(slot_id_1, txn).data, page_slot_date_1);
+  ASSERT_EQ(_page.GetPageSlot(slot_id_2, txn).data, page_slot_date_2);
+  ASSERT_THROW(_page.GetPageSlot(stale_slot_id, txn), PageSlotNotFoundError);
+}
+
 TEST_F(RecordPageTestFixture, TestLoadError) {
   ByteBuffer _input;
   RecordPage _page;
@@ -458,3 +563,299 @@ TEST_F(RecordPageTestFixture, TestDump) {
 
   ASSERT_EQ(input, output);
 }
+
+TEST_F(RecordPageTestFixture, TestDumpAfterRemove) {
+  // Page image matches that of a page which never had the removed slot
+  RecordPage _page(page_id, page_size);
+  _page.SetNextPageId(next_page_id);
+  _page.SetPrevPageId(prev_page_id);
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot page_slot;
+  page_slot.data = page_slot_date_1;
+  _page.InsertPageSlot(page_slot, txn);
+  page->RemovePageSlot(slot_id_2, txn);
+  page->ReleasePageSlot(slot_id_2);
+
+  ByteBuffer output(page_size), _output(page_size);
+  page->Dump(output);
+  _page.Dump(_output);
+
+  ASSERT_EQ(output, _output);
+}
+
+TEST_F(RecordPageTestFixture, TestLoadAfterUpdate) {
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot page_slot;
+  page_slot.data = "testing_1-update"_bb;
+  page->UpdatePageSlot(slot_id_1, page_slot, txn);
+  RecordPageSlot removed_slot = page->GetPageSlot(slot_id_2, txn);
+  page->RemovePageSlot(slot_id_2, txn);
+  page->UndoRemovePageSlot(slot_id_2, removed_slot, txn);
+
+  ByteBuffer output(page_size);
+  page->Dump(output);
+  RecordPage _page;
+  _page.Load(output);
+
+  ASSERT_EQ(_page.GetNextPageId(), next_page_id);
+  ASSERT_EQ(_page.GetPrevPageId(), prev_page_id);
+  ASSERT_EQ(_page.GetPageSlot(slot_id_1, txn).data, "testing_1-update"_bb);
+  ASSERT_EQ(_page.GetPageSlot(slot_id_2, txn).data, page_slot_date_2);
+  ASSERT_EQ(_page.GetFreeSpaceSize(Operation::UPDATE),
+            page->GetFreeSpaceSize(Operation::UPDATE));
+}
+
+TEST_F(RecordPageTestFixture, TestUpdateKeepsOffsets) {
+  Transaction txn(*log_manager, 0);
+  RecordPage::Header::SlotSpan span_2 = page->GetSlotSpan(slot_id_2);
+  RecordPageSlot page_slot;
+  page_slot.data = "testing_1-update"_bb;
+  page->UpdatePageSlot(slot_id_1, page_slot, txn);
+
+  // Other slots are not moved
+  ASSERT_EQ(page->GetSlotSpan(slot_id_2).offset, span_2.offset);
+  ASSERT_EQ(page->GetPageSlot(slot_id_1, txn).data, "testing_1-update"_bb);
+  ASSERT_EQ(page->GetPageSlot(slot_id_2, txn).data, page_slot_date_2);
+}
+
+TEST_F(RecordPageTestFixture, TestRemoveReusesSpace) {
+  Transaction txn(*log_manager, 0);
+  RecordPage::Header::SlotSpan span_1 = page->GetSlotSpan(slot_id_1);
+  size_t free_space = page->GetFreeSpaceSize(Operation::UPDATE);
+  page->RemovePageSlot(slot_id_1, txn);
+
+  // Space of the removed slot is free but not contiguous
+  ASSERT_EQ(page->GetFreeSpaceSize(Operation::UPDATE),
+            free_space + span_1.size);
+
+  // Slot ID and space of the removed slot are re-used once released
+  ASSERT_NE(page->GetNextSlotId(), slot_id_1);
+  page->ReleasePageSlot(slot_id_1);
+  ASSERT_EQ(page->GetNextSlotId(), slot_id_1);
+  RecordPageSlot page_slot;
+  page_slot.data = "test"_bb;
+  PageSlotId slot_id = page->InsertPageSlot(page_slot, txn).first;
+  RecordPage::Header::SlotSpan span = page->GetSlotSpan(slot_id);
+
+  ASSERT_EQ(slot_id, slot_id_1);
+  ASSERT_GE(span.offset, span_1.offset);
+  ASSERT_LE(span.offset + span.size, span_1.offset + span_1.size);
+  ASSERT_EQ(page->GetPageSlot(slot_id_2, txn).data, page_slot_date_2);
+}
+
+TEST_F(RecordPageTestFixture, TestCompact) {
+  Transaction txn(*log_manager, 0);
+  // Fill the page leaving less contiguous free space than a slot
+  RecordPageSlot page_slot;
+  page_slot.data = "testing_x"_bb;
+  std::vector<PageSlotId> slot_ids;
+  while (page->GetFreeSpaceSize(Operation::INSERT) >=
+         page_slot.GetStorageSize()) {
+    slot_ids.push_back(page->InsertPageSlot(page_slot, txn).first);
+  }
+  page->RemovePageSlot(slot_id_2, txn);
+  page->RemovePageSlot(slot_ids.front(), txn);
+
+  // Slot larger than any free block is inserted after compaction
+  RecordPageSlot large_slot;
+  large_slot.data = ByteBuffer(18, 'A');
+  ASSERT_LT(page->GetTail() - page->GetHeaderSize(),
+            large_slot.GetStorageSize());
+  ASSERT_GE(page->GetFreeSpaceSize(Operation::INSERT),
+            large_slot.GetStorageSize());
+  PageSlotId slot_id = page->InsertPageSlot(large_slot, txn).first;
+
+  ASSERT_EQ(page->GetPageSlot(slot_id, txn), large_slot);
+  ASSERT_EQ(page->GetPageSlot(slot_id_1, txn).data, page_slot_date_1);
+  ASSERT_EQ(page->GetPageSlot(slot_ids.back(), txn), page_slot);
+
+  // Compacted page is loaded back
+  ByteBuffer output(page_size);
+  page->Dump(output);
+  RecordPage _page;
+  _page.Load(output);
+  ASSERT_EQ(_page.GetPageSlot(slot_id, txn), large_slot);
+  ASSERT_EQ(_page.GetPageSlot(slot_ids.back(), txn), page_slot);
+}
+
+TEST_F(RecordPageTestFixture, TestPageFullError) {
+  Transaction txn(*log_manager, 0);
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(page_size, 'A');
+  ASSERT_THROW(page->InsertPageSlot(page_slot, txn), PageFullError);
+}
+
+TEST_F(RecordPageTestFixture, TestLargeFormat) {
+  Transaction txn(*log_manager, 0);
+  const size_t large_page_size = 1 << 17;
+  RecordPage _page(page_id, large_page_size);
+  ASSERT_EQ(page->format, RecordPage::Format::COMPACT);
+  ASSERT_EQ(_page.format, RecordPage::Format::LARGE);
+
+  // Slots beyond 64KiB are addressed in large format
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(1 << 16, 'A');
+  PageSlotId slot_id_a = _page.InsertPageSlot(page_slot, txn).first;
+  PageSlotId slot_id_b = _page.InsertPageSlot(*page_slot_1, txn).first;
+  ASSERT_LT(_page.GetSlotSpan(slot_id_b).offset, 1 << 16);
+
+  ByteBuffer output(large_page_size);
+  _page.Dump(output);
+  RecordPage loaded_page(0, large_page_size);
+  loaded_page.Load(output);
+  ASSERT_EQ(loaded_page.GetPageSlot(slot_id_a, txn), page_slot);
+  ASSERT_EQ(loaded_page.GetPageSlot(slot_id_b, txn), *page_slot_1);
+
+  // Page format must match the page size
+  RecordPage compact_page;
+  ASSERT_THROW(compact_page.Load(output), PageParseError);
+}
+
+TEST_F(RecordPageTestFixture, TestLoadLegacy) {
+  Transaction txn(*log_manager, 0);
+  // Page image dumped by the record page of the legacy layout, holding slots
+  // with IDs 1 and 2
+  ByteBuffer legacy = {12,  0,   0,   0,   0,   0,  0,  0,   15,  0,   0,   0,
+                       0,   0,   0,   0,   1,   0,  0,  0,   0,   0,   0,   0,
+                       2,   0,   0,   0,   0,   0,  0,  0,   1,   0,   0,   0,
+                       0,   0,   0,   0,   199, 3,  0,  0,   0,   0,   0,   0,
+                       57,  0,   0,   0,   0,   0,  0,  0,   2,   0,   0,   0,
+                       0,   0,   0,   0,   142, 3,  0,  0,   0,   0,   0,   0,
+                       57,  0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   9,   0,   0,   0,  0,  0,   0,   0,   116, 101,
+                       115, 116, 105, 110, 103, 95, 50, 0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   0,
+                       0,   0,   0,   0,   0,   0,  0,  0,   0,   0,   0,   9,
+                       0,   0,   0,   0,   0,   0,  0,  116, 101, 115, 116, 105,
+                       110, 103, 95,  49};
+
+  // Legacy page is converted to the current format on load
+  RecordPage _page(0, page_size);
+  _page.Load(legacy);
+  ASSERT_EQ(_page.GetId(), page_id);
+  ASSERT_EQ(_page.GetNextPageId(), next_page_id);
+  ASSERT_EQ(_page.GetPrevPageId(), prev_page_id);
+  RecordPageSlot page_slot_a = _page.GetPageSlot(slot_id_1, txn);
+  ASSERT_EQ(page_slot_a.data, page_slot_date_1);
+  ASSERT_TRUE(page_slot_a.GetNextLocation().IsNull());
+  ASSERT_TRUE(page_slot_a.GetPrevLocation().IsNull());
+  RecordPageSlot page_slot_b = _page.GetPageSlot(slot_id_2, txn);
+  ASSERT_EQ(page_slot_b.data, page_slot_date_2);
+  ASSERT_THROW(_page.GetPageSlot(3, txn), PageSlotNotFoundError);
+
+  // Converted page is dumped in the current format
+  ByteBuffer output(page_size);
+  _page.Dump(output);
+  RecordPage loaded_page(0, page_size);
+  loaded_page.Load(output);
+  ASSERT_EQ(loaded_page.format, RecordPage::Format::COMPACT);
+  ASSERT_EQ(loaded_page.GetPageSlot(slot_id_1, txn), page_slot_a);
+  ASSERT_EQ(loaded_page.GetPageSlot(slot_id_2, txn), page_slot_b);
+
+  // Slot IDs left unused by removed slots are kept
+  ByteBuffer sparse = legacy;
+  sparse[56] = 3;
+  _page.Load(sparse);
+  ASSERT_THROW(_page.GetPageSlot(2, txn), PageSlotNotFoundError);
+  ASSERT_EQ(_page.GetPageSlot(3, txn).data, page_slot_date_2);
+
+  // Corrupt legacy slot directory fails to load
+  ByteBuffer corrupt = legacy;
+  corrupt[56] = 1;
+  ASSERT_THROW(_page.Load(corrupt), PageParseError);
+  corrupt = legacy;
+  corrupt[24] = 100;
+  ASSERT_THROW(_page.Load(corrupt), PageParseError);
+}
+
+TEST_F(RecordPageTestFixture, TestConcurrentGetPageSlot) {
+  // Readers of a loaded page parse its slots concurrently
+  RecordPage _page;
+  _page.Load(input);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      Transaction txn(*log_manager, 0);
+      for (int j = 0; j < 100; ++j) {
+        EXPECT_EQ(_page.GetPageSlot(slot_id_1, txn).data, page_slot_date_1);
+        EXPECT_EQ(_page.GetPageSlot(slot_id_2, txn).data, page_slot_date_2);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
@@ -59,8 +59,7 @@ protected:
     header->prev_location.page_id = prev_page_id;
     header->prev_location.slot_id = prev_slot_id;
 
-    input = {10, 0, 0, 0, 0,  0, 0, 0, 100, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
-             0,  0, 0, 0, 10, 0, 0, 0, 0,   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    input = {10, 100, 1, 10};
     extra = {41, 0, 6, 0, 21, 48, 4};
   }
 };
@@ -92,8 +91,18 @@ TEST_F(RecordPageSlotHeaderTestFixture, TestDump) {
   ASSERT_EQ(input, output);
 }
 
+TEST_F(RecordPageSlotHeaderTestFixture, TestLoadTruncatedError) {
+  ByteBuffer _input = {10, 100, 1, 138};
+  RecordPageSlot::Header _header;
+
+  ASSERT_THROW(_header.Load(_input), PageParseError);
+}
+
 TEST_F(RecordPageSlotHeaderTestFixture, TestSize) {
-  ASSERT_EQ(header->GetStorageSize(), sizeof(RecordPageSlot::Header));
+  ASSERT_EQ(header->GetStorageSize(), 4);
+
+  header->next_location.page_id = 300;
+  ASSERT_EQ(header->GetStorageSize(), 5);
 }
 
 /***********************************************
@@ -117,10 +126,7 @@ protected:
     slot = std::make_unique<RecordPageSlot>(header);
     slot->data = data;
 
-    input = {10, 0, 0, 0, 0, 0, 0,   0,   100, 0,   0,   0,   0,  0,
-             0,  0, 1, 0, 0, 0, 0,   0,   0,   0,   10,  0,   0,  0,
-             0,  0, 0, 0, 0, 0, 0,   0,   0,   0,   0,   0,   7,  0,
-             0,  0, 0, 0, 0, 0, 116, 101, 115, 116, 105, 110, 103};
+    input = {10, 100, 1, 10, 7, 116, 101, 115, 116, 105, 110, 103};
   }
 };
 
@@ -138,6 +144,13 @@ TEST_F(RecordPageSlotTestFixture, TestLoadParseError) {
   ASSERT_THROW(_slot.Load(_input), PageParseError);
 }
 
+TEST_F(RecordPageSlotTestFixture, TestLoadTruncatedError) {
+  ByteBuffer _input(input.begin(), input.end() - 1);
+  RecordPageSlot _slot;
+
+  ASSERT_THROW(_slot.Load(_input), PageParseError);
+}
+
 TEST_F(RecordPageSlotTestFixture, TestDump) {
   ByteBuffer output(slot->GetStorageSize());
   slot->Dump(output);
@@ -154,9 +167,7 @@ TEST_F(RecordPageSlotTestFixture, TestMoveRecordPageSlot) {
 }
 
 TEST_F(RecordPageSlotTestFixture, TestSize) {
-  ASSERT_EQ(slot->GetStorageSize(), sizeof(RecordPageSlot::Header) +
-                                        sizeof(size_t) +
-                                        sizeof(Byte) * data.size());
+  ASSERT_EQ(slot->GetStorageSize(), 4 + 1 + sizeof(Byte) * data.size());
 }
 
 TEST_F(RecordPageSlotTestFixture, TestGetNextLocation) {
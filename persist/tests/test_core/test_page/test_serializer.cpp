@@ -121,6 +121,16 @@ TEST_F(PageSerializerTestFixture, TestLoad) {
   ASSERT_EQ(_page->GetRecord(), page->GetRecord());
 }
 
+TEST_F(PageSerializerTestFixture, TestLoadInPlace) {
+  auto _page = persist::CreatePage<SimplePage>(1, page_size);
+  ByteBuffer _record = "loaded"_bb;
+  _page->SetRecord(_record);
+  persist::LoadPage(input, *_page);
+
+  ASSERT_EQ(_page->GetId(), page->GetId());
+  ASSERT_EQ(_page->GetRecord(), page->GetRecord());
+}
+
 TEST_F(PageSerializerTestFixture, TestLoadError) {
   ByteBuffer _input;
 
@@ -46,6 +46,28 @@ TEST(StorageFactoryTest, TestCreateMemoryStorage) {
   ASSERT_TRUE(className.find("MemoryStorage") != std::string::npos);
 }
 
+TEST(StorageFactoryTest, TestCreateObjectMemoryStorage) {
+  auto storage = CreateStorage<SimplePage>("memory://?mode=object");
+  Storage<SimplePage> *ptr = storage.get();
+  std::string className = typeid(*ptr).name();
+  ASSERT_TRUE(className.find("MemoryStorage") != std::string::npos);
+  ASSERT_TRUE(storage->IsObjectStore());
+}
+
+TEST(StorageFactoryTest, TestCreateStorageWithVerifyPolicy) {
+  auto storage = CreateStorage<SimplePage>(
+      "memory://?verify=sampled&verify_sample_interval=8");
+  ASSERT_EQ(storage->GetVerifyPolicy(), VerifyPolicy::SAMPLED);
+  ASSERT_EQ(storage->GetVerifySampleInterval(), 8);
+}
+
+TEST(StorageFactoryTest, TestCreateStorageUnknownArgValue) {
+  ASSERT_THROW(CreateStorage<SimplePage>("memory://?mode=objcet"),
+               StorageError);
+  ASSERT_THROW(CreateStorage<SimplePage>("memory://?verify=sometimes"),
+               StorageError);
+}
+
 TEST(StorageFactoryTest, TestCreateFileStorage) {
   auto storage = CreateStorage<SimplePage>("file://storage.db");
   Storage<SimplePage> *ptr = storage.get();
@@ -53,4 +75,47 @@ TEST(StorageFactoryTest, TestCreateFileStorage) {
   ASSERT_TRUE(className.find("FileStorage") != std::string::npos);
   ASSERT_EQ(static_cast<FileStorage<SimplePage> *>(ptr)->GetPath(),
             "storage.db");
-}
\ No newline at end of file
+}
+
+TEST(StorageFactoryTest, TestCreateFileStorageWithArgs) {
+  auto storage =
+      CreateStorage<SimplePage>("file://storage.db?punch_threshold=16");
+  auto ptr = static_cast<FileStorage<SimplePage> *>(storage.get());
+  ASSERT_EQ(ptr->GetPath(), "storage.db");
+  ASSERT_EQ(ptr->GetPunchThreshold(), 16);
+}
+
+TEST(StorageFactoryTest, TestCreateSegmentedFileStorage) {
+  auto storage =
+      CreateStorage<SimplePage>("segment://storage.db?segment_size=4096");
+  Storage<SimplePage> *ptr = storage.get();
+  std::string className = typeid(*ptr).name();
+  ASSERT_TRUE(className.find("SegmentedFileStorage") != std::string::npos);
+  auto _ptr = static_cast<SegmentedFileStorage<SimplePage> *>(ptr);
+  ASSERT_EQ(_ptr->GetPath(), "storage.db");
+  ASSERT_EQ(_ptr->GetSegmentSize(), 4096);
+}
+
+TEST(StorageFactoryTest, TestCreateLogStructuredStorage) {
+  auto storage = CreateStorage<SimplePage>("lss://storage.db?segment_size=4096&"
+                                           "clean_threshold=0.25&"
+                                           "clean_interval=0");
+  Storage<SimplePage> *ptr = storage.get();
+  std::string className = typeid(*ptr).name();
+  ASSERT_TRUE(className.find("LogStructuredStorage") != std::string::npos);
+  auto _ptr = static_cast<LogStructuredStorage<SimplePage> *>(ptr);
+  ASSERT_EQ(_ptr->GetPath(), "storage.db");
+  ASSERT_EQ(_ptr->GetSegmentSize(), 4096);
+  ASSERT_EQ(_ptr->GetCleanThreshold(), 0.25);
+  ASSERT_EQ(_ptr->GetCleanInterval(), 0);
+}
+
+TEST(ConnectionStringTest, TestParseArgs) {
+  ConnectionString connection_string("file://storage.db?a=1&b=&c");
+  ASSERT_EQ(connection_string.type, "file");
+  ASSERT_EQ(connection_string.path, "storage.db");
+  ASSERT_EQ(connection_string.Get("a"), "1");
+  ASSERT_EQ(connection_string.Get("b"), "");
+  ASSERT_TRUE(connection_string.Has("c"));
+  ASSERT_FALSE(connection_string.Has("d"));
+}
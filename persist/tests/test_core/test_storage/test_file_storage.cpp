@@ -28,6 +28,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -89,6 +90,41 @@ TEST_F(NewFileStorageTestFixture, TestOpen) {
   ASSERT_EQ(header.page_size, page_size);
 }
 
+TEST_F(NewFileStorageTestFixture, TestChecksumType) {
+  ASSERT_EQ(write_storage->GetChecksumType(), DefaultChecksumType());
+
+  // Checksum algorithm is recorded in the file header
+  write_storage->Close();
+  FileHeader header;
+  ByteBuffer buffer(header.GetStorageSize());
+  std::fstream file = file::open(write_path + FILE_STORAGE_DATA_FILE_EXTENTION,
+                                 std::ios::in | std::ios::binary);
+  file::read(file, buffer, 0);
+  header.Load(buffer);
+  ASSERT_EQ(header.page_size, page_size);
+  ASSERT_EQ(header.checksum_type, DefaultChecksumType());
+
+  // Checksum algorithm is stored as a 32-bit integer after the page size
+  ASSERT_EQ(header.GetStorageSize(), 16);
+  uint32_t stored_type;
+  std::memcpy(&stored_type, buffer.data() + sizeof(size_t), sizeof(uint32_t));
+  ASSERT_EQ(stored_type, static_cast<uint32_t>(DefaultChecksumType()));
+
+  // Unknown checksum algorithm in the file header is refused
+  file = file::open(write_path + FILE_STORAGE_DATA_FILE_EXTENTION,
+                    std::ios::in | std::ios::out | std::ios::binary);
+  header.checksum_type = static_cast<ChecksumType>(7);
+  header.Dump(buffer);
+  file::write(file, buffer, 0);
+  file.flush();
+  ASSERT_THROW(write_storage->Open(), StorageError);
+
+  // Restore the file header
+  header.checksum_type = DefaultChecksumType();
+  header.Dump(buffer);
+  file::write(file, buffer, 0);
+}
+
 TEST_F(NewFileStorageTestFixture, TestReadPage) {
   ASSERT_THROW(read_storage->Read(1), PageNotFoundError);
 }
@@ -104,16 +140,114 @@ TEST_F(NewFileStorageTestFixture, TestWritePage) {
                                  std::ios::in | std::ios::binary);
   ByteBuffer buffer(page_size);
   file::read(file, buffer, FileHeader().GetStorageSize());
-  auto _page = persist::LoadPage<SimplePage>(buffer);
+  auto _page =
+      persist::LoadPage<SimplePage>(buffer, write_storage->GetChecksumType());
 
   ASSERT_EQ(page->GetId(), _page->GetId());
   ASSERT_EQ(page->GetRecord(), _page->GetRecord());
 }
 
+TEST_F(NewFileStorageTestFixture, TestSync) {
+  auto page = CreatePage<SimplePage>(1, page_size);
+  page->SetRecord("testing"_bb);
+  write_storage->Write(*page);
+
+  // Buffered writes are visible in the file after sync
+  write_storage->Sync();
+  std::fstream file = file::open(write_path + FILE_STORAGE_DATA_FILE_EXTENTION,
+                                 std::ios::in | std::ios::binary);
+  ASSERT_EQ(file::size(file), FileHeader().GetStorageSize() + page_size);
+}
+
 TEST_F(NewFileStorageTestFixture, TestAllocate) {
   ASSERT_EQ(read_storage->Allocate(), 1);
 }
 
+TEST_F(NewFileStorageTestFixture, TestDeallocate) {
+  PageId page_id_1 = write_storage->Allocate();
+  PageId page_id_2 = write_storage->Allocate();
+  PageId page_id_3 = write_storage->Allocate();
+
+  write_storage->Deallocate(page_id_3);
+  write_storage->Deallocate(page_id_1);
+  // Invalid page IDs are ignored
+  write_storage->Deallocate(0);
+  write_storage->Deallocate(page_id_3 + 10);
+  ASSERT_EQ(write_storage->GetFreePageCount(), 2);
+  ASSERT_FALSE(write_storage->IsFree(page_id_2));
+
+  // Lowest free page is re-used first
+  ASSERT_EQ(write_storage->Allocate(), page_id_1);
+  ASSERT_EQ(write_storage->Allocate(), page_id_3);
+  ASSERT_EQ(write_storage->Allocate(), page_id_3 + 1);
+  ASSERT_EQ(write_storage->GetFreePageCount(), 0);
+}
+
+TEST_F(NewFileStorageTestFixture, TestPersistFreePages) {
+  for (PageId page_id = 1; page_id <= 3; ++page_id) {
+    auto page = CreatePage<SimplePage>(write_storage->Allocate(), page_size);
+    write_storage->Write(*page);
+  }
+  PageId page_id = write_storage->GetPageCount() - 1;
+  write_storage->Deallocate(page_id);
+  write_storage->Close();
+
+  // Free page list is restored on re-open
+  write_storage->Open();
+  ASSERT_EQ(write_storage->GetFreePageCount(), 1);
+  ASSERT_EQ(write_storage->Allocate(), page_id);
+
+  write_storage->Remove();
+}
+
+TEST_F(NewFileStorageTestFixture, TestPunchHole) {
+  write_storage->SetPunchThreshold(2);
+  for (PageId page_id = 1; page_id <= 3; ++page_id) {
+    auto page = CreatePage<SimplePage>(write_storage->Allocate(), page_size);
+    page->SetRecord("testing"_bb);
+    write_storage->Write(*page);
+  }
+  PageId page_id = write_storage->GetPageCount();
+  write_storage->Deallocate(page_id - 2);
+  write_storage->Deallocate(page_id - 1);
+
+  // Live page is untouched
+  auto page = write_storage->Read(page_id);
+  ASSERT_EQ(page->GetRecord(), "testing"_bb);
+
+  write_storage->Remove();
+}
+
+TEST_F(NewFileStorageTestFixture, TestPunchHoleOnce) {
+  write_storage->SetPunchThreshold(2);
+  std::vector<PageId> page_ids;
+  for (size_t i = 0; i < 4; ++i) {
+    auto page = CreatePage<SimplePage>(write_storage->Allocate(), page_size);
+    page->SetRecord("testing"_bb);
+    write_storage->Write(*page);
+    page_ids.push_back(page->GetId());
+  }
+  ByteBuffer block(page_size), zeros(page_size, 0), written(page_size, 'A');
+  write_storage->Deallocate(page_ids[0]);
+  write_storage->Deallocate(page_ids[1]);
+  write_storage->ReadBlock(page_ids[1], block);
+  bool punched = block == zeros;
+
+  // Pages punched once the run reached the threshold are not punched again
+  write_storage->WriteBlock(page_ids[0], written);
+  write_storage->Deallocate(page_ids[2]);
+  write_storage->ReadBlock(page_ids[0], block);
+  ASSERT_EQ(block, written);
+  if (punched) {
+    write_storage->ReadBlock(page_ids[2], block);
+    ASSERT_EQ(block, zeros);
+  }
+  auto page = write_storage->Read(page_ids[3]);
+  ASSERT_EQ(page->GetRecord(), "testing"_bb);
+
+  write_storage->Remove();
+}
+
 /********************************
  * Testing for Existing Storage
  ********************************/
@@ -161,6 +295,11 @@ TEST_F(ExistingFileStorageTestFixture, TestOpen) {
   ASSERT_EQ(header.page_size, page_size);
 }
 
+TEST_F(ExistingFileStorageTestFixture, TestChecksumType) {
+  // Files created before pluggable checksums use Alder-32
+  ASSERT_EQ(read_storage->GetChecksumType(), ChecksumType::ALDER32);
+}
+
 TEST_F(ExistingFileStorageTestFixture, TestReadPage) {
   auto page = read_storage->Read(1);
 
@@ -179,12 +318,38 @@ TEST_F(ExistingFileStorageTestFixture, TestWritePage) {
                                  std::ios::in | std::ios::binary);
   ByteBuffer buffer(page_size);
   file::read(file, buffer, FileHeader().GetStorageSize());
-  auto _page = persist::LoadPage<SimplePage>(buffer);
+  auto _page =
+      persist::LoadPage<SimplePage>(buffer, write_storage->GetChecksumType());
 
   ASSERT_EQ(page->GetId(), _page->GetId());
   ASSERT_EQ(page->GetRecord(), _page->GetRecord());
 }
 
+TEST_F(ExistingFileStorageTestFixture, TestReadWriteBlock) {
+  ByteBuffer block(page_size);
+  read_storage->ReadBlock(1, block);
+  auto page =
+      persist::LoadPage<SimplePage>(block, read_storage->GetChecksumType());
+
+  ASSERT_EQ(page->GetId(), 1);
+  ASSERT_EQ(page->GetRecord(), "testing"_bb);
+
+  // Blocks are written as is without verifying the checksum
+  write_storage->WriteBlock(1, block);
+  ByteBuffer _block(page_size);
+  write_storage->ReadBlock(1, _block);
+
+  ASSERT_EQ(_block, block);
+}
+
+TEST_F(ExistingFileStorageTestFixture, TestReadBlockError) {
+  ByteBuffer block(page_size);
+
+  ASSERT_THROW(read_storage->ReadBlock(0, block), PageNotFoundError);
+  ASSERT_THROW(read_storage->ReadBlock(read_storage->GetPageCount() + 1, block),
+               PageNotFoundError);
+}
+
 TEST_F(ExistingFileStorageTestFixture, TestAllocate) {
   ASSERT_EQ(read_storage->Allocate(), 2);
 }
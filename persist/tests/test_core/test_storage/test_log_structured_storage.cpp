@@ -0,0 +1,303 @@
+/**
+ * test_log_structured_storage.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Log-Structured Storage Unit Tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <persist/core/page/creator.hpp>
+#include <persist/core/storage/log_structured_storage.hpp>
+
+#include "common.hpp"
+#include "persist/test/simple_page.hpp"
+
+using namespace persist;
+using namespace persist::test;
+
+class LogStructuredStorageTestFixture : public ::testing::Test {
+protected:
+  const std::string path = std::string(DATA_PATH) + "/_log_structured";
+  const uint64_t page_size = 512;
+  // Segments hold 2 page records each
+  const uint64_t segment_size = 2 * (sizeof(PageId) + page_size);
+  std::unique_ptr<LogStructuredStorage<SimplePage>> storage;
+
+  void SetUp() override {
+    storage = Create();
+    storage->Remove();
+    storage->Open();
+  }
+
+  void TearDown() override { storage->Remove(); }
+
+  /**
+   * @brief Create storage with background cleaner disabled.
+   */
+  std::unique_ptr<LogStructuredStorage<SimplePage>> Create() {
+    auto _storage = std::make_unique<LogStructuredStorage<SimplePage>>(
+        path, page_size, segment_size);
+    _storage->SetCleanInterval(0);
+    return _storage;
+  }
+
+  /**
+   * @brief Write page with given ID and record.
+   */
+  void Write(PageId page_id, ByteBuffer record) {
+    auto page = CreatePage<SimplePage>(page_id, page_size);
+    page->SetRecord(record);
+    storage->Write(*page);
+  }
+
+  /**
+   * @brief Check if segment file with given number exists.
+   */
+  bool HasSegment(uint64_t segment) {
+    return std::ifstream((path + "_" + std::to_string(segment) +
+                          LOG_STRUCTURED_STORAGE_SEGMENT_FILE_EXTENTION)
+                             .c_str())
+        .good();
+  }
+};
+
+TEST_F(LogStructuredStorageTestFixture, TestReadPageError) {
+  ASSERT_THROW(storage->Read(1), PageNotFoundError);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestReadWritePage) {
+  Write(storage->Allocate(), "testing_1"_bb);
+  Write(storage->Allocate(), "testing_2"_bb);
+
+  ASSERT_EQ(storage->Read(1)->GetRecord(), "testing_1"_bb);
+  ASSERT_EQ(storage->Read(2)->GetRecord(), "testing_2"_bb);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestAppend) {
+  PageId page_id = storage->Allocate();
+  Write(page_id, "testing_1"_bb);
+  Write(page_id, "testing_2"_bb);
+  Write(page_id, "testing_3"_bb);
+
+  // Every write is appended
+  ASSERT_TRUE(HasSegment(0));
+  ASSERT_TRUE(HasSegment(1));
+  ASSERT_EQ(storage->GetSegmentCount(), 2);
+  ASSERT_EQ(storage->Read(page_id)->GetRecord(), "testing_3"_bb);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestReopen) {
+  PageId page_id_1 = storage->Allocate(), page_id_2 = storage->Allocate();
+  Write(page_id_1, "testing_1"_bb);
+  Write(page_id_2, "testing_2"_bb);
+  Write(page_id_1, "testing_3"_bb);
+  storage->Close();
+
+  storage = Create();
+  storage->Open();
+
+  ASSERT_EQ(storage->GetPageCount(), 2);
+  ASSERT_EQ(storage->Read(page_id_1)->GetRecord(), "testing_3"_bb);
+  ASSERT_EQ(storage->Read(page_id_2)->GetRecord(), "testing_2"_bb);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestReplay) {
+  Write(storage->Allocate(), "testing_1"_bb);
+  storage->Checkpoint();
+  PageId page_id = storage->Allocate();
+  Write(page_id, "testing_2"_bb);
+  Write(page_id, "testing_3"_bb);
+  Write(page_id, "testing_4"_bb);
+  storage->Close();
+  // Drop checkpoint to recover all records by replay
+  std::remove(
+      (path + LOG_STRUCTURED_STORAGE_CHECKPOINT_FILE_EXTENTION).c_str());
+
+  storage = Create();
+  storage->Open();
+
+  ASSERT_EQ(storage->GetPageCount(), 2);
+  ASSERT_EQ(storage->Read(1)->GetRecord(), "testing_1"_bb);
+  ASSERT_EQ(storage->Read(page_id)->GetRecord(), "testing_4"_bb);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestClean) {
+  PageId page_id_1 = storage->Allocate(), page_id_2 = storage->Allocate(),
+         page_id_3 = storage->Allocate();
+  Write(page_id_1, "testing_1"_bb);
+  Write(page_id_2, "testing_2"_bb);
+  // Overwrite one page of the first segment
+  Write(page_id_1, "testing_3"_bb);
+  Write(page_id_3, "testing_4"_bb);
+  Write(page_id_3, "testing_5"_bb);
+
+  // No segment has less than half of its records live
+  ASSERT_EQ(storage->Clean(), 0);
+
+  storage->SetCleanThreshold(0.75);
+  ASSERT_EQ(storage->Clean(), 2);
+  ASSERT_FALSE(HasSegment(0));
+  ASSERT_FALSE(HasSegment(1));
+  ASSERT_EQ(storage->Read(page_id_1)->GetRecord(), "testing_3"_bb);
+  ASSERT_EQ(storage->Read(page_id_2)->GetRecord(), "testing_2"_bb);
+  ASSERT_EQ(storage->Read(page_id_3)->GetRecord(), "testing_5"_bb);
+
+  // Relocated pages are recovered
+  storage->Close();
+  storage = Create();
+  storage->Open();
+  ASSERT_EQ(storage->Read(page_id_1)->GetRecord(), "testing_3"_bb);
+  ASSERT_EQ(storage->Read(page_id_2)->GetRecord(), "testing_2"_bb);
+  ASSERT_EQ(storage->Read(page_id_3)->GetRecord(), "testing_5"_bb);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestCrashAfterClean) {
+  for (int i = 1; i <= 6; ++i) {
+    Write(storage->Allocate(), ByteBuffer(8, 'A' + i));
+  }
+  // Overwrite one page in each of the first two segments
+  Write(1, "testing_1"_bb);
+  Write(3, "testing_3"_bb);
+  storage->SetCleanThreshold(0.75);
+  ASSERT_EQ(storage->Clean(), 2);
+  storage->Sync();
+
+  // Open the storage again without closing it
+  auto reopened = Create();
+  reopened->Open();
+
+  ASSERT_EQ(reopened->GetPageCount(), 6);
+  ASSERT_EQ(reopened->Read(1)->GetRecord(), "testing_1"_bb);
+  ASSERT_EQ(reopened->Read(3)->GetRecord(), "testing_3"_bb);
+  for (PageId page_id : {2, 4, 5, 6}) {
+    ASSERT_EQ(reopened->Read(page_id)->GetRecord(),
+              ByteBuffer(8, 'A' + page_id));
+  }
+  ASSERT_EQ(reopened->Allocate(), 7);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestReplaySegmentGap) {
+  for (int i = 1; i <= 6; ++i) {
+    Write(storage->Allocate(), ByteBuffer(8, 'A' + i));
+  }
+  Write(1, "testing_1"_bb);
+  Write(3, "testing_3"_bb);
+  storage->SetCleanThreshold(0.75);
+  ASSERT_EQ(storage->Clean(), 2);
+  storage->Sync();
+  ASSERT_FALSE(HasSegment(0));
+  // Drop checkpoint to recover all records by replay across the gap
+  std::remove(
+      (path + LOG_STRUCTURED_STORAGE_CHECKPOINT_FILE_EXTENTION).c_str());
+
+  auto reopened = Create();
+  reopened->Open();
+
+  ASSERT_EQ(reopened->Read(1)->GetRecord(), "testing_1"_bb);
+  ASSERT_EQ(reopened->Read(3)->GetRecord(), "testing_3"_bb);
+  for (PageId page_id : {2, 4, 5, 6}) {
+    ASSERT_EQ(reopened->Read(page_id)->GetRecord(),
+              ByteBuffer(8, 'A' + page_id));
+  }
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestMissingSegment) {
+  for (int i = 1; i <= 4; ++i) {
+    Write(storage->Allocate(), ByteBuffer(8, 'A' + i));
+  }
+  storage->Close();
+  // Segment holding live pages is lost
+  std::remove((path + "_0" + LOG_STRUCTURED_STORAGE_SEGMENT_FILE_EXTENTION)
+                  .c_str());
+
+  storage = Create();
+  ASSERT_THROW(storage->Open(), StorageError);
+  // No segment file is created by the failed open
+  ASSERT_FALSE(HasSegment(0));
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestCleanConcurrentWrites) {
+  // Segments hold more records than relocated at a time
+  const size_t count = 2 * LOG_STRUCTURED_STORAGE_CLEAN_BATCH_SIZE;
+  storage->Remove();
+  storage = std::make_unique<LogStructuredStorage<SimplePage>>(
+      path, page_size, count * (sizeof(PageId) + page_size));
+  storage->SetCleanInterval(0);
+  storage->Open();
+  for (size_t i = 0; i < count; ++i) {
+    Write(storage->Allocate(), "testing"_bb);
+  }
+  for (PageId page_id = 1; page_id <= count / 2; ++page_id) {
+    Write(page_id, "testing_1"_bb);
+  }
+
+  // Pages are written while the first segment is cleaned
+  storage->SetCleanThreshold(0.75);
+  std::thread writer([&]() {
+    for (PageId page_id = count; page_id > count / 2; --page_id) {
+      Write(page_id, "testing_2"_bb);
+    }
+  });
+  storage->Clean();
+  writer.join();
+
+  ASSERT_FALSE(HasSegment(0));
+  for (PageId page_id = 1; page_id <= count; ++page_id) {
+    ASSERT_EQ(storage->Read(page_id)->GetRecord(),
+              page_id <= count / 2 ? "testing_1"_bb : "testing_2"_bb);
+  }
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestBackgroundClean) {
+  storage->Close();
+  storage->SetCleanInterval(1);
+  storage->Open();
+
+  PageId page_id = storage->Allocate();
+  Write(page_id, "testing_1"_bb);
+  Write(page_id, "testing_2"_bb);
+  Write(page_id, "testing_3"_bb);
+
+  // Wait for cleaner to remove the dead segment
+  for (int i = 0; i < 1000 && HasSegment(0); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_FALSE(HasSegment(0));
+  ASSERT_EQ(storage->Read(page_id)->GetRecord(), "testing_3"_bb);
+}
+
+TEST_F(LogStructuredStorageTestFixture, TestDeallocate) {
+  PageId page_id = storage->Allocate();
+  Write(page_id, "testing"_bb);
+  storage->Deallocate(page_id);
+
+  ASSERT_THROW(storage->Read(page_id), PageNotFoundError);
+  ASSERT_EQ(storage->Allocate(), page_id);
+}
@@ -69,6 +69,135 @@ TEST_F(MemoryStorageTestFixture, TestReadWritePage) {
   ASSERT_EQ(page->GetRecord(), _page->GetRecord());
 }
 
+TEST_F(MemoryStorageTestFixture, TestReadWriteBlock) {
+  auto page = CreatePage<SimplePage>(1, page_size);
+  ByteBuffer record = "testing"_bb;
+  page->SetRecord(record);
+
+  ByteBuffer block(page_size);
+  persist::DumpPage(*page, block, storage->GetChecksumType());
+  storage->WriteBlock(1, block);
+
+  ByteBuffer _block(page_size);
+  storage->ReadBlock(1, _block);
+  auto _page =
+      persist::LoadPage<SimplePage>(_block, storage->GetChecksumType());
+
+  ASSERT_EQ(_block, block);
+  ASSERT_EQ(page->GetId(), _page->GetId());
+  ASSERT_EQ(page->GetRecord(), _page->GetRecord());
+}
+
+TEST_F(MemoryStorageTestFixture, TestVerifyPolicy) {
+  auto page = CreatePage<SimplePage>(1, page_size);
+  ByteBuffer block(page_size);
+  persist::DumpPage(*page, block, storage->GetChecksumType());
+  ByteBuffer corrupt_block = block;
+  corrupt_block[page_size - 1] ^= 0xFF;
+  storage->WriteBlock(1, corrupt_block);
+
+  ASSERT_THROW(storage->Read(1), PageCorruptError);
+
+  storage->SetVerifyPolicy(VerifyPolicy::NEVER);
+  ASSERT_EQ(storage->Read(1)->GetId(), 1);
+
+  // Every second load is verified
+  storage->SetVerifyPolicy(VerifyPolicy::SAMPLED);
+  storage->SetVerifySampleInterval(2);
+  ASSERT_THROW(storage->Read(1), PageCorruptError);
+  ASSERT_EQ(storage->Read(1)->GetId(), 1);
+  ASSERT_THROW(storage->Read(1), PageCorruptError);
+
+  // Only the first load is verified
+  storage->SetVerifyPolicy(VerifyPolicy::FIRST_LOAD);
+  ASSERT_THROW(storage->Read(1), PageCorruptError);
+  storage->WriteBlock(1, block);
+  ASSERT_EQ(storage->Read(1)->GetId(), 1);
+  storage->WriteBlock(1, corrupt_block);
+  ASSERT_EQ(storage->Read(1)->GetId(), 1);
+}
+
 TEST_F(MemoryStorageTestFixture, TestAllocate) {
   ASSERT_EQ(storage->Allocate(), 1);
 }
+
+TEST_F(MemoryStorageTestFixture, TestDeallocate) {
+  auto page = CreatePage<SimplePage>(storage->Allocate(), page_size);
+  storage->Write(*page);
+
+  storage->Deallocate(page->GetId());
+  ASSERT_EQ(storage->GetFreePageCount(), 1);
+  ASSERT_THROW(storage->Read(page->GetId()), PageNotFoundError);
+  ASSERT_EQ(storage->Allocate(), page->GetId());
+}
+
+/********************************
+ * Testing for Object Mode
+ ********************************/
+
+class ObjectMemoryStorageTestFixture : public ::testing::Test {
+protected:
+  const uint64_t page_size = 512;
+  std::unique_ptr<MemoryStorage<SimplePage>> storage;
+
+  void SetUp() override {
+    storage = std::make_unique<MemoryStorage<SimplePage>>(
+        page_size, MemoryStorageMode::OBJECT);
+    storage->Open();
+  }
+
+  void TearDown() override { storage->Close(); }
+};
+
+TEST_F(ObjectMemoryStorageTestFixture, TestIsObjectStore) {
+  ASSERT_TRUE(storage->IsObjectStore());
+  ASSERT_FALSE(MemoryStorage<SimplePage>(page_size).IsObjectStore());
+}
+
+TEST_F(ObjectMemoryStorageTestFixture, TestReleaseAdopt) {
+  auto page = CreatePage<SimplePage>(1, page_size);
+  SimplePage *page_ptr = page.get();
+
+  storage->Adopt(std::move(page));
+  auto _page = storage->Release(1);
+
+  // Page object is handed over without a copy
+  ASSERT_EQ(_page.get(), page_ptr);
+  ASSERT_THROW(storage->Release(1), PageNotFoundError);
+}
+
+TEST_F(ObjectMemoryStorageTestFixture, TestReadWritePage) {
+  auto page = CreatePage<SimplePage>(1, page_size);
+  page->SetRecord("testing"_bb);
+
+  storage->Write(*page);
+  auto _page = storage->Read(1);
+
+  // A copy of the page is kept and returned
+  ASSERT_NE(_page.get(), page.get());
+  ASSERT_EQ(page->GetRecord(), _page->GetRecord());
+  ASSERT_EQ(storage->Release(1)->GetRecord(), page->GetRecord());
+}
+
+TEST_F(ObjectMemoryStorageTestFixture, TestReadWriteBlock) {
+  auto page = CreatePage<SimplePage>(1, page_size);
+  page->SetRecord("testing"_bb);
+
+  ByteBuffer block(page_size);
+  persist::DumpPage(*page, block, storage->GetChecksumType());
+  storage->WriteBlock(1, block);
+
+  ByteBuffer _block(page_size);
+  storage->ReadBlock(1, _block);
+
+  ASSERT_EQ(_block, block);
+}
+
+TEST_F(ObjectMemoryStorageTestFixture, TestDeallocate) {
+  auto page = CreatePage<SimplePage>(storage->Allocate(), page_size);
+  PageId page_id = page->GetId();
+  storage->Adopt(std::move(page));
+
+  storage->Deallocate(page_id);
+  ASSERT_THROW(storage->Release(page_id), PageNotFoundError);
+}
@@ -0,0 +1,209 @@
+/**
+ * test_segmented_file_storage.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Segmented File Storage Unit Tests
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <persist/core/page/creator.hpp>
+#include <persist/core/storage/segmented_file_storage.hpp>
+
+#include "common.hpp"
+#include "persist/test/simple_page.hpp"
+
+using namespace persist;
+using namespace persist::test;
+
+class SegmentedFileStorageTestFixture : public ::testing::Test {
+protected:
+  const std::string path = std::string(DATA_PATH) + "/_segmented";
+  const uint64_t page_size = 512;
+  const uint64_t segment_size = 1024;
+  std::unique_ptr<SegmentedFileStorage<SimplePage>> storage;
+
+  void SetUp() override {
+    storage = std::make_unique<SegmentedFileStorage<SimplePage>>(
+        path, page_size, segment_size);
+    storage->Remove();
+    storage->Open();
+  }
+
+  void TearDown() override { storage->Remove(); }
+
+  /**
+   * @brief Allocate and write a page with given record.
+   */
+  PageId Write(ByteBuffer record) {
+    auto page = CreatePage<SimplePage>(storage->Allocate(), page_size);
+    page->SetRecord(record);
+    storage->Write(*page);
+    return page->GetId();
+  }
+
+  /**
+   * @brief Check if file at given path exists.
+   */
+  bool Exists(const std::string &file_path) {
+    return std::ifstream(file_path.c_str()).good();
+  }
+};
+
+TEST_F(SegmentedFileStorageTestFixture, TestOpen) {
+  SegmentedFileHeader header;
+  ByteBuffer buffer(header.GetStorageSize());
+  std::fstream file =
+      file::open(path + SEGMENTED_FILE_STORAGE_META_FILE_EXTENTION,
+                 std::ios::in | std::ios::binary);
+  file::read(file, buffer, 0);
+  header.Load(buffer);
+
+  ASSERT_EQ(header.page_size, page_size);
+  ASSERT_EQ(header.segment_page_count, segment_size / page_size);
+  ASSERT_EQ(storage->GetSegmentPageCount(), segment_size / page_size);
+  // Segment files are created lazily
+  ASSERT_FALSE(
+      Exists(path + "_0" SEGMENTED_FILE_STORAGE_SEGMENT_FILE_EXTENTION));
+}
+
+TEST_F(SegmentedFileStorageTestFixture, TestReadPageError) {
+  ASSERT_THROW(storage->Read(0), PageNotFoundError);
+  ASSERT_THROW(storage->Read(1), PageNotFoundError);
+  ASSERT_FALSE(
+      Exists(path + "_0" SEGMENTED_FILE_STORAGE_SEGMENT_FILE_EXTENTION));
+}
+
+TEST_F(SegmentedFileStorageTestFixture, TestReadWritePage) {
+  std::vector<ByteBuffer> records = {"testing_1"_bb, "testing_2"_bb,
+                                     "testing_3"_bb, "testing_4"_bb,
+                                     "testing_5"_bb};
+  for (auto &record : records) {
+    Write(record);
+  }
+
+  // Pages are spread across segments of 2 pages each
+  ASSERT_EQ(storage->GetSegmentCount(), 3);
+  for (size_t index = 0; index < 3; ++index) {
+    std::fstream file =
+        file::open(path + "_" + std::to_string(index) +
+                       SEGMENTED_FILE_STORAGE_SEGMENT_FILE_EXTENTION,
+                   std::ios::in | std::ios::binary);
+    ASSERT_EQ(file::size(file), index < 2 ? 2 * page_size : page_size);
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    auto page = storage->Read(i + 1);
+    ASSERT_EQ(page->GetId(), i + 1);
+    ASSERT_EQ(page->GetRecord(), records[i]);
+  }
+}
+
+TEST_F(SegmentedFileStorageTestFixture, TestSync) {
+  for (int i = 0; i < 3; ++i) {
+    Write("testing"_bb);
+  }
+  storage->Sync();
+
+  // Buffered pages of every segment are written out
+  for (size_t index = 0; index < 2; ++index) {
+    std::fstream file =
+        file::open(path + "_" + std::to_string(index) +
+                       SEGMENTED_FILE_STORAGE_SEGMENT_FILE_EXTENTION,
+                   std::ios::in | std::ios::binary);
+    ASSERT_EQ(file::size(file), index < 1 ? 2 * page_size : page_size);
+  }
+}
+
+TEST_F(SegmentedFileStorageTestFixture, TestReopen) {
+  for (int i = 0; i < 3; ++i) {
+    Write("testing"_bb);
+  }
+  PageId page_id = storage->Allocate();
+  storage->Deallocate(page_id - 1);
+  storage->Close();
+
+  // Segment size of the existing storage is used
+  storage = std::make_unique<SegmentedFileStorage<SimplePage>>(
+      path, page_size, 4 * segment_size);
+  storage->Open();
+
+  ASSERT_EQ(storage->GetSegmentPageCount(), segment_size / page_size);
+  ASSERT_EQ(storage->GetPageCount(), page_id);
+  ASSERT_EQ(storage->GetFreePageCount(), 1);
+  ASSERT_EQ(storage->Read(1)->GetRecord(), "testing"_bb);
+  ASSERT_EQ(storage->Allocate(), page_id - 1);
+}
+
+TEST_F(SegmentedFileStorageTestFixture, TestReopenSegmentGap) {
+  // Only the third segment file is created
+  for (int i = 0; i < 6; ++i) {
+    storage->Allocate();
+  }
+  auto page = CreatePage<SimplePage>(5, page_size);
+  page->SetRecord("testing"_bb);
+  storage->Write(*page);
+  ASSERT_FALSE(
+      Exists(path + "_0" SEGMENTED_FILE_STORAGE_SEGMENT_FILE_EXTENTION));
+
+  // Open the storage again without closing it
+  SegmentedFileStorage<SimplePage> reopened(path, page_size, segment_size);
+  reopened.Open();
+
+  ASSERT_EQ(reopened.GetPageCount(), 6);
+  ASSERT_EQ(reopened.Read(5)->GetRecord(), "testing"_bb);
+  ASSERT_EQ(reopened.Allocate(), 7);
+}
+
+TEST_F(SegmentedFileStorageTestFixture, TestParallelIO) {
+  const size_t page_count = 16;
+  for (size_t i = 0; i < page_count; ++i) {
+    storage->Allocate();
+  }
+
+  // Each thread writes and reads pages of its own segment
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < page_count / 2; ++t) {
+    threads.emplace_back([this, t]() {
+      for (PageId page_id = 2 * t + 1; page_id <= 2 * t + 2; ++page_id) {
+        auto page = CreatePage<SimplePage>(page_id, page_size);
+        ByteBuffer record(8, 'A' + page_id);
+        page->SetRecord(record);
+        storage->Write(*page);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (PageId page_id = 1; page_id <= page_count; ++page_id) {
+    ASSERT_EQ(storage->Read(page_id)->GetRecord(),
+              ByteBuffer(8, 'A' + page_id));
+  }
+}
@@ -31,7 +31,9 @@
 
 #include <memory>
 
+#include <persist/core/page/fixed_record_page/page.hpp>
 #include <persist/core/storage/creator.hpp>
+#include <persist/core/storage/memory_storage.hpp>
 #include <persist/core/transaction/transaction_manager.hpp>
 
 using namespace persist;
@@ -273,12 +275,11 @@ TEST_F(TransactionManagerTestFixture, TestUpdateAbort) {
   ASSERT_EQ(log_records[3].GetLogType(), LogRecord::Type::BEGIN);
   ASSERT_EQ(log_records[2].GetLogType(), LogRecord::Type::UPDATE);
   ASSERT_EQ(log_records[2].GetLocation(), location);
-  ASSERT_EQ(log_records[2].GetPageSlotA().data, "testing"_bb);
-  ASSERT_EQ(log_records[2].GetPageSlotB().data, "testing-update-abort"_bb);
+  RecordPageSlot old_slot("testing"_bb);
+  ASSERT_EQ(log_records[2].Redo(old_slot), slot);
   ASSERT_EQ(log_records[1].GetLogType(), LogRecord::Type::UPDATE);
   ASSERT_EQ(log_records[1].GetLocation(), location);
-  ASSERT_EQ(log_records[1].GetPageSlotA().data, "testing-update-abort"_bb);
-  ASSERT_EQ(log_records[1].GetPageSlotB().data, "testing"_bb);
+  ASSERT_EQ(log_records[1].Undo(old_slot), slot);
   ASSERT_EQ(log_records[0].GetLogType(), LogRecord::Type::ABORT);
 }
 
@@ -309,3 +310,177 @@ TEST_F(TransactionManagerTestFixture, TestRemoveAbort) {
   ASSERT_EQ(log_records[1].GetPageSlotA().data, "testing"_bb);
   ASSERT_EQ(log_records[0].GetLogType(), LogRecord::Type::ABORT);
 }
+
+TEST_F(TransactionManagerTestFixture, TestFreePageCommit) {
+  // Empty the page as part of transaction
+  Transaction txn = txn_manager->Begin();
+  Remove(txn, location);
+  txn.FreePage(location.page_id);
+
+  // Page is released only once the transaction commits
+  ASSERT_FALSE(data_storage->IsFree(location.page_id));
+  txn_manager->Commit(txn);
+  ASSERT_TRUE(data_storage->IsFree(location.page_id));
+  ASSERT_EQ(buffer_manager->GetNew()->GetId(), location.page_id);
+
+  // Deallocation is logged after the commit
+  std::vector<LogRecord> log_records;
+  RetriveLogRecord(txn, log_records);
+  ASSERT_EQ(log_records[0].GetLogType(), LogRecord::Type::DEALLOCATE);
+  ASSERT_EQ(log_records[0].GetLocation().page_id, location.page_id);
+  ASSERT_EQ(log_records[1].GetLogType(), LogRecord::Type::COMMIT);
+}
+
+TEST_F(TransactionManagerTestFixture, TestFreePagesCommit) {
+  // Empty two pages as part of transaction
+  Transaction txn = txn_manager->Begin();
+  RecordPageSlot slot("testing"_bb);
+  RecordPageSlot::Location _location = Insert(txn, slot);
+  Remove(txn, location);
+  Remove(txn, _location);
+  txn.FreePage(location.page_id);
+  txn.FreePage(_location.page_id);
+  txn_manager->Commit(txn);
+
+  // Both deallocations are logged before the pages are released
+  ASSERT_TRUE(data_storage->IsFree(location.page_id));
+  ASSERT_TRUE(data_storage->IsFree(_location.page_id));
+  std::vector<LogRecord> log_records;
+  RetriveLogRecord(txn, log_records);
+  ASSERT_EQ(log_records[0].GetLogType(), LogRecord::Type::DEALLOCATE);
+  ASSERT_EQ(log_records[1].GetLogType(), LogRecord::Type::DEALLOCATE);
+  ASSERT_EQ(log_records[2].GetLogType(), LogRecord::Type::COMMIT);
+}
+
+TEST_F(TransactionManagerTestFixture, TestFreePageCommitPinned) {
+  // Empty the page as part of transaction
+  Transaction txn = txn_manager->Begin();
+  Remove(txn, location);
+  txn.FreePage(location.page_id);
+
+  // Page pinned during commit is kept and the commit completes
+  {
+    auto page = buffer_manager->Get(location.page_id);
+    txn_manager->Commit(txn, true);
+  }
+  ASSERT_EQ(txn.GetState(), Transaction::State::COMMITED);
+  ASSERT_FALSE(data_storage->IsFree(location.page_id));
+  std::vector<LogRecord> log_records;
+  RetriveLogRecord(txn, log_records);
+  ASSERT_EQ(log_records[0].GetLogType(), LogRecord::Type::DEALLOCATE);
+  ASSERT_EQ(log_records[1].GetLogType(), LogRecord::Type::COMMIT);
+}
+
+TEST_F(TransactionManagerTestFixture, TestFreePageAbort) {
+  // Empty the page as part of transaction
+  Transaction txn = txn_manager->Begin();
+  Remove(txn, location);
+  txn.FreePage(location.page_id);
+  txn_manager->Abort(txn);
+
+  // Page is kept with the restored page slot
+  ASSERT_FALSE(data_storage->IsFree(location.page_id));
+  Transaction _txn = txn_manager->Begin();
+  auto page = buffer_manager->Get(location.page_id);
+  ASSERT_EQ(page->GetPageSlot(location.slot_id, _txn).data, "testing"_bb);
+  txn_manager->Commit(_txn);
+}
+
+TEST_F(TransactionManagerTestFixture, TestAbortRemoveAfterInsert) {
+  // Page slot is removed and another is inserted in the same page before the
+  // removal is rolled back
+  Transaction txn_a = txn_manager->Begin();
+  Remove(txn_a, location);
+  Transaction txn_b = txn_manager->Begin();
+  RecordPageSlot slot("testing_b"_bb);
+  PageSlotId slot_id =
+      buffer_manager->Get(location.page_id)->InsertPageSlot(slot, txn_b).first;
+  ASSERT_NE(slot_id, location.slot_id);
+  txn_manager->Abort(txn_a);
+  txn_manager->Commit(txn_b);
+
+  // Both the restored and the inserted page slots are kept
+  Transaction txn = txn_manager->Begin();
+  auto page = buffer_manager->Get(location.page_id);
+  ASSERT_EQ(page->GetPageSlot(location.slot_id, txn).data, "testing"_bb);
+  ASSERT_EQ(page->GetPageSlot(slot_id, txn).data, "testing_b"_bb);
+  txn_manager->Commit(txn);
+}
+
+TEST_F(TransactionManagerTestFixture, TestCommitRemoveReleasesSlot) {
+  // Slot ID of a removed page slot is re-used once the removal commits
+  Transaction txn = txn_manager->Begin();
+  Remove(txn, location);
+  auto page = buffer_manager->Get(location.page_id);
+  ASSERT_NE(page->GetNextSlotId(), location.slot_id);
+  txn_manager->Commit(txn);
+  ASSERT_EQ(page->GetNextSlotId(), location.slot_id);
+}
+
+TEST_F(TransactionManagerTestFixture, TestConcreteStorage) {
+  // Buffer manager calling the concrete storage type manages record pages
+  typedef MemoryStorage<RecordPage> StorageType;
+  StorageType page_storage(page_size);
+  BufferManager<RecordPage, LRUReplacer, StorageType> page_buffer_manager(
+      page_storage, max_size);
+  page_buffer_manager.Start();
+  TransactionManager _txn_manager(page_buffer_manager, *log_manager);
+
+  Transaction txn = _txn_manager.Begin();
+  RecordPageSlot slot("testing"_bb);
+  auto page = page_buffer_manager.GetNew();
+  PageSlotId slot_id = page->InsertPageSlot(slot, txn).first;
+  _txn_manager.Abort(txn);
+
+  ASSERT_THROW(page->GetPageSlot(slot_id, txn), PageSlotNotFoundError);
+}
+
+TEST_F(TransactionManagerTestFixture, TestFixedRecordPageAbort) {
+  typedef FixedRecordPage<8> PageType;
+  MemoryStorage<PageType> page_storage(page_size);
+  BufferManager<PageType> page_buffer_manager(page_storage, max_size);
+  page_buffer_manager.Start();
+  ByteBuffer record_a = "record_a"_bb, record_b = "record_b"_bb;
+
+  // Abort fails for pages of a kind not registered, leaving the record
+  Transaction txn_a = txn_manager->Begin();
+  PageId page_id = page_buffer_manager.GetNew()->GetId();
+  page_buffer_manager.Get(page_id)->InsertRecord(record_a.data(), txn_a);
+  ASSERT_THROW(txn_manager->Abort(txn_a), LogRecordUndoError);
+
+  // Records are flushed to the registered pages on force commit
+  txn_manager->Register(page_buffer_manager);
+  Transaction txn_b = txn_manager->Begin();
+  PageSlotId slot_id_a =
+      page_buffer_manager.Get(page_id)->InsertRecord(record_a.data(), txn_b);
+  txn_manager->Commit(txn_b, true);
+  ASSERT_EQ(page_storage.Read(page_id)->GetRecordCount(), 2);
+
+  // Operations are undone on the fixed record page and not the record page
+  // with the same page ID
+  Transaction txn_c = txn_manager->Begin();
+  PageSlotId slot_id_b;
+  {
+    auto page = page_buffer_manager.Get(page_id);
+    page->UpdateRecord(slot_id_a, record_b.data(), txn_c);
+    slot_id_b = page->InsertRecord(record_b.data(), txn_c);
+    page->RemoveRecord(1, txn_c);
+  }
+  txn_manager->Abort(txn_c);
+  {
+    auto page = page_buffer_manager.Get(page_id);
+    ASSERT_EQ(page->GetRecordCount(), 2);
+    ASSERT_FALSE(page->IsOccupied(slot_id_b));
+    ASSERT_EQ(ByteBuffer(page->GetRecord(1), page->GetRecord(1) + 8),
+              record_a);
+    ASSERT_EQ(
+        ByteBuffer(page->GetRecord(slot_id_a), page->GetRecord(slot_id_a) + 8),
+        record_a);
+  }
+  Transaction _txn = txn_manager->Begin();
+  auto page = buffer_manager->Get(location.page_id);
+  ASSERT_EQ(page->GetPageSlot(location.slot_id, _txn).data, "testing"_bb);
+  txn_manager->Commit(_txn);
+
+  page_buffer_manager.Stop();
+}
@@ -0,0 +1,143 @@
+/**
+ * log/test_log_buffer.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Log buffer unit tests
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Enabled intrusive testing
+ */
+#define PERSIST_INTRUSIVE_TESTING
+
+#include <persist/core/wal/log_buffer.hpp>
+
+using namespace persist;
+
+class LogBufferTestFixture : public ::testing::Test {
+protected:
+  const size_t capacity = 64;
+  std::unique_ptr<LogBuffer> log_buffer;
+
+  void SetUp() override {
+    log_buffer = std::make_unique<LogBuffer>(capacity);
+  }
+
+  /**
+   * @brief Consume all completed entries.
+   */
+  std::vector<ByteBuffer> Consume() {
+    std::vector<ByteBuffer> entries;
+    log_buffer->Consume([&](uint64_t, Span entry) {
+      entries.emplace_back(entry.start, entry.start + entry.size);
+    });
+    return entries;
+  }
+};
+
+TEST_F(LogBufferTestFixture, TestReserve) {
+  ASSERT_EQ(log_buffer->GetCapacity(), capacity);
+  // Entries are aligned
+  ASSERT_EQ(log_buffer->Reserve(5), 0);
+  ASSERT_EQ(log_buffer->Reserve(8), 8);
+  ASSERT_EQ(log_buffer->Reserve(1), 16);
+  ASSERT_THROW(log_buffer->Reserve(0), LogBufferError);
+  ASSERT_THROW(log_buffer->Reserve(capacity + 1), LogBufferError);
+  ASSERT_TRUE(log_buffer->Fits(capacity));
+  ASSERT_FALSE(log_buffer->Fits(capacity + 1));
+  ASSERT_FALSE(log_buffer->Fits(0));
+}
+
+TEST_F(LogBufferTestFixture, TestConsumeCompletedPrefix) {
+  ByteBuffer entry_1 = "aaaaa"_bb, entry_2 = "bbb"_bb;
+  uint64_t offset_1 = log_buffer->Reserve(entry_1.size());
+  uint64_t offset_2 = log_buffer->Reserve(entry_2.size());
+
+  // Entries completed out of order are consumed in order
+  log_buffer->Write(offset_2, entry_2);
+  ASSERT_TRUE(Consume().empty());
+  log_buffer->Write(offset_1, entry_1);
+  ASSERT_EQ(Consume(), std::vector<ByteBuffer>({entry_1, entry_2}));
+  ASSERT_TRUE(Consume().empty());
+}
+
+TEST_F(LogBufferTestFixture, TestWrapAround) {
+  ByteBuffer entry(40, 'A');
+  uint64_t offset = log_buffer->Reserve(entry.size());
+  log_buffer->Write(offset, entry);
+
+  // Space is freed only once consumed
+  ByteBuffer wrapped(40, 'B');
+  offset = log_buffer->Reserve(wrapped.size());
+  ASSERT_FALSE(log_buffer->IsWritable(offset, wrapped.size()));
+  ASSERT_EQ(Consume(), std::vector<ByteBuffer>({entry}));
+  ASSERT_TRUE(log_buffer->IsWritable(offset, wrapped.size()));
+
+  // Entry wrapping around the end of the ring is joined
+  log_buffer->Write(offset, wrapped);
+  ASSERT_EQ(Consume(), std::vector<ByteBuffer>({wrapped}));
+}
+
+TEST_F(LogBufferTestFixture, TestConcurrentWrite) {
+  const size_t thread_count = 8, entry_count = 1000;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&, i]() {
+      for (size_t j = 0; j < entry_count; ++j) {
+        ByteBuffer entry(1 + j % 16, static_cast<Byte>(i));
+        uint64_t offset = log_buffer->Reserve(entry.size());
+        while (!log_buffer->IsWritable(offset, entry.size())) {
+          std::this_thread::yield();
+        }
+        log_buffer->Write(offset, entry);
+      }
+    });
+  }
+
+  // Consume entries while they are written
+  size_t count = 0;
+  uint64_t last_offset = 0;
+  while (count < thread_count * entry_count) {
+    count += log_buffer->Consume([&](uint64_t offset, Span entry) {
+      ASSERT_TRUE(offset == 0 || offset > last_offset);
+      last_offset = offset;
+      // Entries are not torn
+      for (size_t i = 1; i < entry.size; ++i) {
+        ASSERT_EQ(entry.start[i], entry.start[0]);
+      }
+    });
+    std::this_thread::yield();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(count, thread_count * entry_count);
+}
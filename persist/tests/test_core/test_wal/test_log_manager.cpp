@@ -28,7 +28,13 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
 #include <memory>
+#include <thread>
+#include <vector>
 
 /**
  * @brief Enable debug mode if not already enabled
@@ -136,6 +142,7 @@ TEST_F(LogManagerTestFixture, TestFlush) {
 
   LogRecord::Location location = log_manager->Add(log_record);
   log_manager->Flush();
+  ASSERT_EQ(*log_manager->Get(location), log_record);
 
   // Create storage to test page flush
   auto _storage = CreateStorage<LogPage>(connection_string);
@@ -143,3 +150,209 @@ TEST_F(LogManagerTestFixture, TestFlush) {
   ASSERT_TRUE(_storage->GetPageCount() > 1);
   _storage->Close();
 }
+
+TEST_F(LogManagerTestFixture, TestCompression) {
+  // Creating log record which would span multiple page slots uncompressed
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(4 * storage->GetPageSize(), 'A');
+  RecordPageSlot::Location slot_location = {10, 1};
+  LogRecord log_record(11, {0, 0}, LogRecord::Type::INSERT, slot_location,
+                       page_slot);
+
+  ASSERT_FALSE(log_manager->IsCompressionEnabled());
+  LogRecord::Location location = log_manager->Add(log_record);
+  log_manager->SetCompression(true);
+  ASSERT_TRUE(log_manager->IsCompressionEnabled());
+  LogRecord _log_record = log_record;
+  LogRecord::Location _location = log_manager->Add(_log_record);
+
+  // Compressed log records share a page
+  LogRecord __log_record = log_record;
+  ASSERT_EQ(log_manager->Add(__log_record).page_id, _location.page_id);
+  // Both log records are readable
+  ASSERT_EQ(*log_manager->Get(location), log_record);
+  ASSERT_EQ(*log_manager->Get(_location), _log_record);
+}
+
+TEST_F(LogManagerTestFixture, TestAddLarge) {
+  // Log record larger than the log buffer is stored directly
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(DEFAULT_LOG_BUFFER_CAPACITY + 1, 'A');
+  RecordPageSlot::Location slot_location = {10, 1};
+  LogRecord log_record(11, {0, 0}, LogRecord::Type::INSERT, slot_location,
+                       page_slot);
+  LogRecord log_record_a(12);
+  LogRecord::Location location = log_manager->Add(log_record);
+  LogRecord::Location location_a = log_manager->Add(log_record_a);
+
+  ASSERT_EQ(location.seq_number, seq_number + 1);
+  ASSERT_EQ(location_a.seq_number, seq_number + 2);
+  ASSERT_EQ(*log_manager->Get(location), log_record);
+  ASSERT_EQ(*log_manager->Get(location_a), log_record_a);
+}
+
+TEST_F(LogManagerTestFixture, TestAddError) {
+  SequentialLog log("test_log_manager_error", 256);
+  LogManager _log_manager(log);
+  _log_manager.Start();
+
+  // Error storing a log record is raised to its writer
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(512, 'A');
+  RecordPageSlot::Location slot_location = {10, 1};
+  LogRecord log_record(11, {0, 0}, LogRecord::Type::INSERT, slot_location,
+                       page_slot);
+  ASSERT_THROW(_log_manager.Add(log_record), LogBufferError);
+
+  // Log records added afterwards are stored
+  LogRecord log_record_a(12);
+  LogRecord::Location location_a = _log_manager.Add(log_record_a);
+  ASSERT_EQ(*_log_manager.Get(location_a), log_record_a);
+
+  _log_manager.Stop();
+  log.Remove();
+}
+
+TEST_F(LogManagerTestFixture, TestFlushSeqNumber) {
+  // Log records loaded from storage are already flushed
+  ASSERT_EQ(log_manager->GetFlushedSeqNumber(), seq_number);
+
+  LogRecord log_record_a(11), log_record_b(12);
+  LogRecord::Location location_a = log_manager->Add(log_record_a);
+  LogRecord::Location location_b = log_manager->Add(log_record_b);
+
+  // Flush of the first record covers the second record as well
+  log_manager->Flush(location_a.seq_number);
+  ASSERT_EQ(log_manager->GetFlushedSeqNumber(), location_b.seq_number);
+  log_manager->Flush(location_b.seq_number);
+  ASSERT_EQ(log_manager->GetFlushedSeqNumber(), location_b.seq_number);
+}
+
+TEST_F(LogManagerTestFixture, TestGroupFlush) {
+  const size_t thread_count = 8, record_count = 50;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&, i]() {
+      for (size_t j = 0; j < record_count; ++j) {
+        LogRecord log_record(i);
+        LogRecord::Location location = log_manager->Add(log_record);
+        log_manager->Flush(location.seq_number);
+        // Log record is durable once flush returns
+        ASSERT_GE(log_manager->GetFlushedSeqNumber(), location.seq_number);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(log_manager->GetFlushedSeqNumber(),
+            seq_number + thread_count * record_count);
+  ASSERT_EQ(log_manager->GetFlushedSeqNumber(), log_manager->GetSeqNumber());
+}
+
+TEST_F(LogManagerTestFixture, TestSyncPolicy) {
+  ASSERT_EQ(log_manager->GetSyncPolicy(), SyncPolicy::ALWAYS);
+  ASSERT_EQ(log_manager->GetSyncedSeqNumber(), seq_number);
+
+  // Log is synced on every flush
+  LogRecord log_record_a(11);
+  LogRecord::Location location = log_manager->Add(log_record_a);
+  log_manager->Flush(location.seq_number);
+  ASSERT_EQ(log_manager->GetSyncedSeqNumber(), location.seq_number);
+
+  // Log is synced only when stopped
+  log_manager->Stop();
+  log_manager->SetSyncPolicy(SyncPolicy::NEVER);
+  log_manager->Start();
+  LogRecord log_record_b(12);
+  location = log_manager->Add(log_record_b);
+  log_manager->Flush(location.seq_number);
+  ASSERT_EQ(log_manager->GetFlushedSeqNumber(), location.seq_number);
+  ASSERT_LT(log_manager->GetSyncedSeqNumber(), location.seq_number);
+  log_manager->Stop();
+  ASSERT_EQ(log_manager->GetSyncedSeqNumber(), location.seq_number);
+
+  // Log is synced in the background
+  log_manager->SetSyncPolicy(SyncPolicy::INTERVAL, 1);
+  log_manager->Start();
+  LogRecord log_record_c(13);
+  location = log_manager->Add(log_record_c);
+  log_manager->Flush(location.seq_number);
+  for (int i = 0; i < 1000; ++i) {
+    if (log_manager->GetSyncedSeqNumber() == location.seq_number) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(log_manager->GetSyncedSeqNumber(), location.seq_number);
+}
+
+/**
+ * @brief Storage of log pages in memory whose sync blocks until released.
+ */
+class SlowSyncStorage : public Storage<LogPage> {
+  std::map<PageId, ByteBuffer> blocks;
+
+public:
+  std::atomic<bool> syncing, released;
+
+  SlowSyncStorage()
+      : Storage<LogPage>(DEFAULT_LOG_PAGE_SIZE), syncing(false),
+        released(false) {}
+
+  void Open() override {}
+  bool IsOpen() override { return true; }
+  void Close() override {}
+  void Remove() override { blocks.clear(); }
+
+  void Sync() override {
+    syncing = true;
+    for (int i = 0; i < 5000 && !released; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    syncing = false;
+  }
+
+  void ReadBlock(PageId page_id, Span output) override {
+    auto it = blocks.find(page_id);
+    if (it == blocks.end()) {
+      throw PageNotFoundError(page_id);
+    }
+    std::memcpy(output.start, it->second.data(), page_size);
+  }
+
+  void WriteBlock(PageId page_id, Span input) override {
+    blocks[page_id] = ByteBuffer(input.start, input.start + page_size);
+  }
+};
+
+TEST(LogManagerSyncTest, TestAddDuringSync) {
+  SlowSyncStorage storage;
+  LogManager log_manager(storage);
+  log_manager.Start();
+
+  LogRecord log_record_a(11);
+  LogRecord::Location location_a = log_manager.Add(log_record_a);
+  std::thread flusher([&]() { log_manager.Flush(location_a.seq_number); });
+  while (!storage.syncing) {
+    std::this_thread::yield();
+  }
+
+  // Log records are added while the log is synced
+  LogRecord log_record_b(12);
+  LogRecord::Location location_b = log_manager.Add(log_record_b);
+  bool added_during_sync = storage.syncing;
+  SeqNumber synced_during_sync = log_manager.GetSyncedSeqNumber();
+  storage.released = true;
+  flusher.join();
+
+  EXPECT_TRUE(added_during_sync);
+  EXPECT_LT(synced_during_sync, location_a.seq_number);
+  // Only the log records written before the sync are synced
+  EXPECT_EQ(log_manager.GetSyncedSeqNumber(), location_a.seq_number);
+  EXPECT_GT(location_b.seq_number, location_a.seq_number);
+
+  log_manager.Stop();
+  ASSERT_EQ(log_manager.GetSyncedSeqNumber(), location_b.seq_number);
+}
@@ -52,18 +52,10 @@ protected:
                                              page_slot_a, page_slot_b);
     log_record->SetSeqNumber(seq_number);
 
-    input = {5,   0,   0,   0,   0,   0,   0,   0,   1,   0,   0,  0,  0, 0, 0,
-             0,   3,   0,   0,   0,   0,   0,   0,   0,   176, 1,  0,  0, 0, 0,
-             0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,  0,  0, 0, 10,
-             0,   0,   0,   0,   0,   0,   0,   1,   0,   0,   0,  0,  0, 0, 0,
-             0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0, 0,
-             0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0, 0,
-             0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   9,  0,  0, 0, 0,
-             0,   0,   0,   116, 101, 115, 116, 105, 110, 103, 45, 65, 0, 0, 0,
-             0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0, 0,
-             0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  0,  0, 0, 0,
-             0,   0,   0,   0,   0,   0,   0,   9,   0,   0,   0,  0,  0, 0, 0,
-             116, 101, 115, 116, 105, 110, 103, 45,  66};
+    // Update log record stores the delta of the changed last byte
+    input = {5, 0, 0,  0, 0, 0, 0,   0, 1, 0,  0, 0, 0, 0, 0, 0, 3, 0, 0, 0,
+             0, 0, 0,  0, 176, 1, 0, 0, 0, 0,  0, 0, 2, 0, 0, 0, 10, 0, 0, 0,
+             0, 0, 0,  0, 1,   0, 0, 0, 0, 0,  0, 0, 1, 13, 1, 1, 65, 66};
   }
 };
 
@@ -81,6 +73,58 @@ TEST_F(LogRecordTestFixture, TestLoadParseError) {
   ASSERT_THROW(_log_record.Load(_input), LogRecordParseError);
 }
 
+TEST_F(LogRecordTestFixture, TestRedoUndo) {
+  ASSERT_EQ(log_record->Redo(page_slot_a), page_slot_b);
+  ASSERT_EQ(log_record->Undo(page_slot_b), page_slot_a);
+  ASSERT_THROW(log_record->Undo(page_slot_a), LogRecordParseError);
+}
+
+TEST_F(LogRecordTestFixture, TestCompress) {
+  // Log record with nothing to compress is left as is
+  ByteBuffer output = input;
+  output.resize(LogRecord::Header::GetFixedStorageSize() + sizeof(uint32_t));
+  ASSERT_FALSE(LogRecord::Compress(output));
+
+  // Compressed log record is loaded back
+  page_slot_a.data = ByteBuffer(1000, 'A');
+  LogRecord _log_record(txn_id, prev_log_record_location,
+                        LogRecord::Type::INSERT, location, page_slot_a);
+  _log_record.SetSeqNumber(seq_number);
+  output.resize(_log_record.GetStorageSize());
+  _log_record.Dump(output);
+  ASSERT_TRUE(LogRecord::Compress(output));
+  ASSERT_LT(output.size(), _log_record.GetStorageSize() / 10);
+  LogRecord __log_record;
+  __log_record.Load(output);
+  ASSERT_EQ(__log_record, _log_record);
+
+  // Size of the compressed bytes does not match
+  ++output[LogRecord::Header::GetFixedStorageSize() + sizeof(uint32_t)];
+  ASSERT_THROW(__log_record.Load(output), LogRecordParseError);
+}
+
+TEST_F(LogRecordTestFixture, TestPageKind) {
+  // Log records stored without page kind target record pages
+  ASSERT_EQ(log_record->GetPageKind(), LogRecord::PageKind::RECORD);
+
+  // Page kind is stored in the upper half of the stored type
+  LogRecord _log_record(txn_id, prev_log_record_location,
+                        LogRecord::Type::UPDATE, location, page_slot_a,
+                        page_slot_b, LogRecord::PageKind::PAX);
+  _log_record.SetSeqNumber(seq_number);
+  ByteBuffer output(_log_record.GetStorageSize());
+  _log_record.Dump(output);
+  ByteBuffer _input = input;
+  _input[LogRecord::Header::GetFixedStorageSize() + 2] = 2;
+  ASSERT_EQ(output, _input);
+
+  LogRecord __log_record;
+  __log_record.Load(output);
+  ASSERT_EQ(__log_record.GetLogType(), LogRecord::Type::UPDATE);
+  ASSERT_EQ(__log_record.GetPageKind(), LogRecord::PageKind::PAX);
+  ASSERT_EQ(__log_record, _log_record);
+}
+
 TEST_F(LogRecordTestFixture, TestDump) {
   ByteBuffer output(log_record->GetStorageSize());
   log_record->Dump(output);
@@ -0,0 +1,105 @@
+/**
+ * log/test_page_slot_delta.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief PageSlotDelta unit test
+ */
+
+#include <gtest/gtest.h>
+
+/**
+ * Enabled intrusive testing
+ */
+#define PERSIST_INTRUSIVE_TESTING
+
+#include <persist/core/wal/page_slot_delta.hpp>
+
+using namespace persist;
+
+class PageSlotDeltaTestFixture : public ::testing::Test {
+protected:
+  ByteBuffer old_image, new_image;
+
+  void SetUp() override {
+    old_image = ByteBuffer(256, 'A');
+    new_image = old_image;
+    // Two nearby changes and a distant change
+    new_image[10] = 'B';
+    new_image[12] = 'C';
+    new_image[200] = 'D';
+  }
+};
+
+TEST_F(PageSlotDeltaTestFixture, TestDiff) {
+  PageSlotDelta delta(old_image, new_image);
+
+  // Nearby changes share a range
+  ASSERT_EQ(delta.ranges.size(), 2);
+  ASSERT_EQ(delta.ranges[0].offset, 10);
+  ASSERT_EQ(delta.ranges[0].old_size, 3);
+  ASSERT_EQ(delta.ranges[1].offset, 200);
+  ASSERT_EQ(delta.ranges[1].old_size, 1);
+  ASSERT_EQ(delta.data, "AAABACAD"_bb);
+  ASSERT_EQ(delta.GetStorageSize(), 16);
+
+  // Identical images have an empty delta
+  ASSERT_TRUE(PageSlotDelta(old_image, old_image).IsEmpty());
+}
+
+TEST_F(PageSlotDeltaTestFixture, TestRedoUndo) {
+  PageSlotDelta delta(old_image, new_image);
+
+  ASSERT_EQ(delta.Redo(old_image), new_image);
+  ASSERT_EQ(delta.Undo(new_image), old_image);
+  ASSERT_THROW(delta.Undo(old_image), LogRecordParseError);
+}
+
+TEST_F(PageSlotDeltaTestFixture, TestSizeChange) {
+  // Grow the image in the middle
+  new_image = old_image;
+  new_image.insert(new_image.begin() + 100, 10, 'B');
+  PageSlotDelta delta(old_image, new_image);
+
+  ASSERT_EQ(delta.ranges.size(), 1);
+  ASSERT_EQ(delta.Redo(old_image), new_image);
+  ASSERT_EQ(delta.Undo(new_image), old_image);
+
+  // Shrink the image
+  delta = PageSlotDelta(new_image, old_image);
+  ASSERT_EQ(delta.Redo(new_image), old_image);
+  ASSERT_EQ(delta.Undo(old_image), new_image);
+}
+
+TEST_F(PageSlotDeltaTestFixture, TestLoadDump) {
+  PageSlotDelta delta(old_image, new_image);
+  ByteBuffer output(delta.GetStorageSize());
+  delta.Dump(output);
+
+  PageSlotDelta _delta;
+  _delta.Load(output);
+  ASSERT_EQ(_delta, delta);
+
+  output.pop_back();
+  ASSERT_THROW(_delta.Load(output), LogRecordParseError);
+}
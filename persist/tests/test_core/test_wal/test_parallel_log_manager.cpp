@@ -0,0 +1,196 @@
+/**
+ * log/test_parallel_log_manager.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief ParallelLogManager unit test
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Enabled intrusive testing
+ */
+#define PERSIST_INTRUSIVE_TESTING
+
+#include <persist/core/storage/memory_storage.hpp>
+#include <persist/core/transaction/transaction_manager.hpp>
+#include <persist/core/wal/parallel_log_manager.hpp>
+
+using namespace persist;
+
+class ParallelLogManagerTestFixture : public ::testing::Test {
+protected:
+  const std::string path = "test_parallel_log";
+  const size_t stream_count = 3;
+  std::unique_ptr<ParallelLogManager> log_manager;
+
+  void SetUp() override {
+    log_manager = std::make_unique<ParallelLogManager>(path, stream_count);
+    log_manager->Start();
+  }
+
+  void TearDown() override {
+    log_manager->Stop();
+    log_manager->Remove();
+  }
+
+  /**
+   * @brief Add a log record of given transaction ID to the stream of given
+   * index.
+   */
+  LogRecord::Location Add(size_t index, TransactionId txn_id) {
+    LogRecord log_record(txn_id, LogRecord::Location(),
+                         LogRecord::Type::BEGIN);
+    return log_manager->GetStream(index).Add(log_record);
+  }
+
+  /**
+   * @brief Restart the test log manager and scan all log records.
+   */
+  std::vector<std::pair<size_t, TransactionId>> Restart() {
+    log_manager->Stop();
+    log_manager = std::make_unique<ParallelLogManager>(path, stream_count);
+    log_manager->Start();
+    std::vector<std::pair<size_t, TransactionId>> records;
+    log_manager->Scan([&](size_t index, LogRecord &log_record) {
+      records.push_back({index, log_record.GetTransactionId()});
+    });
+    return records;
+  }
+};
+
+TEST_F(ParallelLogManagerTestFixture, TestStreams) {
+  ASSERT_EQ(log_manager->GetStreamCount(), stream_count);
+  ASSERT_THROW(log_manager->GetStream(stream_count), std::out_of_range);
+
+  // Each stream has its own log files
+  Add(0, 1);
+  Add(2, 2);
+  log_manager->Flush();
+  ASSERT_FALSE(log_manager->GetLog(0).IsEmpty());
+  ASSERT_TRUE(log_manager->GetLog(1).IsEmpty());
+  ASSERT_FALSE(log_manager->GetLog(2).IsEmpty());
+  ASSERT_NE(log_manager->GetLog(0).GetSegmentPath(0),
+            log_manager->GetLog(2).GetSegmentPath(0));
+
+  // A thread keeps its stream while threads are spread over the streams
+  LogManager &stream = log_manager->GetStream();
+  ASSERT_EQ(&log_manager->GetStream(), &stream);
+  std::vector<LogManager *> thread_streams(stream_count);
+  for (size_t i = 0; i < stream_count; ++i) {
+    std::thread thread(
+        [&, i]() { thread_streams[i] = &log_manager->GetStream(); });
+    thread.join();
+  }
+  std::sort(thread_streams.begin(), thread_streams.end());
+  ASSERT_EQ(std::unique(thread_streams.begin(), thread_streams.end()),
+            thread_streams.end());
+
+  // Threads are assigned streams separately by each log manager
+  ParallelLogManager other(path + "_other", stream_count);
+  ASSERT_EQ(&other.GetStream(), &other.GetStream(0));
+}
+
+TEST_F(ParallelLogManagerTestFixture, TestGlobalOrder) {
+  // Sequence numbers increase across streams
+  ASSERT_EQ(Add(1, 1).seq_number, 1);
+  ASSERT_EQ(Add(0, 2).seq_number, 2);
+  ASSERT_EQ(Add(1, 3).seq_number, 3);
+  ASSERT_EQ(Add(2, 4).seq_number, 4);
+  ASSERT_EQ(Add(0, 5).seq_number, 5);
+
+  // Streams are merged in order of sequence numbers
+  std::vector<std::pair<size_t, TransactionId>> records = {
+      {1, 1}, {0, 2}, {1, 3}, {2, 4}, {0, 5}};
+  ASSERT_EQ(Restart(), records);
+
+  // The clock continues past the latest log record of any stream
+  ASSERT_EQ(Add(1, 6).seq_number, 6);
+}
+
+TEST_F(ParallelLogManagerTestFixture, TestConcurrentAdd) {
+  const size_t thread_count = 6, record_count = 200;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&, i]() {
+      for (size_t j = 0; j < record_count; ++j) {
+        Add(i % stream_count, i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // All log records are recovered with unique sequence numbers
+  std::vector<size_t> counts(thread_count);
+  SeqNumber last_seq_number = 0;
+  log_manager->Scan([&](size_t index, LogRecord &log_record) {
+    ASSERT_EQ(index, log_record.GetTransactionId() % stream_count);
+    ASSERT_GT(log_record.GetSeqNumber(), last_seq_number);
+    last_seq_number = log_record.GetSeqNumber();
+    ++counts[log_record.GetTransactionId()];
+  });
+  ASSERT_EQ(last_seq_number, thread_count * record_count);
+  ASSERT_EQ(counts, std::vector<size_t>(thread_count, record_count));
+}
+
+TEST_F(ParallelLogManagerTestFixture, TestTransaction) {
+  MemoryStorage<RecordPage> storage;
+  BufferManager<RecordPage> buffer_manager(storage);
+  buffer_manager.Start();
+  TransactionManager txn_manager(buffer_manager, *log_manager);
+  txn_manager.Start();
+
+  // Transaction logs to the stream of the thread
+  Transaction txn = txn_manager.Begin();
+  LogManager &stream = log_manager->GetStream();
+  ASSERT_EQ(&txn.GetLogManager(), &stream);
+  size_t other = &stream == &log_manager->GetStream(0) ? 1 : 0;
+  SeqNumber other_seq_number = Add(other, 1).seq_number;
+
+  // Abort undoes the operations of the transaction
+  auto page = buffer_manager.GetNew();
+  RecordPageSlot page_slot;
+  page_slot.data = ByteBuffer(10, 'A');
+  PageSlotId slot_id = page->InsertPageSlot(page_slot, txn).first;
+  txn_manager.Abort(txn);
+  ASSERT_THROW(page->GetPageSlot(slot_id, txn), PageSlotNotFoundError);
+
+  // Commit flushes only the stream of the transaction
+  Transaction txn_2 = txn_manager.Begin();
+  page->InsertPageSlot(page_slot, txn_2);
+  txn_manager.Commit(txn_2);
+  ASSERT_GE(stream.GetFlushedSeqNumber(), txn_2.GetLogLocation().seq_number);
+  ASSERT_LT(log_manager->GetStream(other).GetFlushedSeqNumber(),
+            other_seq_number);
+
+  txn_manager.Stop();
+  buffer_manager.Stop();
+}
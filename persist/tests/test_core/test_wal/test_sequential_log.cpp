@@ -0,0 +1,227 @@
+/**
+ * log/test_sequential_log.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief SequentialLog unit test
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+/**
+ * Enabled intrusive testing
+ */
+#define PERSIST_INTRUSIVE_TESTING
+
+#include <persist/core/wal/log_manager.hpp>
+#include <persist/core/wal/sequential_log.hpp>
+
+using namespace persist;
+
+class SequentialLogTestFixture : public ::testing::Test {
+protected:
+  const std::string path = "test_sequential_log";
+  const size_t segment_size = 64;
+  const size_t tail_size = 48;
+  std::unique_ptr<SequentialLog> log;
+  ByteBuffer record_1, record_2, record_3;
+  SequentialLog::Lsn lsn_1, lsn_2, lsn_3;
+
+  void SetUp() override {
+    log = std::make_unique<SequentialLog>(path, segment_size, tail_size);
+    log->Open();
+    record_1 = ByteBuffer(20, 'A');
+    record_2 = ByteBuffer(20, 'B');
+    record_3 = ByteBuffer(20, 'C');
+    lsn_1 = log->Append(record_1);
+    lsn_2 = log->Append(record_2);
+    lsn_3 = log->Append(record_3);
+  }
+
+  void TearDown() override { log->Remove(); }
+
+  /**
+   * @brief Reopen the test log and scan all records.
+   */
+  std::vector<ByteBuffer> Reopen() {
+    log->Close();
+    log = std::make_unique<SequentialLog>(path, segment_size, tail_size);
+    log->Open();
+    std::vector<ByteBuffer> records;
+    log->Scan(0, [&](SequentialLog::Lsn, Span record) {
+      records.push_back(ByteBuffer(record.start, record.start + record.size));
+    });
+    return records;
+  }
+};
+
+TEST_F(SequentialLogTestFixture, TestAppend) {
+  // Frames are laid out back to back and never span segments
+  ASSERT_EQ(lsn_1, 0);
+  ASSERT_EQ(lsn_2, 28);
+  ASSERT_EQ(lsn_3, segment_size);
+  ASSERT_EQ(log->GetLastLsn(), lsn_3);
+  ASSERT_EQ(log->GetEndLsn(), segment_size + 28);
+  ByteBuffer large(segment_size, 'D'), empty;
+  ASSERT_THROW(log->Append(large), LogBufferError);
+  ASSERT_THROW(log->Append(empty), LogBufferError);
+
+  // Record length must fit in a frame even if the segment is larger
+  SequentialLog large_log(path + "_large", uint64_t(1) << 33);
+  large_log.Open();
+  Span oversized(record_1.data(), uint64_t(1) << 32);
+  ASSERT_THROW(large_log.Append(oversized), LogBufferError);
+  ASSERT_TRUE(large_log.IsEmpty());
+  large_log.Remove();
+}
+
+TEST_F(SequentialLogTestFixture, TestRead) {
+  // Read from the tail buffer
+  ASSERT_EQ(log->Read(lsn_3), record_3);
+  // Read from segment files
+  log->Flush();
+  ASSERT_EQ(log->Read(lsn_1), record_1);
+  ASSERT_EQ(log->Read(lsn_2), record_2);
+  ASSERT_EQ(log->Read(lsn_3), record_3);
+  ASSERT_THROW(log->Read(lsn_1 + 4), LogRecordParseError);
+  ASSERT_THROW(log->Read(log->GetEndLsn()), LogRecordParseError);
+}
+
+TEST_F(SequentialLogTestFixture, TestReader) {
+  // Records are read in order across the skipped rest of a segment
+  SequentialLog::Reader reader(*log, 0);
+  std::vector<SequentialLog::Lsn> lsns;
+  std::vector<ByteBuffer> records;
+  SequentialLog::Lsn lsn;
+  Span record;
+  while (reader.Next(lsn, record)) {
+    lsns.push_back(lsn);
+    records.push_back(ByteBuffer(record.start, record.start + record.size));
+  }
+  ASSERT_EQ(lsns, std::vector<SequentialLog::Lsn>({lsn_1, lsn_2, lsn_3}));
+  ASSERT_EQ(records, std::vector<ByteBuffer>({record_1, record_2, record_3}));
+  ASSERT_FALSE(reader.Next(lsn, record));
+
+  // Reader stops at the end of the log as of its construction
+  SequentialLog::Reader _reader(*log, lsn_2);
+  log->Append(record_1);
+  ASSERT_TRUE(_reader.Next(lsn, record));
+  ASSERT_EQ(lsn, lsn_2);
+  ASSERT_TRUE(_reader.Next(lsn, record));
+  ASSERT_EQ(lsn, lsn_3);
+  ASSERT_FALSE(_reader.Next(lsn, record));
+}
+
+TEST_F(SequentialLogTestFixture, TestReopen) {
+  std::vector<ByteBuffer> records = Reopen();
+
+  ASSERT_EQ(records, std::vector<ByteBuffer>({record_1, record_2, record_3}));
+  ASSERT_EQ(log->GetLastLsn(), lsn_3);
+  ASSERT_EQ(log->GetEndLsn(), segment_size + 28);
+  ASSERT_EQ(log->Read(lsn_2), record_2);
+}
+
+TEST_F(SequentialLogTestFixture, TestFormatVersion) {
+  log->Close();
+  // Rewrite the meta file with the header written before the log format was
+  // versioned
+  std::string meta_path = path + SEQUENTIAL_LOG_META_FILE_EXTENTION;
+  ByteBuffer meta(3 * sizeof(uint64_t));
+  std::ifstream(meta_path, std::ios::binary)
+      .read(reinterpret_cast<char *>(meta.data()), meta.size());
+  std::ofstream(meta_path, std::ios::binary | std::ios::trunc)
+      .write(reinterpret_cast<char *>(meta.data()), meta.size());
+
+  log = std::make_unique<SequentialLog>(path, segment_size, tail_size);
+  ASSERT_THROW(log->Open(), StorageError);
+}
+
+TEST_F(SequentialLogTestFixture, TestTornTail) {
+  log->Sync();
+  // Corrupt the last record
+  {
+    std::fstream file(log->GetSegmentPath(1),
+                      std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(20);
+    file.put('X');
+  }
+  std::vector<ByteBuffer> records = Reopen();
+
+  // Scan stops at the corrupt record which is dropped
+  ASSERT_EQ(records, std::vector<ByteBuffer>({record_1, record_2}));
+  ASSERT_EQ(log->GetLastLsn(), lsn_2);
+  ASSERT_EQ(log->GetEndLsn(), segment_size);
+  // Appends overwrite the corrupt record
+  ASSERT_EQ(log->Append(record_1), segment_size);
+}
+
+TEST_F(SequentialLogTestFixture, TestTruncate) {
+  log->Append(record_1);
+  log->Append(record_2);
+  log->Flush();
+  ASSERT_TRUE(log->HasSegmentFile(2));
+  log->Truncate(lsn_3 + 1);
+  ASSERT_EQ(log->GetStartLsn(), segment_size);
+
+  // Truncated segment is recycled for the next segment
+  ByteBuffer record_4(40, 'D');
+  SequentialLog::Lsn lsn = log->Append(record_4);
+  ASSERT_EQ(lsn, 3 * segment_size);
+  log->Flush();
+  ASSERT_FALSE(log->HasSegmentFile(0));
+  ASSERT_TRUE(log->HasSegmentFile(3));
+
+  // Stale records of the recycled segment are rejected
+  std::vector<ByteBuffer> records = Reopen();
+  ASSERT_EQ(records, std::vector<ByteBuffer>(
+                         {record_3, record_1, record_2, record_4}));
+  ASSERT_EQ(log->GetStartLsn(), segment_size);
+  ASSERT_EQ(log->GetEndLsn(), lsn + 48);
+  ASSERT_THROW(log->Read(lsn + 48), LogRecordParseError);
+}
+
+TEST_F(SequentialLogTestFixture, TestLogManager) {
+  SequentialLog _log(path + "_manager", 4096);
+  LogManager log_manager(_log);
+  log_manager.Start();
+  LogRecord log_record(1);
+  LogRecord::Location location = log_manager.Add(log_record);
+  log_manager.Flush(location.seq_number);
+  ASSERT_EQ(log_manager.GetSyncedSeqNumber(), 1);
+  ASSERT_EQ(*log_manager.Get(location), log_record);
+  log_manager.Stop();
+
+  // Sequence number is recovered from the last log record
+  log_manager.Start();
+  LogRecord _log_record(2);
+  LogRecord::Location _location = log_manager.Add(_log_record);
+  ASSERT_EQ(_location.seq_number, 2);
+  ASSERT_EQ(*log_manager.Get(location), log_record);
+  ASSERT_EQ(*log_manager.Get(_location), _log_record);
+  log_manager.Stop();
+  _log.Remove();
+}
@@ -38,3 +38,54 @@ TEST(ChecksumTestFixture, TestChecksumAlder32) {
   Checksum value = checksum(input);
   ASSERT_EQ(value, 956630705);
 }
+
+TEST(ChecksumTestFixture, TestChecksumAlder32Long) {
+  // Runs longer than the deferred modulo run length
+  ByteBuffer input(20000, 0xFF);
+  uint32_t a = 1, b = 0;
+  for (Byte byte : input) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  ASSERT_EQ(checksum(input), (b << 16) | a);
+}
+
+TEST(ChecksumTestFixture, TestChecksumCrc32c) {
+  ByteBuffer input = "123456789"_bb;
+  ASSERT_EQ(checksum<Crc32cHash>(input), 0xE3069283);
+  ByteBuffer empty;
+  ASSERT_EQ(checksum<Crc32cHash>(empty), 0);
+  // Long input with a tail not a multiple of 8 bytes
+  ByteBuffer zeros(32, 0);
+  ASSERT_EQ(checksum<Crc32cHash>(zeros), 0x8A9136AA);
+}
+
+TEST(ChecksumTestFixture, TestChecksumXXHash64) {
+  ByteBuffer empty;
+  ASSERT_EQ(checksum<XXHash64>(empty), 0xEF46DB3751D8E999);
+  ByteBuffer input = "abc"_bb;
+  ASSERT_EQ(checksum<XXHash64>(input), 0x44BC2CF5AD770999);
+}
+
+TEST(ChecksumTestFixture, TestChecksumType) {
+  ByteBuffer input = "testing_checksum"_bb;
+  ASSERT_EQ(checksum(input, ChecksumType::ALDER32), checksum(input));
+  ASSERT_EQ(checksum(input, ChecksumType::CRC32C),
+            checksum<Crc32cHash>(input));
+  ASSERT_EQ(checksum(input, ChecksumType::XXHASH64),
+            checksum<XXHash64>(input));
+
+  // Unknown checksum algorithm is not used
+  ChecksumType type = static_cast<ChecksumType>(7);
+  ASSERT_FALSE(IsKnownChecksumType(type));
+  ASSERT_THROW(checksum(input, type), std::invalid_argument);
+}
+
+TEST(ChecksumTestFixture, TestChecksumCrc32cPortable) {
+  ByteBuffer input(1021);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<Byte>(i * 31);
+  }
+  uint32_t crc = Crc32cHash::Portable(0xFFFFFFFF, input) ^ 0xFFFFFFFF;
+  ASSERT_EQ(checksum<Crc32cHash>(input), crc);
+}
@@ -0,0 +1,84 @@
+/**
+ * test_compression.cpp - Persist
+ *
+ * Copyright 2021 Ketan Goyal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Compression unit tests
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <persist/utility/compression.hpp>
+
+using namespace persist;
+
+/**
+ * @brief Compress and decompress input checking the round trip.
+ */
+static ByteBuffer RoundTrip(ByteBuffer &input) {
+  ByteBuffer compressed;
+  size_t size = LzCodec::Compress(input, compressed);
+  EXPECT_EQ(size, compressed.size());
+  ByteBuffer output(input.size());
+  EXPECT_TRUE(LzCodec::Decompress(compressed, output));
+  EXPECT_EQ(output, input);
+  return compressed;
+}
+
+TEST(CompressionTest, TestRoundTrip) {
+  ByteBuffer empty;
+  ASSERT_EQ(RoundTrip(empty).size(), 1);
+
+  ByteBuffer text = "{\"name\": \"persist\", \"type\": \"record\"}"_bb;
+  ByteBuffer repeated;
+  for (int i = 0; i < 100; ++i) {
+    repeated.insert(repeated.end(), text.begin(), text.end());
+  }
+  ASSERT_LT(RoundTrip(repeated).size(), repeated.size() / 20);
+
+  // Long literal runs and overlapping matches
+  ByteBuffer mixed;
+  for (size_t i = 0; i < 1000; ++i) {
+    mixed.push_back(static_cast<Byte>(i * 7919 % 251));
+  }
+  mixed.insert(mixed.end(), 1000, 'A');
+  ASSERT_LT(RoundTrip(mixed).size(), mixed.size());
+}
+
+TEST(CompressionTest, TestDecompressError) {
+  ByteBuffer input(100, 'A');
+  ByteBuffer compressed;
+  LzCodec::Compress(input, compressed);
+
+  // Output size must match
+  ByteBuffer output(99);
+  ASSERT_FALSE(LzCodec::Decompress(compressed, output));
+  // Truncated input
+  output.resize(100);
+  compressed.resize(2);
+  ASSERT_FALSE(LzCodec::Decompress(compressed, output));
+  // Match offset before the start of the output
+  ByteBuffer invalid = {0x00, 0x05, 0x00};
+  ASSERT_FALSE(LzCodec::Decompress(invalid, output));
+}
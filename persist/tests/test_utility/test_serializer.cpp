@@ -147,6 +147,36 @@ TEST_F(UtilitySerializerTestFixture, TestDumpVector) {
   dump(span, vector2d);
 }
 
+TEST_F(UtilitySerializerTestFixture, TestLoadDumpByteBuffer) {
+  ByteBuffer data = "persist"_bb;
+  ByteBuffer output(sizeof(size_t) + data.size());
+  Span span(output);
+  dump(span, data);
+  ASSERT_EQ(output, ByteBuffer({7, 0, 0, 0, 0, 0, 0, 0, 'p', 'e', 'r', 's', 'i',
+                                's', 't'}));
+
+  // Loaded data is appended to the buffer
+  ByteBuffer _data = "a"_bb;
+  span = Span(output);
+  load(span, _data);
+  ASSERT_EQ(_data, "apersist"_bb);
+}
+
+TEST_F(UtilitySerializerTestFixture, TestLoadDumpByteView) {
+  ByteBuffer data = "persist"_bb;
+  ByteBuffer output(sizeof(size_t) + data.size());
+  Span span(output);
+  dump(span, ByteView(data));
+
+  // Loaded view points into the input without copying
+  ByteView view;
+  span = Span(output);
+  load(span, view);
+  ASSERT_EQ(view.start, output.data() + sizeof(size_t));
+  ASSERT_EQ(view.ToBuffer(), data);
+  ASSERT_EQ(span.size, 0);
+}
+
 TEST_F(UtilitySerializerTestFixture, TestLoadSet) {
   std::set<uint64_t> _set;
 
@@ -249,3 +279,32 @@ TEST_F(UtilitySerializerTestFixture, TestDumpAll) {
 
   ASSERT_EQ(output, input_all);
 }
+
+TEST(UtilitySerializerVarintTest, TestLoadDumpVarint) {
+  const std::vector<uint64_t> values = {0, 127, 128, 300, UINT64_MAX};
+  const std::vector<size_t> sizes = {1, 1, 2, 2, 10};
+  for (size_t i = 0; i < values.size(); ++i) {
+    ByteBuffer buffer(varint_size(values[i]));
+    ASSERT_EQ(buffer.size(), sizes[i]);
+    Span output(buffer);
+    dump_varint(output, values[i]);
+    ASSERT_EQ(output.size, 0);
+
+    uint64_t value;
+    Span input(buffer);
+    ASSERT_TRUE(load_varint(input, value));
+    ASSERT_EQ(value, values[i]);
+  }
+  // Low order groups of 7 bits are dumped first
+  ByteBuffer output(2);
+  Span span(output);
+  dump_varint(span, 300);
+  ASSERT_EQ(output, ByteBuffer({0xAC, 0x02}));
+}
+
+TEST(UtilitySerializerVarintTest, TestLoadVarintTruncated) {
+  ByteBuffer buffer = {0x80, 0x80};
+  Span input(buffer);
+  uint64_t value;
+  ASSERT_FALSE(load_varint(input, value));
+}